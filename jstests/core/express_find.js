@@ -0,0 +1,59 @@
+// Tests that point reads on _id or on a unique index, which the find command may answer without
+// planning the query, return the same documents as the query system.
+// @tags: [
+//   assumes_no_implicit_collection_creation_after_drop,
+//   assumes_unsharded_collection,
+//   requires_fcv_44,
+// ]
+(function() {
+"use strict";
+
+const coll = db.express_find;
+coll.drop();
+
+assert.commandWorked(coll.insert([
+    {_id: 1, a: 1, b: "x"},
+    {_id: 2.5, a: [2, 3], b: "y"},
+    {_id: "str", a: {c: 1}},
+    {_id: {x: 1, y: 2}, b: "z"},
+    {_id: NumberLong(4), a: NumberDecimal("4.5")},
+]));
+
+// _id lookups compare numbers by value and match embedded documents literally.
+assert.eq([{_id: 1, a: 1, b: "x"}], coll.find({_id: 1}).toArray());
+assert.eq([{_id: 1, a: 1, b: "x"}], coll.find({_id: 1.0}).toArray());
+assert.eq([{_id: NumberLong(4), a: NumberDecimal("4.5")}], coll.find({_id: 4}).toArray());
+assert.eq([{_id: {x: 1, y: 2}, b: "z"}], coll.find({_id: {x: 1, y: 2}}).toArray());
+assert.eq([], coll.find({_id: {y: 2, x: 1}}).toArray());
+assert.eq([], coll.find({_id: 5}).toArray());
+assert.eq([{_id: 1, a: 1, b: "x"}], coll.find({_id: 1}).limit(1).batchSize(1).toArray());
+
+// Lookups on a unique index find documents through any of their keys, including those of arrays.
+assert.commandWorked(coll.createIndex({a: 1}, {unique: true, sparse: true}));
+assert.eq([{_id: 2.5, a: [2, 3], b: "y"}], coll.find({a: 3}).toArray());
+assert.eq([{_id: "str", a: {c: 1}}], coll.find({a: {c: 1}}).toArray());
+assert.eq([{_id: NumberLong(4), a: NumberDecimal("4.5")}], coll.find({a: 4.5}).toArray());
+assert.eq([], coll.find({a: 7}).toArray());
+
+// Null and arrays must not be looked up as index keys.
+assert.eq(1, coll.find({a: null}).itcount());
+assert.eq([{_id: 2.5, a: [2, 3], b: "y"}], coll.find({a: [2, 3]}).toArray());
+
+// Descending and partial unique indexes return the same results.
+assert.commandWorked(coll.createIndex({b: -1}, {unique: true, partialFilterExpression: {a: 1}}));
+assert.eq([{_id: 1, a: 1, b: "x"}], coll.find({b: "x"}).toArray());
+assert.eq([{_id: 2.5, a: [2, 3], b: "y"}], coll.find({b: "y"}).toArray());
+
+// A projection or sort is still applied.
+assert.eq([{a: 1}], coll.find({_id: 1}, {_id: 0, a: 1}).toArray());
+assert.eq([{_id: 1, a: 1, b: "x"}], coll.find({_id: 1}).sort({b: 1}).toArray());
+
+// Lookups honor the collection's default collation.
+coll.drop();
+assert.commandWorked(db.createCollection(coll.getName(), {collation: {locale: "en", strength: 2}}));
+assert.commandWorked(coll.insert({_id: "foo", k: "bar"}));
+assert.commandWorked(coll.createIndex({k: 1}, {unique: true}));
+assert.eq([{_id: "foo", k: "bar"}], coll.find({_id: "FOO"}).toArray());
+assert.eq([{_id: "foo", k: "bar"}], coll.find({k: "BAR"}).toArray());
+assert.eq([], coll.find({_id: "FOO"}).collation({locale: "simple"}).toArray());
+})();
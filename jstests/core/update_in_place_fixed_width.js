@@ -0,0 +1,64 @@
+// Tests that updates which only overwrite existing numeric, date and bool fields, and which the
+// server may apply directly to the stored BSON, produce the same documents and index entries as
+// any other update.
+// @tags: [
+//   assumes_no_implicit_collection_creation_after_drop,
+//   requires_fcv_44,
+//   requires_non_retryable_writes,
+// ]
+(function() {
+"use strict";
+
+const coll = db.update_in_place_fixed_width;
+coll.drop();
+
+assert.commandWorked(coll.insert({
+    _id: 1,
+    views: NumberLong(10),
+    stats: {clicks: NumberInt(5), ratio: 0.5},
+    seen: new Date(1000),
+    flag: false,
+    indexed: 1
+}));
+assert.commandWorked(coll.createIndex({indexed: 1}));
+
+// Counters keep their types while they fit.
+assert.commandWorked(
+    coll.update({_id: 1}, {$inc: {views: NumberLong(1), "stats.clicks": NumberInt(2)}}));
+assert.commandWorked(coll.update({_id: 1}, {$max: {seen: new Date(2000)}, $set: {flag: true}}));
+assert.commandWorked(coll.update({_id: 1}, {$min: {"stats.ratio": 0.25}}));
+assert.eq({
+    _id: 1,
+    views: NumberLong(11),
+    stats: {clicks: NumberInt(7), ratio: 0.25},
+    seen: new Date(2000),
+    flag: true,
+    indexed: 1
+},
+          coll.findOne());
+
+// No-ops report that nothing was modified.
+let res = assert.commandWorked(
+    coll.update({_id: 1}, {$inc: {views: NumberLong(0)}, $max: {seen: new Date(0)}}));
+assert.eq(0, res.nModified);
+
+// Updates that change the type or size of a value still apply.
+assert.commandWorked(coll.update({_id: 1}, {$inc: {"stats.clicks": NumberInt(2147483647)}}));
+assert.eq(NumberLong(2147483654), coll.findOne()["stats"]["clicks"]);
+assert.commandWorked(coll.update({_id: 1}, {$set: {flag: "yes"}}));
+assert.eq("yes", coll.findOne()["flag"]);
+
+// Indexed fields are kept in step with the index.
+assert.commandWorked(coll.update({_id: 1}, {$inc: {indexed: 1}}));
+assert.eq(1, coll.find({indexed: 2}).hint({indexed: 1}).itcount());
+assert.eq(0, coll.find({indexed: 1}).hint({indexed: 1}).itcount());
+
+// The _id is still immutable.
+assert.commandFailedWithCode(coll.update({_id: 1}, {$set: {_id: 2}}), ErrorCodes.ImmutableField);
+
+// Upserts that find a document only apply the update.
+assert.commandWorked(coll.update(
+    {_id: 1}, {$inc: {views: NumberLong(1)}, $setOnInsert: {created: true}}, {upsert: true}));
+assert.eq(NumberLong(12), coll.findOne()["views"]);
+assert(!coll.findOne().hasOwnProperty("created"));
+})();
@@ -0,0 +1,63 @@
+// Confirms that point reads answered without planning the query are profiled with the same
+// queryHash, planCacheKey and execution stats shape as when the query system plans them.
+// @tags: [requires_profiling]
+(function() {
+"use strict";
+
+load("jstests/libs/profiler.js");  // For getLatestProfilerEntry().
+
+const conn = MongoRunner.runMongod();
+assert.neq(null, conn, "mongod was unable to start up");
+const testDB = conn.getDB(jsTestName());
+const coll = testDB.test;
+
+assert.commandWorked(coll.insert([{_id: 1, a: 1}, {_id: 2, a: 2}]));
+assert.commandWorked(coll.createIndex({a: 1}, {unique: true}));
+assert.commandWorked(testDB.setProfilingLevel(2));
+
+function setExpressFind(enabled) {
+    assert.commandWorked(
+        testDB.adminCommand({setParameter: 1, internalQueryEnableExpressFind: enabled}));
+}
+
+function profileFind(filter, comment) {
+    assert.eq(1, coll.find(filter).comment(comment).itcount());
+    return getLatestProfilerEntry(testDB, {op: "query", "command.comment": comment});
+}
+
+setExpressFind(true);
+const expressEntry = profileFind({a: 1}, "express unique");
+const expressIdEntry = profileFind({_id: 1}, "express _id");
+
+setExpressFind(false);
+const plannedEntry = profileFind({a: 2}, "planned unique");
+const plannedIdEntry = profileFind({_id: 2}, "planned _id");
+
+// Lookups on a unique index carry the hashes of their query shape.
+assert.eq(expressEntry.planSummary, "IXSCAN { a: 1 }", tojson(expressEntry));
+assert(expressEntry.hasOwnProperty("queryHash"), tojson(expressEntry));
+assert.eq(expressEntry.queryHash, plannedEntry.queryHash, tojson(plannedEntry));
+assert.eq(expressEntry.planCacheKey, plannedEntry.planCacheKey, tojson(plannedEntry));
+
+// IDHACK queries have no plan cache key whichever path answers them.
+assert.eq(expressIdEntry.planSummary, "IDHACK", tojson(expressIdEntry));
+assert(!expressIdEntry.hasOwnProperty("queryHash"), tojson(expressIdEntry));
+assert(!plannedIdEntry.hasOwnProperty("queryHash"), tojson(plannedIdEntry));
+
+// The execution stats have the stages and fields of the plan the query system chooses.
+function stageShape(stats) {
+    const shape = {stage: stats.stage, fields: Object.keys(stats).sort()};
+    if (stats.hasOwnProperty("inputStage")) {
+        shape.inputStage = stageShape(stats.inputStage);
+    }
+    return shape;
+}
+assert.eq(stageShape(expressEntry.execStats),
+          stageShape(plannedEntry.execStats),
+          tojson(expressEntry));
+assert.eq(stageShape(expressIdEntry.execStats),
+          stageShape(plannedIdEntry.execStats),
+          tojson(expressIdEntry));
+
+MongoRunner.stopMongod(conn);
+})();
@@ -0,0 +1,103 @@
+/**
+ * Measures the oplog bytes written per pipeline-style update with and without
+ * 'enableDeltaOplogEntriesForPipelineUpdates', and checks that '$v: 2' delta entries are applied
+ * correctly by secondaries and reported correctly by change streams.
+ *
+ * @tags: [requires_replication, uses_change_streams]
+ */
+(function() {
+"use strict";
+
+const rst = new ReplSetTest({name: jsTestName(), nodes: 2});
+rst.startSet();
+rst.initiate();
+
+const primary = rst.getPrimary();
+const testDB = primary.getDB(jsTestName());
+const coll = testDB.test;
+const oplog = primary.getDB("local").oplog.rs;
+
+const numDocs = 20;
+const payload = "x".repeat(50 * 1024);
+
+function setDeltaEntries(enabled) {
+    assert.commandWorked(primary.adminCommand(
+        {setParameter: 1, enableDeltaOplogEntriesForPipelineUpdates: enabled}));
+}
+
+// Runs one pipeline update per document and returns the average size of the oplog 'o' field.
+function measureOplogBytesPerUpdate() {
+    const startTime = oplog.find().sort({$natural: -1}).limit(1).next().ts;
+    for (let i = 0; i < numDocs; ++i) {
+        assert.commandWorked(
+            coll.update({_id: i}, [{$set: {counter: {$add: ["$counter", 1]}}}]));
+    }
+
+    const entries =
+        oplog.find({op: "u", ns: coll.getFullName(), ts: {$gt: startTime}}).toArray();
+    assert.eq(entries.length, numDocs, tojson(entries.map((entry) => entry.o)));
+    return {
+        bytes: entries.reduce((total, entry) => total + Object.bsonsize(entry.o), 0) / numDocs,
+        entries: entries
+    };
+}
+
+let bulk = coll.initializeUnorderedBulkOp();
+for (let i = 0; i < numDocs; ++i) {
+    bulk.insert({_id: i, counter: NumberLong(0), payload: payload});
+}
+assert.commandWorked(bulk.execute());
+
+setDeltaEntries(false);
+const replacement = measureOplogBytesPerUpdate();
+replacement.entries.forEach((entry) => assert.eq(entry.o.payload, payload, tojson(entry)));
+
+setDeltaEntries(true);
+const csCursor = coll.watch();
+const delta = measureOplogBytesPerUpdate();
+delta.entries.forEach((entry) => {
+    assert.eq(entry.o, {$v: 2, diff: {u: {counter: NumberLong(2)}}}, tojson(entry));
+});
+
+jsTestLog("Oplog bytes per pipeline update: replacement " + replacement.bytes + ", delta " +
+          delta.bytes);
+assert.lt(delta.bytes * 100, replacement.bytes);
+
+// Updates which touch most of the document still fall back to a replacement.
+assert.commandWorked(coll.update({_id: 0}, [{$replaceWith: {_id: "$_id", other: 1}}]));
+const lastEntry =
+    oplog.find({op: "u", ns: coll.getFullName()}).sort({$natural: -1}).limit(1).next();
+assert.eq(lastEntry.o, {_id: 0, other: 1}, tojson(lastEntry));
+
+// Removed fields are recorded in the 'd' section of the diff.
+assert.commandWorked(coll.update({_id: 1}, [{$unset: "counter"}]));
+
+for (let i = 0; i < numDocs; ++i) {
+    assert.soon(() => csCursor.hasNext());
+    const event = csCursor.next();
+    assert.eq(event.operationType, "update", tojson(event));
+    assert.eq(event.updateDescription,
+              {updatedFields: {counter: NumberLong(2)}, removedFields: []},
+              tojson(event));
+}
+assert.soon(() => csCursor.hasNext());
+assert.eq(csCursor.next().operationType, "replace");
+assert.soon(() => csCursor.hasNext());
+assert.eq(csCursor.next().updateDescription, {updatedFields: {}, removedFields: ["counter"]});
+csCursor.close();
+
+// The secondary applied the delta entries to the same documents.
+rst.awaitReplication();
+const secondaryColl = rst.getSecondary().getDB(jsTestName()).test;
+assert.eq(coll.find().sort({_id: 1}).toArray(), secondaryColl.find().sort({_id: 1}).toArray());
+rst.checkReplicatedDataHashes();
+
+// Delta entries are not logged while the FCV is downgraded, even with the parameter enabled.
+assert.commandWorked(primary.adminCommand({setFeatureCompatibilityVersion: lastStableFCV}));
+assert.commandWorked(coll.update({_id: 2}, [{$set: {counter: {$add: ["$counter", 1]}}}]));
+const downgradedEntry =
+    oplog.find({op: "u", ns: coll.getFullName()}).sort({$natural: -1}).limit(1).next();
+assert.eq(downgradedEntry.o.payload, payload, tojson(downgradedEntry));
+
+rst.stopSet();
+})();
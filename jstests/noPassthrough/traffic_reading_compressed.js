@@ -0,0 +1,49 @@
+// Tests that compressed traffic recordings read back the same as uncompressed ones.
+(function() {
+const recordingDir = MongoRunner.toRealDir("$dataDir/traffic_recording_compressed/");
+mkdir(recordingDir);
+
+const m = MongoRunner.runMongod({setParameter: "trafficRecordingDirectory=" + recordingDir});
+const adminDB = m.getDB("admin");
+const testDB = m.getDB("test");
+const coll = testDB.getCollection("foo");
+
+function recordTraffic(filename, compress) {
+    assert.commandWorked(
+        adminDB.runCommand({startRecordingTraffic: 1, filename: filename, compress: compress}));
+
+    const stats = assert.commandWorked(adminDB.runCommand({serverStatus: 1})).trafficRecording;
+    assert.eq(stats.running, true);
+    assert.eq(stats.compress, compress);
+
+    for (let i = 0; i < 100; i++) {
+        assert.commandWorked(coll.insert({_id: filename + i, payload: "x".repeat(100)}));
+        assert.eq(filename + i, coll.findOne({_id: filename + i})._id);
+    }
+
+    assert.commandWorked(adminDB.runCommand({stopRecordingTraffic: 1}));
+    return convertTrafficRecordingToBSON(MongoRunner.toRealDir(recordingDir + "/" + filename));
+}
+
+function summarize(packets) {
+    let opTypes = {};
+    let lastOrder = 0;
+    packets.forEach((obj) => {
+        // Packets from all threads are written in the order they were observed
+        assert.gt(obj["order"], lastOrder);
+        lastOrder = obj["order"];
+        opTypes[obj["opType"]] = (opTypes[obj["opType"]] || 0) + 1;
+    });
+    return opTypes;
+}
+
+const plain = summarize(recordTraffic("plain.bin", false));
+const compressed = summarize(recordTraffic("compressed.bin", true));
+
+assert.eq(plain["insert"], 100);
+assert.eq(plain["find"], 100);
+assert.eq(compressed["insert"], plain["insert"]);
+assert.eq(compressed["find"], plain["find"]);
+
+MongoRunner.stopMongod(m);
+})();
@@ -33,6 +33,7 @@
 
 #include "mongo/client/async_client.h"
 
+#include <algorithm>
 #include <memory>
 
 #include "mongo/bson/bsonobjbuilder.h"
@@ -62,14 +63,15 @@ Future<AsyncDBClient::Handle> AsyncDBClient::connect(const HostAndPort& peer,
                                                      transport::ReactorHandle reactor,
                                                      Milliseconds timeout) {
     auto tl = context->getTransportLayer();
-    return tl->asyncConnect(peer, sslMode, std::move(reactor), timeout)
-        .then([peer, context](transport::SessionHandle session) {
-            return std::make_shared<AsyncDBClient>(peer, std::move(session), context);
+    return tl->asyncConnect(peer, sslMode, reactor, timeout)
+        .then([peer, context, reactor](transport::SessionHandle session) {
+            return std::make_shared<AsyncDBClient>(peer, std::move(session), context, reactor);
         });
 }
 
 BSONObj AsyncDBClient::_buildIsMasterRequest(const std::string& appName,
-                                             executor::NetworkConnectionHook* hook) {
+                                             executor::NetworkConnectionHook* hook,
+                                             bool requestMultiplexing) {
     BSONObjBuilder bob;
 
     bob.append("isMaster", 1);
@@ -88,6 +90,10 @@ BSONObj AsyncDBClient::_buildIsMasterRequest(const std::string& appName,
 
     _compressorManager.clientBegin(&bob);
 
+    if (requestMultiplexing) {
+        bob.append(rpc::kRequestMultiplexingFieldName, true);
+    }
+
     if (WireSpec::instance().isInternalClient) {
         WireSpec::appendInternalClientWireVersion(WireSpec::instance().outgoing, &bob);
     }
@@ -134,6 +140,11 @@ void AsyncDBClient::_parseIsMasterResponse(BSONObj request,
     _negotiatedProtocol = uassertStatusOK(rpc::negotiate(protocolSet.protocolSet, clientProtocols));
 
     _compressorManager.clientFinish(responseBody);
+
+    // Only a server that understood the request agrees to it, so older servers are never sent
+    // multiplexed requests.
+    _multiplexingNegotiated = request[rpc::kRequestMultiplexingFieldName].trueValue() &&
+        responseBody[rpc::kRequestMultiplexingFieldName].trueValue();
 }
 
 auth::RunCommandHook AsyncDBClient::_makeAuthRunCommandHook() {
@@ -214,8 +225,10 @@ Future<bool> AsyncDBClient::completeSpeculativeAuth(std::shared_ptr<SaslClientSe
 }
 
 Future<void> AsyncDBClient::initWireVersion(const std::string& appName,
-                                            executor::NetworkConnectionHook* const hook) {
-    auto requestObj = _buildIsMasterRequest(appName, hook);
+                                            executor::NetworkConnectionHook* const hook,
+                                            bool requestMultiplexing) {
+    // Shared connections do their I/O on the reactor, so one is needed to share this one.
+    auto requestObj = _buildIsMasterRequest(appName, hook, requestMultiplexing && _reactor);
     // We use a legacy request to create our ismaster request because we may
     // have to communicate with servers that do not support other protocols.
     auto requestMsg =
@@ -237,7 +250,7 @@ Future<void> AsyncDBClient::initWireVersion(const std::string& appName,
         });
 }
 
-Future<void> AsyncDBClient::_call(Message request, int32_t msgId, const BatonHandle& baton) {
+StatusWith<Message> AsyncDBClient::_prepareRequest(Message request, int32_t msgId) {
     auto swm = _compressorManager.compressMessage(request);
     if (!swm.isOK()) {
         return swm.getStatus();
@@ -254,7 +267,204 @@ Future<void> AsyncDBClient::_call(Message request, int32_t msgId, const BatonHan
     OpMsg::appendChecksum(&request);
 #endif
 
-    return _session->asyncSinkMessage(request, baton);
+    return std::move(request);
+}
+
+Future<void> AsyncDBClient::_call(Message request, int32_t msgId, const BatonHandle& baton) {
+    auto swm = _prepareRequest(std::move(request), msgId);
+    if (!swm.isOK()) {
+        return swm.getStatus();
+    }
+
+    return _session->asyncSinkMessage(std::move(swm.getValue()), baton);
+}
+
+Future<Message> AsyncDBClient::_callMultiplexed(
+    Message request,
+    int32_t msgId,
+    boost::optional<executor::RemoteCommandRequest::RequestId> requestId) {
+    const bool expectsReply = !OpMsg::isFlagSet(request, OpMsg::kMoreToCome);
+    auto swm = _prepareRequest(std::move(request), msgId);
+    if (!swm.isOK()) {
+        return swm.getStatus();
+    }
+
+    auto pf = makePromiseFuture<Message>();
+
+    std::vector<Message> batch;
+    bool startReading = false;
+    {
+        stdx::lock_guard lk(_multiplexingMutex);
+        if (!_multiplexingStatus.isOK()) {
+            return _multiplexingStatus;
+        }
+
+        if (expectsReply) {
+            _inFlight.emplace(msgId, MultiplexedRequest{std::move(pf.promise), requestId});
+            startReading = !std::exchange(_isReading, true);
+        }
+
+        _pendingWrites.push_back(std::move(swm.getValue()));
+        if (!std::exchange(_isWriting, true)) {
+            batch = std::exchange(_pendingWrites, {});
+        }
+    }
+
+    if (!batch.empty() || startReading) {
+        // The caller may be on any thread, so leave the I/O to the reactor, which also runs the
+        // completions of the reads and writes already in progress.
+        _reactor->schedule([this,
+                            anchor = shared_from_this(),
+                            batch = std::move(batch),
+                            startReading](Status status) mutable {
+            if (!status.isOK()) {
+                _failMultiplexed(std::move(status));
+                return;
+            }
+            if (!batch.empty()) {
+                _writeMultiplexed(std::move(batch));
+            }
+            if (startReading) {
+                _readMultiplexed();
+            }
+        });
+    }
+
+    if (!expectsReply) {
+        // There is no reply to wait for, and a failed write fails the connection for the requests
+        // that come after this one.
+        pf.promise.emplaceValue(Message());
+    }
+    return std::move(pf.future);
+}
+
+void AsyncDBClient::_writeMultiplexed(std::vector<Message> batch) {
+    // Loop rather than recurse while writes complete inline.
+    while (true) {
+        auto future = _session->asyncSinkMessages(std::move(batch));
+        if (!future.isReady()) {
+            std::move(future).getAsync([this, anchor = shared_from_this()](Status status) {
+                if (auto next = _nextMultiplexedWrite(std::move(status))) {
+                    _writeMultiplexed(std::move(*next));
+                }
+            });
+            return;
+        }
+
+        auto next = _nextMultiplexedWrite(std::move(future).getNoThrow());
+        if (!next) {
+            return;
+        }
+        batch = std::move(*next);
+    }
+}
+
+boost::optional<std::vector<Message>> AsyncDBClient::_nextMultiplexedWrite(Status lastWrite) {
+    if (!lastWrite.isOK()) {
+        _failMultiplexed(std::move(lastWrite));
+        return boost::none;
+    }
+
+    stdx::lock_guard lk(_multiplexingMutex);
+    if (_pendingWrites.empty() || !_multiplexingStatus.isOK()) {
+        _isWriting = false;
+        return boost::none;
+    }
+    return std::exchange(_pendingWrites, {});
+}
+
+void AsyncDBClient::_readMultiplexed() {
+    // Loop rather than recurse while replies are already buffered.
+    while (true) {
+        auto future = _session->asyncSourceMessage();
+        if (!future.isReady()) {
+            std::move(future).getAsync(
+                [this, anchor = shared_from_this()](StatusWith<Message> swResponse) {
+                    if (_onMultiplexedReply(std::move(swResponse))) {
+                        _readMultiplexed();
+                    }
+                });
+            return;
+        }
+
+        if (!_onMultiplexedReply(std::move(future).getNoThrow())) {
+            return;
+        }
+    }
+}
+
+bool AsyncDBClient::_onMultiplexedReply(StatusWith<Message> swResponse) {
+    if (swResponse.isOK() && swResponse.getValue().operation() == dbCompressed) {
+        swResponse = _compressorManager.decompressMessage(swResponse.getValue());
+    }
+    if (!swResponse.isOK()) {
+        _failMultiplexed(swResponse.getStatus());
+        return false;
+    }
+
+    auto& response = swResponse.getValue();
+    boost::optional<Promise<Message>> promise;
+    bool keepReading;
+    {
+        stdx::lock_guard lk(_multiplexingMutex);
+        if (auto it = _inFlight.find(response.header().getResponseToMsgId());
+            it != _inFlight.end()) {
+            promise.emplace(std::move(it->second.promise));
+            _inFlight.erase(it);
+        }
+
+        // Requests made after this point start reading again.
+        keepReading = !_inFlight.empty();
+        _isReading = keepReading;
+    }
+
+    // A reply with no request was for one that has been canceled.
+    if (promise) {
+        promise->emplaceValue(std::move(response));
+    }
+    return keepReading;
+}
+
+void AsyncDBClient::_failMultiplexed(Status status) {
+    invariant(!status.isOK());
+
+    stdx::unordered_map<int32_t, MultiplexedRequest> inFlight;
+    {
+        stdx::lock_guard lk(_multiplexingMutex);
+        if (_multiplexingStatus.isOK()) {
+            _multiplexingStatus = status;
+        }
+        _pendingWrites.clear();
+        inFlight = std::exchange(_inFlight, {});
+    }
+
+    for (auto& [msgId, request] : inFlight) {
+        request.promise.setError(status);
+    }
+}
+
+void AsyncDBClient::cancelRequest(executor::RemoteCommandRequest::RequestId requestId) {
+    boost::optional<Promise<Message>> promise;
+    {
+        stdx::lock_guard lk(_multiplexingMutex);
+        auto it = std::find_if(_inFlight.begin(), _inFlight.end(), [&](const auto& entry) {
+            return entry.second.requestId == requestId;
+        });
+        if (it == _inFlight.end()) {
+            return;
+        }
+        promise.emplace(std::move(it->second.promise));
+        _inFlight.erase(it);
+    }
+
+    promise->setError(Status(ErrorCodes::CallbackCanceled,
+                             str::stream() << "Request " << requestId << " to " << _peer
+                                           << " was canceled"));
+}
+
+Status AsyncDBClient::getMultiplexingStatus() const {
+    stdx::lock_guard lk(_multiplexingMutex);
+    return _multiplexingStatus;
 }
 
 Future<Message> AsyncDBClient::_waitForResponse(boost::optional<int32_t> msgId,
@@ -275,12 +485,35 @@ Future<Message> AsyncDBClient::_waitForResponse(boost::optional<int32_t> msgId,
 Future<rpc::UniqueReply> AsyncDBClient::runCommand(OpMsgRequest request,
                                                    const BatonHandle& baton,
                                                    bool fireAndForget) {
+    return _runCommand(std::move(request), baton, fireAndForget, boost::none);
+}
+
+Future<rpc::UniqueReply> AsyncDBClient::_runCommand(
+    OpMsgRequest request,
+    const BatonHandle& baton,
+    bool fireAndForget,
+    boost::optional<executor::RemoteCommandRequest::RequestId> requestId) {
     invariant(_negotiatedProtocol);
     auto requestMsg = rpc::messageFromOpMsgRequest(*_negotiatedProtocol, std::move(request));
     if (fireAndForget) {
         OpMsg::setFlag(&requestMsg, OpMsg::kMoreToCome);
     }
     auto msgId = nextMessageId();
+
+    if (_multiplexingNegotiated) {
+        return _callMultiplexed(std::move(requestMsg), msgId, requestId)
+            .then([msgId, fireAndForget](Message response) -> Future<rpc::UniqueReply> {
+                if (fireAndForget) {
+                    OpMsgBuilder builder;
+                    builder.setBody(BSON("ok" << 1));
+                    response = builder.finish();
+                    response.header().setResponseToMsgId(msgId);
+                    response.header().setId(msgId);
+                }
+                return rpc::UniqueReply(response, rpc::makeReply(&response));
+            });
+    }
+
     auto future = _call(std::move(requestMsg), msgId, baton);
 
     if (fireAndForget) {
@@ -310,7 +543,7 @@ Future<executor::RemoteCommandResponse> AsyncDBClient::runCommandRequest(
         std::move(request.dbname), std::move(request.cmdObj), std::move(request.metadata));
     auto fireAndForget =
         request.fireAndForgetMode == executor::RemoteCommandRequest::FireAndForgetMode::kOn;
-    return runCommand(std::move(opMsgRequest), baton, fireAndForget)
+    return _runCommand(std::move(opMsgRequest), baton, fireAndForget, request.id)
         .then([start, clkSource, this](rpc::UniqueReply response) {
             auto duration = duration_cast<Milliseconds>(clkSource->now() - start);
             return executor::RemoteCommandResponse(*response, duration);
@@ -337,6 +570,10 @@ Future<executor::RemoteCommandResponse> AsyncDBClient::awaitExhaustCommand(
 Future<executor::RemoteCommandResponse> AsyncDBClient::runExhaustCommand(OpMsgRequest request,
                                                                          const BatonHandle& baton) {
     invariant(_negotiatedProtocol);
+    if (_multiplexingNegotiated) {
+        return Status(ErrorCodes::IllegalOperation,
+                      "Exhaust commands can not run on a connection with multiplexed requests");
+    }
     auto requestMsg = rpc::messageFromOpMsgRequest(*_negotiatedProtocol, std::move(request));
     OpMsg::setFlag(&requestMsg, OpMsg::kExhaustSupported);
 
@@ -355,6 +592,7 @@ Future<executor::RemoteCommandResponse> AsyncDBClient::beginExhaustCommandReques
 }
 
 void AsyncDBClient::cancel(const BatonHandle& baton) {
+    // Canceling the session's reads and writes fails every multiplexed request in flight.
     _session->cancelAsyncOperations(baton);
 }
 
@@ -30,14 +30,17 @@
 #pragma once
 
 #include <memory>
+#include <vector>
 
 #include "mongo/client/authenticate.h"
 #include "mongo/db/service_context.h"
 #include "mongo/executor/network_connection_hook.h"
 #include "mongo/executor/remote_command_request.h"
 #include "mongo/executor/remote_command_response.h"
+#include "mongo/platform/mutex.h"
 #include "mongo/rpc/protocol.h"
 #include "mongo/rpc/unique_message.h"
+#include "mongo/stdx/unordered_map.h"
 #include "mongo/transport/baton.h"
 #include "mongo/transport/message_compressor_manager.h"
 #include "mongo/transport/transport_layer.h"
@@ -49,8 +52,12 @@ class AsyncDBClient : public std::enable_shared_from_this<AsyncDBClient> {
 public:
     explicit AsyncDBClient(const HostAndPort& peer,
                            transport::SessionHandle session,
-                           ServiceContext* svcCtx)
-        : _peer(std::move(peer)), _session(std::move(session)), _svcCtx(svcCtx) {}
+                           ServiceContext* svcCtx,
+                           transport::ReactorHandle reactor = nullptr)
+        : _peer(std::move(peer)),
+          _session(std::move(session)),
+          _svcCtx(svcCtx),
+          _reactor(std::move(reactor)) {}
 
     using Handle = std::shared_ptr<AsyncDBClient>;
 
@@ -81,8 +88,39 @@ public:
                                          BSONObj specAuth,
                                          auth::SpeculativeAuthType speculativeAuthtype);
 
+    /**
+     * Runs isMaster on the connection to negotiate the wire protocol, compression and, if
+     * 'requestMultiplexing' is set, request multiplexing. See isMultiplexing().
+     */
     Future<void> initWireVersion(const std::string& appName,
-                                 executor::NetworkConnectionHook* const hook);
+                                 executor::NetworkConnectionHook* const hook,
+                                 bool requestMultiplexing = false);
+
+    /**
+     * Whether the remote host agreed in isMaster to accept requests on this connection before it
+     * has replied to earlier ones. If so, runCommand() and runCommandRequest() send each request as
+     * soon as it is made, coalescing those made while a write is in progress into the next write,
+     * and match replies to requests by id, so any number of callers can share the connection.
+     * All reads and writes on the session then run on the reactor the connection was made with, so
+     * that a read and a write never touch the session from two threads at once.
+     *
+     * Exhaust commands can not run on such a connection.
+     */
+    bool isMultiplexing() const {
+        return _multiplexingNegotiated;
+    }
+
+    /**
+     * Fails the in-flight request 'requestId' on a multiplexing connection with CallbackCanceled,
+     * leaving the connection and its other requests running. The reply is dropped when it arrives.
+     */
+    void cancelRequest(executor::RemoteCommandRequest::RequestId requestId);
+
+    /**
+     * Returns the error that stopped request multiplexing on this connection, or OK while it can
+     * still take requests.
+     */
+    Status getMultiplexingStatus() const;
 
     void cancel(const BatonHandle& baton = nullptr);
 
@@ -101,8 +139,24 @@ private:
     Future<Message> _waitForResponse(boost::optional<int32_t> msgId,
                                      const BatonHandle& baton = nullptr);
     Future<void> _call(Message request, int32_t msgId, const BatonHandle& baton = nullptr);
+    StatusWith<Message> _prepareRequest(Message request, int32_t msgId);
+    Future<Message> _callMultiplexed(Message request,
+                                     int32_t msgId,
+                                     boost::optional<executor::RemoteCommandRequest::RequestId>
+                                         requestId = boost::none);
+    void _writeMultiplexed(std::vector<Message> batch);
+    boost::optional<std::vector<Message>> _nextMultiplexedWrite(Status lastWrite);
+    void _readMultiplexed();
+    bool _onMultiplexedReply(StatusWith<Message> swResponse);
+    void _failMultiplexed(Status status);
+    Future<rpc::UniqueReply> _runCommand(
+        OpMsgRequest request,
+        const BatonHandle& baton,
+        bool fireAndForget,
+        boost::optional<executor::RemoteCommandRequest::RequestId> requestId);
     BSONObj _buildIsMasterRequest(const std::string& appName,
-                                  executor::NetworkConnectionHook* hook);
+                                  executor::NetworkConnectionHook* hook,
+                                  bool requestMultiplexing);
     void _parseIsMasterResponse(BSONObj request,
                                 const std::unique_ptr<rpc::ReplyInterface>& response);
     auth::RunCommandHook _makeAuthRunCommandHook();
@@ -110,8 +164,25 @@ private:
     const HostAndPort _peer;
     transport::SessionHandle _session;
     ServiceContext* const _svcCtx;
+    const transport::ReactorHandle _reactor;
     MessageCompressorManager _compressorManager;
     boost::optional<rpc::Protocol> _negotiatedProtocol;
+
+    struct MultiplexedRequest {
+        Promise<Message> promise;
+        boost::optional<executor::RemoteCommandRequest::RequestId> requestId;
+    };
+
+    bool _multiplexingNegotiated = false;
+
+    mutable Mutex _multiplexingMutex = MONGO_MAKE_LATCH("AsyncDBClient::_multiplexingMutex");
+    // Requests sent or waiting to be sent that expect a reply, by message id.
+    stdx::unordered_map<int32_t, MultiplexedRequest> _inFlight;
+    // Requests made while a write was in progress, to be sent together when it finishes.
+    std::vector<Message> _pendingWrites;
+    bool _isWriting = false;
+    bool _isReading = false;
+    Status _multiplexingStatus = Status::OK();
 };
 
 }  // namespace mongo
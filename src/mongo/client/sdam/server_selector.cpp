@@ -39,6 +39,8 @@
 namespace mongo::sdam {
 MONGO_FAIL_POINT_DEFINE(sdamServerSelectorIgnoreLatencyWindow);
 
+MinOpTimeSelectionStats gMinOpTimeSelectionStats;
+
 ServerSelector::~ServerSelector() {}
 
 SdamServerSelector::SdamServerSelector(const ServerSelectionConfiguration& config)
@@ -50,32 +52,6 @@ void SdamServerSelector::_getCandidateServers(std::vector<ServerDescriptionPtr>*
     // when querying the primary we don't need to consider tags
     bool shouldTagFilter = true;
 
-    // TODO SERVER-46499: check to see if we want to enforce minOpTime at all since
-    // it was effectively optional in the original implementation.
-    if (!criteria.minOpTime.isNull()) {
-        auto eligibleServers = topologyDescription->findServers([](const ServerDescriptionPtr& s) {
-            return (s->getType() == ServerType::kRSPrimary ||
-                    s->getType() == ServerType::kRSSecondary);
-        });
-
-        auto beginIt = eligibleServers.begin();
-        auto endIt = eligibleServers.end();
-        auto maxIt = std::max_element(beginIt,
-                                      endIt,
-                                      [topologyDescription](const ServerDescriptionPtr& left,
-                                                            const ServerDescriptionPtr& right) {
-                                          return left->getOpTime() < right->getOpTime();
-                                      });
-        if (maxIt != endIt) {
-            auto maxOpTime = (*maxIt)->getOpTime();
-            if (maxOpTime && maxOpTime < criteria.minOpTime) {
-                // ignore minOpTime
-                const_cast<ReadPreferenceSetting&>(criteria) = ReadPreferenceSetting(criteria.pref);
-                LOGV2(46712001, "Ignoring minOpTime", "readPreference"_attr = criteria);
-            }
-        }
-    }
-
     switch (criteria.pref) {
         case ReadPreference::Nearest:
             *result = topologyDescription->findServers(nearestFilter(criteria));
@@ -113,6 +89,11 @@ void SdamServerSelector::_getCandidateServers(std::vector<ServerDescriptionPtr>*
             auto secondaryCriteria = criteria;
             secondaryCriteria.pref = ReadPreference::SecondaryOnly;
             _getCandidateServers(result, topologyDescription, secondaryCriteria);
+            if (result->empty() && !secondaryCriteria.minOpTime.isNull()) {
+                // a secondary which has yet to reach minOpTime is still preferred to the primary
+                secondaryCriteria.minOpTime = repl::OpTime();
+                _getCandidateServers(result, topologyDescription, secondaryCriteria);
+            }
             if (result->size()) {
                 break;
             }
@@ -154,13 +135,22 @@ boost::optional<std::vector<ServerDescriptionPtr>> SdamServerSelector::selectSer
     }
 
     std::vector<ServerDescriptionPtr> results;
-    _getCandidateServers(&results, topologyDescription, criteria);
+    const auto minOpTimeReach = _checkMinOpTime(topologyDescription, criteria);
+    if (minOpTimeReach == MinOpTimeReach::kNoMembers) {
+        // Only the ignored minOpTime is dropped; tags and maxStalenessSeconds still apply.
+        LOGV2_DEBUG(46712001, 2, "Ignoring minOpTime", "readPreference"_attr = criteria);
+        auto relaxedCriteria = criteria;
+        relaxedCriteria.minOpTime = repl::OpTime();
+        _getCandidateServers(&results, topologyDescription, relaxedCriteria);
+    } else {
+        _getCandidateServers(&results, topologyDescription, criteria);
+    }
 
-    if (results.size()) {
-        if (MONGO_unlikely(sdamServerSelectorIgnoreLatencyWindow.shouldFail())) {
-            return results;
-        }
+    if (results.empty()) {
+        return boost::none;
+    }
 
+    if (MONGO_likely(!sdamServerSelectorIgnoreLatencyWindow.shouldFail())) {
         ServerDescriptionPtr minServer =
             *std::min_element(results.begin(), results.end(), LatencyWindow::rttCompareFn);
 
@@ -170,11 +160,50 @@ boost::optional<std::vector<ServerDescriptionPtr>> SdamServerSelector::selectSer
 
         // latency window should always leave at least one result
         invariant(results.size());
+    }
 
-        return results;
+    // Choosing among caught up members only avoids a wait when some eligible member lagged.
+    if (minOpTimeReach != MinOpTimeReach::kAllMembers) {
+        const bool allSelectedReached =
+            std::all_of(results.begin(), results.end(), [&](const ServerDescriptionPtr& s) {
+                return s->getOpTime() >= criteria.minOpTime;
+            });
+        if (allSelectedReached) {
+            gMinOpTimeSelectionStats.waitsAvoided.increment();
+        } else {
+            gMinOpTimeSelectionStats.waitsNotAvoided.increment();
+        }
     }
 
-    return boost::none;
+    return results;
+}
+
+SdamServerSelector::MinOpTimeReach SdamServerSelector::_checkMinOpTime(
+    const TopologyDescriptionPtr& topologyDescription, const ReadPreferenceSetting& criteria) {
+    // TODO SERVER-46499: check to see if we want to enforce minOpTime at all since
+    // it was effectively optional in the original implementation.
+    if (criteria.minOpTime.isNull()) {
+        return MinOpTimeReach::kAllMembers;
+    }
+
+    // Reads that prefer secondaries only fall back to the primary when no secondary is eligible,
+    // so a primary which has reached the minOpTime must not keep it from being ignored.
+    const bool secondariesOnly = criteria.pref == ReadPreference::SecondaryOnly ||
+        criteria.pref == ReadPreference::SecondaryPreferred;
+    auto eligibleServers =
+        topologyDescription->findServers([secondariesOnly](const ServerDescriptionPtr& s) {
+            return s->getType() == ServerType::kRSSecondary ||
+                (!secondariesOnly && s->getType() == ServerType::kRSPrimary);
+        });
+
+    const size_t numReached = std::count_if(
+        eligibleServers.begin(), eligibleServers.end(), [&](const ServerDescriptionPtr& s) {
+            return s->getOpTime() >= criteria.minOpTime;
+        });
+    if (numReached == eligibleServers.size()) {
+        return MinOpTimeReach::kAllMembers;
+    }
+    return numReached ? MinOpTimeReach::kSomeMembers : MinOpTimeReach::kNoMembers;
 }
 
 ServerDescriptionPtr SdamServerSelector::_randomSelect(
@@ -30,6 +30,7 @@
 #include <functional>
 #include <vector>
 
+#include "mongo/base/counter.h"
 #include "mongo/client/read_preference.h"
 #include "mongo/client/sdam/sdam_configuration.h"
 #include "mongo/client/sdam/sdam_datatypes.h"
@@ -38,6 +39,18 @@
 #include "mongo/platform/random.h"
 
 namespace mongo::sdam {
+/**
+ * Outcomes of server selections whose ReadPreferenceSetting carries a minOpTime that some eligible
+ * member had not reached. A wait is avoided when only members which had reached the minOpTime
+ * were selected, so the read does not wait for replication to catch up on a lagging member.
+ * Selections for which every eligible member had already reached the minOpTime are not counted.
+ */
+struct MinOpTimeSelectionStats {
+    Counter64 waitsAvoided;
+    Counter64 waitsNotAvoided;
+};
+extern MinOpTimeSelectionStats gMinOpTimeSelectionStats;
+
 /**
  * This is the interface that allows one to select a server to satisfy a DB operation given a
  * TopologyDescription and a ReadPreferenceSetting.
@@ -82,6 +95,15 @@ private:
                               const TopologyDescriptionPtr topologyDescription,
                               const ReadPreferenceSetting& criteria);
 
+    // How many of the members eligible for the criteria have reached its minOpTime. A missing
+    // minOpTime is reached by every member.
+    enum class MinOpTimeReach { kAllMembers, kSomeMembers, kNoMembers };
+
+    // When no eligible member has reached the criteria's minOpTime, it should not be used to filter
+    // candidates.
+    MinOpTimeReach _checkMinOpTime(const TopologyDescriptionPtr& topologyDescription,
+                                   const ReadPreferenceSetting& criteria);
+
     bool _containsAllTags(ServerDescriptionPtr server, const BSONObj& tags);
 
     ServerDescriptionPtr _randomSelect(const std::vector<ServerDescriptionPtr>& servers) const;
@@ -305,6 +305,108 @@ TEST_F(ServerSelectorTestFixture, ShouldFilterByLastWriteTime) {
     ASSERT_FALSE(frequencyInfo["s2"]);
 }
 
+TEST_F(ServerSelectorTestFixture, ShouldFilterByMinOpTimeAndIgnoreItIfUnreachable) {
+    TopologyStateMachine stateMachine(sdamConfiguration);
+    auto topologyDescription = std::make_shared<TopologyDescription>(sdamConfiguration);
+
+    const auto makeServer = [&](ServerAddress address, ServerType type, Timestamp lastApplied) {
+        auto builder = ServerDescriptionBuilder()
+                           .withAddress(address)
+                           .withType(type)
+                           .withRtt(selectionConfig.getLocalThresholdMs())
+                           .withSetName("set")
+                           .withMinWireVersion(WireVersion::SUPPORTS_OP_MSG)
+                           .withMaxWireVersion(WireVersion::LATEST_WIRE_VERSION)
+                           .withLastUpdateTime(Date_t::now())
+                           .withLastWriteDate(Date_t::now())
+                           .withOpTime(repl::OpTime(lastApplied, 1));
+        if (type == ServerType::kRSPrimary) {
+            builder.withHost("s0").withHost("s1").withHost("s2");
+        }
+        return builder.instance();
+    };
+    stateMachine.onServerDescription(*topologyDescription,
+                                     makeServer("s0", ServerType::kRSPrimary, Timestamp(15, 0)));
+    stateMachine.onServerDescription(*topologyDescription,
+                                     makeServer("s1", ServerType::kRSSecondary, Timestamp(10, 0)));
+    stateMachine.onServerDescription(*topologyDescription,
+                                     makeServer("s2", ServerType::kRSSecondary, Timestamp(5, 0)));
+
+    // Causally consistent reads only know the cluster time, so the term is left uninitialized.
+    auto readPref = ReadPreferenceSetting(ReadPreference::SecondaryOnly);
+    readPref.minOpTime = repl::OpTime(Timestamp(8, 0), repl::OpTime::kUninitializedTerm);
+
+    const auto avoidedBefore = gMinOpTimeSelectionStats.waitsAvoided.get();
+    for (int i = 0; i < NUM_ITERATIONS; i++) {
+        auto server = selector.selectServer(topologyDescription, readPref);
+        ASSERT(server);
+        ASSERT_EQ("s1", (*server)->getAddress());
+    }
+    ASSERT_EQ(avoidedBefore + NUM_ITERATIONS, gMinOpTimeSelectionStats.waitsAvoided.get());
+
+    // No member has reached the minOpTime, so any secondary may be selected.
+    readPref.minOpTime = repl::OpTime(Timestamp(20, 0), repl::OpTime::kUninitializedTerm);
+    const auto notAvoidedBefore = gMinOpTimeSelectionStats.waitsNotAvoided.get();
+    std::map<ServerAddress, int> frequencyInfo{{"s0", 0}, {"s1", 0}, {"s2", 0}};
+    for (int i = 0; i < NUM_ITERATIONS; i++) {
+        auto server = selector.selectServer(topologyDescription, readPref);
+        ASSERT(server);
+        frequencyInfo[(*server)->getAddress()]++;
+    }
+    ASSERT_EQ(notAvoidedBefore + NUM_ITERATIONS, gMinOpTimeSelectionStats.waitsNotAvoided.get());
+
+    ASSERT_FALSE(frequencyInfo["s0"]);
+    ASSERT(frequencyInfo["s1"]);
+    ASSERT(frequencyInfo["s2"]);
+
+    // Only the primary has reached the minOpTime, which does not make secondaryPreferred reads
+    // fall back to it.
+    readPref = ReadPreferenceSetting(ReadPreference::SecondaryPreferred);
+    readPref.minOpTime = repl::OpTime(Timestamp(12, 0), repl::OpTime::kUninitializedTerm);
+    frequencyInfo = {{"s0", 0}, {"s1", 0}, {"s2", 0}};
+    for (int i = 0; i < NUM_ITERATIONS; i++) {
+        auto server = selector.selectServer(topologyDescription, readPref);
+        ASSERT(server);
+        frequencyInfo[(*server)->getAddress()]++;
+    }
+
+    ASSERT_FALSE(frequencyInfo["s0"]);
+    ASSERT(frequencyInfo["s1"]);
+    ASSERT(frequencyInfo["s2"]);
+}
+
+TEST_F(ServerSelectorTestFixture, ShouldNotCountMinOpTimeEveryMemberHasReached) {
+    TopologyStateMachine stateMachine(sdamConfiguration);
+    auto topologyDescription = std::make_shared<TopologyDescription>(sdamConfiguration);
+
+    for (auto&& address : {"s0", "s1"}) {
+        auto builder = ServerDescriptionBuilder()
+                           .withAddress(address)
+                           .withType(address == "s0"_sd ? ServerType::kRSPrimary
+                                                        : ServerType::kRSSecondary)
+                           .withRtt(selectionConfig.getLocalThresholdMs())
+                           .withSetName("set")
+                           .withHost("s0")
+                           .withHost("s1")
+                           .withMinWireVersion(WireVersion::SUPPORTS_OP_MSG)
+                           .withMaxWireVersion(WireVersion::LATEST_WIRE_VERSION)
+                           .withLastUpdateTime(Date_t::now())
+                           .withLastWriteDate(Date_t::now())
+                           .withOpTime(repl::OpTime(Timestamp(10, 0), 1));
+        stateMachine.onServerDescription(*topologyDescription, builder.instance());
+    }
+
+    auto readPref = ReadPreferenceSetting(ReadPreference::Nearest);
+    readPref.minOpTime = repl::OpTime(Timestamp(8, 0), repl::OpTime::kUninitializedTerm);
+
+    // No member would have made the read wait, so choosing one avoided nothing.
+    const auto avoidedBefore = gMinOpTimeSelectionStats.waitsAvoided.get();
+    const auto notAvoidedBefore = gMinOpTimeSelectionStats.waitsNotAvoided.get();
+    ASSERT(selector.selectServer(topologyDescription, readPref));
+    ASSERT_EQ(avoidedBefore, gMinOpTimeSelectionStats.waitsAvoided.get());
+    ASSERT_EQ(notAvoidedBefore, gMinOpTimeSelectionStats.waitsNotAvoided.get());
+}
+
 TEST_F(ServerSelectorTestFixture, ShouldSelectPreferredIfAvailable) {
     TopologyStateMachine stateMachine(sdamConfiguration);
     auto topologyDescription = std::make_shared<TopologyDescription>(sdamConfiguration);
@@ -0,0 +1,117 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/catalog/catalog_test_fixture.h"
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/db_raii.h"
+#include "mongo/db/index/index_descriptor.h"
+#include "mongo/platform/random.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+const NamespaceString kNss("test.coll");
+
+constexpr int kBatchSize = 1000;
+
+/**
+ * Sets up a mongod backed by the in-memory test storage engine for the duration of a benchmark.
+ */
+class CollectionInsertBenchmarkFixture : public CatalogTestFixture {
+public:
+    explicit CollectionInsertBenchmarkFixture(int numIndexes) {
+        setUp();
+
+        auto opCtx = operationContext();
+        ASSERT_OK(storageInterface()->createCollection(opCtx, kNss, CollectionOptions()));
+
+        AutoGetCollection autoColl(opCtx, kNss, MODE_X);
+        auto indexCatalog = autoColl.getCollection()->getIndexCatalog();
+        WriteUnitOfWork wuow(opCtx);
+        for (int i = 0; i < numIndexes; ++i) {
+            const auto field = "f" + std::to_string(i);
+            ASSERT_OK(indexCatalog
+                          ->createIndexOnEmptyCollection(
+                              opCtx,
+                              BSON("v" << int(IndexDescriptor::kLatestIndexVersion) << "key"
+                                       << BSON(field << 1) << "name" << field))
+                          .getStatus());
+        }
+        wuow.commit();
+    }
+
+    ~CollectionInsertBenchmarkFixture() {
+        tearDown();
+    }
+
+private:
+    void _doTest() final {}
+};
+
+// Inserts batches of documents with eight random integer fields into a collection with as many
+// secondary indexes as the argument, on the first fields.
+void BM_insertBatch(benchmark::State& state) {
+    CollectionInsertBenchmarkFixture fixture(state.range(0));
+    auto opCtx = fixture.operationContext();
+    PseudoRandom random(1);
+
+    int nextId = 0;
+    std::vector<InsertStatement> inserts;
+    for (auto _ : state) {
+        state.PauseTiming();
+        inserts.clear();
+        for (int i = 0; i < kBatchSize; ++i) {
+            BSONObjBuilder builder;
+            builder.append("_id", nextId++);
+            for (int field = 0; field < 8; ++field) {
+                builder.append("f" + std::to_string(field), random.nextInt32());
+            }
+            inserts.emplace_back(builder.obj());
+        }
+        state.ResumeTiming();
+
+        AutoGetCollection autoColl(opCtx, kNss, MODE_IX);
+        WriteUnitOfWork wuow(opCtx);
+        invariant(autoColl.getCollection()->insertDocuments(
+            opCtx, inserts.begin(), inserts.end(), nullptr, false));
+        wuow.commit();
+    }
+    state.SetItemsProcessed(state.iterations() * kBatchSize);
+}
+
+BENCHMARK(BM_insertBatch)->Arg(0)->Arg(1)->Arg(8)->Unit(benchmark::kMillisecond);
+
+}  // namespace
+}  // namespace mongo
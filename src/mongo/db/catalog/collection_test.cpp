@@ -36,7 +36,10 @@
 #include "mongo/db/catalog/catalog_test_fixture.h"
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/catalog/collection_validation.h"
+#include "mongo/db/curop.h"
 #include "mongo/db/db_raii.h"
+#include "mongo/db/index/index_access_method.h"
+#include "mongo/db/index/index_descriptor.h"
 #include "mongo/db/repl/storage_interface_impl.h"
 #include "mongo/stdx/thread.h"
 #include "mongo/unittest/unittest.h"
@@ -48,6 +51,7 @@ using namespace mongo;
 class CollectionTest : public CatalogTestFixture {
 protected:
     void makeCapped(NamespaceString nss, long long cappedSize = 8192);
+    void makeCollectionWithIndexes(NamespaceString nss, const std::vector<BSONObj>& indexSpecs);
 };
 
 void CollectionTest::makeCapped(NamespaceString nss, long long cappedSize) {
@@ -57,6 +61,23 @@ void CollectionTest::makeCapped(NamespaceString nss, long long cappedSize) {
     ASSERT_OK(storageInterface()->createCollection(operationContext(), nss, options));
 }
 
+void CollectionTest::makeCollectionWithIndexes(NamespaceString nss,
+                                               const std::vector<BSONObj>& indexSpecs) {
+    ASSERT_OK(storageInterface()->createCollection(operationContext(), nss, CollectionOptions()));
+
+    AutoGetCollection autoColl(operationContext(), nss, MODE_X);
+    auto indexCatalog = autoColl.getCollection()->getIndexCatalog();
+    WriteUnitOfWork wuow(operationContext());
+    for (auto&& spec : indexSpecs) {
+        BSONObjBuilder specBuilder;
+        specBuilder.append("v", int(IndexDescriptor::kLatestIndexVersion));
+        specBuilder.appendElements(spec);
+        ASSERT_OK(indexCatalog->createIndexOnEmptyCollection(operationContext(), specBuilder.obj())
+                      .getStatus());
+    }
+    wuow.commit();
+}
+
 TEST_F(CollectionTest, CappedNotifierKillAndIsDead) {
     NamespaceString nss("test.t");
     makeCapped(nss);
@@ -207,4 +228,68 @@ TEST_F(CollectionTest, AsynchronouslyNotifyCappedWaitersIfNeeded) {
     ASSERT_EQ(notifier->getVersion(), thisVersion);
 }
 
+TEST_F(CollectionTest, InsertingBatchIndexesEveryDocumentInKeyOrder) {
+    NamespaceString nss("test.t");
+    makeCollectionWithIndexes(nss,
+                              {BSON("key" << BSON("a" << 1) << "name"
+                                          << "a_1"
+                                          << "unique" << true),
+                               BSON("key" << BSON("b" << -1) << "name"
+                                          << "b_-1")});
+
+    // The values of 'a' descend as the documents are inserted, and each 'b' array makes the
+    // second index multikey.
+    const int kNumDocs = 10;
+    std::vector<InsertStatement> inserts;
+    for (int i = 0; i < kNumDocs; ++i) {
+        inserts.push_back(
+            InsertStatement(BSON("_id" << i << "a" << kNumDocs - i << "b" << BSON_ARRAY(i << -i))));
+    }
+
+    auto opCtx = operationContext();
+    AutoGetCollection autoColl(opCtx, nss, MODE_IX);
+    Collection* coll = autoColl.getCollection();
+    OpDebug opDebug;
+    {
+        WriteUnitOfWork wuow(opCtx);
+        ASSERT_OK(coll->insertDocuments(opCtx, inserts.begin(), inserts.end(), &opDebug, false));
+        wuow.commit();
+    }
+
+    // One key per document in the _id and 'a' indexes, and two per document in the 'b' index,
+    // except for the document whose array holds 0 twice.
+    ASSERT_EQ(4 * kNumDocs - 1, *opDebug.additiveMetrics.keysInserted);
+
+    auto indexCatalog = coll->getIndexCatalog();
+    auto aEntry = indexCatalog->getEntry(indexCatalog->findIndexByName(opCtx, "a_1"));
+    auto bEntry = indexCatalog->getEntry(indexCatalog->findIndexByName(opCtx, "b_-1"));
+    ASSERT_FALSE(aEntry->isMultikey());
+    ASSERT_TRUE(bEntry->isMultikey());
+
+    for (int i = 0; i < kNumDocs; ++i) {
+        RecordId recordId = aEntry->accessMethod()->findSingle(opCtx, BSON("a" << kNumDocs - i));
+        ASSERT_FALSE(recordId.isNull());
+        ASSERT_EQ(i, coll->docFor(opCtx, recordId).value()["_id"].numberInt());
+    }
+}
+
+TEST_F(CollectionTest, InsertingBatchRejectsDuplicateKeyWithinBatch) {
+    NamespaceString nss("test.t");
+    makeCollectionWithIndexes(nss,
+                              {BSON("key" << BSON("a" << 1) << "name"
+                                          << "a_1"
+                                          << "unique" << true)});
+
+    std::vector<InsertStatement> inserts = {InsertStatement(BSON("_id" << 0 << "a" << 1)),
+                                            InsertStatement(BSON("_id" << 1 << "a" << 2)),
+                                            InsertStatement(BSON("_id" << 2 << "a" << 1))};
+
+    auto opCtx = operationContext();
+    AutoGetCollection autoColl(opCtx, nss, MODE_IX);
+    Collection* coll = autoColl.getCollection();
+    WriteUnitOfWork wuow(opCtx);
+    ASSERT_EQ(ErrorCodes::DuplicateKey,
+              coll->insertDocuments(opCtx, inserts.begin(), inserts.end(), nullptr, false));
+}
+
 }  // namespace
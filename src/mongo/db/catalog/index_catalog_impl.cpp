@@ -33,6 +33,8 @@
 
 #include "mongo/db/catalog/index_catalog_impl.h"
 
+#include <algorithm>
+#include <set>
 #include <vector>
 
 #include "mongo/base/init.h"
@@ -1394,6 +1396,11 @@ Status IndexCatalogImpl::_indexFilteredRecords(OperationContext* opCtx,
     InsertDeleteOptions options;
     prepareInsertDeleteOptions(opCtx, index->descriptor(), &options);
 
+    // Hybrid builds write the keys of each record to the side table separately.
+    if (bsonRecords.size() > 1 && !index->isHybridBuilding()) {
+        return _indexRecordBatch(opCtx, index, bsonRecords, options, keysInsertedOut);
+    }
+
     for (auto bsonRecord : bsonRecords) {
         invariant(bsonRecord.id != RecordId());
 
@@ -1434,6 +1441,111 @@ Status IndexCatalogImpl::_indexFilteredRecords(OperationContext* opCtx,
     return Status::OK();
 }
 
+Status IndexCatalogImpl::_indexRecordBatch(OperationContext* opCtx,
+                                           IndexCatalogEntry* index,
+                                           const std::vector<BsonRecord>& bsonRecords,
+                                           const InsertDeleteOptions& options,
+                                           int64_t* keysInsertedOut) {
+    auto& executionCtx = StorageExecutionContext::get(opCtx);
+    auto accessMethod = index->accessMethod();
+
+    // Generate the keys of every record, along with the timestamp of the record each key belongs
+    // to. Every data key ends with the RecordId of its record, so only multikey metadata keys
+    // repeat across records. Only the copy of the earliest record is kept, which makes it visible
+    // from that record's timestamp on.
+    std::vector<std::pair<Timestamp, KeyString::Value>> batchKeys;
+    batchKeys.reserve(bsonRecords.size());
+    std::set<KeyString::Value> seenMultikeyMetadataKeys;
+    boost::optional<MultikeyPaths> multikeyPaths;
+    size_t firstMultikeyRecord = 0;
+    for (size_t i = 0; i < bsonRecords.size(); ++i) {
+        const BsonRecord& bsonRecord = bsonRecords[i];
+        invariant(bsonRecord.id != RecordId());
+
+        auto keys = executionCtx.keys();
+        auto multikeyMetadataKeys = executionCtx.multikeyMetadataKeys();
+        auto recordMultikeyPaths = executionCtx.multikeyPaths();
+
+        accessMethod->getKeys(executionCtx.pooledBufferBuilder(),
+                              *bsonRecord.docPtr,
+                              options.getKeysMode,
+                              IndexAccessMethod::GetKeysContext::kAddingKeys,
+                              keys.get(),
+                              multikeyMetadataKeys.get(),
+                              recordMultikeyPaths.get(),
+                              bsonRecord.id,
+                              IndexAccessMethod::kNoopOnSuppressedErrorFn);
+
+        for (const auto& keyString : *keys) {
+            batchKeys.emplace_back(bsonRecord.ts, keyString);
+        }
+        for (const auto& keyString : *multikeyMetadataKeys) {
+            if (seenMultikeyMetadataKeys.insert(keyString).second) {
+                batchKeys.emplace_back(bsonRecord.ts, keyString);
+            }
+        }
+
+        if (accessMethod->shouldMarkIndexAsMultikey(
+                keys->size(), *multikeyMetadataKeys, *recordMultikeyPaths)) {
+            if (!multikeyPaths) {
+                multikeyPaths = *recordMultikeyPaths;
+                firstMultikeyRecord = i;
+            } else {
+                for (size_t j = 0; j < recordMultikeyPaths->size(); ++j) {
+                    (*multikeyPaths)[j].insert((*recordMultikeyPaths)[j].begin(),
+                                               (*recordMultikeyPaths)[j].end());
+                }
+            }
+        }
+    }
+
+    // Records written by a replica set primary each have their own timestamp, which their keys
+    // must be written at too. Sorting by timestamp before key groups the keys of each timestamp,
+    // so the timestamp is switched at most once per record, as when indexing the records one by
+    // one. Only the keys of records sharing a timestamp, which is every record of an
+    // untimestamped batch, are merged into a single key order.
+    std::sort(batchKeys.begin(), batchKeys.end());
+
+    Timestamp currentTimestamp;
+    auto setTimestamp = [&](const Timestamp& timestamp) {
+        if (timestamp.isNull() || timestamp == currentTimestamp) {
+            return Status::OK();
+        }
+        currentTimestamp = timestamp;
+        return opCtx->recoveryUnit()->setTimestamp(timestamp);
+    };
+
+    if (multikeyPaths) {
+        // Marking the index multikey from the first record that makes it so is conservative for
+        // the records after it.
+        Status status = setTimestamp(bsonRecords[firstMultikeyRecord].ts);
+        if (!status.isOK()) {
+            return status;
+        }
+        index->setMultikey(opCtx, *multikeyPaths);
+    }
+
+    InsertResult result;
+    for (const auto& [timestamp, keyString] : batchKeys) {
+        Status status = setTimestamp(timestamp);
+        if (!status.isOK()) {
+            return status;
+        }
+
+        status = accessMethod->insertKey(opCtx, keyString, options, &result);
+        if (!status.isOK()) {
+            return status;
+        }
+    }
+
+    if (keysInsertedOut) {
+        *keysInsertedOut += result.numInserted;
+    }
+
+    // Leave the timestamp of the last record in place, as indexing the records one by one does.
+    return setTimestamp(bsonRecords.back().ts);
+}
+
 Status IndexCatalogImpl::_indexRecords(OperationContext* opCtx,
                                        IndexCatalogEntry* index,
                                        const std::vector<BsonRecord>& bsonRecords,
@@ -321,6 +321,16 @@ private:
                                  const std::vector<BsonRecord>& bsonRecords,
                                  int64_t* keysInsertedOut);
 
+    /**
+     * Indexes several records at once: generates the keys of all of them, then inserts those keys
+     * in key order, each at the timestamp of its record.
+     */
+    Status _indexRecordBatch(OperationContext* opCtx,
+                             IndexCatalogEntry* index,
+                             const std::vector<BsonRecord>& bsonRecords,
+                             const InsertDeleteOptions& options,
+                             int64_t* keysInsertedOut);
+
     Status _indexRecords(OperationContext* opCtx,
                          IndexCatalogEntry* index,
                          const std::vector<BsonRecord>& bsonRecords,
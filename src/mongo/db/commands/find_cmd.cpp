@@ -45,6 +45,7 @@
 #include "mongo/db/query/collation/collator_factory_interface.h"
 #include "mongo/db/query/cursor_response.h"
 #include "mongo/db/query/explain.h"
+#include "mongo/db/query/express_find.h"
 #include "mongo/db/query/find.h"
 #include "mongo/db/query/find_common.h"
 #include "mongo/db/query/get_executor.h"
@@ -432,6 +433,15 @@ public:
             const int ntoskip = -1;
             beginQueryOp(opCtx, nss, _request.body, ntoreturn, ntoskip);
 
+            // Point reads on _id or a unique index go straight to the index and the record store,
+            // without canonicalizing or planning the query.
+            if (!ctx->getView() && ctx->getCollection() && isExpressFindEligible(*qr)) {
+                if (auto index = getExpressFindIndex(opCtx, ctx->getCollection(), *qr)) {
+                    runExpressFind(opCtx, ctx->getCollection(), *qr, index, result);
+                    return;
+                }
+            }
+
             // Finish the parsing step by using the QueryRequest to create a CanonicalQuery.
             const ExtensionsCallbackReal extensionsCallback(opCtx, &nss);
             auto expCtx = makeExpressionContext(opCtx, *qr, boost::none /* verbosity */);
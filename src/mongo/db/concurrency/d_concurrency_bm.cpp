@@ -33,6 +33,7 @@
 
 #include "mongo/db/concurrency/d_concurrency.h"
 #include "mongo/db/concurrency/lock_manager_test_help.h"
+#include "mongo/db/concurrency/lock_stats.h"
 #include "mongo/db/storage/recovery_unit_noop.h"
 #include "mongo/platform/mutex.h"
 #include "mongo/unittest/unittest.h"
@@ -166,6 +167,40 @@ BENCHMARK_DEFINE_F(DConcurrencyTest, BM_MMAPv1CollectionExclusiveLock)(benchmark
     }
 }
 
+/**
+ * Mixes intent locks on a collection with an exclusive lock on it every 'state.range(0)'
+ * acquisitions per thread, as a workload does when DDL operations run alongside reads and writes.
+ */
+BENCHMARK_DEFINE_F(DConcurrencyTest, BM_CollectionMixedIntentAndExclusiveLock)
+(benchmark::State& state) {
+    std::unique_ptr<ForceSupportsDocLocking> supportDocLocking;
+
+    if (state.thread_index == 0) {
+        makeKClientsWithLockers(state.threads);
+        supportDocLocking = std::make_unique<ForceSupportsDocLocking>(true);
+        resetGlobalLockStats();
+    }
+
+    const auto exclusiveEvery = state.range(0);
+    const LockMode intentMode = state.thread_index % 2 ? MODE_IX : MODE_IS;
+    int64_t numAcquisitions = 0;
+    for (auto keepRunning : state) {
+        auto opCtx = clients[state.thread_index].second.get();
+        const bool exclusive = ++numAcquisitions % exclusiveEvery == 0;
+        Lock::DBLock dlk(opCtx, "test", MODE_IX);
+        Lock::CollectionLock clk(
+            opCtx, NamespaceString("test.coll"), exclusive ? MODE_X : intentMode);
+    }
+
+    if (state.thread_index == 0) {
+        // Report how the waits for the collection lock were resolved.
+        const auto& contention = getGlobalLockContentionStats().get(RESOURCE_COLLECTION);
+        state.counters["grantedWhileSpinning"] = contention.grantedWhileSpinning.load();
+        state.counters["parkedAfterSpinning"] = contention.parkedAfterSpinning.load();
+        clients.clear();
+    }
+}
+
 BENCHMARK_REGISTER_F(DConcurrencyTest, BM_StdMutex)->ThreadRange(1, kMaxPerfThreads);
 
 BENCHMARK_REGISTER_F(DConcurrencyTest, BM_ResourceMutexShared)->ThreadRange(1, kMaxPerfThreads);
@@ -181,5 +216,10 @@ BENCHMARK_REGISTER_F(DConcurrencyTest, BM_MMAPv1CollectionSharedLock)
 BENCHMARK_REGISTER_F(DConcurrencyTest, BM_MMAPv1CollectionExclusiveLock)
     ->ThreadRange(1, kMaxPerfThreads);
 
+BENCHMARK_REGISTER_F(DConcurrencyTest, BM_CollectionMixedIntentAndExclusiveLock)
+    ->Arg(100)
+    ->Arg(10000)
+    ->ThreadRange(1, kMaxPerfThreads);
+
 }  // namespace
 }  // namespace mongo
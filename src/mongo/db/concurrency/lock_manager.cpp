@@ -47,6 +47,7 @@
 #include "mongo/logv2/log.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/str.h"
+#include "mongo/util/time_support.h"
 #include "mongo/util/timer.h"
 
 namespace mongo {
@@ -93,6 +94,13 @@ const uint64_t intentModes = (1 << MODE_IS) | (1 << MODE_IX);
 // Ensure we do not add new modes without updating the conflicts table
 MONGO_STATIC_ASSERT((sizeof(LockConflictsTable) / sizeof(LockConflictsTable[0])) == LockModesCount);
 
+// A resource whose partitioned intent requests are migrated back to its LockHead this many times
+// in a row, each migration following the previous one within kHotResourceMigrationInterval, is
+// considered hot and is not partitioned again for kHotResourcePartitioningCooldown.
+const int kHotResourceMigrationStreak = 4;
+const Milliseconds kHotResourceMigrationInterval{10};
+const Milliseconds kHotResourcePartitioningCooldown{1000};
+
 
 /**
  * Maps the mode id to a string.
@@ -159,6 +167,12 @@ struct LockHead {
 
         conversionsCount = 0;
         compatibleFirstCount = 0;
+
+        numConflicts = 0;
+        numMigrations = 0;
+        migrationStreak = 0;
+        lastMigration = Date_t();
+        partitioningDisabledUntil = Date_t();
     }
 
     /**
@@ -239,6 +253,42 @@ struct LockHead {
      */
     void migratePartitionedLockHeads();
 
+    /**
+     * Migrates the partitioned requests because a request in a conflicting mode has arrived, and
+     * detects resources which are hot: those whose conflicting requests arrive so often that
+     * spreading their intent requests across the partitions in between only adds the cost of
+     * gathering them back. Hot resources stay unpartitioned for a while. The caller reads the
+     * clock before locking the bucket, so that the time is not taken under its mutex.
+     */
+    void migrateForConflictingRequest(Date_t now) {
+        if (now - lastMigration < kHotResourceMigrationInterval) {
+            if (++migrationStreak >= kHotResourceMigrationStreak) {
+                partitioningDisabledUntil = now + kHotResourcePartitioningCooldown;
+            }
+        } else {
+            migrationStreak = 0;
+        }
+        lastMigration = now;
+        numMigrations++;
+
+        migratePartitionedLockHeads();
+    }
+
+    /**
+     * True unless the resource was recently found to be hot.
+     */
+    bool partitioningAllowed(Date_t now) {
+        if (partitioningDisabledUntil == Date_t()) {
+            return true;
+        }
+        if (now < partitioningDisabledUntil) {
+            return false;
+        }
+        partitioningDisabledUntil = Date_t();
+        migrationStreak = 0;
+        return true;
+    }
+
     // Methods to maintain the granted queue
     void incGrantedModeCount(LockMode mode) {
         invariant(grantedCounts[mode] >= 0);
@@ -331,6 +381,21 @@ struct LockHead {
     // be switched to compatible-first. As long as this value is > 0, the policy will stay
     // compatible-first.
     uint32_t compatibleFirstCount;
+
+    //
+    // Contention
+    //
+
+    // Counts the requests and conversions which had to wait, and the times partitioned requests
+    // were migrated back because of a conflicting request, for reporting through lockInfo.
+    long long numConflicts;
+    long long numMigrations;
+
+    // Hot resource detection, see migrateForConflictingRequest(). While partitioningDisabledUntil
+    // is set, intent requests are granted on this LockHead rather than in the partitions.
+    int migrationStreak;
+    Date_t lastMigration;
+    Date_t partitioningDisabledUntil;
 };
 
 /**
@@ -486,13 +551,15 @@ LockResult LockManager::lock(ResourceId resId, LockRequest* request, LockMode mo
     }
 
     // Use regular LockHead, maybe start partitioning
+    const auto now = Date_t::now();
     LockBucket* bucket = _getBucket(resId);
     stdx::lock_guard<SimpleMutex> scopedLock(bucket->mutex);
 
     LockHead* lock = bucket->findOrInsert(resId);
 
     // Start a partitioned lock if possible
-    if (request->partitioned && !(lock->grantedModes & (~intentModes)) && !lock->conflictModes) {
+    if (request->partitioned && !(lock->grantedModes & (~intentModes)) && !lock->conflictModes &&
+        lock->partitioningAllowed(now)) {
         Partition* partition = _getPartition(request);
         stdx::lock_guard<SimpleMutex> scopedLock(partition->mutex);
         PartitionedLockHead* partitionedLock = partition->findOrInsert(resId);
@@ -504,11 +571,15 @@ LockResult LockManager::lock(ResourceId resId, LockRequest* request, LockMode mo
 
     // For the first lock with a non-intent mode, migrate requests from partitioned lock heads
     if (lock->partitioned()) {
-        lock->migratePartitionedLockHeads();
+        lock->migrateForConflictingRequest(now);
     }
 
     request->partitioned = false;
-    return lock->newRequest(request);
+    const LockResult result = lock->newRequest(request);
+    if (result == LOCK_WAITING) {
+        lock->numConflicts++;
+    }
+    return result;
 }
 
 LockResult LockManager::convert(ResourceId resId, LockRequest* request, LockMode newMode) {
@@ -534,6 +605,7 @@ LockResult LockManager::convert(ResourceId resId, LockRequest* request, LockMode
     invariant((LockConflictsTable[request->mode] | LockConflictsTable[newMode]) ==
               LockConflictsTable[newMode]);
 
+    const auto now = Date_t::now();
     LockBucket* bucket = _getBucket(resId);
     stdx::lock_guard<SimpleMutex> scopedLock(bucket->mutex);
 
@@ -543,7 +615,7 @@ LockResult LockManager::convert(ResourceId resId, LockRequest* request, LockMode
     LockHead* const lock = it->second;
 
     if (lock->partitioned()) {
-        lock->migratePartitionedLockHeads();
+        lock->migrateForConflictingRequest(now);
     }
 
     // Construct granted mask without our current mode, so that it is not counted as
@@ -574,6 +646,7 @@ LockResult LockManager::convert(ResourceId resId, LockRequest* request, LockMode
 
         lock->conversionsCount++;
         lock->incGrantedModeCount(request->convertMode);
+        lock->numConflicts++;
 
         return LOCK_WAITING;
     } else {  // No conflict, existing request
@@ -858,6 +931,7 @@ void LockManager::_buildLocksArray(const std::map<LockerId, BSONObj>& lockToClie
                                    bool forLogging,
                                    LockManager* mutableThis,
                                    BSONArrayBuilder* locks) const {
+    const auto now = Date_t::now();
     for (size_t i = 0; i < _numLockBuckets; ++i) {
         LockBucket& bucket = _lockBuckets[i];
         stdx::lock_guard<SimpleMutex> scopedLock(bucket.mutex);
@@ -874,6 +948,9 @@ void LockManager::_buildLocksArray(const std::map<LockerId, BSONObj>& lockToClie
             if (forLogging)
                 o.append("lockAddr", formatPtr(lock));
             o.append("resourceId", lock->resourceId.toString());
+            o.append("numConflicts", lock->numConflicts);
+            o.append("numMigrations", lock->numMigrations);
+            o.append("hot", lock->partitioningDisabledUntil > now);
             struct {
                 StringData key;
                 LockRequest* iter;
@@ -913,6 +913,35 @@ TEST(LockManager, CompatibleFirstCancelWaiting) {
     ASSERT(lockMgr.unlock(&requestX));
 }
 
+TEST(LockManager, HotResourceStopsPartitioningIntentLocks) {
+    LockManager lockMgr;
+    const ResourceId resId(RESOURCE_COLLECTION, std::string("TestDB.hot"));
+
+    LockerImpl lockerIS;
+    LockerImpl lockerX;
+
+    // Repeatedly interrupt a partitioned intent lock with an exclusive one, as DDL operations
+    // under a steady read load do.
+    for (int i = 0; i < 5; i++) {
+        LockRequestCombo requestIS(&lockerIS);
+        ASSERT(LOCK_OK == lockMgr.lock(resId, &requestIS, MODE_IS));
+        ASSERT(requestIS.partitionedLock);
+
+        LockRequestCombo requestX(&lockerX);
+        ASSERT(LOCK_WAITING == lockMgr.lock(resId, &requestX, MODE_X));
+        ASSERT(lockMgr.unlock(&requestIS));
+        ASSERT_EQ(LOCK_OK, requestX.lastResult);
+        ASSERT(lockMgr.unlock(&requestX));
+    }
+
+    // The resource is now hot, so intent locks are granted on its lock head directly.
+    LockRequestCombo requestIS(&lockerIS);
+    ASSERT(LOCK_OK == lockMgr.lock(resId, &requestIS, MODE_IS));
+    ASSERT(!requestIS.partitionedLock);
+    ASSERT(requestIS.lock);
+    ASSERT(lockMgr.unlock(&requestIS));
+}
+
 TEST(LockManager, Fairness) {
     LockManager lockMgr;
     const ResourceId resId(RESOURCE_GLOBAL, 0);
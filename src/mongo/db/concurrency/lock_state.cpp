@@ -33,16 +33,20 @@
 
 #include "mongo/db/concurrency/lock_state.h"
 
+#include <algorithm>
 #include <vector>
 
 #include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/bson/json.h"
 #include "mongo/db/concurrency/flow_control_ticketholder.h"
+#include "mongo/db/concurrency/lock_manager_gen.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/service_context.h"
+#include "mongo/db/stats/operation_phase_timers.h"
 #include "mongo/db/storage/flow_control.h"
 #include "mongo/logv2/log.h"
 #include "mongo/platform/compiler.h"
+#include "mongo/platform/pause.h"
 #include "mongo/stdx/new.h"
 #include "mongo/util/background.h"
 #include "mongo/util/concurrency/ticketholder.h"
@@ -131,6 +135,44 @@ AtomicWord<unsigned long long> idCounter(0);
 // indexed by LockerId in order to minimize concurrent access conflicts.
 PartitionedInstanceWideLockStats globalStats;
 
+// Tracks wait times and spinning outcomes of contended lock acquisitions across all Lockers.
+LockContentionStats globalContentionStats;
+
+// How long a waiting request for each resource type currently spins before going to sleep. Doubles
+// each time spinning ends with the lock granted and halves each time it does not, within
+// [kMinSpinMicros, lockAcquisitionMaxSpinMicros].
+const int kMinSpinMicros = 1;
+AtomicWord<int> spinMicrosByResourceType[ResourceTypesCount];
+
+// Spinning while more threads than there are cores spin would delay the holders of the locks
+// being waited for, so beyond that waiters go straight to sleep.
+AtomicWord<int> numSpinningLockers{0};
+const int kMaxSpinningLockers = std::max(1U, stdx::thread::hardware_concurrency());
+
+/**
+ * Spins for a while, waiting for a request which could not be granted immediately to be granted.
+ */
+void spinBeforeWaiting(CondVarLockGrantNotification* notify, ResourceId resId) {
+    const int maxSpinMicros = gLockAcquisitionMaxSpinMicros.load();
+    if (maxSpinMicros == 0) {
+        return;
+    }
+
+    if (numSpinningLockers.addAndFetch(1) > kMaxSpinningLockers) {
+        numSpinningLockers.subtractAndFetch(1);
+        return;
+    }
+
+    auto& spinMicros = spinMicrosByResourceType[resId.getType()];
+    const int limit = std::clamp(spinMicros.load(), kMinSpinMicros, maxSpinMicros);
+    const bool granted = notify->spinUntilNotified(Microseconds(limit));
+    numSpinningLockers.subtractAndFetch(1);
+
+    spinMicros.store(granted ? std::min(limit * 2, maxSpinMicros)
+                             : std::max(limit / 2, kMinSpinMicros));
+    globalContentionStats.recordSpin(resId, granted);
+}
+
 }  // namespace
 
 bool LockerImpl::_shouldDelayUnlock(ResourceId resId, LockMode mode) const {
@@ -233,6 +275,7 @@ CondVarLockGrantNotification::CondVarLockGrantNotification() {
 
 void CondVarLockGrantNotification::clear() {
     _result = LOCK_INVALID;
+    _notified.store(false);
 }
 
 LockResult CondVarLockGrantNotification::wait(Milliseconds timeout) {
@@ -258,10 +301,24 @@ LockResult CondVarLockGrantNotification::wait(OperationContext* opCtx, Milliseco
     return LOCK_TIMEOUT;
 }
 
+bool CondVarLockGrantNotification::spinUntilNotified(Microseconds limit) {
+    const uint64_t start = curTimeMicros64();
+    for (int spins = 1; !_notified.load(); spins++) {
+        MONGO_YIELD_CORE_FOR_SMT();
+
+        // Reading the clock costs more than a pause, so only check it every so often.
+        if (spins % 64 == 0 && Microseconds(int64_t(curTimeMicros64() - start)) >= limit) {
+            return false;
+        }
+    }
+    return true;
+}
+
 void CondVarLockGrantNotification::notify(ResourceId resId, LockResult result) {
     stdx::unique_lock<Latch> lock(_mutex);
     invariant(_result == LOCK_INVALID);
     _result = result;
+    _notified.store(true);
 
     _cond.notify_all();
 }
@@ -353,11 +410,16 @@ bool LockerImpl::_acquireTicket(OperationContext* opCtx, LockMode mode, Date_t d
         // If the ticket wait is interrupted, restore the state of the client.
         auto restoreStateOnErrorGuard = makeGuard([&] { _clientState.store(kInactive); });
 
-        OperationContext* interruptible = _uninterruptibleLocksRequested ? nullptr : opCtx;
-        if (deadline == Date_t::max()) {
-            holder->waitForTicket(interruptible);
-        } else if (!holder->waitForTicketUntil(interruptible, deadline)) {
-            return false;
+        // Only time the wait when there is one, so that uncontended acquisitions stay cheap.
+        if (!holder->tryAcquire(getAdmissionPriority())) {
+            ScopedOperationPhase ticketWaitPhase(opCtx, OperationPhase::kTicketWait);
+            OperationContext* interruptible = _uninterruptibleLocksRequested ? nullptr : opCtx;
+            if (deadline == Date_t::max()) {
+                holder->waitForTicket(interruptible, getAdmissionPriority());
+            } else if (!holder->waitForTicketUntil(
+                           interruptible, deadline, getAdmissionPriority())) {
+                return false;
+            }
         }
         restoreStateOnErrorGuard.dismiss();
     }
@@ -939,6 +1001,12 @@ void LockerImpl::_lockComplete(OperationContext* opCtx,
     const uint64_t startOfTotalWaitTime = curTimeMicros64();
     uint64_t startOfCurrentWaitTime = startOfTotalWaitTime;
 
+    // Conflicting locks are often held only briefly, so spin for a while before going to sleep.
+    // If the request is granted while spinning, the first wait below returns straight away.
+    if (timeout > Milliseconds(0)) {
+        spinBeforeWaiting(&_notify, resId);
+    }
+
     while (true) {
         // It is OK if this call wakes up spuriously, because we re-evaluate the remaining
         // wait time anyways.
@@ -990,6 +1058,8 @@ void LockerImpl::_lockComplete(OperationContext* opCtx,
 
     invariant(result == LOCK_OK);
     unlockOnErrorGuard.dismiss();
+
+    globalContentionStats.recordWaitTime(resId, curTimeMicros64() - startOfTotalWaitTime);
 }
 
 void LockerImpl::getFlowControlTicket(OperationContext* opCtx, LockMode lockMode) {
@@ -1097,8 +1167,13 @@ void reportGlobalLockingStats(SingleThreadedLockStats* outStats) {
     globalStats.report(outStats);
 }
 
+const LockContentionStats& getGlobalLockContentionStats() {
+    return globalContentionStats;
+}
+
 void resetGlobalLockStats() {
     globalStats.reset();
+    globalContentionStats.reset();
 }
 
 // Hardcoded resource IDs.
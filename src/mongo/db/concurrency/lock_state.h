@@ -71,6 +71,12 @@ public:
      */
     LockResult wait(OperationContext* opCtx, Milliseconds timeout);
 
+    /**
+     * Busy-waits for up to 'limit' for the notification to fire, without taking the mutex or
+     * giving up the CPU. Returns true if it fired, in which case wait() returns without blocking.
+     */
+    bool spinUntilNotified(Microseconds limit);
+
 private:
     virtual void notify(ResourceId resId, LockResult result);
 
@@ -80,6 +86,9 @@ private:
 
     // Result from the last call to notify
     LockResult _result;
+
+    // Set once _result has been set, for spinUntilNotified() to poll.
+    AtomicWord<bool> _notified{false};
 };
 
 
@@ -40,21 +40,63 @@ LockStats<CounterType>::LockStats() {
     reset();
 }
 
+LockContentionStats::LockContentionStats() {
+    reset();
+}
+
+void LockContentionStats::recordWaitTime(ResourceId resId, uint64_t waitMicros) {
+    int bucket = 0;
+    for (auto micros = waitMicros; micros > 0 && bucket < kNumWaitTimeBuckets - 1; micros >>= 1) {
+        ++bucket;
+    }
+    _get(resId).waitTimeMicrosHistogram[bucket].addAndFetch(1);
+}
+
+void LockContentionStats::recordSpin(ResourceId resId, bool granted) {
+    auto& counters = _get(resId);
+    if (granted) {
+        counters.grantedWhileSpinning.addAndFetch(1);
+    } else {
+        counters.parkedAfterSpinning.addAndFetch(1);
+    }
+}
+
+void LockContentionStats::reset() {
+    const auto resetCounters = [](Counters& counters) {
+        for (auto& bucket : counters.waitTimeMicrosHistogram) {
+            bucket.store(0);
+        }
+        counters.grantedWhileSpinning.store(0);
+        counters.parkedAfterSpinning.store(0);
+    };
+
+    for (auto& counters : _stats) {
+        resetCounters(counters);
+    }
+    resetCounters(_oplogStats);
+}
+
 template <typename CounterType>
-void LockStats<CounterType>::report(BSONObjBuilder* builder) const {
+void LockStats<CounterType>::report(BSONObjBuilder* builder,
+                                    const LockContentionStats* contention) const {
     // All indexing below starts from offset 1, because we do not want to report/account
     // position 0, which is a sentinel value for invalid resource/no lock.
     for (int i = 1; i < ResourceTypesCount; i++) {
-        _report(builder, resourceTypeName(static_cast<ResourceType>(i)), _stats[i]);
+        const auto resType = static_cast<ResourceType>(i);
+        _report(builder,
+                resourceTypeName(resType),
+                _stats[i],
+                contention ? &contention->get(resType) : nullptr);
     }
 
-    _report(builder, "oplog", _oplogStats);
+    _report(builder, "oplog", _oplogStats, contention ? &contention->getOplog() : nullptr);
 }
 
 template <typename CounterType>
 void LockStats<CounterType>::_report(BSONObjBuilder* builder,
                                      const char* resourceTypeName,
-                                     const PerModeLockStatCounters& stat) const {
+                                     const PerModeLockStatCounters& stat,
+                                     const LockContentionStats::Counters* contention) const {
     std::unique_ptr<BSONObjBuilder> section;
 
     // All indexing below starts from offset 1, because we do not want to report/account
@@ -115,6 +157,46 @@ void LockStats<CounterType>::_report(BSONObjBuilder* builder,
             }
         }
     }
+
+    if (!contention) {
+        return;
+    }
+
+    // Distribution of the time spent waiting by acquisitions which had to wait
+    {
+        std::unique_ptr<BSONArrayBuilder> waitHistogram;
+        for (int bucket = 0; bucket < LockContentionStats::kNumWaitTimeBuckets; bucket++) {
+            long long value = contention->waitTimeMicrosHistogram[bucket].load();
+            if (value > 0) {
+                if (!waitHistogram) {
+                    if (!section) {
+                        section.reset(new BSONObjBuilder(builder->subobjStart(resourceTypeName)));
+                    }
+
+                    waitHistogram.reset(
+                        new BSONArrayBuilder(section->subarrayStart("acquireWaitHistogram")));
+                }
+                BSONObjBuilder entry(waitHistogram->subobjStart());
+                entry.append("micros", bucket ? 1LL << (bucket - 1) : 0LL);
+                entry.append("count", value);
+            }
+        }
+    }
+
+    // Outcome of spinning before going to sleep
+    {
+        long long granted = contention->grantedWhileSpinning.load();
+        long long parked = contention->parkedAfterSpinning.load();
+        if (granted > 0 || parked > 0) {
+            if (!section) {
+                section.reset(new BSONObjBuilder(builder->subobjStart(resourceTypeName)));
+            }
+
+            BSONObjBuilder spinWait(section->subobjStart("acquireSpinCount"));
+            spinWait.append("granted", granted);
+            spinWait.append("parked", parked);
+        }
+    }
 }
 
 template <typename CounterType>
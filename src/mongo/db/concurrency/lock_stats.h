@@ -107,6 +107,51 @@ struct LockStatCounters {
 };
 
 
+/**
+ * Instance-wide statistics about contended lock acquisitions: how long they waited, and whether
+ * the request was granted while its locker was still spinning or only after it went to sleep.
+ * Unlike LockStats, these are not kept per locker, because they are only updated on the slow path.
+ */
+class LockContentionStats {
+public:
+    // Wait times are bucketed by powers of two microseconds; the last bucket is unbounded.
+    static constexpr int kNumWaitTimeBuckets = 24;
+
+    struct Counters {
+        AtomicWord<long long> waitTimeMicrosHistogram[kNumWaitTimeBuckets];
+        AtomicWord<long long> grantedWhileSpinning;
+        AtomicWord<long long> parkedAfterSpinning;
+    };
+
+    LockContentionStats();
+
+    void recordWaitTime(ResourceId resId, uint64_t waitMicros);
+    void recordSpin(ResourceId resId, bool granted);
+
+    const Counters& get(ResourceType resType) const {
+        return _stats[resType];
+    }
+
+    const Counters& getOplog() const {
+        return _oplogStats;
+    }
+
+    void reset();
+
+private:
+    Counters& _get(ResourceId resId) {
+        if (resId == resourceIdOplog) {
+            return _oplogStats;
+        }
+
+        return _stats[resId.getType()];
+    }
+
+    Counters _stats[ResourceTypesCount];
+    Counters _oplogStats;
+};
+
+
 /**
  * Templatized lock statistics management class, which can be specialized with atomic integers
  * for the global stats and with regular integers for the per-locker stats.
@@ -184,7 +229,11 @@ public:
         }
     }
 
-    void report(BSONObjBuilder* builder) const;
+    /**
+     * Appends the counters for each resource type to 'builder'. If 'contention' is provided, its
+     * wait time histogram and spin counts are appended alongside them.
+     */
+    void report(BSONObjBuilder* builder, const LockContentionStats* contention = nullptr) const;
     void reset();
 
 private:
@@ -203,7 +252,8 @@ private:
 
     void _report(BSONObjBuilder* builder,
                  const char* resourceTypeName,
-                 const PerModeLockStatCounters& stat) const;
+                 const PerModeLockStatCounters& stat,
+                 const LockContentionStats::Counters* contention) const;
 
 
     // Split the lock stats per resource type. Special-case the oplog so we can collect more
@@ -221,6 +271,11 @@ typedef LockStats<AtomicWord<long long>> AtomicLockStats;
  */
 void reportGlobalLockingStats(SingleThreadedLockStats* outStats);
 
+/**
+ * Returns the instance-wide statistics about contended lock acquisitions.
+ */
+const LockContentionStats& getGlobalLockContentionStats();
+
 /**
  * Currently used for testing only.
  */
@@ -32,6 +32,7 @@
 #include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/db/concurrency/lock_manager_test_help.h"
 #include "mongo/db/service_context_test_fixture.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/unittest/unittest.h"
 
 namespace mongo {
@@ -91,6 +92,50 @@ TEST_F(LockStatsTest, Wait) {
     ASSERT_GREATER_THAN(stats.get(resId, MODE_S).combinedWaitTimeMicros, 0);
 }
 
+TEST_F(LockStatsTest, WaitHistogram) {
+    const ResourceId resId(RESOURCE_COLLECTION, std::string("LockStats.WaitHistogram"));
+
+    resetGlobalLockStats();
+
+    LockerForTests locker(MODE_IX);
+    locker.lock(resId, MODE_X);
+
+    stdx::thread waiter([&] {
+        LockerForTests lockerConflict(MODE_IX);
+        lockerConflict.lock(resId, MODE_S);
+        lockerConflict.unlock(resId);
+    });
+
+    // Release the lock once the waiter is blocked on it.
+    while (true) {
+        SingleThreadedLockStats stats;
+        reportGlobalLockingStats(&stats);
+        if (stats.get(resId, MODE_S).numWaits > 0) {
+            break;
+        }
+        sleepmillis(1);
+    }
+    locker.unlock(resId);
+    waiter.join();
+
+    const auto& contention = getGlobalLockContentionStats().get(RESOURCE_COLLECTION);
+    long long numWaits = 0;
+    for (const auto& bucket : contention.waitTimeMicrosHistogram) {
+        numWaits += bucket.load();
+    }
+    ASSERT_EQUALS(1, numWaits);
+    ASSERT_EQUALS(
+        1, contention.grantedWhileSpinning.load() + contention.parkedAfterSpinning.load());
+
+    SingleThreadedLockStats stats;
+    reportGlobalLockingStats(&stats);
+    BSONObjBuilder builder;
+    stats.report(&builder, &getGlobalLockContentionStats());
+    const auto report = builder.obj();
+    ASSERT_EQUALS(1U, report["Collection"]["acquireWaitHistogram"].Array().size());
+    ASSERT(report["Collection"]["acquireSpinCount"].isABSONObj());
+}
+
 TEST_F(LockStatsTest, Reporting) {
     const ResourceId resId(RESOURCE_COLLECTION, std::string("LockStats.Reporting"));
 
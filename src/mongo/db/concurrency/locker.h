@@ -37,6 +37,7 @@
 #include "mongo/db/concurrency/lock_stats.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/stdx/thread.h"
+#include "mongo/util/concurrency/admission_priority.h"
 
 namespace mongo {
 
@@ -492,6 +493,17 @@ public:
         return _shouldAcquireTicket;
     }
 
+    /**
+     * Sets the priority with which this locker queues for a ticket while tickets are scarce.
+     */
+    void setAdmissionPriority(AdmissionPriority priority) {
+        _admissionPriority = priority;
+    }
+
+    AdmissionPriority getAdmissionPriority() const {
+        return _admissionPriority;
+    }
+
     /**
      * Acquire a flow control admission ticket into the system. Flow control is used as a
      * backpressure mechanism to limit replication majority point lag.
@@ -540,6 +552,7 @@ protected:
 private:
     bool _shouldConflictWithSecondaryBatchApplication = true;
     bool _shouldAcquireTicket = true;
+    AdmissionPriority _admissionPriority = AdmissionPriority::kNormal;
     std::string _debugInfo;  // Extra info about this locker for debugging purpose
 };
 
@@ -601,4 +614,26 @@ private:
     const bool _originalShouldConflict;
 };
 
+/**
+ * RAII-style class to set the priority with which a locker queues for a ticket.
+ */
+class ScopedAdmissionPriority {
+    ScopedAdmissionPriority(const ScopedAdmissionPriority&) = delete;
+    ScopedAdmissionPriority& operator=(const ScopedAdmissionPriority&) = delete;
+
+public:
+    ScopedAdmissionPriority(Locker* lockState, AdmissionPriority priority)
+        : _lockState(lockState), _originalPriority(_lockState->getAdmissionPriority()) {
+        _lockState->setAdmissionPriority(priority);
+    }
+
+    ~ScopedAdmissionPriority() {
+        _lockState->setAdmissionPriority(_originalPriority);
+    }
+
+private:
+    Locker* const _lockState;
+    const AdmissionPriority _originalPriority;
+};
+
 }  // namespace mongo
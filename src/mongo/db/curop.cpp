@@ -48,7 +48,9 @@
 #include "mongo/db/json.h"
 #include "mongo/db/prepare_conflict_tracker.h"
 #include "mongo/db/query/getmore_request.h"
+#include "mongo/db/query/operation_arena.h"
 #include "mongo/db/query/plan_summary_stats.h"
+#include "mongo/db/stats/operation_phase_timers.h"
 #include "mongo/logv2/log.h"
 #include "mongo/rpc/metadata/client_metadata.h"
 #include "mongo/rpc/metadata/client_metadata_ismaster.h"
@@ -446,6 +448,13 @@ bool CurOp::completeAndLogOperation(OperationContext* opCtx,
         oplogGetMoreStats.recordMillis(executionTimeMillis);
     }
 
+    // Operations nested in this one charge their phases to the same OperationContext, so only the
+    // outermost operation is recorded.
+    if (!_parent) {
+        OperationPhaseStats::get(opCtx->getServiceContext())
+            .record(_debug.queryHash, OperationPhaseTimers::get(opCtx));
+    }
+
     bool shouldLogSlowOp, shouldSample;
 
     // Log the operation if it is eligible according to the current slowMS and sampleRate settings.
@@ -658,6 +667,14 @@ void CurOp::reportState(OperationContext* opCtx, BSONObjBuilder* builder, bool t
         builder->append("writeConflicts", n);
     }
 
+    if (auto phaseTimes = OperationPhaseTimers::get(opCtx).toBSON(); !phaseTimes.isEmpty()) {
+        builder->append("phaseTimes", phaseTimes);
+    }
+
+    if (auto arena = OperationArena::get(opCtx).toBSON(); !arena.isEmpty()) {
+        builder->append("arena", arena);
+    }
+
     builder->append("numYields", _numYields);
 }
 
@@ -827,6 +844,14 @@ string OpDebug::report(OperationContext* opCtx, const SingleThreadedLockStats* l
         s << " storage:" << storageStats->toBSON().toString();
     }
 
+    if (auto phaseTimes = OperationPhaseTimers::get(opCtx).toBSON(); !phaseTimes.isEmpty()) {
+        s << " phaseTimes:" << phaseTimes.toString();
+    }
+
+    if (auto arena = OperationArena::get(opCtx).toBSON(); !arena.isEmpty()) {
+        s << " arena:" << arena.toString();
+    }
+
     if (iscommand) {
         s << " protocol:" << getProtoString(networkOp);
     }
@@ -996,6 +1021,14 @@ void OpDebug::report(OperationContext* opCtx,
         pAttrs->add("storage", storageStats->toBSON());
     }
 
+    if (auto phaseTimes = OperationPhaseTimers::get(opCtx).toBSON(); !phaseTimes.isEmpty()) {
+        pAttrs->add("phaseTimes", phaseTimes);
+    }
+
+    if (auto arena = OperationArena::get(opCtx).toBSON(); !arena.isEmpty()) {
+        pAttrs->add("arena", arena);
+    }
+
     if (iscommand) {
         pAttrs->add("protocol", getProtoString(networkOp));
     }
@@ -1108,6 +1141,14 @@ void OpDebug::append(OperationContext* opCtx,
         b.append("storage", storageStats->toBSON());
     }
 
+    if (auto phaseTimes = OperationPhaseTimers::get(opCtx).toBSON(); !phaseTimes.isEmpty()) {
+        b.append("phaseTimes", phaseTimes);
+    }
+
+    if (auto arena = OperationArena::get(opCtx).toBSON(); !arena.isEmpty()) {
+        b.append("arena", arena);
+    }
+
     if (!errInfo.isOK()) {
         b.appendNumber("ok", 0.0);
         if (!errInfo.reason().empty()) {
@@ -79,6 +79,8 @@ CollectionScan::CollectionScan(ExpressionContext* expCtx,
     }
     invariant(!_params.shouldTrackLatestOplogTimestamp || collection->ns().isOplog());
 
+    _compiledFilter = CompiledMatchExpression::compile(_filter);
+
     if (params.resumeAfterRecordId) {
         // The 'resumeAfterRecordId' parameter is used for resumable collection scans, which we
         // only support in the forward direction.
@@ -238,9 +240,13 @@ PlanStage::StageState CollectionScan::returnIfMatches(WorkingSetMember* member,
                                                       WorkingSetID memberID,
                                                       WorkingSetID* out) {
     ++_specificStats.docsTested;
-    if (Filter::passes(member, _filter)) {
+    const bool passes = _compiledFilter && member->hasObj()
+        ? _compiledFilter->matches(member->doc.value().toBson())
+        : Filter::passes(member, _filter);
+    if (passes) {
         if (_params.stopApplyingFilterAfterFirstMatch) {
             _filter = nullptr;
+            _compiledFilter.reset();
         }
         *out = memberID;
         return PlanStage::ADVANCED;
@@ -33,6 +33,7 @@
 
 #include "mongo/db/exec/collection_scan_common.h"
 #include "mongo/db/exec/requires_collection_stage.h"
+#include "mongo/db/matcher/compiled_match_expression.h"
 #include "mongo/db/matcher/expression_leaf.h"
 #include "mongo/db/record_id.h"
 
@@ -106,6 +107,9 @@ private:
     // The filter is not owned by us.
     const MatchExpression* _filter;
 
+    // Single-pass form of '_filter', or null if the filter is too small to benefit from it.
+    std::unique_ptr<CompiledMatchExpression> _compiledFilter;
+
     // If a document does not pass '_filter' but passes '_endCondition', stop scanning and return
     // IS_EOF.
     BSONObj _endConditionBSON;
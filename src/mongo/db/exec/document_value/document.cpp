@@ -46,6 +46,34 @@ using std::vector;
 
 const DocumentStorage DocumentStorage::kEmptyDoc;
 
+namespace {
+// A sub-document read from owned BSON shares its parent's buffer, rather than being copied, only
+// if that buffer is at most this many times the size of the sub-document.
+constexpr size_t kMaxSharedBufferToSubDocumentRatio = 2;
+
+// Returns true if the Value for 'elem' is held entirely inside the Value itself, so building it
+// again on every read costs no more than fetching it from the cache.
+bool fitsInlineInValue(const BSONElement& elem) {
+    switch (elem.type()) {
+        case Code:
+        case Symbol:
+        case String:
+            return static_cast<size_t>(elem.valuestrsize() - 1) <=
+                sizeof(ValueStorage::shortStrStorage);
+        case Object:
+        case Array:
+        case RegEx:
+        case NumberDecimal:
+        case CodeWScope:
+        case BinData:
+        case DBRef:
+            return false;
+        default:
+            return true;
+    }
+}
+}  // namespace
+
 const StringDataSet Document::allMetadataFieldNames{Document::metaFieldTextScore,
                                                     Document::metaFieldRandVal,
                                                     Document::metaFieldSortKey,
@@ -103,8 +131,9 @@ bool DocumentStorageIterator::shouldSkipDeleted() {
         if (auto pos = _storage->findFieldInCache(fieldName); pos.found()) {
             _it = _first->plusBytes(pos.index);
             if (_it->kind == ValueElement::Kind::kMaybeInserted) {
-                // We have found the value in the BSON so it was not in fact inserted.
-                const_cast<ValueElement*>(_it)->kind = ValueElement::Kind::kCached;
+                // We have found the value in the BSON so it was not in fact inserted. It was
+                // written to though, so its BSON image is stale.
+                const_cast<ValueElement*>(_it)->kind = ValueElement::Kind::kModified;
             }
             if (_it->val.missing()) {
                 return true;
@@ -118,7 +147,8 @@ bool DocumentStorageIterator::shouldSkipDeleted() {
             _it = nullptr;
         }
     } else if (!atEnd()) {
-        if (_it->val.missing() || _it->kind == ValueElement::Kind::kCached) {
+        if (_it->val.missing() || _it->kind == ValueElement::Kind::kCached ||
+            _it->kind == ValueElement::Kind::kModified) {
             return true;
         }
     }
@@ -170,11 +200,62 @@ Position DocumentStorage::findField(StringData requested, LookupPolicy policy) c
     return Position();
 }
 
+Value DocumentStorage::getField(StringData name) const {
+    if (auto pos = findFieldInCache(name); pos.found()) {
+        return getField(pos).val;
+    }
+
+    for (auto&& bsonElement : _bson) {
+        if (name == bsonElement.fieldNameStringData()) {
+            if (!fitsInlineInValue(bsonElement)) {
+                // Building this value allocates, so keep it around for subsequent reads.
+                auto pos = const_cast<DocumentStorage*>(this)->constructInCache(bsonElement);
+                return getField(pos).val;
+            }
+            return valueFromBson(bsonElement);
+        }
+    }
+
+    return Value();
+}
+
+Value DocumentStorage::valueFromBson(const BSONElement& elem) const {
+    if (!_bson.isOwned()) {
+        return Value(elem);
+    }
+
+    switch (elem.type()) {
+        case Object: {
+            // Sharing the parent's buffer avoids a copy but keeps the whole buffer alive for as
+            // long as the sub-document is, so small sub-documents are copied instead.
+            auto subObj = elem.embeddedObject();
+            if (static_cast<size_t>(subObj.objsize()) * kMaxSharedBufferToSubDocumentRatio <
+                _bson.sharedBuffer().capacity()) {
+                return Value(Document(subObj.getOwned()));
+            }
+
+            auto storage = make_intrusive<DocumentStorage>(
+                subObj.shareOwnershipWith(_bson), false /* stripMetadata */, false /* modified */);
+            storage->_sharesParentBuffer = true;
+            return Value(Document(std::move(storage)));
+        }
+        case Array: {
+            std::vector<Value> values;
+            for (auto&& sub : elem.embeddedObject()) {
+                values.push_back(valueFromBson(sub));
+            }
+            return Value(std::move(values));
+        }
+        default:
+            return Value(elem);
+    }
+}
+
 Position DocumentStorage::constructInCache(const BSONElement& elem) {
     auto savedModified = _modified;
     auto pos = getNextPosition();
     const auto fieldName = elem.fieldNameStringData();
-    appendField(fieldName, ValueElement::Kind::kCached) = Value(elem);
+    appendField(fieldName, ValueElement::Kind::kCached) = valueFromBson(elem);
     _modified = savedModified;
 
     return pos;
@@ -208,7 +289,7 @@ Value& DocumentStorage::appendField(StringData name, ValueElement::Kind kind) {
 #undef append
 
     // Make sure next field starts where we expect it
-    fassert(16486, getField(pos).next()->ptr() == _cache + _usedBytes);
+    fassert(16486, elementAt(pos).next()->ptr() == _cache + _usedBytes);
 
     _numFields++;
 
@@ -219,12 +300,12 @@ Value& DocumentStorage::appendField(StringData name, ValueElement::Kind kind) {
         rehash();
     }
 
-    return getField(pos).val;
+    return elementAt(pos).val;
 }
 
 // Call after adding field to _fields and increasing _numFields
 void DocumentStorage::addFieldToHashTable(Position pos) {
-    ValueElement& elem = getField(pos);
+    ValueElement& elem = elementAt(pos);
     elem.nextCollision = Position();
 
     const unsigned bucket = bucketForKey(elem.nameSD());
@@ -232,7 +313,7 @@ void DocumentStorage::addFieldToHashTable(Position pos) {
     Position* posPtr = &_hashTab[bucket];
     while (posPtr->found()) {
         // collision: walk links and add new to end
-        posPtr = &getField(*posPtr).nextCollision;
+        posPtr = &elementAt(*posPtr).nextCollision;
     }
     *posPtr = Position(pos.index);
 }
@@ -320,6 +401,7 @@ intrusive_ptr<DocumentStorage> DocumentStorage::clone() const {
 
     out->_haveLazyLoadedMetadata = _haveLazyLoadedMetadata;
     out->_metadataFields = _metadataFields;
+    out->_sharesParentBuffer = _sharesParentBuffer;
 
     return out;
 }
@@ -340,6 +422,7 @@ void DocumentStorage::reset(const BSONObj& bson, bool stripMetadata) {
     _bson = bson;
     _stripMetadata = stripMetadata;
     _modified = false;
+    _sharesParentBuffer = false;
 
     // Clean cache.
     for (auto it = iteratorCacheOnly(); !it.atEnd(); it.advance()) {
@@ -435,13 +518,35 @@ void Document::toBson(BSONObjBuilder* builder, size_t recursionLevel) const {
                           << BSONDepth::getMaxAllowableDepth() << " levels of nesting",
             recursionLevel <= BSONDepth::getMaxAllowableDepth());
 
+    // Fields whose BSON image is still accurate are copied verbatim. Runs of adjacent unchanged
+    // fields are spliced from the underlying BSON with a single copy.
+    const char* runStart = nullptr;
+    size_t runSize = 0;
+    auto flushRun = [&] {
+        if (runSize) {
+            builder->bb().appendBuf(runStart, runSize);
+            runSize = 0;
+        }
+    };
+
     for (DocumentStorageIterator it = storage().iterator(); !it.atEnd(); it.advance()) {
-        if (auto cached = it.cachedValue()) {
-            cached->val.addToBsonObj(builder, cached->nameSD(), recursionLevel);
-        } else {
-            builder->append(*it.bsonIter());
+        auto cached = it.cachedValue();
+        if (it.bsonIter().more() && (!cached || cached->kind == ValueElement::Kind::kCached)) {
+            const BSONElement elem = *it.bsonIter();
+            if (runSize && runStart + runSize == elem.rawdata()) {
+                runSize += elem.size();
+            } else {
+                flushRun();
+                runStart = elem.rawdata();
+                runSize = elem.size();
+            }
+            continue;
         }
+
+        flushRun();
+        cached->val.addToBsonObj(builder, cached->nameSD(), recursionLevel);
     }
+    flushRun();
 }
 
 BSONObj Document::toBson() const {
@@ -656,7 +761,7 @@ size_t Document::getApproximateSize() const {
 
     // The metadata also occupies space in the document storage that's pre-allocated.
     size += storage().getMetadataApproximateSize();
-    size += storage().bsonObjSize();
+    size += storage().bsonBufferBytes();
 
     return size;
 }
@@ -335,6 +335,7 @@ public:
     }
 
 private:
+    friend class DocumentStorage;
     friend class FieldIterator;
     friend class ValueStorage;
     friend class MutableDocument;
@@ -0,0 +1,125 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/exec/document_value/document.h"
+#include "mongo/db/pipeline/field_path.h"
+
+namespace mongo {
+namespace {
+
+// These benchmarks mimic how common pipeline stages touch documents that come straight from BSON:
+// $match reads a few fields, $project builds a new document out of a few fields and $addFields
+// modifies a document before it is serialized back to BSON.
+
+std::vector<BSONObj> makeBsonDocuments() {
+    std::vector<BSONObj> docs;
+    for (int i = 0; i < 1000; ++i) {
+        BSONObjBuilder bob;
+        bob.append("_id", i);
+        bob.append("name", "a name that is long enough to be heap allocated");
+        bob.append("qty", i % 17);
+        bob.append("price", 1.5 * i);
+        bob.append("tags", BSON_ARRAY("red"
+                                      << "green"
+                                      << "blue"));
+        bob.append("stats", BSON("views" << i * 7LL << "likes" << i % 100));
+        for (int j = 0; j < 20; ++j) {
+            bob.append("padding" + std::to_string(j), j);
+        }
+        docs.push_back(bob.obj());
+    }
+    return docs;
+}
+
+void BM_MatchReads(benchmark::State& state) {
+    const auto docs = makeBsonDocuments();
+    for (auto _ : state) {
+        for (auto&& bson : docs) {
+            Document doc(bson);
+            benchmark::DoNotOptimize(doc["qty"]);
+            benchmark::DoNotOptimize(doc["name"]);
+            benchmark::DoNotOptimize(doc.getNestedField("stats.likes"));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * docs.size());
+}
+
+void BM_ProjectToBson(benchmark::State& state) {
+    const auto docs = makeBsonDocuments();
+    for (auto _ : state) {
+        for (auto&& bson : docs) {
+            Document doc(bson);
+            MutableDocument out;
+            out.addField("_id", doc["_id"]);
+            out.addField("name", doc["name"]);
+            out.addField("stats", doc["stats"]);
+            benchmark::DoNotOptimize(out.freeze().toBson());
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * docs.size());
+}
+
+void BM_AddFieldsToBson(benchmark::State& state) {
+    const auto docs = makeBsonDocuments();
+    for (auto _ : state) {
+        for (auto&& bson : docs) {
+            Document doc(bson);
+            MutableDocument md(doc);
+            md.addField("total", Value(doc["price"].getDouble() * doc["qty"].getInt()));
+            benchmark::DoNotOptimize(md.freeze().toBson());
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * docs.size());
+}
+
+void BM_SetExistingFieldToBson(benchmark::State& state) {
+    const auto docs = makeBsonDocuments();
+    for (auto _ : state) {
+        for (auto&& bson : docs) {
+            MutableDocument md{Document(bson)};
+            md.setField("qty", Value(0));
+            md.setNestedField(FieldPath("stats.likes"), Value(0));
+            benchmark::DoNotOptimize(md.freeze().toBson());
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * docs.size());
+}
+
+BENCHMARK(BM_MatchReads);
+BENCHMARK(BM_ProjectToBson);
+BENCHMARK(BM_AddFieldsToBson);
+BENCHMARK(BM_SetExistingFieldToBson);
+
+}  // namespace
+}  // namespace mongo
@@ -31,6 +31,7 @@
 
 #include <third_party/murmurhash3/MurmurHash3.h>
 
+#include <algorithm>
 #include <bitset>
 #include <boost/intrusive_ptr.hpp>
 
@@ -90,7 +91,10 @@ public:
         // The value has the image in the underlying BSON.
         kCached,
         // The value has been opportunistically inserted into the cache without checking the BSON.
-        kMaybeInserted
+        kMaybeInserted,
+        // The value has the image in the underlying BSON but may have been modified since it was
+        // brought into the cache, so the BSON image can no longer be trusted.
+        kModified
     };
 
     Value val;
@@ -332,18 +336,22 @@ public:
         verify(pos.found());
         return *(_firstElement->plusBytes(pos.index));
     }
-    Value getField(StringData name) const {
-        Position pos = findField(name, LookupPolicy::kCacheAndBSON);
-        if (!pos.found())
-            return Value();
-        return getField(pos).val;
-    }
+    /**
+     * Looks up a field, bringing it into the cache only if building its Value allocates (see
+     * valueFromBson()). Scalars and short strings that fit inside a Value are decoded from the
+     * underlying BSON on every call instead.
+     */
+    Value getField(StringData name) const;
 
     // MutableDocument uses these
     ValueElement& getField(Position pos) {
         _modified = true;
-        verify(pos.found());
-        return *(_firstElement->plusBytes(pos.index));
+        ValueElement& elem = elementAt(pos);
+        if (elem.kind == ValueElement::Kind::kCached) {
+            // The caller may change the value through the returned reference.
+            elem.kind = ValueElement::Kind::kModified;
+        }
+        return elem;
     }
     Value& getField(StringData name, LookupPolicy policy) {
         _modified = true;
@@ -398,7 +406,14 @@ public:
         return !_cache ? 0 : (_cacheEnd - _cache + hashTabBytes());
     }
 
-    auto bsonObjSize() const {
+    /**
+     * The number of bytes of BSON that this storage keeps alive. A sub-document that shares its
+     * parent's buffer keeps the whole buffer alive, not only its own bytes.
+     */
+    size_t bsonBufferBytes() const {
+        if (_sharesParentBuffer) {
+            return std::max(static_cast<size_t>(_bson.objsize()), _bson.sharedBuffer().capacity());
+        }
         return _bson.objsize();
     }
 
@@ -484,6 +499,12 @@ public:
 
     Position constructInCache(const BSONElement& elem);
 
+    /**
+     * Converts an element of the underlying BSON into a Value. When the underlying BSON is owned,
+     * sub-documents (including those nested in arrays) share its buffer instead of being copied.
+     */
+    Value valueFromBson(const BSONElement& elem) const;
+
     auto isModified() const {
         return _modified;
     }
@@ -496,6 +517,12 @@ private:
     /// Returns the position of the named field in the cache or Position()
     Position findFieldInCache(StringData name) const;
 
+    /// Same as getField(Position) but does not mark the element as modified.
+    ValueElement& elementAt(Position pos) {
+        verify(pos.found());
+        return *(_firstElement->plusBytes(pos.index));
+    }
+
     /// Allocates space in _cache. Copies existing data if there is any.
     void alloc(unsigned newSize);
 
@@ -581,6 +608,9 @@ private:
     // a conversion to BSON; i.e. if there are not any modifications we can directly return _bson.
     bool _modified{false};
 
+    // Set when '_bson' is a sub-document viewing the buffer of the document it was read from.
+    bool _sharesParentBuffer{false};
+
     // Defined in document.cpp
     static const DocumentStorage kEmptyDoc;
 
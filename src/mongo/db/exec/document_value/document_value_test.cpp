@@ -201,8 +201,8 @@ TEST(DocumentGetFieldNonCaching, CachedTopLevelFields) {
     BSONObj bson = BSON("scalar" << 1 << "array" << BSON_ARRAY(1 << 2 << 3) << "scalar2" << true);
     Document document = fromBson(bson);
 
-    // Force 'scalar2' to be cached.
-    ASSERT_FALSE(document["scalar2"].missing());
+    // Force 'scalar2' to be cached. Reading a scalar with operator[] does not cache it.
+    ASSERT_TRUE(document.positionOf("scalar2").found());
 
     // Attempt to access scalar2 with the non caching accessor. It should be cached already.
     {
@@ -354,6 +354,115 @@ TEST(DocumentGetFieldNonCaching, TraverseArray) {
     checkArrayTagIsReturned();
 }
 
+TEST(DocumentLazyRead, ReadsCacheOnlyValuesThatAllocate) {
+    BSONObj bson = BSON("scalar" << 1 << "shortString"
+                                 << "short"
+                                 << "string"
+                                 << "a string long enough not to fit inline"
+                                 << "subObj" << BSON("a" << 1));
+    Document document = fromBson(bson);
+
+    ASSERT_VALUE_EQ(document["scalar"], Value(1));
+    ASSERT_VALUE_EQ(document["shortString"], Value("short"_sd));
+    ASSERT_VALUE_EQ(document["string"], Value("a string long enough not to fit inline"_sd));
+    ASSERT_VALUE_EQ(document.getNestedField("subObj.a"), Value(1));
+    ASSERT_VALUE_EQ(document["subObj"]["a"], Value(1));
+
+    // Values that allocate are cached after the first read; those held inline in a Value are not.
+    ASSERT_TRUE(stdx::holds_alternative<BSONElement>(document.getNestedFieldNonCaching("scalar")));
+    ASSERT_TRUE(
+        stdx::holds_alternative<BSONElement>(document.getNestedFieldNonCaching("shortString")));
+    ASSERT_TRUE(stdx::holds_alternative<Value>(document.getNestedFieldNonCaching("string")));
+    ASSERT_TRUE(stdx::holds_alternative<Value>(document.getNestedFieldNonCaching("subObj")));
+
+    ASSERT_BSONOBJ_EQ(bson, toBson(document));
+    ASSERT_TRUE(bson.objdata() == toBson(document).objdata());
+}
+
+TEST(DocumentLazyRead, OnlySubDocumentsMakingUpMostOfTheBufferShareIt) {
+    const std::string payload(1000, 'x');
+    BSONObj bson = BSON("small" << BSON("a" << 1) << "large" << BSON("payload" << payload)).copy();
+    Document document = fromBson(bson);
+
+    ASSERT_TRUE(bson["large"].embeddedObject().objdata() ==
+                document["large"].getDocument().toBson().objdata());
+    ASSERT_FALSE(bson["small"].embeddedObject().objdata() ==
+                 document["small"].getDocument().toBson().objdata());
+    ASSERT_BSONOBJ_EQ(bson["small"].embeddedObject(), document["small"].getDocument().toBson());
+
+    // Neither the field nor the array element holding a payload is most of this buffer.
+    bson = BSON("large" << BSON("payload" << payload) << "array"
+                        << BSON_ARRAY(BSON("payload" << payload)))
+               .copy();
+    document = fromBson(bson);
+
+    ASSERT_FALSE(bson["large"].embeddedObject().objdata() ==
+                 document["large"].getDocument().toBson().objdata());
+    ASSERT_FALSE(bson["array"].embeddedObject()["0"].embeddedObject().objdata() ==
+                 document["array"][0].getDocument().toBson().objdata());
+}
+
+TEST(DocumentLazyRead, ApproximateSizeIncludesTheBufferKeptAlive) {
+    const std::string payload(1000, 'x');
+    BSONObj bson = BSON("small" << BSON("a" << 1) << "large" << BSON("payload" << payload)).copy();
+    Document document = fromBson(bson);
+
+    // A shared sub-document keeps its parent's whole buffer alive and is charged for it.
+    const Document large = document["large"].getDocument();
+    ASSERT_TRUE(bson["large"].embeddedObject().objdata() == large.toBson().objdata());
+    ASSERT_GTE(large.getApproximateSize(), static_cast<size_t>(bson.objsize()));
+
+    // A copied sub-document is only charged for its own copy.
+    const Document small = document["small"].getDocument();
+    ASSERT_LT(small.getApproximateSize(), static_cast<size_t>(bson.objsize()));
+}
+
+TEST(DocumentLazyRead, SubDocumentsOfUnownedBsonAreCopied) {
+    BSONObj owned = BSON("subObj" << BSON("a" << 1));
+    BSONObj unowned(owned.objdata());
+    Document document = fromBson(unowned);
+
+    const Document subObj = document["subObj"].getDocument();
+    ASSERT_FALSE(owned["subObj"].embeddedObject().objdata() == subObj.toBson().objdata());
+    ASSERT_BSONOBJ_EQ(owned["subObj"].embeddedObject(), subObj.toBson());
+}
+
+TEST(DocumentLazyRead, ToBsonOfModifiedDocumentMatchesExpected) {
+    BSONObj bson = BSON("a" << 1 << "b" << 2 << "c" << BSON_ARRAY(1 << 2) << "d"
+                            << BSON("x" << 1 << "y" << 2) << "e" << 5);
+    Document document = fromBson(bson);
+
+    // Bring some fields into the cache without modifying them.
+    ASSERT_EQ(document["c"].getArrayLength(), 2U);
+    ASSERT_TRUE(document.positionOf("e").found());
+
+    MutableDocument md(document);
+    md.setField("b", Value(20));
+    md.setNestedField(FieldPath("d.y"), Value(3));
+    md.addField("f", Value(6));
+    auto modified = md.freeze();
+
+    ASSERT_BSONOBJ_EQ(toBson(modified),
+                      BSON("a" << 1 << "b" << 20 << "c" << BSON_ARRAY(1 << 2) << "d"
+                               << BSON("x" << 1 << "y" << 3) << "e" << 5 << "f" << 6));
+
+    // The original document is unaffected.
+    ASSERT_BSONOBJ_EQ(toBson(document), bson);
+}
+
+TEST(DocumentLazyRead, ToBsonOfDocumentWithRemovedAndOverwrittenFields) {
+    BSONObj bson = BSON("a" << 1 << "b" << 2 << "c" << 3 << "d" << 4);
+
+    MutableDocument md(fromBson(bson));
+    md.remove("b");
+    // operator[] inserts into the cache without consulting the BSON.
+    md["c"] = Value(30);
+    ASSERT_VALUE_EQ(md.peek()["d"], Value(4));
+    auto modified = md.freeze();
+
+    ASSERT_BSONOBJ_EQ(toBson(modified), BSON("a" << 1 << "c" << 30 << "d" << 4));
+}
+
 /** Add Document fields. */
 class AddField {
 public:
@@ -31,6 +31,8 @@
 
 #include "mongo/db/exec/projection_node.h"
 
+#include "mongo/db/query/query_knobs_gen.h"
+
 namespace mongo::projection_executor {
 using ArrayRecursionPolicy = ProjectionPolicies::ArrayRecursionPolicy;
 using ComputedFieldsPolicy = ProjectionPolicies::ComputedFieldsPolicy;
@@ -182,6 +184,11 @@ void ProjectionNode::applyExpressions(const Document& root, MutableDocument* out
             outputDoc->setField(
                 field, childIt->second->applyExpressionsToValue(root, outputDoc->peek()[field]));
         } else {
+            if (auto compiledIt = _compiledExpressions.find(field);
+                compiledIt != _compiledExpressions.end()) {
+                outputDoc->setField(field, compiledIt->second->evaluate(root));
+                continue;
+            }
             auto expressionIt = _expressions.find(field);
             invariant(expressionIt != _expressions.end());
             outputDoc->setField(
@@ -253,6 +260,15 @@ void ProjectionNode::optimize() {
         childPair.second->optimize();
     }
 
+    _compiledExpressions.clear();
+    if (internalQueryEnableExpressionBytecode.load()) {
+        for (auto&& [field, expr] : _expressions) {
+            if (auto compiled = CompiledExpression::compile(expr)) {
+                _compiledExpressions.emplace(field, std::move(compiled));
+            }
+        }
+    }
+
     _maxFieldsToProject = maxFieldsToProject();
 }
 
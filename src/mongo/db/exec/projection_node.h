@@ -31,6 +31,7 @@
 
 #include "mongo/db/exec/projection_executor.h"
 
+#include "mongo/db/pipeline/expression_bytecode.h"
 #include "mongo/db/query/projection_policies.h"
 
 namespace mongo::projection_executor {
@@ -193,6 +194,7 @@ private:
      */
     void makeOptimizationsStale() {
         _maxFieldsToProject = boost::none;
+        _compiledExpressions.clear();
     }
 
     // Our projection semantics are such that all field additions need to be processed in the order
@@ -209,5 +211,9 @@ private:
     // optimization which means we don't have to iterate over an entire document. The value is
     // stored here to avoid re-computation for each document.
     boost::optional<size_t> _maxFieldsToProject;
+
+    // Bytecode for the entries of '_expressions' which could be compiled, populated by optimize()
+    // when 'internalQueryEnableExpressionBytecode' is set.
+    stdx::unordered_map<std::string, std::unique_ptr<CompiledExpression>> _compiledExpressions;
 };
 }  // namespace mongo::projection_executor
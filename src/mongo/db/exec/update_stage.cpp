@@ -149,7 +149,8 @@ UpdateStage::UpdateStage(ExpressionContext* expCtx,
           request->isFromMigration()) &&
         OperationShardingState::isOperationVersioned(expCtx->opCtx);
 
-    _specificStats.isModUpdate = params.driver->type() == UpdateDriver::UpdateType::kOperator;
+    _specificStats.isModUpdate = params.driver->type() == UpdateDriver::UpdateType::kOperator ||
+        params.driver->type() == UpdateDriver::UpdateType::kDelta;
 }
 
 BSONObj UpdateStage::transformAndUpdate(const Snapshotted<BSONObj>& oldObj, RecordId& recordId) {
@@ -160,24 +161,12 @@ BSONObj UpdateStage::transformAndUpdate(const Snapshotted<BSONObj>& oldObj, Reco
     // If asked to return new doc, default to the oldObj, in case nothing changes.
     BSONObj newObj = oldObj.value();
 
-    // Ask the driver to apply the mods. It may be that the driver can apply those "in
-    // place", that is, some values of the old document just get adjusted without any
-    // change to the binary layout on the bson layer. It may be that a whole new document
-    // is needed to accomodate the new bson layout of the resulting document. In any event,
-    // only enable in-place mutations if the underlying storage engine offers support for
-    // writing damage events.
-    _doc.reset(oldObj.value(),
-               (collection()->updateWithDamagesSupported()
-                    ? mutablebson::Document::kInPlaceEnabled
-                    : mutablebson::Document::kInPlaceDisabled));
-
     BSONObj logObj;
 
     bool docWasModified = false;
 
     auto* const css = CollectionShardingState::get(opCtx(), collection()->ns());
     const auto collDesc = css->getCollectionDescription_DEPRECATED();
-    Status status = Status::OK();
     const bool validateForStorage = opCtx()->writesAreReplicated() && _enforceOkForStorage;
     const bool isInsert = false;
     FieldRefSet immutablePaths;
@@ -187,50 +176,83 @@ BSONObj UpdateStage::transformAndUpdate(const Snapshotted<BSONObj>& oldObj, Reco
         }
         immutablePaths.keepShortest(&idFieldRef);
     }
-    if (!driver->needMatchDetails()) {
-        // If we don't need match details, avoid doing the rematch
-        status = driver->update(StringData(),
-                                &_doc,
-                                validateForStorage,
-                                immutablePaths,
-                                isInsert,
-                                &logObj,
-                                &docWasModified);
-    } else {
-        // If there was a matched field, obtain it.
-        MatchDetails matchDetails;
-        matchDetails.requestElemMatchKey();
-
-        dassert(cq);
-        verify(cq->root()->matchesBSON(oldObj.value(), &matchDetails));
-
-        string matchedField;
-        if (matchDetails.hasElemMatchKey())
-            matchedField = matchDetails.elemMatchKey();
-
-        status = driver->update(matchedField,
-                                &_doc,
-                                validateForStorage,
-                                immutablePaths,
-                                isInsert,
-                                &logObj,
-                                &docWasModified);
-    }
 
-    if (!status.isOK()) {
-        uasserted(16837, status.reason());
+    // If the update only overwrites fixed-width values, the driver can compute the damages from
+    // the old document directly. Changes to the shard key are left to the mutable document, which
+    // the shard key update checks below read from.
+    const char* source = nullptr;
+    bool inPlace = false;
+    bool appliedToBSON = false;
+    if (collection()->updateWithDamagesSupported()) {
+        FieldRefSet protectedPaths;
+        for (auto&& path : immutablePaths) {
+            protectedPaths.insert(path);
+        }
+        if (collDesc.isSharded()) {
+            protectedPaths.fillFrom(collDesc.getKeyPatternFields());
+        }
+        appliedToBSON = driver->updateInPlace(
+            oldObj.value(), protectedPaths, &_damages, &source, &logObj, &docWasModified);
+        inPlace = appliedToBSON;
     }
 
-    // Skip adding _id field if the collection is capped (since capped collection documents can
-    // neither grow nor shrink).
-    const auto createIdField = !collection()->isCapped();
+    if (!inPlace) {
+        // Ask the driver to apply the mods. It may be that the driver can apply those "in
+        // place", that is, some values of the old document just get adjusted without any
+        // change to the binary layout on the bson layer. It may be that a whole new document
+        // is needed to accomodate the new bson layout of the resulting document. In any event,
+        // only enable in-place mutations if the underlying storage engine offers support for
+        // writing damage events.
+        _doc.reset(oldObj.value(),
+                   (collection()->updateWithDamagesSupported()
+                        ? mutablebson::Document::kInPlaceEnabled
+                        : mutablebson::Document::kInPlaceDisabled));
+
+        Status status = Status::OK();
+        if (!driver->needMatchDetails()) {
+            // If we don't need match details, avoid doing the rematch
+            status = driver->update(StringData(),
+                                    &_doc,
+                                    validateForStorage,
+                                    immutablePaths,
+                                    isInsert,
+                                    &logObj,
+                                    &docWasModified);
+        } else {
+            // If there was a matched field, obtain it.
+            MatchDetails matchDetails;
+            matchDetails.requestElemMatchKey();
+
+            dassert(cq);
+            verify(cq->root()->matchesBSON(oldObj.value(), &matchDetails));
+
+            string matchedField;
+            if (matchDetails.hasElemMatchKey())
+                matchedField = matchDetails.elemMatchKey();
+
+            status = driver->update(matchedField,
+                                    &_doc,
+                                    validateForStorage,
+                                    immutablePaths,
+                                    isInsert,
+                                    &logObj,
+                                    &docWasModified);
+        }
+
+        if (!status.isOK()) {
+            uasserted(16837, status.reason());
+        }
 
-    // Ensure _id is first if it exists, and generate a new OID if appropriate.
-    _ensureIdFieldIsFirst(&_doc, createIdField);
+        // Skip adding _id field if the collection is capped (since capped collection documents
+        // can neither grow nor shrink).
+        const auto createIdField = !collection()->isCapped();
 
-    // See if the changes were applied in place
-    const char* source = nullptr;
-    const bool inPlace = _doc.getInPlaceUpdates(&_damages, &source);
+        // Ensure _id is first if it exists, and generate a new OID if appropriate.
+        _ensureIdFieldIsFirst(&_doc, createIdField);
+
+        // See if the changes were applied in place
+        inPlace = _doc.getInPlaceUpdates(&_damages, &source);
+    }
 
     if (inPlace && _damages.empty()) {
         // An interesting edge case. A modifier didn't notice that it was really a no-op
@@ -270,7 +292,8 @@ BSONObj UpdateStage::transformAndUpdate(const Snapshotted<BSONObj>& oldObj, Reco
 
                 Snapshotted<RecordData> snap(oldObj.snapshotId(), oldRec);
 
-                if (collDesc.isSharded() && _shouldCheckForShardKeyUpdate) {
+                // An update applied to the BSON directly never changes the shard key.
+                if (!appliedToBSON && collDesc.isSharded() && _shouldCheckForShardKeyUpdate) {
                     bool changesShardKeyOnSameNode =
                         checkUpdateChangesShardKeyFields(collDesc, oldObj);
                     if (changesShardKeyOnSameNode && !args.preImageDoc) {
@@ -38,13 +38,18 @@
 namespace mongo {
 
 /**
- * Compesses and uncompresses a block of buffer using zlib.
+ * Compesses and uncompresses a block of buffer using zlib or zstd.
  */
 class BlockCompressor {
     BlockCompressor(const BlockCompressor&) = delete;
     BlockCompressor& operator=(const BlockCompressor&) = delete;
 
 public:
+    enum class Algorithm {
+        kZlib,
+        kZstd,
+    };
+
     BlockCompressor() = default;
 
     /**
@@ -53,7 +58,8 @@ public:
      * Returns a pointer to a buffer that BlockCompressor owns.
      * The returned buffer is valid until the next call to compress or uncompress.
      */
-    StatusWith<ConstDataRange> compress(ConstDataRange source);
+    StatusWith<ConstDataRange> compress(ConstDataRange source,
+                                        Algorithm algorithm = Algorithm::kZlib);
 
     /**
      * Uncompress a buffer of data.
@@ -64,9 +70,17 @@ public:
      * Returns a pointer to a buffer that BlockCompressor owns.
      * The returned buffer is valid until the next call to compress or uncompress.
      */
-    StatusWith<ConstDataRange> uncompress(ConstDataRange source, size_t maxUncompressedLength);
+    StatusWith<ConstDataRange> uncompress(ConstDataRange source,
+                                          size_t maxUncompressedLength,
+                                          Algorithm algorithm = Algorithm::kZlib);
 
 private:
+    StatusWith<ConstDataRange> _compressZlib(ConstDataRange source);
+    StatusWith<ConstDataRange> _compressZstd(ConstDataRange source);
+
+    StatusWith<ConstDataRange> _uncompressZlib(ConstDataRange source, size_t uncompressedLength);
+    StatusWith<ConstDataRange> _uncompressZstd(ConstDataRange source, size_t uncompressedLength);
+
     std::vector<std::uint8_t> _buffer;
 };
 
@@ -133,6 +133,7 @@ StatusWith<std::tuple<ConstDataRange, Date_t>> FTDCCompressor::getCompressedSamp
         DataBuilder db(_metricsCount * _deltaCount * FTDCVarInt::kMaxSizeBytes64 / 2);
 
         std::uint32_t zeroesCount = 0;
+        const bool deltaOfDelta = _formatVersion >= kMetricChunkFormatVersion2;
 
         // For each set of samples for a particular metric,
         // we think of it is simple array of 64-bit integers we try to compress into a byte array.
@@ -140,17 +141,27 @@ StatusWith<std::tuple<ConstDataRange, Date_t>> FTDCCompressor::getCompressedSamp
         // 1. Delta Compression
         //   - i.e., we store the difference between pairs of samples, not their absolute values
         //   - this is done in addSamples
+        //   - for format version 2, we store the zigzag encoded difference between consecutive
+        //     deltas instead, which is zero for metrics changing at a constant rate
         // 2. Run Length Encoding of zeros
         //   - We find consecutive sets of zeros and represent them as a tuple of (0, count - 1).
         //   - Each memeber is stored as VarInt packed integer
         // 3. Finally, for non-zero members, we store these as VarInt packed
         //
         // These byte arrays are added to a buffer which is then concatenated with other chunks and
-        // compressed with ZLIB.
+        // compressed with ZLIB, or ZSTD for format version 2.
         for (std::uint32_t i = 0; i < _metricsCount; i++) {
+            std::uint64_t prevDelta = 0;
+
             for (std::uint32_t j = 0; j < _deltaCount; j++) {
                 std::uint64_t delta = _deltas[getArrayOffset(_maxDeltas, j, i)];
 
+                if (deltaOfDelta) {
+                    std::uint64_t current = delta;
+                    delta = zigZagEncode(current - prevDelta);
+                    prevDelta = current;
+                }
+
                 if (delta == 0) {
                     ++zeroesCount;
                     continue;
@@ -199,7 +210,9 @@ StatusWith<std::tuple<ConstDataRange, Date_t>> FTDCCompressor::getCompressedSamp
     }
 
     auto swDest = _compressor.compress(
-        ConstDataRange(_uncompressedChunkBuffer.buf(), _uncompressedChunkBuffer.len()));
+        ConstDataRange(_uncompressedChunkBuffer.buf(), _uncompressedChunkBuffer.len()),
+        _formatVersion >= kMetricChunkFormatVersion2 ? BlockCompressor::Algorithm::kZstd
+                                                     : BlockCompressor::Algorithm::kZlib);
 
     // The only way for compression to fail is if the buffer size calculations are wrong
     if (!swDest.isOK()) {
@@ -208,6 +221,11 @@ StatusWith<std::tuple<ConstDataRange, Date_t>> FTDCCompressor::getCompressedSamp
 
     _compressedChunkBuffer.setlen(0);
 
+    if (_formatVersion >= kMetricChunkFormatVersion2) {
+        _compressedChunkBuffer.appendNum(kMetricChunkFormatMarker);
+        _compressedChunkBuffer.appendNum(_formatVersion);
+    }
+
     _compressedChunkBuffer.appendNum(static_cast<std::uint32_t>(_uncompressedChunkBuffer.len()));
 
     _compressedChunkBuffer.appendBuf(swDest.getValue().data(), swDest.getValue().length());
@@ -226,6 +244,7 @@ void FTDCCompressor::reset() {
 void FTDCCompressor::_reset(const BSONObj& referenceDoc, Date_t date) {
     _referenceDoc = referenceDoc;
     _referenceDocDate = date;
+    _formatVersion = _config->metricChunkFormatVersion;
 
     _metricsCount = _metrics.size();
     _deltaCount = 0;
@@ -56,6 +56,12 @@ namespace mongo {
  * 4. Encodes zeros in Run Length Encoded pairs of <Count, Zero>
  * 5. ZLIB compresses the final processed array
  *
+ * Format version 2 (see FTDCConfig::metricChunkFormatVersion) replaces each delta with the zigzag
+ * encoded difference from the previous delta of the same metric before step 3, so that counters
+ * which grow at a steady rate become runs of zeros, and uses ZSTD instead of ZLIB in step 5. A
+ * version 2 chunk is prefixed with kMetricChunkFormatMarker and the format version so that
+ * FTDCDecompressor can tell the two formats apart.
+ *
  * NOTE: This compression ignores non-number data, and assumes the non-number data is constant
  * across all documents in the series of documents.
  */
@@ -80,6 +86,15 @@ public:
         kCompressorFull,
     };
 
+    /**
+     * Version 1 chunks start with the uncompressed length, which never exceeds the decompressor's
+     * limit. Later versions start with this marker followed by the format version.
+     */
+    static constexpr std::uint32_t kMetricChunkFormatMarker = 0xFFFFFFFF;
+
+    static constexpr std::uint32_t kMetricChunkFormatVersion1 = 1;
+    static constexpr std::uint32_t kMetricChunkFormatVersion2 = 2;
+
     explicit FTDCCompressor(const FTDCConfig* config) : _config(config) {}
 
     /**
@@ -144,6 +159,18 @@ public:
         return metric * sampleCount + sample;
     }
 
+    /**
+     * Map a signed difference onto an unsigned integer so that small magnitudes, positive or
+     * negative, have small VarInt encodings.
+     */
+    static std::uint64_t zigZagEncode(std::uint64_t value) {
+        return (value << 1) ^ static_cast<std::uint64_t>(static_cast<std::int64_t>(value) >> 63);
+    }
+
+    static std::uint64_t zigZagDecode(std::uint64_t value) {
+        return (value >> 1) ^ (~(value & 1) + 1);
+    }
+
 private:
     /**
      * Reset the state
@@ -157,6 +184,10 @@ private:
     // Config
     const FTDCConfig* const _config;
 
+    // Format version of the current chunk, captured when the reference document is set so that a
+    // runtime change only applies to the next chunk.
+    std::uint32_t _formatVersion{kMetricChunkFormatVersion1};
+
     // Reference schema document
     BSONObj _referenceDoc;
 
@@ -32,6 +32,8 @@
 #include <limits>
 #include <random>
 
+#include "mongo/base/data_range_cursor.h"
+#include "mongo/base/data_type_endian.h"
 #include "mongo/base/status_with.h"
 #include "mongo/bson/bsonmisc.h"
 #include "mongo/bson/bsonobjbuilder.h"
@@ -122,8 +124,11 @@ TEST_F(FTDCCompressorTest, TestStrings) {
  */
 class TestTie {
 public:
-    TestTie(FTDCValidationMode mode = FTDCValidationMode::kStrict)
-        : _compressor(&_config), _mode(mode) {}
+    TestTie(FTDCValidationMode mode = FTDCValidationMode::kStrict,
+            std::uint32_t formatVersion = FTDCConfig::kMetricChunkFormatVersionDefault)
+        : _compressor(&_config), _mode(mode) {
+        _config.metricChunkFormatVersion = formatVersion;
+    }
 
     ~TestTie() {
         validate(boost::none);
@@ -537,4 +542,119 @@ TEST_F(FTDCCompressorTest, TestManyMetrics) {
     }
 }
 
+// Test the zigzag mapping used by the delta of delta encoding
+TEST_F(FTDCCompressorTest, TestZigZag) {
+    ASSERT_EQUALS(FTDCCompressor::zigZagEncode(0), 0ULL);
+    ASSERT_EQUALS(FTDCCompressor::zigZagEncode(static_cast<std::uint64_t>(-1)), 1ULL);
+    ASSERT_EQUALS(FTDCCompressor::zigZagEncode(1), 2ULL);
+    ASSERT_EQUALS(FTDCCompressor::zigZagEncode(static_cast<std::uint64_t>(-2)), 3ULL);
+
+    for (std::int64_t value : {std::numeric_limits<std::int64_t>::min(),
+                               std::numeric_limits<std::int64_t>::min() + 1,
+                               -1000LL,
+                               0LL,
+                               1000LL,
+                               std::numeric_limits<std::int64_t>::max()}) {
+        auto encoded = FTDCCompressor::zigZagEncode(static_cast<std::uint64_t>(value));
+        ASSERT_EQUALS(static_cast<std::int64_t>(FTDCCompressor::zigZagDecode(encoded)), value);
+    }
+}
+
+// Test both chunk formats round trip counters, gauges, and values that go backwards or negative
+TEST_F(FTDCCompressorTest, TestFormatVersions) {
+    for (std::uint32_t version : {FTDCCompressor::kMetricChunkFormatVersion1,
+                                  FTDCCompressor::kMetricChunkFormatVersion2}) {
+        TestTie c(FTDCValidationMode::kStrict, version);
+
+        auto makeSample = [](long long i) {
+            return BSON("name"
+                        << "joe"
+                        << "steady" << 1000 + 7 * i << "constant" << 42 << "falling" << -3 * i
+                        << "sawtooth" << i % 5 << "jumpy"
+                        << ((i % 17 == 0) ? std::numeric_limits<long long>::max() : i * i));
+        };
+
+        auto st = c.addSample(makeSample(0));
+        ASSERT_HAS_SPACE(st);
+
+        for (size_t i = 1; i != FTDCConfig::kMaxSamplesPerArchiveMetricChunkDefault - 1; i++) {
+            st = c.addSample(makeSample(i));
+            ASSERT_HAS_SPACE(st);
+        }
+
+        st = c.addSample(makeSample(FTDCConfig::kMaxSamplesPerArchiveMetricChunkDefault - 1));
+        ASSERT_FULL(st);
+
+        // Only the new format carries the marker
+        ConstDataRangeCursor cursor(std::get<0>(st.getValue().get()));
+        auto first = cursor.readAndAdvance<LittleEndian<std::uint32_t>>().value;
+        if (version == FTDCCompressor::kMetricChunkFormatVersion1) {
+            ASSERT_NOT_EQUALS(first, FTDCCompressor::kMetricChunkFormatMarker);
+        } else {
+            ASSERT_EQUALS(first, FTDCCompressor::kMetricChunkFormatMarker);
+            ASSERT_EQUALS(cursor.readAndAdvance<LittleEndian<std::uint32_t>>().value, version);
+        }
+
+        st = c.addSample(makeSample(0));
+        ASSERT_HAS_SPACE(st);
+    }
+}
+
+// Test that counters whose rate changes steadily compress better with the delta of delta format
+TEST_F(FTDCCompressorTest, TestDeltaOfDeltaIsSmaller) {
+    auto compressedSize = [](std::uint32_t version) {
+        FTDCConfig config;
+        config.metricChunkFormatVersion = version;
+        FTDCCompressor c(&config);
+
+        for (size_t i = 0; i != FTDCConfig::kMaxSamplesPerArchiveMetricChunkDefault - 1; i++) {
+            BSONObjBuilder builder;
+            for (int j = 0; j < 100; ++j) {
+                builder.append("counter", static_cast<long long>(i * i * (j + 1)));
+            }
+
+            auto st = c.addSample(builder.obj(), Date_t());
+            ASSERT_HAS_SPACE(st);
+        }
+
+        auto swBuf = c.getCompressedSamples();
+        ASSERT_OK(swBuf.getStatus());
+        return std::get<0>(swBuf.getValue()).length();
+    };
+
+    ASSERT_LESS_THAN(compressedSize(FTDCCompressor::kMetricChunkFormatVersion2),
+                     compressedSize(FTDCCompressor::kMetricChunkFormatVersion1));
+}
+
+// Test that new chunks use the original format unless the new one is asked for
+TEST_F(FTDCCompressorTest, TestDefaultFormatVersionIsOriginalFormat) {
+    FTDCConfig config;
+    ASSERT_EQUALS(config.metricChunkFormatVersion, FTDCCompressor::kMetricChunkFormatVersion1);
+
+    FTDCCompressor c(&config);
+    auto st = c.addSample(BSON("name"
+                               << "joe"
+                               << "key1" << 33),
+                          Date_t());
+    ASSERT_HAS_SPACE(st);
+
+    auto swBuf = c.getCompressedSamples();
+    ASSERT_OK(swBuf.getStatus());
+    ConstDataRangeCursor cursor(std::get<0>(swBuf.getValue()));
+    ASSERT_NOT_EQUALS(cursor.readAndAdvance<LittleEndian<std::uint32_t>>().value,
+                      FTDCCompressor::kMetricChunkFormatMarker);
+}
+
+// Test that a chunk from an unknown future format is rejected
+TEST_F(FTDCCompressorTest, TestUnknownFormatVersion) {
+    BufBuilder builder;
+    builder.appendNum(FTDCCompressor::kMetricChunkFormatMarker);
+    builder.appendNum(static_cast<std::uint32_t>(3));
+    builder.appendNum(static_cast<std::uint32_t>(16));
+
+    FTDCDecompressor decompressor;
+    auto sw = decompressor.uncompress(ConstDataRange(builder.buf(), builder.len()));
+    ASSERT_EQUALS(sw.getStatus(), ErrorCodes::BadValue);
+}
+
 }  // namespace mongo
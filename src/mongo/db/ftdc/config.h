@@ -47,7 +47,9 @@ struct FTDCConfig {
           maxFileSizeBytes(kMaxFileSizeBytesDefault),
           period(kPeriodMillisDefault),
           maxSamplesPerArchiveMetricChunk(kMaxSamplesPerArchiveMetricChunkDefault),
-          maxSamplesPerInterimMetricChunk(kMaxSamplesPerInterimMetricChunkDefault) {}
+          maxSamplesPerInterimMetricChunk(kMaxSamplesPerInterimMetricChunkDefault),
+          metricChunkFormatVersion(kMetricChunkFormatVersionDefault),
+          anomalyPeriod(kAnomalyPeriodMillisDefault) {}
 
     /**
      * True if FTDC is collecting data. False otherwise
@@ -84,6 +86,19 @@ struct FTDCConfig {
      */
     std::uint32_t maxSamplesPerInterimMetricChunk;
 
+    /**
+     * Format version of new metric chunks. Version 1 is delta + ZLIB, version 2 is delta of
+     * delta + ZSTD. See FTDCCompressor. Version 2 is opt-in, because tools that only read version 1
+     * cannot decode it.
+     */
+    std::uint32_t metricChunkFormatVersion;
+
+    /**
+     * Period at which to run FTDC for a while after the collector notices a latency anomaly in
+     * the server status operation latencies. Zero disables the faster sampling.
+     */
+    Milliseconds anomalyPeriod;
+
     static const bool kEnabledDefault = true;
 
     static const std::int64_t kPeriodMillisDefault;
@@ -94,6 +109,10 @@ struct FTDCConfig {
 
     static const std::uint32_t kMaxSamplesPerArchiveMetricChunkDefault = 300;
     static const std::uint32_t kMaxSamplesPerInterimMetricChunkDefault = 10;
+
+    static const std::uint32_t kMetricChunkFormatVersionDefault = 1;
+
+    static const std::int64_t kAnomalyPeriodMillisDefault;
 };
 
 }  // namespace mongo
@@ -33,6 +33,7 @@
 
 #include "mongo/db/ftdc/controller.h"
 
+#include <algorithm>
 #include <memory>
 
 #include "mongo/db/client.h"
@@ -49,6 +50,13 @@
 
 namespace mongo {
 
+namespace {
+
+// How long to keep collecting at the anomaly period after the last anomalous sample.
+const Seconds kAnomalyBoostDuration{60};
+
+}  // namespace
+
 Status FTDCController::setEnabled(bool enabled) {
     stdx::lock_guard<Latch> lock(_mutex);
 
@@ -94,6 +102,18 @@ void FTDCController::setMaxSamplesPerInterimMetricChunk(size_t size) {
     _condvar.notify_one();
 }
 
+void FTDCController::setMetricChunkFormatVersion(std::uint32_t version) {
+    stdx::lock_guard<Latch> lock(_mutex);
+    _configTemp.metricChunkFormatVersion = version;
+    _condvar.notify_one();
+}
+
+void FTDCController::setAnomalyPeriod(Milliseconds millis) {
+    stdx::lock_guard<Latch> lock(_mutex);
+    _configTemp.anomalyPeriod = millis;
+    _condvar.notify_one();
+}
+
 Status FTDCController::setDirectory(const boost::filesystem::path& path) {
     stdx::lock_guard<Latch> lock(_mutex);
 
@@ -188,6 +208,14 @@ void FTDCController::stop() {
     }
 }
 
+Milliseconds FTDCController::_currentPeriod(Date_t now) const {
+    if (now < _anomalyBoostUntil && _config.anomalyPeriod > Milliseconds(0)) {
+        return std::min(_config.period, _config.anomalyPeriod);
+    }
+
+    return _config.period;
+}
+
 void FTDCController::doLoop() noexcept {
     // Note: All exceptions thrown in this loop are considered process fatal. The default terminate
     // is used to provide a good stack trace of the issue.
@@ -206,7 +234,7 @@ void FTDCController::doLoop() noexcept {
         auto now = getGlobalServiceContext()->getPreciseClockSource()->now();
 
         // Get next time to run at
-        auto next_time = FTDCUtil::roundTime(now, _config.period);
+        auto next_time = FTDCUtil::roundTime(now, _currentPeriod(now));
 
         // Wait for the next run or signal to shutdown
         {
@@ -258,6 +286,19 @@ void FTDCController::doLoop() noexcept {
                 stdx::lock_guard<Latch> lock(_mutex);
                 _mostRecentPeriodicDocument = std::get<0>(collectSample);
             }
+
+            if (_anomalyDetector.observe(std::get<0>(collectSample)) &&
+                _config.anomalyPeriod > Milliseconds(0) &&
+                _config.anomalyPeriod < _config.period) {
+                if (_anomalyBoostUntil <= std::get<1>(collectSample)) {
+                    LOGV2(4911800,
+                          "Operation latency anomaly detected, increasing full-time diagnostic "
+                          "data capture frequency",
+                          "period"_attr = _config.anomalyPeriod,
+                          "duration"_attr = kAnomalyBoostDuration);
+                }
+                _anomalyBoostUntil = std::get<1>(collectSample) + kAnomalyBoostDuration;
+            }
         }
     }
 }
@@ -36,6 +36,7 @@
 #include "mongo/db/ftdc/collector.h"
 #include "mongo/db/ftdc/config.h"
 #include "mongo/db/ftdc/file_manager.h"
+#include "mongo/db/ftdc/latency_anomaly_detector.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/platform/mutex.h"
 #include "mongo/stdx/condition_variable.h"
@@ -99,6 +100,18 @@ public:
      */
     void setMaxSamplesPerInterimMetricChunk(size_t size);
 
+    /**
+     * Set the format version of new metric chunks. The chunk currently being filled keeps its
+     * format.
+     */
+    void setMetricChunkFormatVersion(std::uint32_t version);
+
+    /**
+     * Set the period for data collection while operation latencies are anomalous. Zero disables
+     * the faster collection.
+     */
+    void setAnomalyPeriod(Milliseconds millis);
+
     /*
      * Set the path to store FTDC files if not already set.
      *
@@ -148,6 +161,12 @@ private:
      */
     void doLoop() noexcept;
 
+    /**
+     * Period to use for the next collection, which is shorter while a latency anomaly is being
+     * investigated.
+     */
+    Milliseconds _currentPeriod(Date_t now) const;
+
 private:
     /**
      * Private enum to track state.
@@ -207,6 +226,12 @@ private:
     // Set of file rotation collectors
     FTDCCollectorCollection _rotateCollectors;
 
+    // Watches the periodic samples for operation latency anomalies, background thread only
+    FTDCLatencyAnomalyDetector _anomalyDetector;
+
+    // Collect at _config.anomalyPeriod until this time, background thread only
+    Date_t _anomalyBoostUntil;
+
     // File manager that manages file rotation, and logging
     std::unique_ptr<FTDCFileManager> _mgr;
 
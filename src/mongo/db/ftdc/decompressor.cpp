@@ -39,19 +39,43 @@
 #include "mongo/db/jsobj.h"
 #include "mongo/rpc/object_check.h"
 #include "mongo/util/assert_util.h"
+#include "mongo/util/str.h"
 
 namespace mongo {
 
 StatusWith<std::vector<BSONObj>> FTDCDecompressor::uncompress(ConstDataRange buf) {
     ConstDataRangeCursor compressedDataRange(buf);
 
-    // Read the length of the uncompressed buffer
+    // Read the length of the uncompressed buffer, or the marker of a versioned chunk
     auto swUncompressedLength =
         compressedDataRange.readAndAdvanceNoThrow<LittleEndian<std::uint32_t>>();
     if (!swUncompressedLength.isOK()) {
         return {swUncompressedLength.getStatus()};
     }
 
+    std::uint32_t formatVersion = FTDCCompressor::kMetricChunkFormatVersion1;
+
+    if (swUncompressedLength.getValue() == FTDCCompressor::kMetricChunkFormatMarker) {
+        auto swFormatVersion =
+            compressedDataRange.readAndAdvanceNoThrow<LittleEndian<std::uint32_t>>();
+        if (!swFormatVersion.isOK()) {
+            return {swFormatVersion.getStatus()};
+        }
+
+        formatVersion = swFormatVersion.getValue();
+        if (formatVersion != FTDCCompressor::kMetricChunkFormatVersion2) {
+            return {ErrorCodes::BadValue,
+                    str::stream() << "Unsupported metrics chunk format version: "
+                                  << formatVersion};
+        }
+
+        swUncompressedLength =
+            compressedDataRange.readAndAdvanceNoThrow<LittleEndian<std::uint32_t>>();
+        if (!swUncompressedLength.isOK()) {
+            return {swUncompressedLength.getStatus()};
+        }
+    }
+
     // Now uncompress the data
     // Limit size of the buffer we need zlib
     auto uncompressedLength = swUncompressedLength.getValue();
@@ -60,7 +84,12 @@ StatusWith<std::vector<BSONObj>> FTDCDecompressor::uncompress(ConstDataRange buf
         return Status(ErrorCodes::InvalidLength, "Metrics chunk has exceeded the allowable size.");
     }
 
-    auto statusUncompress = _compressor.uncompress(compressedDataRange, uncompressedLength);
+    auto statusUncompress = _compressor.uncompress(
+        compressedDataRange,
+        uncompressedLength,
+        formatVersion >= FTDCCompressor::kMetricChunkFormatVersion2
+            ? BlockCompressor::Algorithm::kZstd
+            : BlockCompressor::Algorithm::kZlib);
 
     if (!statusUncompress.isOK()) {
         return {statusUncompress.getStatus()};
@@ -159,6 +188,19 @@ StatusWith<std::vector<BSONObj>> FTDCDecompressor::uncompress(ConstDataRange buf
         }
     }
 
+    // Undo the delta of delta encoding
+    if (formatVersion >= FTDCCompressor::kMetricChunkFormatVersion2) {
+        for (std::uint32_t i = 0; i < metricsCount; i++) {
+            std::uint64_t prevDelta = 0;
+
+            for (std::uint32_t j = 0; j < sampleCount; j++) {
+                auto& delta = deltas[FTDCCompressor::getArrayOffset(sampleCount, j, i)];
+                delta = prevDelta + FTDCCompressor::zigZagDecode(delta);
+                prevDelta = delta;
+            }
+        }
+    }
+
     // Inflate the deltas
     for (std::uint32_t i = 0; i < metricsCount; i++) {
         deltas[FTDCCompressor::getArrayOffset(sampleCount, 0, i)] += metrics[i];
@@ -51,6 +51,8 @@ public:
     /**
      * Inflates a compressed chunk of metrics into a vector of owned BSON documents.
      *
+     * Accepts both version 1 and version 2 chunks, see FTDCCompressor.
+     *
      * Will fail if the chunk is corrupt or too short.
      *
      * Returns N samples where N = sample count + 1. The 1 is the reference document.
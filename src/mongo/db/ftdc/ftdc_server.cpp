@@ -169,6 +169,29 @@ Status onUpdateFTDCPerInterimUpdate(const std::int32_t potentialNewValue) {
     return Status::OK();
 }
 
+Status onUpdateFTDCMetricChunkFormatVersion(const std::int32_t potentialNewValue) {
+    auto controller = getGlobalFTDCController();
+    if (controller) {
+        controller->setMetricChunkFormatVersion(potentialNewValue);
+    }
+
+    return Status::OK();
+}
+
+Status onUpdateFTDCAnomalyPeriod(const std::int32_t potentialNewValue) {
+    if (potentialNewValue != 0 && potentialNewValue < 10) {
+        return Status(ErrorCodes::BadValue,
+                      "diagnosticDataCollectionAnomalyPeriodMillis must be 0 or at least 10.");
+    }
+
+    auto controller = getGlobalFTDCController();
+    if (controller) {
+        controller->setAnomalyPeriod(Milliseconds(potentialNewValue));
+    }
+
+    return Status::OK();
+}
+
 FTDCSimpleInternalCommandCollector::FTDCSimpleInternalCommandCollector(StringData command,
                                                                        StringData name,
                                                                        StringData ns,
@@ -207,6 +230,8 @@ void startFTDC(boost::filesystem::path& path,
         ftdcStartupParams.maxSamplesPerArchiveMetricChunk.load();
     config.maxSamplesPerInterimMetricChunk =
         ftdcStartupParams.maxSamplesPerInterimMetricChunk.load();
+    config.metricChunkFormatVersion = ftdcStartupParams.metricChunkFormatVersion.load();
+    config.anomalyPeriod = Milliseconds(ftdcStartupParams.anomalyPeriodMillis.load());
 
     ftdcDirectoryPathParameter = path;
 
@@ -112,6 +112,9 @@ struct FTDCStartupParams {
     AtomicWord<int> maxSamplesPerArchiveMetricChunk;
     AtomicWord<int> maxSamplesPerInterimMetricChunk;
 
+    AtomicWord<int> metricChunkFormatVersion;
+    AtomicWord<int> anomalyPeriodMillis;
+
     FTDCStartupParams()
         : enabled(FTDCConfig::kEnabledDefault),
           periodMillis(FTDCConfig::kPeriodMillisDefault),
@@ -119,7 +122,9 @@ struct FTDCStartupParams {
           maxDirectorySizeMB(FTDCConfig::kMaxDirectorySizeBytesDefault / (1024 * 1024)),
           maxFileSizeMB(FTDCConfig::kMaxFileSizeBytesDefault / (1024 * 1024)),
           maxSamplesPerArchiveMetricChunk(FTDCConfig::kMaxSamplesPerArchiveMetricChunkDefault),
-          maxSamplesPerInterimMetricChunk(FTDCConfig::kMaxSamplesPerInterimMetricChunkDefault) {}
+          maxSamplesPerInterimMetricChunk(FTDCConfig::kMaxSamplesPerInterimMetricChunkDefault),
+          metricChunkFormatVersion(FTDCConfig::kMetricChunkFormatVersionDefault),
+          anomalyPeriodMillis(FTDCConfig::kAnomalyPeriodMillisDefault) {}
 };
 
 extern FTDCStartupParams ftdcStartupParams;
@@ -133,6 +138,8 @@ Status onUpdateFTDCDirectorySize(const std::int32_t value);
 Status onUpdateFTDCFileSize(const std::int32_t value);
 Status onUpdateFTDCSamplesPerChunk(const std::int32_t value);
 Status onUpdateFTDCPerInterimUpdate(const std::int32_t value);
+Status onUpdateFTDCMetricChunkFormatVersion(const std::int32_t value);
+Status onUpdateFTDCAnomalyPeriod(const std::int32_t value);
 
 /**
  * Server Parameter accessors
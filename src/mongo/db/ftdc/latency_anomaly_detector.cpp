@@ -0,0 +1,113 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/ftdc/latency_anomaly_detector.h"
+
+#include <utility>
+
+namespace mongo {
+
+namespace {
+
+// The opLatencies categories that are summed into a single mean.
+constexpr StringData kLatencyCategories[] = {"reads"_sd, "writes"_sd, "commands"_sd};
+
+}  // namespace
+
+boost::optional<FTDCLatencyAnomalyDetector::LatencyTotals>
+FTDCLatencyAnomalyDetector::_extractTotals(const BSONObj& sample) {
+    BSONElement serverStatus = sample["serverStatus"];
+    if (serverStatus.type() != Object) {
+        return boost::none;
+    }
+
+    BSONElement opLatencies = serverStatus.Obj()["opLatencies"];
+    if (opLatencies.type() != Object) {
+        return boost::none;
+    }
+
+    LatencyTotals totals;
+    for (auto category : kLatencyCategories) {
+        BSONElement stats = opLatencies.Obj()[category];
+        if (stats.type() != Object) {
+            return boost::none;
+        }
+
+        BSONElement latency = stats.Obj()["latency"];
+        BSONElement ops = stats.Obj()["ops"];
+        if (!latency.isNumber() || !ops.isNumber()) {
+            return boost::none;
+        }
+
+        totals.latencyMicros += latency.safeNumberLong();
+        totals.ops += ops.safeNumberLong();
+    }
+
+    return totals;
+}
+
+bool FTDCLatencyAnomalyDetector::observe(const BSONObj& sample) {
+    auto totals = _extractTotals(sample);
+    auto prev = std::exchange(_prev, totals);
+
+    if (!totals || !prev) {
+        return false;
+    }
+
+    std::int64_t ops = totals->ops - prev->ops;
+    std::int64_t latencyMicros = totals->latencyMicros - prev->latencyMicros;
+
+    // Counters only go backwards if they were reset, which tells us nothing about this interval.
+    if (ops < kMinIntervalOps || latencyMicros < 0) {
+        return false;
+    }
+
+    double meanMicros = static_cast<double>(latencyMicros) / ops;
+
+    if (_baselineIntervals < kWarmupIntervals) {
+        _baselineMicros = _baselineIntervals == 0
+            ? meanMicros
+            : _baselineMicros + kBaselineWeight * (meanMicros - _baselineMicros);
+        ++_baselineIntervals;
+        return false;
+    }
+
+    if (meanMicros > kAnomalyRatio * _baselineMicros &&
+        meanMicros - _baselineMicros >= kMinAnomalyMicros) {
+        // Leave the baseline alone so that a long anomaly does not become the new normal.
+        return true;
+    }
+
+    _baselineMicros += kBaselineWeight * (meanMicros - _baselineMicros);
+    return false;
+}
+
+}  // namespace mongo
@@ -0,0 +1,95 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <boost/optional.hpp>
+#include <cstdint>
+
+#include "mongo/db/jsobj.h"
+
+namespace mongo {
+
+/**
+ * Watches the periodic FTDC samples for a sudden rise in the mean latency of the operations
+ * reported by the serverStatus opLatencies section.
+ *
+ * Each pair of consecutive samples gives the mean latency of the operations that completed in
+ * between. That mean is compared against an exponentially weighted moving average of the
+ * previous non-anomalous intervals. Intervals with too few operations are ignored since a single
+ * slow operation on an idle server is not an anomaly.
+ *
+ * Not thread safe, used only by the FTDC background thread.
+ */
+class FTDCLatencyAnomalyDetector {
+public:
+    // Weight of the newest interval in the moving average.
+    static constexpr double kBaselineWeight = 0.1;
+
+    // Number of intervals used to establish the baseline before anything is reported.
+    static constexpr int kWarmupIntervals = 10;
+
+    // An interval is anomalous if its mean exceeds the baseline by this factor...
+    static constexpr double kAnomalyRatio = 4.0;
+
+    // ...and by at least this many microseconds.
+    static constexpr std::int64_t kMinAnomalyMicros = 1000;
+
+    // Intervals with fewer completed operations are ignored.
+    static constexpr std::int64_t kMinIntervalOps = 10;
+
+    /**
+     * Consumes the next periodic sample and returns true if the interval ending with it had an
+     * anomalous mean operation latency.
+     */
+    bool observe(const BSONObj& sample);
+
+    /**
+     * Returns the current baseline mean latency in microseconds.
+     */
+    double getBaselineMicros() const {
+        return _baselineMicros;
+    }
+
+private:
+    struct LatencyTotals {
+        std::int64_t latencyMicros{0};
+        std::int64_t ops{0};
+    };
+
+    static boost::optional<LatencyTotals> _extractTotals(const BSONObj& sample);
+
+    boost::optional<LatencyTotals> _prev;
+
+    double _baselineMicros{0};
+
+    int _baselineIntervals{0};
+};
+
+}  // namespace mongo
@@ -0,0 +1,140 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/ftdc/latency_anomaly_detector.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+/**
+ * Builds a periodic sample with the given cumulative latency and operation count split evenly
+ * between reads and writes.
+ */
+BSONObj makeSample(long long latencyMicros, long long ops) {
+    auto stats = [](long long latency, long long count) {
+        return BSON("latency" << latency << "ops" << count);
+    };
+
+    return BSON("start" << Date_t() << "serverStatus"
+                        << BSON("opLatencies"
+                                << BSON("reads" << stats(latencyMicros / 2, ops / 2) << "writes"
+                                                << stats(latencyMicros - latencyMicros / 2,
+                                                         ops - ops / 2)
+                                                << "commands" << stats(0, 0))));
+}
+
+class LatencyAnomalyDetectorTest : public unittest::Test {
+protected:
+    /**
+     * Feeds an interval of the given number of operations at the given mean latency.
+     */
+    bool observeInterval(long long meanMicros, long long ops = 100) {
+        _latency += meanMicros * ops;
+        _ops += ops;
+        return _detector.observe(makeSample(_latency, _ops));
+    }
+
+    void warmUp(long long meanMicros) {
+        ASSERT_FALSE(_detector.observe(makeSample(_latency, _ops)));
+        for (int i = 0; i < FTDCLatencyAnomalyDetector::kWarmupIntervals; ++i) {
+            ASSERT_FALSE(observeInterval(meanMicros));
+        }
+    }
+
+    FTDCLatencyAnomalyDetector _detector;
+    long long _latency{0};
+    long long _ops{0};
+};
+
+TEST_F(LatencyAnomalyDetectorTest, SteadyLatencyIsNotAnomalous) {
+    warmUp(500);
+    ASSERT_APPROX_EQUAL(_detector.getBaselineMicros(), 500.0, 0.001);
+
+    for (int i = 0; i < 100; ++i) {
+        ASSERT_FALSE(observeInterval(450 + (i % 3) * 50));
+    }
+}
+
+TEST_F(LatencyAnomalyDetectorTest, LatencySpikeIsAnomalous) {
+    warmUp(500);
+
+    ASSERT_TRUE(observeInterval(5000));
+
+    // The spike does not move the baseline, so a sustained spike keeps being reported.
+    ASSERT_APPROX_EQUAL(_detector.getBaselineMicros(), 500.0, 0.001);
+    ASSERT_TRUE(observeInterval(5000));
+
+    ASSERT_FALSE(observeInterval(500));
+}
+
+TEST_F(LatencyAnomalyDetectorTest, SmallAbsoluteIncreaseIsNotAnomalous) {
+    warmUp(50);
+
+    // Ten times the baseline, but well under a millisecond.
+    ASSERT_FALSE(observeInterval(500));
+}
+
+TEST_F(LatencyAnomalyDetectorTest, NothingIsReportedDuringWarmup) {
+    ASSERT_FALSE(_detector.observe(makeSample(_latency, _ops)));
+    ASSERT_FALSE(observeInterval(500));
+    ASSERT_FALSE(observeInterval(50000));
+}
+
+TEST_F(LatencyAnomalyDetectorTest, QuietIntervalsAreIgnored) {
+    warmUp(500);
+
+    ASSERT_FALSE(observeInterval(50000, FTDCLatencyAnomalyDetector::kMinIntervalOps - 1));
+    ASSERT_TRUE(observeInterval(50000, FTDCLatencyAnomalyDetector::kMinIntervalOps));
+}
+
+TEST_F(LatencyAnomalyDetectorTest, MissingOrResetCountersAreIgnored) {
+    warmUp(500);
+
+    ASSERT_FALSE(_detector.observe(BSON("serverStatus" << BSON("ok" << 1))));
+
+    // The first sample after a gap only establishes the new starting point.
+    _latency += 5000 * 100;
+    _ops += 100;
+    ASSERT_FALSE(_detector.observe(makeSample(_latency, _ops)));
+
+    // Counters going backwards are not an interval.
+    _latency = 0;
+    _ops = 0;
+    ASSERT_FALSE(_detector.observe(makeSample(_latency, _ops)));
+
+    ASSERT_TRUE(observeInterval(5000));
+}
+
+}  // namespace
+}  // namespace mongo
@@ -65,6 +65,7 @@ const char kFTDCCollectStartField[] = "start";
 const char kFTDCCollectEndField[] = "end";
 
 const std::int64_t FTDCConfig::kPeriodMillisDefault = 1000;
+const std::int64_t FTDCConfig::kAnomalyPeriodMillisDefault = 100;
 
 const std::size_t kMaxRecursion = 10;
 
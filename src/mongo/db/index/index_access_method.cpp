@@ -158,37 +158,47 @@ Status AbstractIndexAccessMethod::insertKeys(OperationContext* opCtx,
     // the multikey metadata keys, they should point to the reserved 'kMultikeyMetadataKeyId'.
     for (const auto keyVec : {&keys, &multikeyMetadataKeys}) {
         for (const auto& keyString : *keyVec) {
-            bool unique = _descriptor->unique();
-            Status status = _newInterface->insert(opCtx, keyString, !unique /* dupsAllowed */);
-
-            // When duplicates are encountered and allowed, retry with dupsAllowed. Add the
-            // key to the output vector so callers know which duplicate keys were inserted.
-            if (ErrorCodes::DuplicateKey == status.code() && options.dupsAllowed) {
-                invariant(unique);
-                status = _newInterface->insert(opCtx, keyString, true /* dupsAllowed */);
-
-                if (status.isOK() && result) {
-                    auto key =
-                        KeyString::toBson(keyString, getSortedDataInterface()->getOrdering());
-                    result->dupsInserted.push_back(key);
-                }
-            }
-            if (isFatalError(opCtx, status, keyString)) {
+            Status status = insertKey(opCtx, keyString, options, result);
+            if (!status.isOK()) {
                 return status;
             }
         }
     }
 
-    if (result) {
-        result->numInserted += keys.size() + multikeyMetadataKeys.size();
-    }
-
     if (shouldMarkIndexAsMultikey(keys.size(), multikeyMetadataKeys, multikeyPaths)) {
         _indexCatalogEntry->setMultikey(opCtx, multikeyPaths);
     }
     return Status::OK();
 }
 
+Status AbstractIndexAccessMethod::insertKey(OperationContext* opCtx,
+                                            const KeyString::Value& keyString,
+                                            const InsertDeleteOptions& options,
+                                            InsertResult* result) {
+    bool unique = _descriptor->unique();
+    Status status = _newInterface->insert(opCtx, keyString, !unique /* dupsAllowed */);
+
+    // When duplicates are encountered and allowed, retry with dupsAllowed. Add the key to the
+    // output vector so callers know which duplicate keys were inserted.
+    if (ErrorCodes::DuplicateKey == status.code() && options.dupsAllowed) {
+        invariant(unique);
+        status = _newInterface->insert(opCtx, keyString, true /* dupsAllowed */);
+
+        if (status.isOK() && result) {
+            auto key = KeyString::toBson(keyString, getSortedDataInterface()->getOrdering());
+            result->dupsInserted.push_back(key);
+        }
+    }
+    if (isFatalError(opCtx, status, keyString)) {
+        return status;
+    }
+
+    if (result) {
+        ++result->numInserted;
+    }
+    return Status::OK();
+}
+
 void AbstractIndexAccessMethod::removeOneKey(OperationContext* opCtx,
                                              const KeyString::Value& keyString,
                                              const RecordId& loc,
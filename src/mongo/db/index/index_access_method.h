@@ -98,6 +98,16 @@ public:
                               const InsertDeleteOptions& options,
                               InsertResult* result) = 0;
 
+    /**
+     * Inserts a single key, which must end with the RecordId it points to, handling duplicates in
+     * a unique index as insertKeys() does. Unlike insertKeys(), does not mark the index multikey,
+     * which is left to the caller. Lets the keys of several documents be inserted in key order.
+     */
+    virtual Status insertKey(OperationContext* opCtx,
+                             const KeyString::Value& keyString,
+                             const InsertDeleteOptions& options,
+                             InsertResult* result) = 0;
+
     /**
      * Analogous to insertKeys above, but remove the keys instead of inserting them.
      * 'numDeleted' will be set to the number of keys removed from the index for the provided keys.
@@ -463,6 +473,11 @@ public:
                       const InsertDeleteOptions& options,
                       InsertResult* result) final;
 
+    Status insertKey(OperationContext* opCtx,
+                     const KeyString::Value& keyString,
+                     const InsertDeleteOptions& options,
+                     InsertResult* result) final;
+
     Status removeKeys(OperationContext* opCtx,
                       const KeyStringSet& keys,
                       const RecordId& loc,
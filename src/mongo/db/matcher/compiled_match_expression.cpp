@@ -0,0 +1,247 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/matcher/compiled_match_expression.h"
+
+#include <absl/container/inlined_vector.h>
+
+#include "mongo/db/field_ref.h"
+#include "mongo/db/matcher/expression_path.h"
+#include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+
+namespace {
+
+/**
+ * Returns true if 'path' can be resolved by walking sub-objects one field name at a time.
+ */
+bool isResolvablePath(StringData path) {
+    if (path.empty()) {
+        return false;
+    }
+
+    FieldRef fieldRef(path);
+    for (size_t i = 0; i < fieldRef.numParts(); ++i) {
+        if (fieldRef.getPart(i).empty()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
+std::unique_ptr<CompiledMatchExpression> CompiledMatchExpression::compile(
+    const MatchExpression* root) {
+    const int minPathPredicates = internalQueryMatchPathTrieMinLeaves.load();
+    if (!root || minPathPredicates == 0) {
+        return nullptr;
+    }
+
+    std::unique_ptr<CompiledMatchExpression> compiled(new CompiledMatchExpression());
+    compiled->_trie.emplace_back();
+    compiled->_root = compiled->_compileNode(root);
+
+    if (compiled->_numPathPredicates < static_cast<size_t>(minPathPredicates)) {
+        return nullptr;
+    }
+    return compiled;
+}
+
+CompiledMatchExpression::EvalNode CompiledMatchExpression::_compileNode(
+    const MatchExpression* expr) {
+    EvalNode node;
+    node.expr = expr;
+
+    switch (expr->matchType()) {
+        case MatchExpression::AND:
+            node.op = EvalNode::Op::kAnd;
+            break;
+        case MatchExpression::OR:
+            node.op = EvalNode::Op::kOr;
+            break;
+        case MatchExpression::NOR:
+            node.op = EvalNode::Op::kNor;
+            break;
+        case MatchExpression::NOT:
+            node.op = EvalNode::Op::kNot;
+            break;
+        default: {
+            // PathMatchExpression::matches() is final: it walks the path and calls
+            // matchesSingleElement() on each element found, which is exactly what the document
+            // walk lets us do without walking the path again.
+            auto pathExpr = dynamic_cast<const PathMatchExpression*>(expr);
+            if (pathExpr && isResolvablePath(pathExpr->path())) {
+                node.op = EvalNode::Op::kPath;
+                node.slot = _addPath(pathExpr->path());
+                ++_numPathPredicates;
+            } else {
+                node.op = EvalNode::Op::kOther;
+            }
+            return node;
+        }
+    }
+
+    node.children.reserve(expr->numChildren());
+    for (size_t i = 0; i < expr->numChildren(); ++i) {
+        node.children.push_back(_compileNode(expr->getChild(i)));
+    }
+    return node;
+}
+
+size_t CompiledMatchExpression::_addPath(StringData path) {
+    FieldRef fieldRef(path);
+
+    // Walk down the trie, creating nodes as needed. '_trie' may reallocate, so only hold indices.
+    std::vector<size_t> pathNodes;
+    size_t current = 0;
+    for (size_t i = 0; i < fieldRef.numParts(); ++i) {
+        const auto part = fieldRef.getPart(i);
+        auto it = _trie[current].children.find(part);
+        if (it != _trie[current].children.end()) {
+            current = it->second;
+        } else {
+            const size_t child = _trie.size();
+            _trie.emplace_back();
+            _trie[current].children.emplace(part.toString(), child);
+            current = child;
+        }
+        pathNodes.push_back(current);
+    }
+
+    if (_trie[current].slot >= 0) {
+        // Another predicate already resolves this path.
+        return _trie[current].slot;
+    }
+
+    const size_t slot = _numPaths++;
+    _trie[current].slot = slot;
+    for (auto node : pathNodes) {
+        _trie[node].subtreeSlots.push_back(slot);
+    }
+    return slot;
+}
+
+bool CompiledMatchExpression::matches(const BSONObj& doc) const {
+    absl::InlinedVector<Slot, 16> slots(_numPaths);
+    absl::InlinedVector<bool, 32> visited(_trie.size(), false);
+    _resolve(0, doc, slots.data(), visited.data());
+    return _evaluate(_root, doc, slots.data());
+}
+
+void CompiledMatchExpression::_resolve(size_t trieIndex,
+                                       const BSONObj& obj,
+                                       Slot* slots,
+                                       bool* visited) const {
+    const TrieNode& parent = _trie[trieIndex];
+    size_t remaining = parent.children.size();
+
+    BSONObjIterator it(obj);
+    while (remaining > 0 && it.more()) {
+        const BSONElement elem = it.next();
+        auto child = parent.children.find(elem.fieldNameStringData());
+        if (child == parent.children.end() || visited[child->second]) {
+            // Path traversal only ever sees the first field with a given name.
+            continue;
+        }
+
+        const size_t childIndex = child->second;
+        const TrieNode& node = _trie[childIndex];
+        visited[childIndex] = true;
+        --remaining;
+
+        switch (elem.type()) {
+            case Array:
+                for (auto slot : node.subtreeSlots) {
+                    slots[slot].traversesArray = true;
+                }
+                break;
+            case Object:
+                if (node.slot >= 0) {
+                    slots[node.slot].element = elem;
+                }
+                if (!node.children.empty()) {
+                    _resolve(childIndex, elem.embeddedObject(), slots, visited);
+                }
+                break;
+            default:
+                // Any longer path runs into a scalar and so does not exist.
+                if (node.slot >= 0) {
+                    slots[node.slot].element = elem;
+                }
+                break;
+        }
+    }
+}
+
+bool CompiledMatchExpression::_evaluate(const EvalNode& node,
+                                        const BSONObj& doc,
+                                        const Slot* slots) const {
+    switch (node.op) {
+        case EvalNode::Op::kAnd:
+            for (auto&& child : node.children) {
+                if (!_evaluate(child, doc, slots)) {
+                    return false;
+                }
+            }
+            return true;
+        case EvalNode::Op::kOr:
+            for (auto&& child : node.children) {
+                if (_evaluate(child, doc, slots)) {
+                    return true;
+                }
+            }
+            return false;
+        case EvalNode::Op::kNor:
+            for (auto&& child : node.children) {
+                if (_evaluate(child, doc, slots)) {
+                    return false;
+                }
+            }
+            return true;
+        case EvalNode::Op::kNot:
+            return !_evaluate(node.children[0], doc, slots);
+        case EvalNode::Op::kPath: {
+            const Slot& slot = slots[node.slot];
+            if (slot.traversesArray) {
+                return node.expr->matchesBSON(doc);
+            }
+            return node.expr->matchesSingleElement(slot.element);
+        }
+        case EvalNode::Op::kOther:
+            return node.expr->matchesBSON(doc);
+    }
+    MONGO_UNREACHABLE;
+}
+
+}  // namespace mongo
@@ -0,0 +1,125 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "mongo/bson/bsonobj.h"
+#include "mongo/db/matcher/expression.h"
+#include "mongo/util/string_map.h"
+
+namespace mongo {
+
+/**
+ * A CompiledMatchExpression evaluates a MatchExpression tree against BSON documents with a single
+ * walk over each document, rather than one walk per path predicate.
+ *
+ * The paths of all PathMatchExpressions reachable from the root through $and, $or, $nor and $not
+ * are merged into a trie. Matching first walks the document's fields alongside the trie, resolving
+ * the one element each path leads to, and then evaluates the tree with the usual short-circuiting,
+ * handing the resolved elements to matchesSingleElement(). A path which runs into an array is
+ * evaluated by its expression against the whole document, since array traversal can produce any
+ * number of candidate elements. So is any node which is neither a path predicate nor one of the
+ * logical operators above.
+ *
+ * The compiled form points into the MatchExpression tree, which must outlive it and must not be
+ * modified while it is in use.
+ */
+class CompiledMatchExpression {
+public:
+    /**
+     * Compiles the tree rooted at 'root'. Returns nullptr if the tree has fewer path predicates
+     * than 'internalQueryMatchPathTrieMinLeaves', in which case it should be evaluated directly.
+     */
+    static std::unique_ptr<CompiledMatchExpression> compile(const MatchExpression* root);
+
+    /**
+     * Equivalent to calling matchesBSON() on the original tree without MatchDetails.
+     */
+    bool matches(const BSONObj& doc) const;
+
+    /**
+     * Returns the number of distinct paths resolved by the document walk.
+     */
+    size_t numPaths() const {
+        return _numPaths;
+    }
+
+private:
+    // A node in the trie of field paths. Node 0 stands for the document itself.
+    struct TrieNode {
+        // Indices into '_trie' of the children, keyed by field name.
+        StringMap<size_t> children;
+
+        // The path which ends at this node, if any.
+        int slot = -1;
+
+        // The paths which end at this node or below it.
+        std::vector<size_t> subtreeSlots;
+    };
+
+    // A node of the evaluation tree, which mirrors the MatchExpression tree.
+    struct EvalNode {
+        enum class Op { kAnd, kOr, kNor, kNot, kPath, kOther };
+
+        Op op = Op::kOther;
+        const MatchExpression* expr = nullptr;
+
+        // For kPath, the path whose resolved element is handed to 'expr'.
+        size_t slot = 0;
+
+        std::vector<EvalNode> children;
+    };
+
+    // What the document walk found for one path.
+    struct Slot {
+        // EOO if the path does not exist in the document.
+        BSONElement element;
+
+        // The path runs into an array, so the expression must traverse the document itself.
+        bool traversesArray = false;
+    };
+
+    CompiledMatchExpression() = default;
+
+    EvalNode _compileNode(const MatchExpression* expr);
+    size_t _addPath(StringData path);
+
+    void _resolve(size_t trieIndex, const BSONObj& obj, Slot* slots, bool* visited) const;
+    bool _evaluate(const EvalNode& node, const BSONObj& doc, const Slot* slots) const;
+
+    std::vector<TrieNode> _trie;
+    EvalNode _root;
+    size_t _numPaths = 0;
+    size_t _numPathPredicates = 0;
+};
+
+}  // namespace mongo
@@ -0,0 +1,87 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/matcher/compiled_match_expression.h"
+#include "mongo/db/matcher/expression_parser.h"
+#include "mongo/db/pipeline/expression_context_for_test.h"
+#include "mongo/db/query/query_knobs_gen.h"
+
+namespace mongo {
+namespace {
+
+constexpr int kNumFields = 100;
+
+// A wide document whose fields 'f0' to 'f99' hold their own index, with a nested object at the
+// end so that dotted paths have to walk past every top-level field.
+BSONObj makeWideDocument() {
+    BSONObjBuilder builder;
+    for (int i = 0; i < kNumFields; ++i) {
+        builder.append("f" + std::to_string(i), i);
+    }
+    builder.append("nested", BSON("a" << 1 << "b" << 2));
+    return builder.obj();
+}
+
+// A conjunction of 'numPredicates' predicates spread evenly over the fields of the wide document,
+// all of which the wide document satisfies so that nothing short-circuits.
+BSONObj makeFilter(int numPredicates) {
+    BSONObjBuilder builder;
+    for (int i = 0; i < numPredicates; ++i) {
+        const int field = (i * kNumFields) / numPredicates;
+        builder.append("f" + std::to_string(field), BSON("$gte" << field));
+    }
+    builder.append("nested.b", 2);
+    return builder.obj();
+}
+
+// The first argument is the number of predicates. The second argument selects the evaluation
+// strategy: 0 walks each path separately, 1 uses the compiled single-pass plan.
+void BM_wideDocumentMatch(benchmark::State& state) {
+    internalQueryMatchPathTrieMinLeaves.store(1);
+    auto expCtx = make_intrusive<ExpressionContextForTest>();
+    auto expr = uassertStatusOK(MatchExpressionParser::parse(makeFilter(state.range(0)), expCtx));
+    auto compiled = state.range(1) ? CompiledMatchExpression::compile(expr.get()) : nullptr;
+    const BSONObj doc = makeWideDocument();
+
+    for (auto _ : state) {
+        benchmark::ClobberMemory();
+        benchmark::DoNotOptimize(compiled ? compiled->matches(doc) : expr->matchesBSON(doc));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_wideDocumentMatch)->Ranges({{1, 64}, {0, 1}});
+
+}  // namespace
+}  // namespace mongo
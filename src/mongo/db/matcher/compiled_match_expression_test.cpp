@@ -0,0 +1,148 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/matcher/compiled_match_expression.h"
+
+#include "mongo/db/json.h"
+#include "mongo/db/matcher/expression_parser.h"
+#include "mongo/db/matcher/extensions_callback_noop.h"
+#include "mongo/db/pipeline/expression_context_for_test.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+class CompiledMatchExpressionTest : public unittest::Test {
+protected:
+    std::unique_ptr<MatchExpression> parse(const BSONObj& filter) {
+        auto expCtx = make_intrusive<ExpressionContextForTest>();
+        return uassertStatusOK(
+            MatchExpressionParser::parse(filter,
+                                         expCtx,
+                                         ExtensionsCallbackNoop(),
+                                         MatchExpressionParser::kAllowAllSpecialFeatures));
+    }
+
+    /**
+     * Checks that the compiled form of 'filter' agrees with the tree on each of 'docs'.
+     */
+    void assertMatchesTree(const BSONObj& filter, const std::vector<BSONObj>& docs) {
+        auto expr = parse(filter);
+        auto compiled = CompiledMatchExpression::compile(expr.get());
+        ASSERT(compiled);
+        for (auto&& doc : docs) {
+            ASSERT_EQ(expr->matchesBSON(doc), compiled->matches(doc))
+                << "filter: " << filter << " document: " << doc;
+        }
+    }
+};
+
+TEST_F(CompiledMatchExpressionTest, SmallFiltersAreNotCompiled) {
+    auto expr = parse(fromjson("{a: 1, b: 2, c: 3}"));
+    ASSERT_FALSE(CompiledMatchExpression::compile(expr.get()));
+}
+
+TEST_F(CompiledMatchExpressionTest, PathsWithCommonPrefixesShareTheTrie) {
+    auto expr = parse(fromjson("{a: 1, 'b.c': 2, 'b.d': {$gt: 3}, 'b.c': {$lt: 5}, e: {$ne: 1}}"));
+    auto compiled = CompiledMatchExpression::compile(expr.get());
+    ASSERT(compiled);
+    ASSERT_EQ(compiled->numPaths(), 4U);
+}
+
+TEST_F(CompiledMatchExpressionTest, ScalarAndNestedFields) {
+    assertMatchesTree(fromjson("{a: 1, 'b.c': 'x', 'b.d': {$gte: 2}, e: {$exists: false}}"),
+                      {fromjson("{a: 1, b: {c: 'x', d: 2}}"),
+                       fromjson("{b: {d: 3, c: 'x'}, a: 1}"),
+                       fromjson("{a: 1, b: {c: 'x', d: 1}}"),
+                       fromjson("{a: 1, b: {c: 'x', d: 2}, e: null}"),
+                       fromjson("{a: 1, b: 5}"),
+                       fromjson("{a: 1}"),
+                       fromjson("{}")});
+}
+
+TEST_F(CompiledMatchExpressionTest, MissingFieldsAndNull) {
+    assertMatchesTree(fromjson("{a: null, 'b.c': null, 'b.d': {$exists: true}, f: {$ne: null}}"),
+                      {fromjson("{f: 1, b: {d: 1}}"),
+                       fromjson("{a: null, f: 1, b: {c: null, d: 1}}"),
+                       fromjson("{a: 1, f: 1, b: {d: 1}}"),
+                       fromjson("{f: 1, b: 1}"),
+                       fromjson("{f: null, b: {d: 1}}")});
+}
+
+TEST_F(CompiledMatchExpressionTest, ArraysFallBackToPathTraversal) {
+    assertMatchesTree(
+        fromjson("{a: 2, 'b.c': 3, 'b.0': {$exists: true}, d: [1, 2], e: {$size: 1}}"),
+        {fromjson("{a: [1, 2], b: [{c: 3}], d: [1, 2], e: [1]}"),
+         fromjson("{a: 2, b: {c: [3, 4], '0': 1}, d: [[1, 2]], e: [1]}"),
+         fromjson("{a: [[2]], b: [{c: 3}], d: [1, 2], e: [1]}"),
+         fromjson("{a: 2, b: [[{c: 3}]], d: [1, 2], e: []}"),
+         fromjson("{a: 2, b: {c: 3}, d: [2, 1], e: [1]}")});
+}
+
+TEST_F(CompiledMatchExpressionTest, LogicalOperators) {
+    assertMatchesTree(
+        fromjson("{$or: [{a: 1, b: 2}, {c: {$in: [1, 2]}}],"
+                 " $nor: [{d: 1}, {'e.f': 1}],"
+                 " g: {$not: {$gt: 5}}}"),
+        {fromjson("{a: 1, b: 2, g: 5}"),
+         fromjson("{a: 1, b: 3, c: 2}"),
+         fromjson("{a: 1, b: 3, c: 3}"),
+         fromjson("{a: 1, b: 2, d: 1}"),
+         fromjson("{a: 1, b: 2, e: {f: 1}}"),
+         fromjson("{a: 1, b: 2, e: [{f: 1}]}"),
+         fromjson("{a: 1, b: 2, g: 6}"),
+         fromjson("{a: 1, b: 2, g: [6, 7]}"),
+         fromjson("{a: 1, b: 2, g: [1, 7]}")});
+}
+
+TEST_F(CompiledMatchExpressionTest, NonPathExpressionsAreEvaluatedAgainstTheDocument) {
+    assertMatchesTree(fromjson("{a: {$elemMatch: {b: 1}}, c: 1, d: {$type: 'string'}, e: {$mod: "
+                               "[2, 0]}, $expr: {$eq: ['$c', 1]}}"),
+                      {fromjson("{a: [{b: 1}], c: 1, d: 'x', e: 4}"),
+                       fromjson("{a: {b: 1}, c: 1, d: 'x', e: 4}"),
+                       fromjson("{a: [{b: 1}], c: 2, d: 'x', e: 4}"),
+                       fromjson("{a: [{b: 2}], c: 1, d: 'x', e: 4}"),
+                       fromjson("{a: [{b: 1}], c: 1, d: 1, e: 3}")});
+}
+
+TEST_F(CompiledMatchExpressionTest, OnlyTheFirstOfDuplicateFieldsIsConsidered) {
+    const auto filter = fromjson("{a: 1, 'b.c': 1, 'b.d': {$exists: false}, e: 1}");
+    BSONObjBuilder bob;
+    bob.append("a", 1);
+    bob.append("b", BSON("d" << 1));
+    bob.append("b", BSON("c" << 1));
+    bob.append("a", 2);
+    bob.append("e", 1);
+    assertMatchesTree(filter, {bob.obj(), BSON("a" << 1 << "b" << BSON("c" << 1) << "e" << 1)});
+}
+
+}  // namespace
+}  // namespace mongo
@@ -39,6 +39,7 @@
 #include "mongo/db/matcher/match_details.h"
 #include "mongo/db/matcher/matchable.h"
 #include "mongo/db/pipeline/dependencies.h"
+#include "mongo/db/query/operation_arena.h"
 #include "mongo/util/fail_point.h"
 
 namespace mongo {
@@ -55,7 +56,7 @@ class TreeMatchExpression;
 
 typedef StatusWith<std::unique_ptr<MatchExpression>> StatusWithMatchExpression;
 
-class MatchExpression {
+class MatchExpression : public OperationArenaAllocated {
     MatchExpression(const MatchExpression&) = delete;
     MatchExpression& operator=(const MatchExpression&) = delete;
 
@@ -31,7 +31,9 @@
 
 #include "mongo/db/matcher/expression_leaf.h"
 
+#include <absl/container/flat_hash_set.h>
 #include <cmath>
+#include <limits>
 #include <memory>
 #include <pcrecpp.h>
 
@@ -44,8 +46,10 @@
 #include "mongo/db/matcher/expression_parser.h"
 #include "mongo/db/matcher/path.h"
 #include "mongo/db/query/collation/collator_interface.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/util/regex_util.h"
 #include "mongo/util/str.h"
+#include "mongo/util/string_map.h"
 
 namespace mongo {
 
@@ -362,6 +366,105 @@ bool ExistsMatchExpression::equivalent(const MatchExpression* other) const {
 
 // ----
 
+namespace {
+/**
+ * Returns true and sets 'out' if 'd' is an integer representable as a long long.
+ */
+bool integralDoubleToLong(double d, long long* out) {
+    if (!(d >= std::numeric_limits<long long>::min() &&
+          d < BSONElement::kLongLongMaxPlusOneAsDouble) ||
+        std::trunc(d) != d) {
+        return false;
+    }
+    *out = static_cast<long long>(d);
+    return true;
+}
+}  // namespace
+
+class InMatchExpression::HomogeneousEqualitySet {
+public:
+    /**
+     * Returns nullptr unless 'equalities' are all integral numbers, all ObjectIds, or all strings
+     * compared without a collator.
+     */
+    static std::shared_ptr<const HomogeneousEqualitySet> make(
+        const std::vector<BSONElement>& equalities, const CollatorInterface* collator) {
+        if (equalities.empty()) {
+            return nullptr;
+        }
+
+        auto set = std::make_shared<HomogeneousEqualitySet>();
+        set->_canonicalType = canonicalizeBSONType(equalities.front().type());
+        for (auto&& equality : equalities) {
+            if (canonicalizeBSONType(equality.type()) != set->_canonicalType) {
+                return nullptr;
+            }
+            switch (equality.type()) {
+                case NumberInt:
+                case NumberLong:
+                    set->_integers.insert(equality.numberLong());
+                    break;
+                case NumberDouble: {
+                    long long integer;
+                    if (!integralDoubleToLong(equality.numberDouble(), &integer)) {
+                        return nullptr;
+                    }
+                    set->_integers.insert(integer);
+                    break;
+                }
+                case String:
+                case Symbol:
+                    if (collator) {
+                        return nullptr;
+                    }
+                    set->_bytes.insert(equality.valueStringData());
+                    break;
+                case jstOID:
+                    set->_bytes.insert(StringData(equality.value(), OID::kOIDSize));
+                    break;
+                default:
+                    return nullptr;
+            }
+        }
+        return set;
+    }
+
+    /**
+     * Returns whether 'elem' compares equal to one of the equalities, or boost::none if this set
+     * cannot tell and the caller must fall back to a comparison-based search.
+     */
+    boost::optional<bool> contains(const BSONElement& elem) const {
+        if (canonicalizeBSONType(elem.type()) != _canonicalType) {
+            return false;
+        }
+        switch (elem.type()) {
+            case NumberInt:
+            case NumberLong:
+                return _integers.contains(elem.numberLong());
+            case NumberDouble: {
+                long long integer;
+                return integralDoubleToLong(elem.numberDouble(), &integer) &&
+                    _integers.contains(integer);
+            }
+            case String:
+            case Symbol:
+                return _bytes.contains(elem.valueStringData());
+            case jstOID:
+                return _bytes.contains(StringData(elem.value(), OID::kOIDSize));
+            default:
+                // A decimal may still equal one of the integers.
+                return boost::none;
+        }
+    }
+
+private:
+    int _canonicalType;
+    absl::flat_hash_set<long long> _integers;
+
+    // String values, or the raw bytes of ObjectIds. Points into the BSON owned by the expression.
+    StringDataSet _bytes;
+};
+
 InMatchExpression::InMatchExpression(StringData path)
     : LeafMatchExpression(MATCH_IN, path),
       _eltCmp(BSONElementComparator::FieldNamesMode::kIgnore, _collator) {}
@@ -375,6 +478,7 @@ std::unique_ptr<MatchExpression> InMatchExpression::shallowClone() const {
     next->_hasNull = _hasNull;
     next->_hasEmptyArray = _hasEmptyArray;
     next->_equalitySet = _equalitySet;
+    next->_homogeneousEqualitySet = _homogeneousEqualitySet;
     next->_originalEqualityVector = _originalEqualityVector;
     for (auto&& regex : _regexes) {
         std::unique_ptr<RegexMatchExpression> clonedRegex(
@@ -385,6 +489,11 @@ std::unique_ptr<MatchExpression> InMatchExpression::shallowClone() const {
 }
 
 bool InMatchExpression::contains(const BSONElement& e) const {
+    if (_homogeneousEqualitySet) {
+        if (auto found = _homogeneousEqualitySet->contains(e)) {
+            return *found;
+        }
+    }
     return std::binary_search(_equalitySet.begin(), _equalitySet.end(), e, _eltCmp.makeLessThan());
 }
 
@@ -490,12 +599,7 @@ void InMatchExpression::_doSetCollator(const CollatorInterface* collator) {
     }
 
     // We need to re-compute '_equalitySet', since our set comparator has changed.
-    _equalitySet.clear();
-    _equalitySet.reserve(_originalEqualityVector.size());
-    std::unique_copy(_originalEqualityVector.begin(),
-                     _originalEqualityVector.end(),
-                     std::back_inserter(_equalitySet),
-                     _eltCmp.makeEqualTo());
+    _updateEqualitySet();
 }
 
 Status InMatchExpression::setEqualities(std::vector<BSONElement> equalities) {
@@ -523,6 +627,12 @@ Status InMatchExpression::setEqualities(std::vector<BSONElement> equalities) {
             _originalEqualityVector.begin(), _originalEqualityVector.end(), _eltCmp.makeLessThan());
     }
 
+    _updateEqualitySet();
+
+    return Status::OK();
+}
+
+void InMatchExpression::_updateEqualitySet() {
     _equalitySet.clear();
     _equalitySet.reserve(_originalEqualityVector.size());
     std::unique_copy(_originalEqualityVector.begin(),
@@ -530,7 +640,10 @@ Status InMatchExpression::setEqualities(std::vector<BSONElement> equalities) {
                      std::back_inserter(_equalitySet),
                      _eltCmp.makeEqualTo());
 
-    return Status::OK();
+    const auto minSize = internalQueryInListHashSetMinSize.load();
+    _homogeneousEqualitySet = minSize > 0 && _equalitySet.size() >= static_cast<size_t>(minSize)
+        ? HomogeneousEqualitySet::make(_equalitySet, _collator)
+        : nullptr;
 }
 
 Status InMatchExpression::addRegex(std::unique_ptr<RegexMatchExpression> expr) {
@@ -453,6 +453,9 @@ public:
 private:
     ExpressionOptimizerFunc getOptimizer() const final;
 
+    // Recomputes '_equalitySet' and '_homogeneousEqualitySet' from '_originalEqualityVector'.
+    void _updateEqualitySet();
+
     // Whether or not '_equalities' has a jstNULL element in it.
     bool _hasNull = false;
 
@@ -476,10 +479,15 @@ private:
     // support std::binary_search. Because we need to sort the elements anyway for things like index
     // bounds building, using binary search avoids the overhead of inserting into a hash table which
     // doesn't pay for itself in the common case where lookups are done a few times if ever.
-    // TODO It may be worth dynamically creating a hashset after matchesSingleElement() has been
-    // called "many" times.
     std::vector<BSONElement> _equalitySet;
 
+    // Hashed copy of '_equalitySet', built only for lists of at least
+    // 'internalQueryInListHashSetMinSize' equalities which are either all integral numbers, all
+    // ObjectIds, or all strings compared without a collator. It is immutable once built, and so is
+    // shared with clones.
+    class HomogeneousEqualitySet;
+    std::shared_ptr<const HomogeneousEqualitySet> _homogeneousEqualitySet;
+
     // Container of regex elements this object owns.
     std::vector<std::unique_ptr<RegexMatchExpression>> _regexes;
 };
@@ -1370,6 +1370,141 @@ TEST(InMatchExpression, ChangingCollationAfterAddingEqualitiesPreservesEqualitie
     ASSERT(in.contains(obj2.firstElement()));
 }
 
+/**
+ * Builds an array of 'n' values whose 'i'th element is produced by 'makeValue(i, &arrayBuilder)'.
+ */
+template <typename MakeValue>
+BSONArray buildLargeInList(int n, MakeValue makeValue) {
+    BSONArrayBuilder bab;
+    for (int i = 0; i < n; ++i) {
+        makeValue(i, &bab);
+    }
+    return bab.arr();
+}
+
+std::vector<BSONElement> elementsOf(const BSONArray& arr) {
+    std::vector<BSONElement> elements;
+    for (auto&& elem : arr) {
+        elements.push_back(elem);
+    }
+    return elements;
+}
+
+TEST(InMatchExpression, LargeIntegralListMatchesAllNumericTypes) {
+    // Mix ints, longs and integral doubles, which all hash as the same integers.
+    auto operand = buildLargeInList(500, [](int i, BSONArrayBuilder* bab) {
+        if (i % 3 == 0) {
+            bab->append(i * 2);
+        } else if (i % 3 == 1) {
+            bab->append(static_cast<long long>(i * 2));
+        } else {
+            bab->append(static_cast<double>(i * 2));
+        }
+    });
+    InMatchExpression in("");
+    ASSERT_OK(in.setEqualities(elementsOf(operand)));
+
+    ASSERT(in.matchesSingleElement(BSON("a" << 4).firstElement()));
+    ASSERT(in.matchesSingleElement(BSON("a" << 4LL).firstElement()));
+    ASSERT(in.matchesSingleElement(BSON("a" << 4.0).firstElement()));
+    ASSERT(in.matchesSingleElement(BSON("a" << -0.0).firstElement()));
+    ASSERT(in.matchesSingleElement(BSON("a" << Decimal128("998")).firstElement()));
+    ASSERT(!in.matchesSingleElement(BSON("a" << 5).firstElement()));
+    ASSERT(!in.matchesSingleElement(BSON("a" << 4.5).firstElement()));
+    ASSERT(!in.matchesSingleElement(BSON("a" << 1000).firstElement()));
+    ASSERT(!in.matchesSingleElement(BSON("a" << Decimal128("4.5")).firstElement()));
+    ASSERT(!in.matchesSingleElement(
+        BSON("a" << std::numeric_limits<double>::quiet_NaN()).firstElement()));
+    ASSERT(!in.matchesSingleElement(BSON("a"
+                                         << "4")
+                                        .firstElement()));
+}
+
+TEST(InMatchExpression, LargeObjectIdListMatches) {
+    std::vector<OID> oids;
+    for (int i = 0; i < 300; ++i) {
+        oids.push_back(OID::gen());
+    }
+    auto operand = buildLargeInList(
+        oids.size() - 1, [&](int i, BSONArrayBuilder* bab) { bab->append(oids[i]); });
+    InMatchExpression in("");
+    ASSERT_OK(in.setEqualities(elementsOf(operand)));
+
+    ASSERT(in.matchesSingleElement(BSON("a" << oids[0]).firstElement()));
+    ASSERT(in.matchesSingleElement(BSON("a" << oids[oids.size() - 2]).firstElement()));
+    ASSERT(!in.matchesSingleElement(BSON("a" << oids.back()).firstElement()));
+    ASSERT(!in.matchesSingleElement(BSON("a" << 1).firstElement()));
+}
+
+TEST(InMatchExpression, LargeStringListMatchesUsingBinaryComparison) {
+    auto operand = buildLargeInList(
+        200, [](int i, BSONArrayBuilder* bab) { bab->append("str" + std::to_string(i)); });
+    InMatchExpression in("");
+    ASSERT_OK(in.setEqualities(elementsOf(operand)));
+
+    ASSERT(in.matchesSingleElement(BSON("a"
+                                        << "str150")
+                                       .firstElement()));
+    ASSERT(in.matchesSingleElement(BSON("a" << BSONSymbol("str7")).firstElement()));
+    ASSERT(!in.matchesSingleElement(BSON("a"
+                                         << "STR150")
+                                        .firstElement()));
+    ASSERT(!in.matchesSingleElement(BSON("a"
+                                         << "str200")
+                                        .firstElement()));
+}
+
+TEST(InMatchExpression, LargeStringListRespectsCollation) {
+    auto operand = buildLargeInList(
+        200, [](int i, BSONArrayBuilder* bab) { bab->append("str" + std::to_string(i)); });
+    CollatorInterfaceMock collator(CollatorInterfaceMock::MockType::kToLowerString);
+    InMatchExpression in("");
+    in.setCollator(&collator);
+    ASSERT_OK(in.setEqualities(elementsOf(operand)));
+
+    ASSERT(in.matchesSingleElement(BSON("a"
+                                        << "STR150")
+                                       .firstElement()));
+
+    // Removing the collator afterwards switches back to binary comparison.
+    in.setCollator(nullptr);
+    ASSERT(!in.matchesSingleElement(BSON("a"
+                                         << "STR150")
+                                        .firstElement()));
+    ASSERT(in.matchesSingleElement(BSON("a"
+                                        << "str150")
+                                       .firstElement()));
+}
+
+TEST(InMatchExpression, LargeMixedTypeListMatches) {
+    auto operand = buildLargeInList(200, [](int i, BSONArrayBuilder* bab) {
+        if (i % 2) {
+            bab->append(i);
+        } else {
+            bab->append(std::to_string(i));
+        }
+    });
+    InMatchExpression in("");
+    ASSERT_OK(in.setEqualities(elementsOf(operand)));
+
+    ASSERT(in.matchesSingleElement(BSON("a" << 101).firstElement()));
+    ASSERT(in.matchesSingleElement(BSON("a"
+                                        << "100")
+                                       .firstElement()));
+    ASSERT(!in.matchesSingleElement(BSON("a" << 100).firstElement()));
+}
+
+TEST(InMatchExpression, ClonedLargeListMatchesLikeOriginal) {
+    auto operand = buildLargeInList(200, [](int i, BSONArrayBuilder* bab) { bab->append(i); });
+    InMatchExpression in("a");
+    ASSERT_OK(in.setEqualities(elementsOf(operand)));
+    auto clone = in.shallowClone();
+
+    ASSERT(clone->matchesBSON(BSON("a" << 150), nullptr));
+    ASSERT(clone->matchesBSON(BSON("a" << BSON_ARRAY(500 << 199)), nullptr));
+    ASSERT(!clone->matchesBSON(BSON("a" << 200), nullptr));
+}
+
 std::vector<uint32_t> bsonArrayToBitPositions(const BSONArray& ba) {
     std::vector<uint32_t> bitPositions;
 
@@ -241,7 +241,7 @@ public:
 
 private:
     BSONType totalType = NumberInt;
-    DoubleDoubleSummation nonDecimalTotal;
+    BatchedDoubleDoubleSummation nonDecimalTotal;
     Decimal128 decimalTotal;
 };
 
@@ -327,10 +327,10 @@ private:
      * The total of all values is partitioned between those that are decimals, and those that are
      * not decimals, so the decimal total needs to add the non-decimal.
      */
-    Decimal128 _getDecimalTotal() const;
+    Decimal128 _getDecimalTotal();
 
     bool _isDecimal;
-    DoubleDoubleSummation _nonDecimalTotal;
+    BatchedDoubleDoubleSummation _nonDecimalTotal;
     Decimal128 _decimalTotal;
     long long _count;
 };
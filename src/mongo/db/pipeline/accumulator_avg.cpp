@@ -91,6 +91,9 @@ void AccumulatorAvg::processInternal(const Value& input, bool merging) {
             return;
     }
     _count++;
+
+    // The total starts staging its inputs once it has seen enough of them.
+    _memUsageBytes = sizeof(*this) + _nonDecimalTotal.getBatchMemoryUsageBytes();
 }
 
 intrusive_ptr<AccumulatorState> AccumulatorAvg::create(
@@ -98,8 +101,8 @@ intrusive_ptr<AccumulatorState> AccumulatorAvg::create(
     return new AccumulatorAvg(expCtx);
 }
 
-Decimal128 AccumulatorAvg::_getDecimalTotal() const {
-    return _decimalTotal.add(_nonDecimalTotal.getDecimal());
+Decimal128 AccumulatorAvg::_getDecimalTotal() {
+    return _decimalTotal.add(_nonDecimalTotal.get().getDecimal());
 }
 
 Value AccumulatorAvg::getValue(bool toBeMerged) {
@@ -108,7 +111,7 @@ Value AccumulatorAvg::getValue(bool toBeMerged) {
             return Value(Document{{subTotalName, _getDecimalTotal()}, {countName, _count}});
 
         double total, error;
-        std::tie(total, error) = _nonDecimalTotal.getDoubleDouble();
+        std::tie(total, error) = _nonDecimalTotal.get().getDoubleDouble();
         return Value(
             Document{{subTotalName, total}, {countName, _count}, {subTotalErrorName, error}});
     }
@@ -119,12 +122,12 @@ Value AccumulatorAvg::getValue(bool toBeMerged) {
     if (_isDecimal)
         return Value(_getDecimalTotal().divide(Decimal128(static_cast<int64_t>(_count))));
 
-    return Value(_nonDecimalTotal.getDouble() / static_cast<double>(_count));
+    return Value(_nonDecimalTotal.get().getDouble() / static_cast<double>(_count));
 }
 
 AccumulatorAvg::AccumulatorAvg(const boost::intrusive_ptr<ExpressionContext>& expCtx)
     : AccumulatorState(expCtx), _isDecimal(false), _count(0) {
-    // This is a fixed size AccumulatorState so we never need to update this
+    // This only grows once the total allocates its staging buffers, see processInternal().
     _memUsageBytes = sizeof(*this);
 }
 
@@ -133,5 +136,6 @@ void AccumulatorAvg::reset() {
     _nonDecimalTotal = {};
     _decimalTotal = {};
     _count = 0;
+    _memUsageBytes = sizeof(*this);
 }
 }  // namespace mongo
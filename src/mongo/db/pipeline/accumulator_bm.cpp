@@ -0,0 +1,109 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+
+#include "mongo/db/exec/document_value/value.h"
+#include "mongo/db/pipeline/accumulator.h"
+#include "mongo/db/pipeline/expression_context_for_test.h"
+
+namespace mongo {
+namespace {
+
+// Each benchmark takes the number of inputs fed to a single accumulator, which stands in for the
+// size of one group. Small groups never leave the unbatched path.
+
+std::vector<Value> makeInputs(BSONType type, size_t count) {
+    std::vector<Value> inputs;
+    for (size_t i = 0; i < count; ++i) {
+        switch (type) {
+            case NumberInt:
+                inputs.emplace_back(static_cast<int>(i % 1000));
+                break;
+            case NumberLong:
+                inputs.emplace_back(static_cast<long long>(i) * 1000003);
+                break;
+            default:
+                inputs.emplace_back(0.25 * i);
+                break;
+        }
+    }
+    return inputs;
+}
+
+template <typename AccumulatorType>
+void runAccumulator(benchmark::State& state, BSONType type) {
+    auto expCtx = make_intrusive<ExpressionContextForTest>();
+    const auto inputs = makeInputs(type, state.range(0));
+    auto accum = AccumulatorType::create(expCtx);
+    for (auto _ : state) {
+        accum->reset();
+        for (auto&& input : inputs) {
+            accum->process(input, false);
+        }
+        benchmark::DoNotOptimize(accum->getValue(false));
+    }
+    state.SetItemsProcessed(state.iterations() * inputs.size());
+}
+
+void BM_SumDoubles(benchmark::State& state) {
+    runAccumulator<AccumulatorSum>(state, NumberDouble);
+}
+
+void BM_SumLongs(benchmark::State& state) {
+    runAccumulator<AccumulatorSum>(state, NumberLong);
+}
+
+void BM_AvgDoubles(benchmark::State& state) {
+    runAccumulator<AccumulatorAvg>(state, NumberDouble);
+}
+
+void BM_AvgInts(benchmark::State& state) {
+    runAccumulator<AccumulatorAvg>(state, NumberInt);
+}
+
+void BM_MaxDoubles(benchmark::State& state) {
+    runAccumulator<AccumulatorMax>(state, NumberDouble);
+}
+
+void BM_MinLongs(benchmark::State& state) {
+    runAccumulator<AccumulatorMin>(state, NumberLong);
+}
+
+BENCHMARK(BM_SumDoubles)->Arg(16)->Arg(1000)->Arg(100000);
+BENCHMARK(BM_SumLongs)->Arg(16)->Arg(1000)->Arg(100000);
+BENCHMARK(BM_AvgDoubles)->Arg(16)->Arg(1000)->Arg(100000);
+BENCHMARK(BM_AvgInts)->Arg(16)->Arg(1000)->Arg(100000);
+BENCHMARK(BM_MaxDoubles)->Arg(1000)->Arg(100000);
+BENCHMARK(BM_MinLongs)->Arg(1000)->Arg(100000);
+
+}  // namespace
+}  // namespace mongo
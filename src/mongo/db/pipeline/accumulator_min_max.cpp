@@ -31,6 +31,7 @@
 
 #include "mongo/db/pipeline/accumulator.h"
 
+#include "mongo/base/compare_numbers.h"
 #include "mongo/db/exec/document_value/value.h"
 #include "mongo/db/pipeline/accumulation_statement.h"
 #include "mongo/db/pipeline/expression.h"
@@ -50,7 +51,40 @@ const char* AccumulatorMinMax::getOpName() const {
     return "$max";
 }
 
+namespace {
+/**
+ * Compares two numbers of the same type without going through the generic Value comparator.
+ * Returns false if 'type' is not one of the fixed-width numeric types, in which case 'cmp' is not
+ * set. Numbers never need the collator, so this agrees with ValueComparator::compare().
+ */
+bool compareSameTypedNumbers(BSONType type, const Value& lhs, const Value& rhs, int* cmp) {
+    switch (type) {
+        case NumberInt:
+            *cmp = compareInts(lhs.getInt(), rhs.getInt());
+            return true;
+        case NumberLong:
+            *cmp = compareLongs(lhs.getLong(), rhs.getLong());
+            return true;
+        case NumberDouble:
+            *cmp = compareDoubles(lhs.getDouble(), rhs.getDouble());
+            return true;
+        default:
+            return false;
+    }
+}
+}  // namespace
+
 void AccumulatorMinMax::processInternal(const Value& input, bool merging) {
+    const auto type = input.getType();
+    int cmp;
+    if (type == _val.getType() && compareSameTypedNumbers(type, _val, input, &cmp)) {
+        // Fixed-width numbers carry no out-of-line storage, so the memory usage is unchanged.
+        if (cmp * _sense > 0) {
+            _val = input;
+        }
+        return;
+    }
+
     // nullish values should have no impact on result
     if (!input.nullish()) {
         /* compare with the current value; swap if appropriate */
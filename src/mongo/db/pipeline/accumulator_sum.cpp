@@ -83,6 +83,9 @@ void AccumulatorSum::processInternal(const Value& input, bool merging) {
         default:
             MONGO_UNREACHABLE;
     }
+
+    // The total starts staging its inputs once it has seen enough of them.
+    _memUsageBytes = sizeof(*this) + nonDecimalTotal.getBatchMemoryUsageBytes();
 }
 
 intrusive_ptr<AccumulatorState> AccumulatorSum::create(
@@ -91,14 +94,15 @@ intrusive_ptr<AccumulatorState> AccumulatorSum::create(
 }
 
 Value AccumulatorSum::getValue(bool toBeMerged) {
+    const DoubleDoubleSummation& sum = nonDecimalTotal.get();
     switch (totalType) {
         case NumberInt:
-            if (nonDecimalTotal.fitsLong())
-                return Value::createIntOrLong(nonDecimalTotal.getLong());
+            if (sum.fitsLong())
+                return Value::createIntOrLong(sum.getLong());
         // Fallthrough.
         case NumberLong:
-            if (nonDecimalTotal.fitsLong())
-                return Value(nonDecimalTotal.getLong());
+            if (sum.fitsLong())
+                return Value(sum.getLong());
             if (toBeMerged) {
                 // The value was too large for a NumberLong, so output a document with two values
                 // adding up to the desired total. Older MongoDB versions used to ignore signed
@@ -110,17 +114,17 @@ Value AccumulatorSum::getValue(bool toBeMerged) {
                 //  more than 2**53 integers would have to be summed, which is impossible.
                 double total;
                 double error;
-                std::tie(total, error) = nonDecimalTotal.getDoubleDouble();
+                std::tie(total, error) = sum.getDoubleDouble();
                 long long llerror = static_cast<long long>(error);
                 return Value(DOC(subTotalName << total << subTotalErrorName << llerror));
             }
             // Sum doesn't fit a NumberLong, so return a NumberDouble instead.
-            return Value(nonDecimalTotal.getDouble());
+            return Value(sum.getDouble());
 
         case NumberDouble:
-            return Value(nonDecimalTotal.getDouble());
+            return Value(sum.getDouble());
         case NumberDecimal: {
-            return Value(decimalTotal.add(nonDecimalTotal.getDecimal()));
+            return Value(decimalTotal.add(sum.getDecimal()));
         }
         default:
             MONGO_UNREACHABLE;
@@ -129,7 +133,7 @@ Value AccumulatorSum::getValue(bool toBeMerged) {
 
 AccumulatorSum::AccumulatorSum(const boost::intrusive_ptr<ExpressionContext>& expCtx)
     : AccumulatorState(expCtx) {
-    // This is a fixed size AccumulatorState so we never need to update this.
+    // This only grows once the total allocates its staging buffers, see processInternal().
     _memUsageBytes = sizeof(*this);
 }
 
@@ -137,5 +141,6 @@ void AccumulatorSum::reset() {
     totalType = NumberInt;
     nonDecimalTotal = {};
     decimalTotal = {};
+    _memUsageBytes = sizeof(*this);
 }
 }  // namespace mongo
@@ -208,7 +208,16 @@ TEST(Accumulators, Min) {
          // The accumulator evaluates two documents and retains the minimum value.
          {{Value(5), Value(7)}, Value(5)},
          // The accumulator evaluates two documents and ignores the missing value.
-         {{Value(7), Value()}, Value(7)}});
+         {{Value(7), Value()}, Value(7)},
+
+         // Values of the same numeric type are compared directly.
+         {{Value(7LL), Value(-3LL), Value(5LL)}, Value(-3LL)},
+         {{Value(2.5), Value(-0.5), Value(1.0)}, Value(-0.5)},
+         // NaN sorts below every other double.
+         {{Value(2.5), Value(numeric_limits<double>::quiet_NaN()), Value(1.0)},
+          Value(numeric_limits<double>::quiet_NaN())},
+         // Mixed numeric types are still compared by value.
+         {{Value(7), Value(3.5), Value(5LL)}, Value(3.5)}});
 }
 
 TEST(Accumulators, MinRespectsCollation) {
@@ -235,7 +244,13 @@ TEST(Accumulators, Max) {
          // The accumulator evaluates two documents and retains the maximum value.
          {{Value(5), Value(7)}, Value(7)},
          // The accumulator evaluates two documents and ignores the missing value.
-         {{Value(7), Value()}, Value(7)}});
+         {{Value(7), Value()}, Value(7)},
+
+         // Values of the same numeric type are compared directly.
+         {{Value(7LL), Value(-3LL), Value(9LL)}, Value(9LL)},
+         {{Value(2.5), Value(numeric_limits<double>::quiet_NaN()), Value(1.0)}, Value(2.5)},
+         // Mixed numeric types are still compared by value.
+         {{Value(7), Value(7.5), Value(5LL)}, Value(7.5)}});
 }
 
 TEST(Accumulators, MaxRespectsCollation) {
@@ -336,6 +351,30 @@ TEST(Accumulators, Sum) {
          {{Value(9), Value()}, Value(9)}});
 }
 
+TEST(Accumulators, SumAndAvgOfManyInputs) {
+    // Enough inputs for the running totals to start adding them up in batches.
+    intrusive_ptr<ExpressionContext> expCtx(new ExpressionContextForTest());
+    std::vector<Value> ints;
+    std::vector<Value> longs;
+    std::vector<Value> mixed;
+    for (int i = 0; i < 1000; ++i) {
+        ints.emplace_back(i);
+        longs.emplace_back((1LL << 40) + i);
+        mixed.emplace_back(i % 2 ? Value(i) : Value(i + 0.5));
+    }
+    const long long longTotal = (1LL << 40) * 1000 + 499500;
+
+    assertExpectedResults<AccumulatorSum>(expCtx,
+                                          {{ints, Value(499500)},
+                                           {longs, Value(longTotal)},
+                                           {mixed, Value(499750.0)}});
+    assertExpectedResults<AccumulatorAvg>(
+        expCtx,
+        {{ints, Value(499.5)},
+         {longs, Value(static_cast<double>(1LL << 40) + 499.5)},
+         {mixed, Value(499.75)}});
+}
+
 TEST(Accumulators, AddToSetRespectsCollation) {
     intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
     auto collator =
@@ -54,6 +54,8 @@
 #include "mongo/db/repl/oplog_entry_gen.h"
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/transaction_history_iterator.h"
+#include "mongo/db/update/doc_diff.h"
+#include "mongo/db/update/log_builder.h"
 #include "mongo/s/catalog_cache.h"
 #include "mongo/s/grid.h"
 
@@ -249,7 +251,22 @@ Document DocumentSourceChangeStreamTransform::applyTransformation(const Document
 
                 // Extract the field names of $unset document.
                 vector<Value> removedFieldsVector;
-                if (removedFields.getType() == BSONType::Object) {
+                Value updateSemantics = opObject[LogBuilder::kUpdateSemanticsFieldName];
+                if (updateSemantics.numeric() &&
+                    updateSemantics.coerceToInt() == static_cast<int>(UpdateSemantics::kDelta)) {
+                    // Delta-style entries record a diff, which we flatten into the equivalent
+                    // $set/$unset description.
+                    Value diff = opObject[LogBuilder::kDeltaDiffFieldName];
+                    checkValueType(diff, LogBuilder::kDeltaDiffFieldName, BSONType::Object);
+                    BSONObjBuilder updatedFieldsBuilder;
+                    std::vector<std::string> removedPaths;
+                    doc_diff::describeDiff(
+                        diff.getDocument().toBson(), &updatedFieldsBuilder, &removedPaths);
+                    updatedFields = Value(updatedFieldsBuilder.obj());
+                    for (auto&& path : removedPaths) {
+                        removedFieldsVector.push_back(Value(path));
+                    }
+                } else if (removedFields.getType() == BSONType::Object) {
                     auto iter = removedFields.getDocument().fieldIterator();
                     while (iter.more()) {
                         removedFieldsVector.push_back(Value(iter.next().first));
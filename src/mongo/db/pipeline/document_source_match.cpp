@@ -84,6 +84,11 @@ DocumentSource::GetNextResult DocumentSourceMatch::doGetNext() {
     // The user facing error should have been generated earlier.
     massert(17309, "Should never call getNext on a $match stage with $text clause", !_isTextQuery);
 
+    if (!_compiledExpressionInitialized) {
+        _compiledExpression = CompiledMatchExpression::compile(_expression.get());
+        _compiledExpressionInitialized = true;
+    }
+
     auto nextInput = pSource->getNext();
     for (; nextInput.isAdvanced(); nextInput = pSource->getNext()) {
         // MatchExpression only takes BSON documents, so we have to make one. As an optimization,
@@ -93,7 +98,9 @@ DocumentSource::GetNextResult DocumentSourceMatch::doGetNext() {
             : document_path_support::documentToBsonWithPaths(nextInput.getDocument(),
                                                              _dependencies.fields);
 
-        if (_expression->matchesBSON(toMatch)) {
+        const bool matches = _compiledExpression ? _compiledExpression->matches(toMatch)
+                                                 : _expression->matchesBSON(toMatch);
+        if (matches) {
             return nextInput;
         }
 
@@ -501,6 +508,8 @@ DocumentSourceMatch::DocumentSourceMatch(const BSONObj& query,
 
 void DocumentSourceMatch::rebuild(BSONObj filter) {
     _predicate = filter.getOwned();
+    _compiledExpression.reset();
+    _compiledExpressionInitialized = false;
     _expression = uassertStatusOK(MatchExpressionParser::parse(
         _predicate, pExpCtx, ExtensionsCallbackNoop(), Pipeline::kAllowedMatcherFeatures));
     _isTextQuery = isTextQuery(_predicate);
@@ -34,6 +34,7 @@
 #include <utility>
 
 #include "mongo/client/connpool.h"
+#include "mongo/db/matcher/compiled_match_expression.h"
 #include "mongo/db/matcher/matcher.h"
 #include "mongo/db/pipeline/document_source.h"
 #include "mongo/util/intrusive_counter.h"
@@ -192,6 +193,11 @@ protected:
 private:
     std::unique_ptr<MatchExpression> _expression;
 
+    // Single-pass form of '_expression'. Built on the first call to doGetNext(), once the
+    // expression can no longer be rewritten by optimization. Null if not worth compiling.
+    std::unique_ptr<CompiledMatchExpression> _compiledExpression;
+    bool _compiledExpressionInitialized = false;
+
     bool _isTextQuery;
 
     // Cache the dependencies so that we know what fields we need to serialize to BSON for matching.
@@ -0,0 +1,627 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/expression_bytecode.h"
+
+#include <cmath>
+#include <limits>
+
+#include "mongo/db/pipeline/expression.h"
+#include "mongo/platform/overflow_arithmetic.h"
+#include "mongo/util/summation.h"
+
+namespace mongo {
+
+/**
+ * A register holds either an unboxed scalar or, for every other type, a boxed Value.
+ */
+struct CompiledExpression::Register {
+    enum class Tag : uint8_t { kMissing, kNull, kBool, kInt, kLong, kDouble, kValue };
+
+    void set(Value val) {
+        switch (val.getType()) {
+            case EOO:
+                setTag(Tag::kMissing);
+                break;
+            case jstNULL:
+                setNull();
+                break;
+            case Bool:
+                setBool(val.getBool());
+                break;
+            case NumberInt:
+                setTag(Tag::kInt);
+                intValue = val.getInt();
+                break;
+            case NumberLong:
+                setLong(val.getLong());
+                break;
+            case NumberDouble:
+                setDouble(val.getDouble());
+                break;
+            default:
+                tag = Tag::kValue;
+                value = std::move(val);
+        }
+    }
+
+    void setNull() {
+        setTag(Tag::kNull);
+    }
+
+    void setBool(bool b) {
+        setTag(Tag::kBool);
+        boolValue = b;
+    }
+
+    void setLong(long long l) {
+        setTag(Tag::kLong);
+        longValue = l;
+    }
+
+    void setDouble(double d) {
+        setTag(Tag::kDouble);
+        doubleValue = d;
+    }
+
+    // Matches Value::createIntOrLong().
+    void setIntOrLong(long long l) {
+        int i = l;
+        if (i != l) {
+            setLong(l);
+        } else {
+            setTag(Tag::kInt);
+            intValue = i;
+        }
+    }
+
+    Value box() const {
+        switch (tag) {
+            case Tag::kMissing:
+                return Value();
+            case Tag::kNull:
+                return Value(BSONNULL);
+            case Tag::kBool:
+                return Value(boolValue);
+            case Tag::kInt:
+                return Value(intValue);
+            case Tag::kLong:
+                return Value(longValue);
+            case Tag::kDouble:
+                return Value(doubleValue);
+            case Tag::kValue:
+                return value;
+        }
+        MONGO_UNREACHABLE;
+    }
+
+    bool isNumeric() const {
+        return tag == Tag::kInt || tag == Tag::kLong || tag == Tag::kDouble;
+    }
+
+    bool isNullish() const {
+        return tag == Tag::kMissing || tag == Tag::kNull || (tag == Tag::kValue && value.nullish());
+    }
+
+    bool coerceToBool() const {
+        switch (tag) {
+            case Tag::kMissing:
+            case Tag::kNull:
+                return false;
+            case Tag::kBool:
+                return boolValue;
+            case Tag::kInt:
+                return intValue;
+            case Tag::kLong:
+                return longValue;
+            case Tag::kDouble:
+                return doubleValue;
+            case Tag::kValue:
+                return value.coerceToBool();
+        }
+        MONGO_UNREACHABLE;
+    }
+
+    // Only valid for numeric registers.
+    double coerceToDouble() const {
+        return tag == Tag::kInt ? intValue : tag == Tag::kLong ? longValue : doubleValue;
+    }
+
+    // Only valid for int and long registers.
+    long long coerceToLong() const {
+        return tag == Tag::kInt ? intValue : longValue;
+    }
+
+    void setTag(Tag newTag) {
+        if (MONGO_unlikely(tag == Tag::kValue)) {
+            value = Value();
+        }
+        tag = newTag;
+    }
+
+    Tag tag = Tag::kMissing;
+    union {
+        bool boolValue;
+        int intValue;
+        long long longValue = 0;
+        double doubleValue;
+    };
+    Value value;
+};
+
+struct CompiledExpression::Instruction {
+    enum class Op : uint8_t {
+        kLoadConstant,
+        kLoadField,
+        kEvaluate,
+        kMove,
+        kAdd,
+        kSubtract,
+        kMultiply,
+        kDivide,
+        kCompare,
+        kNot,
+        kJump,
+        kJumpIfFalse,
+        kJumpIfTrue,
+    };
+
+    Op op;
+    uint32_t dst = 0;
+
+    // The operand registers are '_operands[operandsBegin, operandsEnd)'.
+    uint32_t operandsBegin = 0;
+    uint32_t operandsEnd = 0;
+
+    // The destination of a jump, or the index into '_constants' for kLoadConstant.
+    uint32_t target = 0;
+
+    // The tree node this instruction was lowered from, evaluated directly on fallback.
+    const Expression* node = nullptr;
+};
+
+class CompiledExpression::Compiler {
+public:
+    explicit Compiler(CompiledExpression* program) : _program(program) {}
+
+    /**
+     * Emits code for 'expr' and returns the register that holds its value once that code has run.
+     */
+    uint32_t compile(const Expression* expr) {
+        using Op = Instruction::Op;
+
+        if (auto constant = dynamic_cast<const ExpressionConstant*>(expr)) {
+            const auto index = addConstant(constant->getValue());
+            return emit(Op::kLoadConstant, newRegister(), {}, expr, index);
+        } else if (auto fieldPath = dynamic_cast<const ExpressionFieldPath*>(expr)) {
+            if (fieldPath->isRootFieldPath() && fieldPath->getFieldPath().getPathLength() > 1) {
+                return emit(Op::kLoadField, newRegister(), {}, expr);
+            }
+        } else if (dynamic_cast<const ExpressionAdd*>(expr)) {
+            return emitOperator(Op::kAdd, expr);
+        } else if (dynamic_cast<const ExpressionSubtract*>(expr)) {
+            return emitOperator(Op::kSubtract, expr);
+        } else if (dynamic_cast<const ExpressionMultiply*>(expr)) {
+            return emitOperator(Op::kMultiply, expr);
+        } else if (dynamic_cast<const ExpressionDivide*>(expr)) {
+            return emitOperator(Op::kDivide, expr);
+        } else if (dynamic_cast<const ExpressionCompare*>(expr)) {
+            return emitOperator(Op::kCompare, expr);
+        } else if (dynamic_cast<const ExpressionNot*>(expr)) {
+            return emitOperator(Op::kNot, expr);
+        } else if (dynamic_cast<const ExpressionAnd*>(expr)) {
+            return emitShortCircuit(Op::kJumpIfFalse, false, expr);
+        } else if (dynamic_cast<const ExpressionOr*>(expr)) {
+            return emitShortCircuit(Op::kJumpIfTrue, true, expr);
+        } else if (dynamic_cast<const ExpressionCond*>(expr)) {
+            return emitCond(expr);
+        }
+
+        return emit(Op::kEvaluate, newRegister(), {}, expr);
+    }
+
+    uint32_t numRegisters() const {
+        return _numRegisters;
+    }
+
+    bool loweredOperator() const {
+        return _loweredOperator;
+    }
+
+private:
+    using Op = Instruction::Op;
+
+    uint32_t newRegister() {
+        return _numRegisters++;
+    }
+
+    uint32_t addConstant(Value val) {
+        _program->_constants.emplace_back();
+        _program->_constants.back().set(std::move(val));
+        return _program->_constants.size() - 1;
+    }
+
+    // Appends an instruction and returns 'dst'.
+    uint32_t emit(Op op,
+                  uint32_t dst,
+                  const std::vector<uint32_t>& operands,
+                  const Expression* node,
+                  uint32_t target = 0) {
+        Instruction insn;
+        insn.op = op;
+        insn.dst = dst;
+        insn.operandsBegin = _program->_operands.size();
+        _program->_operands.insert(_program->_operands.end(), operands.begin(), operands.end());
+        insn.operandsEnd = _program->_operands.size();
+        insn.target = target;
+        insn.node = node;
+        _program->_code.push_back(insn);
+        return dst;
+    }
+
+    // Appends a jump whose destination is filled in later by patchJump() and returns its address.
+    size_t emitJump(Op op, const std::vector<uint32_t>& operands) {
+        emit(op, 0, operands, nullptr);
+        return _program->_code.size() - 1;
+    }
+
+    void patchJump(size_t address) {
+        _program->_code[address].target = _program->_code.size();
+    }
+
+    uint32_t emitOperator(Op op, const Expression* expr) {
+        _loweredOperator = true;
+        std::vector<uint32_t> operands;
+        for (auto&& child : expr->getChildren()) {
+            operands.push_back(compile(child.get()));
+        }
+        return emit(op, newRegister(), operands, expr);
+    }
+
+    // Lowers $and and $or, which stop at the first operand whose truthiness is 'shortCircuitOn'.
+    uint32_t emitShortCircuit(Op jumpOp, bool shortCircuitOn, const Expression* expr) {
+        _loweredOperator = true;
+        const uint32_t dst = newRegister();
+        std::vector<size_t> exits;
+        for (auto&& child : expr->getChildren()) {
+            exits.push_back(emitJump(jumpOp, {compile(child.get())}));
+        }
+        emit(Op::kLoadConstant, dst, {}, expr, addConstant(Value(!shortCircuitOn)));
+        const size_t done = emitJump(Op::kJump, {});
+        for (auto exit : exits) {
+            patchJump(exit);
+        }
+        emit(Op::kLoadConstant, dst, {}, expr, addConstant(Value(shortCircuitOn)));
+        patchJump(done);
+        return dst;
+    }
+
+    uint32_t emitCond(const Expression* expr) {
+        _loweredOperator = true;
+        const auto& children = expr->getChildren();
+        const uint32_t dst = newRegister();
+        const size_t toElse = emitJump(Op::kJumpIfFalse, {compile(children[0].get())});
+        emit(Op::kMove, dst, {compile(children[1].get())}, expr);
+        const size_t done = emitJump(Op::kJump, {});
+        patchJump(toElse);
+        emit(Op::kMove, dst, {compile(children[2].get())}, expr);
+        patchJump(done);
+        return dst;
+    }
+
+    CompiledExpression* _program;
+    uint32_t _numRegisters = 0;
+    bool _loweredOperator = false;
+};
+
+CompiledExpression::CompiledExpression(boost::intrusive_ptr<Expression> expr)
+    : _expr(std::move(expr)) {}
+
+CompiledExpression::~CompiledExpression() = default;
+
+std::unique_ptr<CompiledExpression> CompiledExpression::compile(
+    boost::intrusive_ptr<Expression> expr) {
+    std::unique_ptr<CompiledExpression> program(new CompiledExpression(std::move(expr)));
+    Compiler compiler(program.get());
+    program->_resultRegister = compiler.compile(program->_expr.get());
+
+    // A program that only loads a value, or only calls back into the tree, cannot beat the tree.
+    if (!compiler.loweredOperator()) {
+        return nullptr;
+    }
+
+    program->_registers.resize(compiler.numRegisters());
+    return program;
+}
+
+Value CompiledExpression::evaluate(const Document& root) const {
+    auto variables = &_expr->getExpressionContext()->variables;
+    try {
+        return _run(root, variables);
+    } catch (const DBException&) {
+        // The program evaluates the operands of arithmetic and comparison operators eagerly,
+        // whereas the tree may stop early and never reach a failing operand. Let the tree decide
+        // whether, and with which error, the expression fails.
+        return _expr->evaluate(root, variables);
+    }
+}
+
+Value CompiledExpression::_run(const Document& root, Variables* variables) const {
+    using Op = Instruction::Op;
+
+    size_t pc = 0;
+    const size_t end = _code.size();
+    while (pc < end) {
+        const auto& insn = _code[pc++];
+        auto& dst = _registers[insn.dst];
+        bool handled = true;
+        switch (insn.op) {
+            case Op::kLoadConstant:
+                dst = _constants[insn.target];
+                break;
+            case Op::kLoadField:
+                handled = _loadField(insn, root, &dst);
+                break;
+            case Op::kEvaluate:
+                handled = false;
+                break;
+            case Op::kMove:
+                dst = _registers[_operands[insn.operandsBegin]];
+                break;
+            case Op::kAdd:
+                handled = _add(insn, &dst);
+                break;
+            case Op::kSubtract:
+                handled = _subtract(insn, &dst);
+                break;
+            case Op::kMultiply:
+                handled = _multiply(insn, &dst);
+                break;
+            case Op::kDivide:
+                handled = _divide(insn, &dst);
+                break;
+            case Op::kCompare:
+                _compare(insn, &dst);
+                break;
+            case Op::kNot:
+                dst.setBool(!_registers[_operands[insn.operandsBegin]].coerceToBool());
+                break;
+            case Op::kJump:
+                pc = insn.target;
+                break;
+            case Op::kJumpIfFalse:
+                if (!_registers[_operands[insn.operandsBegin]].coerceToBool()) {
+                    pc = insn.target;
+                }
+                break;
+            case Op::kJumpIfTrue:
+                if (_registers[_operands[insn.operandsBegin]].coerceToBool()) {
+                    pc = insn.target;
+                }
+                break;
+        }
+
+        if (!handled) {
+            dst.set(insn.node->evaluate(root, variables));
+        }
+    }
+
+    return _registers[_resultRegister].box();
+}
+
+bool CompiledExpression::_loadField(const Instruction& insn,
+                                    const Document& root,
+                                    Register* dst) const {
+    const auto& path = static_cast<const ExpressionFieldPath*>(insn.node)->getFieldPath();
+    Value val = root[path.getFieldName(1)];
+    for (size_t i = 2; i < path.getPathLength(); ++i) {
+        if (val.getType() == Object) {
+            val = val.getDocument()[path.getFieldName(i)];
+        } else if (val.getType() == Array) {
+            // Traversing an array produces an array of the nested values; leave that to the tree.
+            return false;
+        } else {
+            val = Value();
+            break;
+        }
+    }
+    dst->set(std::move(val));
+    return true;
+}
+
+bool CompiledExpression::_add(const Instruction& insn, Register* dst) const {
+    // Follows ExpressionAdd::evaluate() for int, long and double operands.
+    DoubleDoubleSummation total;
+    BSONType totalType = NumberInt;
+    for (auto i = insn.operandsBegin; i < insn.operandsEnd; ++i) {
+        const auto& operand = _registers[_operands[i]];
+        switch (operand.tag) {
+            case Register::Tag::kInt:
+                total.addDouble(operand.intValue);
+                break;
+            case Register::Tag::kLong:
+                total.addLong(operand.longValue);
+                if (totalType == NumberInt)
+                    totalType = NumberLong;
+                break;
+            case Register::Tag::kDouble:
+                total.addDouble(operand.doubleValue);
+                totalType = NumberDouble;
+                break;
+            default:
+                if (!operand.isNullish())
+                    return false;
+                dst->setNull();
+                return true;
+        }
+    }
+
+    if (totalType == NumberLong && total.fitsLong()) {
+        dst->setLong(total.getLong());
+    } else if (totalType != NumberDouble && total.fitsLong()) {
+        dst->setIntOrLong(total.getLong());
+    } else {
+        dst->setDouble(total.getDouble());
+    }
+    return true;
+}
+
+bool CompiledExpression::_subtract(const Instruction& insn, Register* dst) const {
+    const auto& lhs = _registers[_operands[insn.operandsBegin]];
+    const auto& rhs = _registers[_operands[insn.operandsBegin + 1]];
+    if (!lhs.isNumeric() || !rhs.isNumeric()) {
+        if (lhs.isNullish() || rhs.isNullish()) {
+            dst->setNull();
+            return true;
+        }
+        return false;
+    }
+
+    if (lhs.tag == Register::Tag::kDouble || rhs.tag == Register::Tag::kDouble) {
+        dst->setDouble(lhs.coerceToDouble() - rhs.coerceToDouble());
+        return true;
+    }
+
+    long long difference;
+    if (overflow::sub(lhs.coerceToLong(), rhs.coerceToLong(), &difference)) {
+        return false;
+    }
+    if (lhs.tag == Register::Tag::kLong || rhs.tag == Register::Tag::kLong) {
+        dst->setLong(difference);
+    } else {
+        dst->setIntOrLong(difference);
+    }
+    return true;
+}
+
+bool CompiledExpression::_multiply(const Instruction& insn, Register* dst) const {
+    // Follows ExpressionMultiply::evaluate() for int, long and double operands.
+    double doubleProduct = 1;
+    long long longProduct = 1;
+    BSONType productType = NumberInt;
+    for (auto i = insn.operandsBegin; i < insn.operandsEnd; ++i) {
+        const auto& operand = _registers[_operands[i]];
+        if (!operand.isNumeric()) {
+            if (!operand.isNullish())
+                return false;
+            dst->setNull();
+            return true;
+        }
+
+        if (operand.tag == Register::Tag::kDouble) {
+            productType = NumberDouble;
+        } else if (operand.tag == Register::Tag::kLong && productType == NumberInt) {
+            productType = NumberLong;
+        }
+
+        const double d = operand.coerceToDouble();
+        doubleProduct *= d;
+        if (!std::isfinite(d)) {
+            productType = NumberDouble;
+            continue;
+        }
+
+        long long l;
+        if (operand.tag == Register::Tag::kDouble) {
+            // The tree fails to coerce a double outside the range of a long.
+            if (!(d >= std::numeric_limits<long long>::min() &&
+                  d < BSONElement::kLongLongMaxPlusOneAsDouble))
+                return false;
+            l = static_cast<long long>(d);
+        } else {
+            l = operand.coerceToLong();
+        }
+        if (overflow::mul(longProduct, l, &longProduct)) {
+            productType = NumberDouble;
+        }
+    }
+
+    if (productType == NumberDouble) {
+        dst->setDouble(doubleProduct);
+    } else if (productType == NumberLong) {
+        dst->setLong(longProduct);
+    } else {
+        dst->setIntOrLong(longProduct);
+    }
+    return true;
+}
+
+bool CompiledExpression::_divide(const Instruction& insn, Register* dst) const {
+    const auto& lhs = _registers[_operands[insn.operandsBegin]];
+    const auto& rhs = _registers[_operands[insn.operandsBegin + 1]];
+    if (!lhs.isNumeric() || !rhs.isNumeric()) {
+        if (lhs.isNullish() || rhs.isNullish()) {
+            dst->setNull();
+            return true;
+        }
+        return false;
+    }
+
+    const double denom = rhs.coerceToDouble();
+    uassert(16608, "can't $divide by zero", denom != 0.0);
+    dst->setDouble(lhs.coerceToDouble() / denom);
+    return true;
+}
+
+void CompiledExpression::_compare(const Instruction& insn, Register* dst) const {
+    // Comparisons depend on the collation and on the canonical ordering of BSON types, so they are
+    // made on boxed values. Boxing a scalar does not allocate.
+    const auto expr = static_cast<const ExpressionCompare*>(insn.node);
+    const int cmp = expr->getExpressionContext()->getValueComparator().compare(
+        _registers[_operands[insn.operandsBegin]].box(),
+        _registers[_operands[insn.operandsBegin + 1]].box());
+
+    switch (expr->getOp()) {
+        case ExpressionCompare::EQ:
+            dst->setBool(cmp == 0);
+            break;
+        case ExpressionCompare::NE:
+            dst->setBool(cmp != 0);
+            break;
+        case ExpressionCompare::GT:
+            dst->setBool(cmp > 0);
+            break;
+        case ExpressionCompare::GTE:
+            dst->setBool(cmp >= 0);
+            break;
+        case ExpressionCompare::LT:
+            dst->setBool(cmp < 0);
+            break;
+        case ExpressionCompare::LTE:
+            dst->setBool(cmp <= 0);
+            break;
+        case ExpressionCompare::CMP:
+            dst->setIntOrLong(cmp < 0 ? -1 : cmp > 0 ? 1 : 0);
+            break;
+    }
+}
+
+}  // namespace mongo
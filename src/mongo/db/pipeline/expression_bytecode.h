@@ -0,0 +1,112 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <boost/intrusive_ptr.hpp>
+#include <memory>
+#include <vector>
+
+#include "mongo/db/exec/document_value/document.h"
+#include "mongo/db/exec/document_value/value.h"
+
+namespace mongo {
+
+class Expression;
+class Variables;
+
+/**
+ * A CompiledExpression is an optimized Expression tree lowered into a flat program for a small
+ * register machine. Numeric and boolean intermediate results live unboxed in registers, so hot
+ * arithmetic, comparison and conditional expressions avoid constructing a Value for each node and
+ * avoid the virtual evaluate() call per node.
+ *
+ * Only a subset of expressions is lowered: constants, field paths rooted at $$CURRENT or $$ROOT,
+ * $add, $subtract, $multiply, $divide, the comparison operators, $and, $or, $not and $cond. Any
+ * other node is embedded in the program as a call back into the tree's evaluate(). Operations
+ * whose operands fall outside the unboxed fast path (for example dates or decimals) likewise
+ * defer to the original node, so the program always produces the same result as the tree.
+ *
+ * The program keeps its register file inline, so a CompiledExpression must not be evaluated
+ * concurrently from multiple threads. Expressions in a pipeline are already single-threaded.
+ */
+class CompiledExpression {
+public:
+    /**
+     * Lowers 'expr', which should already have been optimized, into a program. Returns nullptr if
+     * no part of the expression can be lowered, in which case the tree should be used directly.
+     */
+    static std::unique_ptr<CompiledExpression> compile(boost::intrusive_ptr<Expression> expr);
+
+    ~CompiledExpression();
+
+    /**
+     * Evaluates the program against 'root' using the variables of the expression's
+     * ExpressionContext. Equivalent to calling evaluate() on the original expression.
+     */
+    Value evaluate(const Document& root) const;
+
+    size_t numInstructions() const {
+        return _code.size();
+    }
+
+private:
+    struct Register;
+    struct Instruction;
+    class Compiler;
+
+    explicit CompiledExpression(boost::intrusive_ptr<Expression> expr);
+
+    Value _run(const Document& root, Variables* variables) const;
+
+    // Each of these returns false, leaving 'dst' untouched, if an operand is outside the
+    // supported fast path. The caller then falls back to evaluating the original node.
+    bool _add(const Instruction& insn, Register* dst) const;
+    bool _subtract(const Instruction& insn, Register* dst) const;
+    bool _multiply(const Instruction& insn, Register* dst) const;
+    bool _divide(const Instruction& insn, Register* dst) const;
+    bool _loadField(const Instruction& insn, const Document& root, Register* dst) const;
+    void _compare(const Instruction& insn, Register* dst) const;
+
+    // The tree this program was compiled from, retained as the reference implementation.
+    boost::intrusive_ptr<Expression> _expr;
+
+    std::vector<Instruction> _code;
+
+    // Register indices consumed by instructions with a variable number of operands.
+    std::vector<uint32_t> _operands;
+
+    std::vector<Register> _constants;
+
+    mutable std::vector<Register> _registers;
+
+    uint32_t _resultRegister = 0;
+};
+
+}  // namespace mongo
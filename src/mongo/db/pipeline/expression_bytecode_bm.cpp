@@ -0,0 +1,116 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+
+#include "mongo/bson/json.h"
+#include "mongo/db/exec/add_fields_projection_executor.h"
+#include "mongo/db/exec/document_value/document.h"
+#include "mongo/db/exec/projection_executor_builder.h"
+#include "mongo/db/pipeline/expression_context_for_test.h"
+#include "mongo/db/query/projection_parser.h"
+#include "mongo/db/query/query_knobs_gen.h"
+
+namespace mongo {
+namespace {
+
+// Each benchmark takes one argument: 0 evaluates expressions by walking the tree, 1 evaluates
+// them through the bytecode interpreter.
+
+std::vector<Document> makeDocuments() {
+    std::vector<Document> docs;
+    for (int i = 0; i < 1000; ++i) {
+        docs.push_back(Document{{"_id", i},
+                                {"price", 1.5 * i},
+                                {"qty", i % 17},
+                                {"discount", i % 3 == 0 ? Value(0.1) : Value(BSONNULL)},
+                                {"stats", Document{{"views", i * 7LL}, {"likes", i % 100}}}});
+    }
+    return docs;
+}
+
+void runProjection(benchmark::State& state, projection_executor::ProjectionExecutor& proj) {
+    const auto docs = makeDocuments();
+    for (auto _ : state) {
+        for (auto&& doc : docs) {
+            benchmark::DoNotOptimize(proj.applyTransformation(doc));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * docs.size());
+}
+
+void BM_Project(benchmark::State& state) {
+    internalQueryEnableExpressionBytecode.store(state.range(0));
+    auto expCtx = make_intrusive<ExpressionContextForTest>();
+    auto projection = projection_ast::parse(
+        expCtx,
+        fromjson("{total: {$multiply: ['$price', '$qty']},"
+                 " engagement: {$add: ['$stats.likes', {$divide: ['$stats.views', 10]}]},"
+                 " popular: {$gte: ['$stats.likes', 50]}}"),
+        ProjectionPolicies::aggregateProjectionPolicies());
+    auto executor = projection_executor::buildProjectionExecutor(
+        expCtx,
+        &projection,
+        ProjectionPolicies::aggregateProjectionPolicies(),
+        projection_executor::kDefaultBuilderParams);
+    executor->optimize();
+    runProjection(state, *executor);
+}
+
+void BM_AddFields(benchmark::State& state) {
+    internalQueryEnableExpressionBytecode.store(state.range(0));
+    auto expCtx = make_intrusive<ExpressionContextForTest>();
+    auto executor = projection_executor::AddFieldsProjectionExecutor::create(
+        expCtx,
+        fromjson("{subtotal: {$multiply: ['$price', '$qty']},"
+                 " net: {$subtract: [{$multiply: ['$price', '$qty']}, 2]}}"));
+    executor->optimize();
+    runProjection(state, *executor);
+}
+
+void BM_AddFieldsCond(benchmark::State& state) {
+    internalQueryEnableExpressionBytecode.store(state.range(0));
+    auto expCtx = make_intrusive<ExpressionContextForTest>();
+    auto executor = projection_executor::AddFieldsProjectionExecutor::create(
+        expCtx,
+        fromjson("{final: {$cond: [{$and: [{$gt: ['$qty', 5]}, '$discount']},"
+                 "                 {$multiply: ['$price', {$subtract: [1, '$discount']}]},"
+                 "                 '$price']}}"));
+    executor->optimize();
+    runProjection(state, *executor);
+}
+
+BENCHMARK(BM_Project)->Arg(0)->Arg(1);
+BENCHMARK(BM_AddFields)->Arg(0)->Arg(1);
+BENCHMARK(BM_AddFieldsCond)->Arg(0)->Arg(1);
+
+}  // namespace
+}  // namespace mongo
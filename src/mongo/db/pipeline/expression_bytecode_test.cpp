@@ -0,0 +1,211 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <limits>
+
+#include "mongo/db/exec/document_value/document.h"
+#include "mongo/db/exec/document_value/document_value_test_util.h"
+#include "mongo/db/json.h"
+#include "mongo/db/pipeline/expression.h"
+#include "mongo/db/pipeline/expression_bytecode.h"
+#include "mongo/db/pipeline/expression_context_for_test.h"
+#include "mongo/db/query/collation/collator_interface_mock.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+using boost::intrusive_ptr;
+
+class CompiledExpressionTest : public unittest::Test {
+protected:
+    intrusive_ptr<Expression> parse(const BSONObj& spec) {
+        return Expression::parseOperand(_expCtx, spec.firstElement(), _expCtx->variablesParseState)
+            ->optimize();
+    }
+
+    std::unique_ptr<CompiledExpression> compile(const BSONObj& spec) {
+        return CompiledExpression::compile(parse(spec));
+    }
+
+    /**
+     * Asserts that the compiled form of 'spec' produces exactly the value the tree does, including
+     * its numeric type, for each document in 'docs'. Where the tree fails, the compiled form must
+     * fail with the same error code.
+     */
+    void assertMatchesTree(const BSONObj& spec, const std::vector<BSONObj>& docs) {
+        auto expr = parse(spec);
+        auto compiled = CompiledExpression::compile(expr);
+        ASSERT(compiled) << spec;
+        for (auto&& doc : docs) {
+            Document root(doc);
+            StatusWith<Value> expected = [&]() -> StatusWith<Value> {
+                try {
+                    return expr->evaluate(root, &_expCtx->variables);
+                } catch (const DBException& ex) {
+                    return ex.toStatus();
+                }
+            }();
+            if (!expected.isOK()) {
+                ASSERT_THROWS_CODE(
+                    compiled->evaluate(root), AssertionException, expected.getStatus().code());
+                continue;
+            }
+            Value actual = compiled->evaluate(root);
+            ASSERT_VALUE_EQ(actual, expected.getValue());
+            ASSERT_EQ(actual.getType(), expected.getValue().getType()) << spec << " on " << doc;
+        }
+    }
+
+    intrusive_ptr<ExpressionContextForTest> _expCtx{new ExpressionContextForTest()};
+};
+
+const std::vector<BSONObj> kNumericDocs{
+    fromjson("{a: 1, b: 2, c: 3}"),
+    fromjson("{a: 1, b: NumberLong(2), c: 3.5}"),
+    fromjson("{a: 2147483647, b: 2147483647, c: -1}"),
+    BSON("a" << std::numeric_limits<long long>::max() << "b" << 2LL << "c" << 1),
+    BSON("a" << std::numeric_limits<long long>::min() << "b" << -1LL << "c" << 1),
+    BSON("a" << std::numeric_limits<double>::quiet_NaN() << "b" << 1 << "c" << 1),
+    BSON("a" << std::numeric_limits<double>::infinity() << "b" << 0.0 << "c" << 1),
+    BSON("a" << 1e300 << "b" << 1e300 << "c" << 2),
+    fromjson("{a: NumberDecimal('1.5'), b: 2, c: 3}"),
+    fromjson("{a: null, b: 2, c: 3}"),
+    fromjson("{b: 2, c: 3}"),
+    fromjson("{a: {$date: 1000}, b: 2, c: 3}"),
+    fromjson("{a: 0.1, b: 0.2, c: 0.3}"),
+};
+
+TEST_F(CompiledExpressionTest, DoesNotCompileExpressionsWithoutOperators) {
+    ASSERT_FALSE(compile(fromjson("{x: {$const: 1}}")));
+    ASSERT_FALSE(compile(fromjson("{x: '$a.b'}")));
+    ASSERT_FALSE(compile(fromjson("{x: {$concat: ['$a', '$b']}}")));
+}
+
+TEST_F(CompiledExpressionTest, CompilesArithmeticOperators) {
+    auto compiled = compile(fromjson("{x: {$add: ['$a', {$multiply: ['$b', '$c']}]}}"));
+    ASSERT(compiled);
+    ASSERT_VALUE_EQ(compiled->evaluate(Document{{"a", 1}, {"b", 2}, {"c", 3}}), Value(7));
+}
+
+TEST_F(CompiledExpressionTest, AddMatchesTree) {
+    assertMatchesTree(fromjson("{x: {$add: ['$a', '$b', '$c']}}"), kNumericDocs);
+    assertMatchesTree(fromjson("{x: {$add: ['$a', 1]}}"), kNumericDocs);
+}
+
+TEST_F(CompiledExpressionTest, SubtractMatchesTree) {
+    assertMatchesTree(fromjson("{x: {$subtract: ['$a', '$b']}}"), kNumericDocs);
+    assertMatchesTree(fromjson("{x: {$subtract: ['$c', '$a']}}"), kNumericDocs);
+}
+
+TEST_F(CompiledExpressionTest, MultiplyMatchesTree) {
+    assertMatchesTree(fromjson("{x: {$multiply: ['$a', '$b', '$c']}}"), kNumericDocs);
+    assertMatchesTree(fromjson("{x: {$multiply: ['$c', '$a']}}"), kNumericDocs);
+}
+
+TEST_F(CompiledExpressionTest, DivideMatchesTree) {
+    assertMatchesTree(fromjson("{x: {$divide: ['$a', '$c']}}"), kNumericDocs);
+}
+
+TEST_F(CompiledExpressionTest, ComparisonsMatchTree) {
+    for (auto op : {"$eq", "$ne", "$gt", "$gte", "$lt", "$lte", "$cmp"}) {
+        assertMatchesTree(BSON("x" << BSON(op << BSON_ARRAY("$a"
+                                                             << "$b"))),
+                          kNumericDocs);
+    }
+}
+
+TEST_F(CompiledExpressionTest, ComparisonsRespectCollation) {
+    auto expr = parse(fromjson("{x: {$eq: ['$a', 'ABC']}}"));
+    _expCtx->setCollator(
+        std::make_unique<CollatorInterfaceMock>(CollatorInterfaceMock::MockType::kAlwaysEqual));
+    auto compiled = CompiledExpression::compile(expr);
+    ASSERT(compiled);
+    ASSERT_VALUE_EQ(compiled->evaluate(Document{{"a", "xyz"_sd}}), Value(true));
+}
+
+TEST_F(CompiledExpressionTest, LogicalOperatorsMatchTree) {
+    const std::vector<BSONObj> docs{fromjson("{a: 0, b: 1, c: 'x'}"),
+                                    fromjson("{a: 1, b: 0.0, c: null}"),
+                                    fromjson("{a: NumberLong(3), b: true, c: []}"),
+                                    fromjson("{b: false}")};
+    assertMatchesTree(fromjson("{x: {$and: ['$a', '$b', '$c']}}"), docs);
+    assertMatchesTree(fromjson("{x: {$or: ['$a', '$b', '$c']}}"), docs);
+    assertMatchesTree(fromjson("{x: {$not: ['$a']}}"), docs);
+    assertMatchesTree(fromjson("{x: {$cond: ['$a', '$b', '$c']}}"), docs);
+    assertMatchesTree(
+        fromjson("{x: {$cond: [{$and: [{$gt: ['$a', 0]}, '$b']}, {$add: ['$a', 1]}, '$c']}}"),
+        docs);
+}
+
+TEST_F(CompiledExpressionTest, FieldPathsMatchTree) {
+    const std::vector<BSONObj> docs{fromjson("{a: {b: {c: 2}}}"),
+                                    fromjson("{a: {b: 3}}"),
+                                    fromjson("{a: [{b: {c: 1}}, {b: {c: 2}}]}"),
+                                    fromjson("{a: 5}"),
+                                    fromjson("{}")};
+    assertMatchesTree(fromjson("{x: {$add: ['$a.b.c', 1]}}"), docs);
+    assertMatchesTree(fromjson("{x: {$eq: ['$$ROOT.a.b', 3]}}"), docs);
+}
+
+TEST_F(CompiledExpressionTest, UnsupportedOperandsFallBackToTree) {
+    const std::vector<BSONObj> docs{fromjson("{a: 'abc', b: 2}"), fromjson("{a: 'b', b: 'c'}")};
+    assertMatchesTree(fromjson("{x: {$add: [{$strLenCP: '$a'}, '$b']}}"), docs);
+    assertMatchesTree(fromjson("{x: {$eq: [{$concat: ['$a', 'c']}, 'bc']}}"), docs);
+}
+
+TEST_F(CompiledExpressionTest, ShortCircuitingPreservesErrorsOfTree) {
+    const std::vector<BSONObj> docs{fromjson("{a: null, b: 0}")};
+
+    // The tree stops at the null operand and never divides by zero.
+    assertMatchesTree(fromjson("{x: {$add: ['$a', {$divide: [1, '$b']}]}}"), docs);
+
+    // The compiled $and skips the failing branch just like the tree.
+    assertMatchesTree(fromjson("{x: {$and: ['$a', {$divide: [1, '$b']}]}}"), docs);
+}
+
+TEST_F(CompiledExpressionTest, PropagatesErrorsOfTree) {
+    ASSERT_THROWS_CODE(compile(fromjson("{x: {$divide: ['$a', '$b']}}"))
+                           ->evaluate(Document{{"a", 1}, {"b", 0}}),
+                       AssertionException,
+                       16608);
+    ASSERT_THROWS_CODE(compile(fromjson("{x: {$add: ['$a', '$b']}}"))
+                           ->evaluate(Document{{"a", "str"_sd}, {"b", 1}}),
+                       AssertionException,
+                       16554);
+    ASSERT_THROWS_CODE(compile(fromjson("{x: {$multiply: ['$a', '$b']}}"))
+                           ->evaluate(Document{{"a", 2}, {"b", 1e300}}),
+                       AssertionException,
+                       31109);
+}
+
+}  // namespace
+}  // namespace mongo
@@ -40,6 +40,7 @@
 #include "mongo/db/query/canonical_query_encoder.h"
 #include "mongo/db/query/collation/collator_factory_interface.h"
 #include "mongo/db/query/indexability.h"
+#include "mongo/db/query/operation_arena.h"
 #include "mongo/db/query/projection_parser.h"
 #include "mongo/db/query/query_planner_common.h"
 
@@ -134,6 +135,10 @@ StatusWith<std::unique_ptr<CanonicalQuery>> CanonicalQuery::canonicalize(
     const ExtensionsCallback& extensionsCallback,
     MatchExpressionParser::AllowedFeatureSet allowedFeatures,
     const ProjectionPolicies& projectionPolicies) {
+    // The parsed MatchExpression and everything derived from it is allocated from the operation's
+    // arena.
+    ScopedOperationArena arena(opCtx);
+
     auto qrStatus = qr->validate();
     if (!qrStatus.isOK()) {
         return qrStatus;
@@ -56,15 +56,34 @@ const char kPartialResultsReturnedField[] = "partialResultsReturned";
 CursorResponseBuilder::CursorResponseBuilder(rpc::ReplyBuilderInterface* replyBuilder,
                                              Options options = Options())
     : _options(options), _replyBuilder(replyBuilder) {
+    if (auto opMsgBuilder = _replyBuilder->getOpMsgBuilder();
+        opMsgBuilder && opMsgBuilder->allowsSplicing()) {
+        _opMsgBuilder = opMsgBuilder;
+    }
+
     if (_options.useDocumentSequences) {
         _docSeqBuilder.emplace(_replyBuilder->getDocSequenceBuilder(
             _options.isInitialResponse ? kBatchDocSequenceFieldInitial : kBatchDocSequenceField));
     } else {
         _bodyBuilder.emplace(_replyBuilder->getBodyBuilder());
         _cursorObject.emplace(_bodyBuilder->subobjStart(kCursorField));
-        _batch.emplace(_cursorObject->subarrayStart(_options.isInitialResponse ? kBatchFieldInitial
-                                                                               : kBatchField));
+        auto& batchBuf = _cursorObject->subarrayStart(_options.isInitialResponse ? kBatchFieldInitial
+                                                                                 : kBatchField);
+        const std::size_t batchOffset = batchBuf.len();
+        _batch.emplace(batchBuf);
+        if (_opMsgBuilder) {
+            _opMsgBuilder->trackSplicedObject(_cursorObject->offset());
+            _opMsgBuilder->trackSplicedObject(batchOffset);
+        }
+    }
+}
+
+void CursorResponseBuilder::_appendSpliced(const BSONObj& obj) {
+    if (!_options.useDocumentSequences) {
+        // Writes the element's type byte and field name. The document itself follows by reference.
+        _batch->subobjStart();
     }
+    _opMsgBuilder->splice(obj);
 }
 
 void CursorResponseBuilder::done(CursorId cursorId, StringData cursorNamespace) {
@@ -74,12 +74,17 @@ public:
 
     size_t bytesUsed() const {
         invariant(_active);
-        return _options.useDocumentSequences ? _docSeqBuilder->len() : _batch->len();
+        if (_options.useDocumentSequences) {
+            return _docSeqBuilder->len();
+        }
+        return _batch->len() + (_opMsgBuilder ? _opMsgBuilder->splicedBytes() : 0);
     }
 
     void append(const BSONObj& obj) {
         invariant(_active);
-        if (_options.useDocumentSequences) {
+        if (_opMsgBuilder && _opMsgBuilder->canSplice(obj)) {
+            _appendSpliced(obj);
+        } else if (_options.useDocumentSequences) {
             _docSeqBuilder->append(obj);
         } else {
             _batch->append(obj);
@@ -113,8 +118,15 @@ public:
     void abandon();
 
 private:
+    /**
+     * Appends 'obj' to the batch by reference rather than by copying it into the reply.
+     */
+    void _appendSpliced(const BSONObj& obj);
+
     const Options _options;
     rpc::ReplyBuilderInterface* const _replyBuilder;
+    // Set when the reply is an OP_MSG that allows splicing documents into it.
+    OpMsgBuilder* _opMsgBuilder = nullptr;
     // Order here is important to ensure destruction in the correct order.
     boost::optional<BSONObjBuilder> _bodyBuilder;
     boost::optional<BSONObjBuilder> _cursorObject;
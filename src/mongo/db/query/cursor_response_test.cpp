@@ -392,6 +392,45 @@ TEST(CursorResponseTest, cursorReturnDocumentSequences) {
     ASSERT_BSONOBJ_EQ(opMsg.body, expectedBody);
 }
 
+TEST(CursorResponseTest, splicedBatchMatchesCopiedBatch) {
+    const auto small = BSON("_id" << 1);
+    const auto large =
+        BSON("_id" << 2 << "pad" << std::string(OpMsgBuilder::kMinSplicedDocumentBytes, 'x'));
+
+    auto buildReply = [&](bool allowSplicing, size_t* bytesUsed) {
+        rpc::OpMsgReplyBuilder builder;
+        builder.getOpMsgBuilder()->setAllowSplicing(allowSplicing);
+        CursorResponseBuilder::Options options;
+        options.isInitialResponse = true;
+        CursorResponseBuilder crb(&builder, options);
+        crb.append(small);
+        crb.append(large);
+        crb.append(small);
+        *bytesUsed = crb.bytesUsed();
+        crb.done(CursorId(123), "db.coll");
+        builder.getBodyBuilder().append("ok", 1);
+        return builder.done();
+    };
+
+    size_t copiedBytesUsed;
+    auto copied = buildReply(false, &copiedBytesUsed);
+    ASSERT_FALSE(copied.isFragmented());
+
+    size_t splicedBytesUsed;
+    auto spliced = buildReply(true, &splicedBytesUsed);
+    ASSERT(spliced.isFragmented());
+    ASSERT_EQ(splicedBytesUsed, copiedBytesUsed);
+    ASSERT_EQ(spliced.size(), copied.size());
+
+    // Reading the reply flattens it into exactly the bytes of the copied reply.
+    ASSERT_EQ(0, memcmp(spliced.buf(), copied.buf(), copied.size()));
+
+    auto response = CursorResponse::parseFromBSON(OpMsg::parse(spliced).body);
+    ASSERT_OK(response.getStatus());
+    ASSERT_EQ(response.getValue().getBatch().size(), 3U);
+    ASSERT_BSONOBJ_EQ(response.getValue().getBatch()[1], large);
+}
+
 }  // namespace
 
 }  // namespace mongo
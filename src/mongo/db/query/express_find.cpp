@@ -0,0 +1,335 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOGV2_DEFAULT_COMPONENT ::mongo::logv2::LogComponent::kQuery
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/express_find.h"
+
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/catalog/index_catalog.h"
+#include "mongo/db/catalog/index_catalog_entry.h"
+#include "mongo/db/concurrency/write_conflict_exception.h"
+#include "mongo/db/curop.h"
+#include "mongo/db/exec/plan_stats.h"
+#include "mongo/db/index/index_access_method.h"
+#include "mongo/db/index/index_descriptor.h"
+#include "mongo/db/index_names.h"
+#include "mongo/db/keypattern.h"
+#include "mongo/db/query/canonical_query.h"
+#include "mongo/db/query/canonical_query_encoder.h"
+#include "mongo/db/query/collation/collator_interface.h"
+#include "mongo/db/query/collection_query_info.h"
+#include "mongo/db/query/cursor_response.h"
+#include "mongo/db/query/explain.h"
+#include "mongo/db/query/find_common.h"
+#include "mongo/db/query/index_bounds_builder.h"
+#include "mongo/db/query/indexability.h"
+#include "mongo/db/query/plan_cache.h"
+#include "mongo/db/query/plan_summary_stats.h"
+#include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/db/s/operation_sharding_state.h"
+#include "mongo/db/storage/snapshot.h"
+#include "mongo/logv2/log.h"
+#include "mongo/rpc/reply_builder_interface.h"
+
+namespace mongo {
+namespace {
+
+/**
+ * Returns the plan summary of the plan the query planner would have chosen for the lookup, so that
+ * the logs and $currentOp look the same whichever path answered the query.
+ */
+std::string getExpressPlanSummary(const IndexDescriptor* index) {
+    if (index->isIdIndex()) {
+        return "IDHACK";
+    }
+
+    StringBuilder sb;
+    sb << "IXSCAN " << KeyPattern(index->keyPattern());
+    return sb.str();
+}
+
+/**
+ * Returns the execution stats of the IDHACK or FETCH over IXSCAN plan that the query planner would
+ * have chosen, as that plan would have reported them for a lookup that took a single seek, so that
+ * profiler entries have the same shape whichever path answered the query.
+ */
+BSONObj getExpressExecStats(OperationContext* opCtx,
+                            const IndexCatalogEntry* entry,
+                            const BSONObj& key,
+                            const PlanSummaryStats& stats) {
+    const IndexDescriptor* index = entry->descriptor();
+
+    // A stage works once per result and once more to reach EOF.
+    const auto makeCommonStats = [&](const char* type) {
+        CommonStats common(type);
+        common.works = stats.nReturned + 1;
+        common.advanced = stats.nReturned;
+        common.isEOF = true;
+        return common;
+    };
+
+    if (index->isIdIndex()) {
+        auto idhackStats = std::make_unique<IDHackStats>();
+        idhackStats->indexName = index->indexName();
+        idhackStats->keysExamined = stats.totalKeysExamined;
+        idhackStats->docsExamined = stats.totalDocsExamined;
+
+        PlanStageStats idhack(makeCommonStats("IDHACK"), STAGE_IDHACK);
+        idhack.specific = std::move(idhackStats);
+        return Explain::statsToBSON(idhack);
+    }
+
+    OrderedIntervalList oil(key.firstElementFieldName());
+    oil.intervals.push_back(IndexBoundsBuilder::makePointInterval(
+        IndexBoundsBuilder::objFromElement(key.firstElement(), entry->getCollator())));
+    IndexBounds bounds;
+    bounds.fields.push_back(std::move(oil));
+
+    auto ixscanStats = std::make_unique<IndexScanStats>();
+    ixscanStats->indexType = "BtreeCursor";
+    ixscanStats->indexName = index->indexName();
+    ixscanStats->keyPattern = index->keyPattern();
+    ixscanStats->isMultiKey = entry->isMultikey();
+    ixscanStats->multiKeyPaths = entry->getMultikeyPaths(opCtx);
+    ixscanStats->isUnique = index->unique();
+    ixscanStats->isSparse = index->isSparse();
+    ixscanStats->isPartial = index->isPartial();
+    ixscanStats->indexVersion = static_cast<int>(index->version());
+    ixscanStats->collation =
+        index->infoObj().getObjectField(IndexDescriptor::kCollationFieldName).getOwned();
+    ixscanStats->indexBounds = bounds.toBSON();
+    ixscanStats->keysExamined = stats.totalKeysExamined;
+    ixscanStats->seeks = 1;
+
+    auto fetchStats = std::make_unique<FetchStats>();
+    fetchStats->docsExamined = stats.totalDocsExamined;
+
+    auto ixscan = std::make_unique<PlanStageStats>(makeCommonStats("IXSCAN"), STAGE_IXSCAN);
+    ixscan->specific = std::move(ixscanStats);
+    PlanStageStats fetch(makeCommonStats("FETCH"), STAGE_FETCH);
+    fetch.specific = std::move(fetchStats);
+    fetch.children.push_back(std::move(ixscan));
+    return Explain::statsToBSON(fetch);
+}
+
+/**
+ * Returns true if the profiler or the slow query log may report this operation, judging by the
+ * time it has taken so far.
+ */
+bool mayReportOperation(CurOp* curOp) {
+    return curOp->shouldDBProfile() ||
+        shouldLog(logv2::LogComponent::kCommand, logv2::LogSeverity::Debug(1)) ||
+        curOp->elapsedTimeExcludingPauses() >= Milliseconds{serverGlobalParams.slowMS};
+}
+
+/**
+ * Sets the query hash and plan cache key in OpDebug as getExecutor() does before planning the
+ * query, so that slow query log lines and profiler entries identify the query whichever path
+ * answered it. This canonicalizes the query but does not plan it.
+ */
+void setQueryHashAndPlanCacheKey(OperationContext* opCtx,
+                                 const Collection* collection,
+                                 const QueryRequest& qr) {
+    auto cq = uassertStatusOK(
+        CanonicalQuery::canonicalize(opCtx, std::make_unique<QueryRequest>(qr)));
+
+    // The collation is part of the key, and getExecutor() applies the collection default first.
+    if (!cq->getCollator() && collection->getDefaultCollator()) {
+        cq->setCollator(collection->getDefaultCollator()->clone());
+    }
+
+    if (!PlanCache::shouldCacheQuery(*cq)) {
+        return;
+    }
+
+    const auto planCacheKey = CollectionQueryInfo::get(collection).getPlanCache()->computeKey(*cq);
+    auto& opDebug = CurOp::get(opCtx)->debug();
+    opDebug.queryHash = canonical_query_encoder::computeHash(planCacheKey.getStableKeyStringData());
+    opDebug.planCacheKey = canonical_query_encoder::computeHash(planCacheKey.toString());
+}
+
+}  // namespace
+
+bool isExpressFindEligible(const QueryRequest& qr) {
+    if (!internalQueryEnableExpressFind.load()) {
+        return false;
+    }
+
+    const BSONObj& filter = qr.getFilter();
+    if (filter.nFields() != 1) {
+        return false;
+    }
+
+    const BSONElement elt = filter.firstElement();
+    const StringData field = elt.fieldNameStringData();
+    if (field.empty() || field[0] == '$' || field.find('.') != std::string::npos) {
+        return false;
+    }
+
+    if (elt.type() == Object) {
+        // An object is matched literally, unless it holds query operators.
+        if (elt.Obj().firstElementFieldNameStringData().startsWith("$")) {
+            return false;
+        }
+    } else if (!Indexability::isExactBoundsGenerating(elt)) {
+        // Arrays, regexes and nulls match documents whose index keys differ from the value.
+        return false;
+    }
+
+    // A batch size of zero leaves the result for a getMore.
+    if (auto batchSize = qr.getEffectiveBatchSize(); batchSize && *batchSize == 0) {
+        return false;
+    }
+
+    return qr.getProj().isEmpty() && qr.getSort().isEmpty() && qr.getHint().isEmpty() &&
+        qr.getMin().isEmpty() && qr.getMax().isEmpty() && qr.getCollation().isEmpty() &&
+        !qr.getSkip() && !qr.getNToReturn() && !qr.returnKey() && !qr.showRecordId() &&
+        !qr.isTailable() && !qr.getRequestResumeToken() && qr.getResumeAfter().isEmpty() &&
+        !qr.isExplain();
+}
+
+const IndexDescriptor* getExpressFindIndex(OperationContext* opCtx,
+                                           const Collection* collection,
+                                           const QueryRequest& qr) {
+    // Versioned operations need the shard filter stage to skip orphan documents.
+    if (OperationShardingState::isOperationVersioned(opCtx)) {
+        return nullptr;
+    }
+
+    const IndexCatalog* indexCatalog = collection->getIndexCatalog();
+    const StringData field = qr.getFilter().firstElementFieldNameStringData();
+    if (field == "_id") {
+        // The _id index always uses the collection's default collation.
+        return indexCatalog->findIdIndex(opCtx);
+    }
+
+    auto it = indexCatalog->getIndexIterator(opCtx, false /* includeUnfinishedIndexes */);
+    while (it->more()) {
+        const IndexCatalogEntry* entry = it->next();
+        const IndexDescriptor* desc = entry->descriptor();
+        if (!desc->unique() || desc->isPartial() || desc->hidden() ||
+            desc->getAccessMethodName() != IndexNames::BTREE) {
+            continue;
+        }
+
+        const BSONObj& keyPattern = desc->keyPattern();
+        if (keyPattern.nFields() != 1 || keyPattern.firstElementFieldNameStringData() != field) {
+            continue;
+        }
+
+        if (!CollatorInterface::collatorsMatch(entry->getCollator(),
+                                               collection->getDefaultCollator())) {
+            continue;
+        }
+
+        return desc;
+    }
+
+    return nullptr;
+}
+
+void runExpressFind(OperationContext* opCtx,
+                    Collection* collection,
+                    const QueryRequest& qr,
+                    const IndexDescriptor* index,
+                    rpc::ReplyBuilderInterface* result) {
+    // Canonicalization would otherwise have validated the request.
+    uassertStatusOK(qr.validate());
+    opCtx->checkForInterrupt();
+
+    if (qr.isReadOnce()) {
+        opCtx->recoveryUnit()->setReadOnce(true);
+    }
+
+    auto curOp = CurOp::get(opCtx);
+    {
+        stdx::lock_guard<Client> lk(*opCtx->getClient());
+        curOp->setPlanSummary_inlock(getExpressPlanSummary(index));
+    }
+
+    FindCommon::waitInFindBeforeMakingBatch(opCtx, qr);
+
+    // findSingle() generates the index key from the filter, which is a document of the form
+    // {<field>: <value>}.
+    const BSONObj& key = qr.getFilter();
+    const IndexCatalogEntry* entry = collection->getIndexCatalog()->getEntry(index);
+    const auto accessMethod = entry->accessMethod();
+
+    PlanSummaryStats stats;
+    Snapshotted<BSONObj> doc;
+    bool found = false;
+    writeConflictRetry(opCtx, "find", collection->ns().ns(), [&] {
+        stats.totalKeysExamined = 0;
+        stats.totalDocsExamined = 0;
+        found = false;
+
+        const RecordId recordId = accessMethod->findSingle(opCtx, key);
+        if (recordId.isNull()) {
+            return;
+        }
+
+        ++stats.totalKeysExamined;
+        ++stats.totalDocsExamined;
+        found = collection->findDoc(opCtx, recordId, &doc);
+    });
+
+    CursorResponseBuilder::Options options;
+    options.isInitialResponse = true;
+    CursorResponseBuilder firstBatch(result, options);
+    if (found) {
+        firstBatch.append(doc.value());
+    }
+
+    // Fill out CurOp as endQueryOp() does for an exhausted cursor.
+    stats.nReturned = found ? 1 : 0;
+    stats.indexesUsed.insert(index->indexName());
+    curOp->debug().nreturned = stats.nReturned;
+    curOp->debug().cursorid = -1;
+    curOp->debug().cursorExhausted = true;
+    curOp->debug().setPlanSummaryMetrics(stats);
+    CollectionQueryInfo::get(collection).notifyOfQuery(opCtx, stats);
+
+    // Canonicalizing the query just to hash it would cost more than the lookup, so it is only done
+    // for operations that may be reported. getExecutor() does not compute a plan cache key for
+    // IDHACK queries either.
+    if (!index->isIdIndex() && mayReportOperation(curOp)) {
+        setQueryHashAndPlanCacheKey(opCtx, collection, qr);
+    }
+
+    if (curOp->shouldDBProfile()) {
+        curOp->debug().execStats = getExpressExecStats(opCtx, entry, key, stats);
+    }
+
+    firstBatch.done(0, collection->ns().ns());
+}
+
+}  // namespace mongo
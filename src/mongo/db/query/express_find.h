@@ -0,0 +1,76 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include "mongo/db/query/query_request.h"
+
+namespace mongo {
+
+class Collection;
+class IndexDescriptor;
+class OperationContext;
+
+namespace rpc {
+class ReplyBuilderInterface;
+}  // namespace rpc
+
+/**
+ * Returns true if 'qr' is a point read that the express path may answer without canonicalizing or
+ * planning it: an equality match on a single top-level field against a value whose index key is
+ * exact, with no projection, sort, skip, hint, min/max, collation, returnKey, showRecordId,
+ * tailable cursor or resume token. Only looks at the request, so the collection may still lack an
+ * index able to answer it.
+ */
+bool isExpressFindEligible(const QueryRequest& qr);
+
+/**
+ * Returns the index that answers the eligible query 'qr' with a single key lookup: the _id index
+ * when the filter is on _id, otherwise a ready, visible, non-partial unique btree index on the
+ * filtered field alone whose collation matches the collection's default. Returns null if there is
+ * no such index, or if the operation is versioned and so must filter out orphan documents.
+ */
+const IndexDescriptor* getExpressFindIndex(OperationContext* opCtx,
+                                           const Collection* collection,
+                                           const QueryRequest& qr);
+
+/**
+ * Answers 'qr' by looking up its key in 'index' and fetching the matching record. Appends the
+ * result as the only batch of an exhausted cursor to 'result', and fills out CurOp with the same
+ * metrics that endQueryOp() records for the equivalent plan. The query hash and plan cache key are
+ * set as getExecutor() sets them, which for a lookup on a unique index other than _id means that
+ * the query is canonicalized.
+ */
+void runExpressFind(OperationContext* opCtx,
+                    Collection* collection,
+                    const QueryRequest& qr,
+                    const IndexDescriptor* index,
+                    rpc::ReplyBuilderInterface* result);
+
+}  // namespace mongo
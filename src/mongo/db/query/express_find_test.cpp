@@ -0,0 +1,92 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/express_find.h"
+
+#include "mongo/db/json.h"
+#include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo {
+namespace {
+
+static const NamespaceString nss("testdb.testcoll");
+
+bool isEligible(const char* findCmd) {
+    const bool isExplain = false;
+    auto qr =
+        uassertStatusOK(QueryRequest::makeFromFindCommand(nss, fromjson(findCmd), isExplain));
+    return isExpressFindEligible(*qr);
+}
+
+TEST(ExpressFindTest, EqualityOnSingleFieldIsEligible) {
+    ASSERT_TRUE(isEligible("{find: 'testcoll', filter: {_id: 1}}"));
+    ASSERT_TRUE(isEligible("{find: 'testcoll', filter: {_id: 'abc'}}"));
+    ASSERT_TRUE(isEligible("{find: 'testcoll', filter: {_id: {a: 1, b: 2}}}"));
+    ASSERT_TRUE(isEligible("{find: 'testcoll', filter: {a: Timestamp(1, 2)}}"));
+    ASSERT_TRUE(isEligible("{find: 'testcoll', filter: {_id: 1}, limit: 1, singleBatch: true}"));
+    ASSERT_TRUE(isEligible("{find: 'testcoll', filter: {_id: 1}, batchSize: 1}"));
+}
+
+TEST(ExpressFindTest, FiltersWithoutExactIndexKeysAreNotEligible) {
+    ASSERT_FALSE(isEligible("{find: 'testcoll', filter: {}}"));
+    ASSERT_FALSE(isEligible("{find: 'testcoll', filter: {_id: 1, a: 1}}"));
+    ASSERT_FALSE(isEligible("{find: 'testcoll', filter: {'a.b': 1}}"));
+    ASSERT_FALSE(isEligible("{find: 'testcoll', filter: {_id: {$gt: 1}}}"));
+    ASSERT_FALSE(isEligible("{find: 'testcoll', filter: {_id: [1, 2]}}"));
+    ASSERT_FALSE(isEligible("{find: 'testcoll', filter: {_id: null}}"));
+    ASSERT_FALSE(isEligible("{find: 'testcoll', filter: {_id: /abc/}}"));
+    ASSERT_FALSE(isEligible("{find: 'testcoll', filter: {$or: [{_id: 1}]}}"));
+}
+
+TEST(ExpressFindTest, OptionsNeedingQuerySystemAreNotEligible) {
+    ASSERT_FALSE(isEligible("{find: 'testcoll', filter: {_id: 1}, projection: {a: 1}}"));
+    ASSERT_FALSE(isEligible("{find: 'testcoll', filter: {_id: 1}, sort: {a: 1}}"));
+    ASSERT_FALSE(isEligible("{find: 'testcoll', filter: {_id: 1}, skip: 1}"));
+    ASSERT_FALSE(isEligible("{find: 'testcoll', filter: {_id: 1}, hint: {_id: 1}}"));
+    ASSERT_FALSE(isEligible("{find: 'testcoll', filter: {_id: 1}, min: {_id: 0}}"));
+    ASSERT_FALSE(isEligible("{find: 'testcoll', filter: {_id: 1}, max: {_id: 2}}"));
+    ASSERT_FALSE(isEligible("{find: 'testcoll', filter: {_id: 1}, collation: {locale: 'fr'}}"));
+    ASSERT_FALSE(isEligible("{find: 'testcoll', filter: {_id: 1}, returnKey: true}"));
+    ASSERT_FALSE(isEligible("{find: 'testcoll', filter: {_id: 1}, showRecordId: true}"));
+    ASSERT_FALSE(isEligible("{find: 'testcoll', filter: {_id: 1}, tailable: true}"));
+    ASSERT_FALSE(isEligible("{find: 'testcoll', filter: {_id: 1}, batchSize: 0}"));
+}
+
+TEST(ExpressFindTest, DisabledByKnob) {
+    internalQueryEnableExpressFind.store(false);
+    ON_BLOCK_EXIT([] { internalQueryEnableExpressFind.store(true); });
+    ASSERT_FALSE(isEligible("{find: 'testcoll', filter: {_id: 1}}"));
+}
+
+}  // namespace
+}  // namespace mongo
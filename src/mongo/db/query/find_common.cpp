@@ -33,6 +33,8 @@
 
 #include "mongo/db/query/find_common.h"
 
+#include <functional>
+
 #include "mongo/bson/bsonobj.h"
 #include "mongo/db/curop.h"
 #include "mongo/db/curop_failpoint_helpers.h"
@@ -40,6 +42,7 @@
 #include "mongo/db/query/query_request.h"
 #include "mongo/logv2/log.h"
 #include "mongo/util/assert_util.h"
+#include "mongo/util/str.h"
 
 namespace mongo {
 
@@ -78,12 +81,16 @@ bool FindCommon::haveSpaceForNext(const BSONObj& nextDoc, long long numDocs, int
     return (bytesBuffered + nextDoc.objsize()) <= kMaxBytesToReturnToClientAtOnce;
 }
 
-void FindCommon::waitInFindBeforeMakingBatch(OperationContext* opCtx, const CanonicalQuery& cq) {
+namespace {
+
+void waitInFindBeforeMakingBatchImpl(OperationContext* opCtx,
+                                     const NamespaceString& nss,
+                                     const std::function<std::string()>& describeQuery) {
     auto whileWaitingFunc = [&, hasLogged = false]() mutable {
         if (!std::exchange(hasLogged, true)) {
             LOGV2(20908,
                   "Waiting in find before making batch for query - {cq_Short}",
-                  "cq_Short"_attr = redact(cq.toStringShort()));
+                  "cq_Short"_attr = redact(describeQuery()));
         }
     };
 
@@ -92,6 +99,18 @@ void FindCommon::waitInFindBeforeMakingBatch(OperationContext* opCtx, const Cano
                                                      "waitInFindBeforeMakingBatch",
                                                      std::move(whileWaitingFunc),
                                                      /* checkForInterrupt = */ false,
-                                                     cq.nss());
+                                                     nss);
+}
+
+}  // namespace
+
+void FindCommon::waitInFindBeforeMakingBatch(OperationContext* opCtx, const CanonicalQuery& cq) {
+    waitInFindBeforeMakingBatchImpl(opCtx, cq.nss(), [&] { return cq.toStringShort(); });
+}
+
+void FindCommon::waitInFindBeforeMakingBatch(OperationContext* opCtx, const QueryRequest& qr) {
+    waitInFindBeforeMakingBatchImpl(opCtx, qr.nss(), [&] {
+        return str::stream() << "ns: " << qr.nss().ns() << " query: " << qr.getFilter().toString();
+    });
 }
 }  // namespace mongo
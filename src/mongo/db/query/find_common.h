@@ -128,6 +128,11 @@ public:
      * failpoint is active.
      */
     static void waitInFindBeforeMakingBatch(OperationContext* opCtx, const CanonicalQuery& cq);
+
+    /**
+     * Same as above, for the express find path, which answers a query without canonicalizing it.
+     */
+    static void waitInFindBeforeMakingBatch(OperationContext* opCtx, const QueryRequest& qr);
 };
 
 }  // namespace mongo
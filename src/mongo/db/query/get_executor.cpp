@@ -68,6 +68,7 @@
 #include "mongo/db/query/explain.h"
 #include "mongo/db/query/index_bounds_builder.h"
 #include "mongo/db/query/internal_plans.h"
+#include "mongo/db/query/operation_arena.h"
 #include "mongo/db/query/plan_cache.h"
 #include "mongo/db/query/plan_executor.h"
 #include "mongo/db/query/planner_access.h"
@@ -375,6 +376,8 @@ StatusWith<PrepareExecutionResult> prepareExecution(OperationContext* opCtx,
                                                     unique_ptr<CanonicalQuery> canonicalQuery,
                                                     size_t plannerOptions) {
     invariant(canonicalQuery);
+    // Query solutions come from the operation's arena.
+    ScopedOperationArena arena(opCtx);
     unique_ptr<PlanStage> root;
 
     // This can happen as we're called by internal clients as well.
@@ -166,6 +166,38 @@ bool isEqualityOrInNull(MatchExpression* me) {
     return false;
 }
 
+/**
+ * Appends a point interval to 'oil' for each of 'points', in order. Rather than allocating a
+ * BSONObj per interval, the intervals reference consecutive elements of a few large shared
+ * buffers, since an $in list may contain many thousands of values.
+ */
+void appendPointIntervals(const std::vector<BSONElement>& points,
+                          const CollatorInterface* collator,
+                          OrderedIntervalList* oil) {
+    // Bounds the size of each shared buffer well below the maximum size of a BSONObj.
+    constexpr int kMaxBufferBytes = 1024 * 1024;
+
+    oil->intervals.reserve(oil->intervals.size() + points.size());
+    auto it = points.begin();
+    while (it != points.end()) {
+        BSONObjBuilder bob;
+        auto chunkEnd = it;
+        for (; chunkEnd != points.end() && bob.len() < kMaxBufferBytes; ++chunkEnd) {
+            CollationIndexKey::collationAwareIndexKeyAppend(*chunkEnd, collator, &bob);
+        }
+
+        BSONObj buffer = bob.obj();
+        for (auto&& elt : buffer) {
+            Interval interval;
+            interval._intervalData = buffer;
+            interval.start = interval.end = elt;
+            interval.startInclusive = interval.endInclusive = true;
+            oil->intervals.push_back(std::move(interval));
+        }
+        it = chunkEnd;
+    }
+}
+
 }  // namespace
 
 string IndexBoundsBuilder::simpleRegex(const char* regex,
@@ -831,15 +863,23 @@ void IndexBoundsBuilder::_translatePredicate(const MatchExpression* expr,
 
         IndexBoundsBuilder::BoundsTightness tightness;
         bool arrayOrNullPresent = false;
+        std::vector<BSONElement> scalarPoints;
         for (auto&& equality : ime->getEqualities()) {
+            const bool isArrayOrNull =
+                equality.type() == BSONType::jstNULL || equality.type() == BSONType::Array;
+            if (!isHashed && !isArrayOrNull) {
+                // Scalars translate to exact point intervals, which are built together below.
+                scalarPoints.push_back(equality);
+                continue;
+            }
             translateEquality(equality, index, isHashed, oilOut, &tightness);
             // The ordering invariant of oil has been violated by the call to translateEquality.
-            arrayOrNullPresent = arrayOrNullPresent || equality.type() == BSONType::jstNULL ||
-                equality.type() == BSONType::Array;
+            arrayOrNullPresent = arrayOrNullPresent || isArrayOrNull;
             if (tightness != IndexBoundsBuilder::EXACT) {
                 *tightnessOut = tightness;
             }
         }
+        appendPointIntervals(scalarPoints, index.collator, oilOut);
 
         for (auto&& regex : ime->getRegexes()) {
             translateRegex(regex.get(), index, oilOut, &tightness);
@@ -864,6 +864,67 @@ TEST_F(IndexBoundsBuilderTest, TranslateInArray) {
     ASSERT_EQUALS(tightness, IndexBoundsBuilder::INEXACT_FETCH);
 }
 
+TEST_F(IndexBoundsBuilderTest, TranslateLargeInSharesPointIntervalBuffers) {
+    auto testIndex = buildSimpleIndexEntry();
+    BSONArrayBuilder inList;
+    for (int i = 20000; i > 0; --i) {
+        inList.append(std::string(100, 'a') + std::to_string(i));
+    }
+    BSONObj obj = BSON("a" << BSON("$in" << inList.arr()));
+    auto expr = parseMatchExpression(obj);
+    BSONElement elt = obj.firstElement();
+    OrderedIntervalList oil;
+    IndexBoundsBuilder::BoundsTightness tightness;
+    IndexBoundsBuilder::translate(expr.get(), elt, testIndex, &oil, &tightness);
+    ASSERT_EQUALS(oil.name, "a");
+    ASSERT_EQUALS(oil.intervals.size(), 20000U);
+    ASSERT_EQUALS(tightness, IndexBoundsBuilder::EXACT);
+    for (size_t i = 0; i < oil.intervals.size(); ++i) {
+        ASSERT_TRUE(oil.intervals[i].isPoint());
+        ASSERT_FALSE(oil.intervals[i].isEmpty());
+        if (i > 0) {
+            ASSERT_LT(oil.intervals[i - 1].start.woCompare(oil.intervals[i].start, false), 0);
+        }
+    }
+    ASSERT_EQUALS(Interval::INTERVAL_EQUALS,
+                  oil.intervals[0].compare(Interval(
+                      BSON("" << std::string(100, 'a') + "1" << "" << std::string(100, 'a') + "1"),
+                      true,
+                      true)));
+
+    // The intervals are backed by a few shared buffers rather than one allocation each.
+    ASSERT_EQUALS(oil.intervals[0]._intervalData.objdata(),
+                  oil.intervals[1]._intervalData.objdata());
+    ASSERT_NOT_EQUALS(oil.intervals.front()._intervalData.objdata(),
+                      oil.intervals.back()._intervalData.objdata());
+}
+
+TEST_F(IndexBoundsBuilderTest, TranslateInWithNullAndScalars) {
+    auto testIndex = buildSimpleIndexEntry();
+    BSONObj obj = fromjson("{a: {$in: [3, null, 1, [2]]}}");
+    auto expr = parseMatchExpression(obj);
+    BSONElement elt = obj.firstElement();
+    OrderedIntervalList oil;
+    IndexBoundsBuilder::BoundsTightness tightness;
+    IndexBoundsBuilder::translate(expr.get(), elt, testIndex, &oil, &tightness);
+    ASSERT_EQUALS(oil.name, "a");
+    ASSERT_EQUALS(oil.intervals.size(), 6U);
+    ASSERT_EQUALS(Interval::INTERVAL_EQUALS,
+                  oil.intervals[0].compare(
+                      Interval(BSON("" << BSONUndefined << "" << BSONUndefined), true, true)));
+    ASSERT_EQUALS(Interval::INTERVAL_EQUALS,
+                  oil.intervals[1].compare(Interval(fromjson("{'': null, '': null}"), true, true)));
+    ASSERT_EQUALS(Interval::INTERVAL_EQUALS,
+                  oil.intervals[2].compare(Interval(fromjson("{'': 1, '': 1}"), true, true)));
+    ASSERT_EQUALS(Interval::INTERVAL_EQUALS,
+                  oil.intervals[3].compare(Interval(fromjson("{'': 2, '': 2}"), true, true)));
+    ASSERT_EQUALS(Interval::INTERVAL_EQUALS,
+                  oil.intervals[4].compare(Interval(fromjson("{'': 3, '': 3}"), true, true)));
+    ASSERT_EQUALS(Interval::INTERVAL_EQUALS,
+                  oil.intervals[5].compare(Interval(fromjson("{'': [2], '': [2]}"), true, true)));
+    ASSERT_EQUALS(tightness, IndexBoundsBuilder::INEXACT_FETCH);
+}
+
 TEST_F(IndexBoundsBuilderTest, TranslateLteBinData) {
     auto testIndex = buildSimpleIndexEntry();
     BSONObj obj = fromjson(
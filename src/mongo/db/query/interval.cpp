@@ -56,7 +56,8 @@ void Interval::init(BSONObj base, bool si, bool ei) {
 }
 
 bool Interval::isEmpty() const {
-    return _intervalData.nFields() == 0;
+    // '_intervalData' may be shared by many point intervals, so avoid counting its fields.
+    return _intervalData.isEmpty();
 }
 
 bool Interval::isPoint() const {
@@ -0,0 +1,255 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/operation_arena.h"
+
+#include <algorithm>
+#include <new>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+namespace {
+
+// While the arena is enabled, every allocation is preceded by a header holding the pool it came
+// from, or null if it came from the heap. The header is padded so that objects keep the alignment
+// the heap would give them.
+constexpr size_t kHeaderSize = alignof(std::max_align_t);
+MONGO_STATIC_ASSERT(kHeaderSize >= sizeof(void*));
+
+// Blocks start small, since most operations plan a single short query, and double from there.
+constexpr size_t kFirstBlockSize = 4 * 1024;
+constexpr size_t kMaxBlockSize = 64 * 1024;
+
+// Allocations larger than this come from the heap rather than waste the rest of a block.
+constexpr size_t kMaxArenaAllocationSize = kMaxBlockSize / 4;
+
+const auto getOperationArena = OperationContext::declareDecoration<OperationArena>();
+
+thread_local OperationArena* currentArena = nullptr;
+
+// Bytes reserved by pools whose operation has finished but which objects still hold.
+AtomicWord<long long> retainedBytes{0};
+
+size_t alignToHeader(size_t size) {
+    return (size + kHeaderSize - 1) & ~(kHeaderSize - 1);
+}
+
+// Whether allocations carry a header. This is decided once, by the value of
+// 'internalQueryOperationArenaMaxBytes' when the first object is allocated, since every object
+// must be freed the same way it was allocated.
+bool headersEnabled() {
+    static const bool enabled = internalQueryOperationArenaMaxBytes.load() > 0;
+    return enabled;
+}
+
+}  // namespace
+
+/**
+ * The memory behind an OperationArena. It is reference counted by the OperationArena and by every
+ * live allocation, and frees all of its blocks at once when the count drops to zero. Once its
+ * operation has finished, the bytes it still reserves count towards 'retainedBytes'.
+ */
+class OperationArena::Pool {
+public:
+    explicit Pool(size_t maxBytes) : _maxBytes(maxBytes) {}
+
+    /**
+     * Returns 'bytes' from the current block, or from a new block if it is full. Sets
+     * 'startedBlock' if a new block was reserved. Returns null if the pool has reached its limit.
+     */
+    char* allocate(size_t bytes, bool* startedBlock) {
+        if (static_cast<size_t>(_end - _cursor) < bytes) {
+            const size_t blockSize = std::max(_nextBlockSize, kHeaderSize + bytes);
+            if (_reservedBytes + blockSize > _maxBytes) {
+                return nullptr;
+            }
+
+            auto block = static_cast<char*>(::operator new(blockSize));
+            *reinterpret_cast<char**>(block) = _blocks;
+            _blocks = block;
+            _cursor = block + kHeaderSize;
+            _end = block + blockSize;
+            _reservedBytes += blockSize;
+            _nextBlockSize = std::min(_nextBlockSize * 2, kMaxBlockSize);
+            *startedBlock = true;
+        }
+
+        char* out = _cursor;
+        _cursor += bytes;
+        _refCount.fetchAndAdd(1);
+        return out;
+    }
+
+    /**
+     * Drops the reference of the owning OperationArena. The pool no longer grows after this.
+     */
+    void detach() noexcept {
+        _detached = true;
+        retainedBytes.fetchAndAdd(_reservedBytes);
+        release();
+    }
+
+    void release() noexcept {
+        if (_refCount.subtractAndFetch(1) == 0) {
+            delete this;
+        }
+    }
+
+private:
+    ~Pool() {
+        if (_detached) {
+            retainedBytes.fetchAndSubtract(_reservedBytes);
+        }
+
+        while (_blocks) {
+            char* next = *reinterpret_cast<char**>(_blocks);
+            ::operator delete(_blocks);
+            _blocks = next;
+        }
+    }
+
+    const size_t _maxBytes;
+
+    // Each block starts with a header pointing to the previously reserved block.
+    char* _blocks = nullptr;
+    char* _cursor = nullptr;
+    char* _end = nullptr;
+    size_t _nextBlockSize = kFirstBlockSize;
+    size_t _reservedBytes = 0;
+    bool _detached = false;
+
+    // One reference for the owning OperationArena and one for each live allocation.
+    AtomicWord<long long> _refCount{1};
+};
+
+OperationArena& OperationArena::get(OperationContext* opCtx) {
+    return getOperationArena(opCtx);
+}
+
+OperationArena::~OperationArena() {
+    if (_pool) {
+        _pool->detach();
+    }
+}
+
+long long OperationArena::getRetainedBytes() {
+    return retainedBytes.load();
+}
+
+void* OperationArena::allocate(size_t size) {
+    if (!headersEnabled()) {
+        return ::operator new(size);
+    }
+
+    const size_t bytes = kHeaderSize + alignToHeader(size);
+
+    if (auto arena = currentArena; arena && size <= kMaxArenaAllocationSize) {
+        bool startedBlock = false;
+        if (char* raw = arena->_pool->allocate(bytes, &startedBlock)) {
+            *reinterpret_cast<Pool**>(raw) = arena->_pool;
+            arena->_allocations.storeRelaxed(arena->_allocations.loadRelaxed() + 1);
+            arena->_bytesAllocated.storeRelaxed(arena->_bytesAllocated.loadRelaxed() + bytes);
+            if (startedBlock) {
+                arena->_blocks.storeRelaxed(arena->_blocks.loadRelaxed() + 1);
+            }
+            return raw + kHeaderSize;
+        }
+    }
+
+    auto raw = static_cast<char*>(::operator new(bytes));
+    *reinterpret_cast<Pool**>(raw) = nullptr;
+    return raw + kHeaderSize;
+}
+
+void OperationArena::deallocate(void* ptr) noexcept {
+    if (!ptr) {
+        return;
+    }
+
+    if (!headersEnabled()) {
+        ::operator delete(ptr);
+        return;
+    }
+
+    char* raw = static_cast<char*>(ptr) - kHeaderSize;
+    if (auto pool = *reinterpret_cast<Pool**>(raw)) {
+        pool->release();
+    } else {
+        ::operator delete(raw);
+    }
+}
+
+void OperationArena::append(BSONObjBuilder* builder) const {
+    if (auto allocations = getAllocations(); allocations > 0) {
+        builder->append("allocations", allocations);
+        builder->append("bytesAllocated", getBytesAllocated());
+        builder->append("blocks", _blocks.loadRelaxed());
+    }
+}
+
+BSONObj OperationArena::toBSON() const {
+    BSONObjBuilder builder;
+    append(&builder);
+    return builder.obj();
+}
+
+ScopedOperationArena::ScopedOperationArena(OperationContext* opCtx) : _previous(currentArena) {
+    if (!opCtx) {
+        return;
+    }
+
+    const int maxBytes = internalQueryOperationArenaMaxBytes.load();
+    if (maxBytes <= 0 || !headersEnabled()) {
+        return;
+    }
+
+    // Objects that outlive their operation, like the query of an idle cursor, keep their arena's
+    // memory reserved. Once those arenas hold too much, new operations use the heap.
+    if (retainedBytes.load() >= internalQueryOperationArenaMaxRetainedBytes.load()) {
+        return;
+    }
+
+    auto& arena = OperationArena::get(opCtx);
+    if (!arena._pool) {
+        arena._pool = new OperationArena::Pool(maxBytes);
+    }
+    currentArena = &arena;
+}
+
+ScopedOperationArena::~ScopedOperationArena() {
+    currentArena = _previous;
+}
+
+}  // namespace mongo
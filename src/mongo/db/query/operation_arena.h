@@ -0,0 +1,167 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstddef>
+
+#include "mongo/bson/bsonobj.h"
+#include "mongo/platform/atomic_word.h"
+
+namespace mongo {
+
+class BSONObjBuilder;
+class OperationContext;
+
+/**
+ * A bump-pointer arena for the many small objects that parsing and planning a query creates:
+ * MatchExpression nodes and QuerySolutionNodes. These classes derive from OperationArenaAllocated,
+ * so 'new' takes them from the arena of the operation while a ScopedOperationArena is active on
+ * the thread, and from the heap otherwise. PlanStages are always allocated from the heap, because
+ * the plan executor of a cursor keeps them, the multi-planner's losing candidates included, for as
+ * long as the cursor lives.
+ *
+ * Individual deletes only count down the arena's live allocations; its memory is freed in bulk
+ * once the operation has finished and every object allocated from it has been deleted. Objects may
+ * therefore outlive the operation, as the query of a cursor does, and be deleted from any thread.
+ * Each arena stops handing out memory once it has reserved 'internalQueryOperationArenaMaxBytes',
+ * so that operations which plan many queries, like $lookup, do not grow without bound, and no new
+ * arenas are started while those kept alive by finished operations reserve
+ * 'internalQueryOperationArenaMaxRetainedBytes' in total.
+ *
+ * If 'internalQueryOperationArenaMaxBytes' is zero when the first object is allocated, the arena
+ * stays disabled for the life of the process and objects are allocated from the heap without the
+ * header that records where they came from.
+ *
+ * Only the thread running the operation allocates, but the statistics may be read concurrently,
+ * for instance by $currentOp.
+ */
+class OperationArena {
+    OperationArena(const OperationArena&) = delete;
+    OperationArena& operator=(const OperationArena&) = delete;
+
+public:
+    static OperationArena& get(OperationContext* opCtx);
+
+    OperationArena() = default;
+    ~OperationArena();
+
+    /**
+     * Allocates 'size' bytes from the arena of the innermost active ScopedOperationArena on this
+     * thread, or from the heap if there is none.
+     */
+    static void* allocate(size_t size);
+
+    /**
+     * Releases memory obtained from allocate().
+     */
+    static void deallocate(void* ptr) noexcept;
+
+    /**
+     * Returns the number of allocations served by this operation's arena.
+     */
+    long long getAllocations() const {
+        return _allocations.loadRelaxed();
+    }
+
+    /**
+     * Returns the number of bytes handed out by this operation's arena.
+     */
+    long long getBytesAllocated() const {
+        return _bytesAllocated.loadRelaxed();
+    }
+
+    /**
+     * Returns the number of bytes reserved by the arenas of finished operations which still have
+     * live allocations.
+     */
+    static long long getRetainedBytes();
+
+    /**
+     * Appends "allocations", "bytesAllocated" and "blocks" if the arena has served any allocation.
+     */
+    void append(BSONObjBuilder* builder) const;
+
+    /**
+     * Returns the output of append() as an object, which is empty if nothing was allocated.
+     */
+    BSONObj toBSON() const;
+
+private:
+    friend class ScopedOperationArena;
+
+    class Pool;
+
+    Pool* _pool = nullptr;
+
+    AtomicWord<long long> _allocations{0};
+    AtomicWord<long long> _bytesAllocated{0};
+    AtomicWord<long long> _blocks{0};
+};
+
+/**
+ * Makes 'new' of OperationArenaAllocated classes use the arena of 'opCtx' until it goes out of
+ * scope, then restores whichever arena was active before. Does nothing without an operation, when
+ * the arena is disabled or when the arenas of finished operations already retain too much memory.
+ */
+class ScopedOperationArena {
+    ScopedOperationArena(const ScopedOperationArena&) = delete;
+    ScopedOperationArena& operator=(const ScopedOperationArena&) = delete;
+
+public:
+    explicit ScopedOperationArena(OperationContext* opCtx);
+    ~ScopedOperationArena();
+
+private:
+    OperationArena* _previous;
+};
+
+/**
+ * Base class for the objects that should come from the operation's arena. The class must be
+ * deleted through a virtual destructor, or through a pointer to its most derived type.
+ */
+class OperationArenaAllocated {
+public:
+    static void* operator new(size_t size) {
+        return OperationArena::allocate(size);
+    }
+
+    static void operator delete(void* ptr) noexcept {
+        OperationArena::deallocate(ptr);
+    }
+
+    // Declaring the operators above hides the global placement forms.
+    static void* operator new(size_t, void* where) noexcept {
+        return where;
+    }
+
+    static void operator delete(void*, void*) noexcept {}
+};
+
+}  // namespace mongo
@@ -0,0 +1,88 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/query/canonical_query.h"
+#include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/db/query/query_planner.h"
+#include "mongo/db/query/query_planner_params.h"
+#include "mongo/db/query/query_test_service_context.h"
+
+namespace mongo {
+namespace {
+
+static const NamespaceString nss("test.collection");
+
+// A conjunction of 'numPredicates' equality and range predicates on distinct fields.
+BSONObj makeFilter(int numPredicates) {
+    BSONObjBuilder builder;
+    for (int i = 0; i < numPredicates; ++i) {
+        const auto field = "f" + std::to_string(i);
+        if (i % 2) {
+            builder.append(field, BSON("$gt" << i));
+        } else {
+            builder.append(field, i);
+        }
+    }
+    return builder.obj();
+}
+
+// Parses and plans one query per operation, as a find command does. The first argument is the
+// number of predicates. The second argument selects the allocator: 0 uses the heap, 1 uses the
+// operation's arena.
+void BM_canonicalizeAndPlan(benchmark::State& state) {
+    const auto oldMaxBytes = internalQueryOperationArenaMaxBytes.load();
+    internalQueryOperationArenaMaxBytes.store(state.range(1) ? oldMaxBytes : 0);
+
+    QueryTestServiceContext serviceContext;
+    const BSONObj filter = makeFilter(state.range(0));
+    QueryPlannerParams params;
+
+    for (auto _ : state) {
+        auto opCtx = serviceContext.makeOperationContext();
+        auto qr = std::make_unique<QueryRequest>(nss);
+        qr->setFilter(filter);
+        auto cq = uassertStatusOK(CanonicalQuery::canonicalize(opCtx.get(), std::move(qr)));
+
+        ScopedOperationArena arena(opCtx.get());
+        benchmark::DoNotOptimize(uassertStatusOK(QueryPlanner::plan(*cq, params)));
+    }
+    state.SetItemsProcessed(state.iterations());
+
+    internalQueryOperationArenaMaxBytes.store(oldMaxBytes);
+}
+
+BENCHMARK(BM_canonicalizeAndPlan)->Ranges({{1, 32}, {0, 1}});
+
+}  // namespace
+}  // namespace mongo
@@ -0,0 +1,228 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/operation_arena.h"
+
+#include <memory>
+#include <vector>
+
+#include "mongo/db/query/canonical_query.h"
+#include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/db/query/query_test_service_context.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo {
+namespace {
+
+static const NamespaceString nss("test.collection");
+
+class ArenaObject : public OperationArenaAllocated {
+public:
+    virtual ~ArenaObject() = default;
+
+    char payload[40] = {};
+};
+
+class LargeArenaObject : public ArenaObject {
+public:
+    char largePayload[32 * 1024] = {};
+};
+
+TEST(OperationArenaTest, AllocatesFromHeapWithoutScope) {
+    QueryTestServiceContext serviceContext;
+    auto opCtx = serviceContext.makeOperationContext();
+
+    auto object = std::make_unique<ArenaObject>();
+    ASSERT_EQ(0, OperationArena::get(opCtx.get()).getAllocations());
+    ASSERT_BSONOBJ_EQ(BSONObj(), OperationArena::get(opCtx.get()).toBSON());
+}
+
+TEST(OperationArenaTest, CountsAllocationsWithinScope) {
+    QueryTestServiceContext serviceContext;
+    auto opCtx = serviceContext.makeOperationContext();
+    auto& arena = OperationArena::get(opCtx.get());
+
+    std::vector<std::unique_ptr<ArenaObject>> objects;
+    {
+        ScopedOperationArena scope(opCtx.get());
+        for (int i = 0; i < 10; ++i) {
+            objects.push_back(std::make_unique<ArenaObject>());
+        }
+    }
+    ASSERT_EQ(10, arena.getAllocations());
+    ASSERT_GTE(arena.getBytesAllocated(), 10 * static_cast<long long>(sizeof(ArenaObject)));
+
+    // Objects created after the scope has ended come from the heap again.
+    objects.push_back(std::make_unique<ArenaObject>());
+    ASSERT_EQ(10, arena.getAllocations());
+
+    auto stats = arena.toBSON();
+    ASSERT_EQ(10, stats["allocations"].numberLong());
+    ASSERT_EQ(arena.getBytesAllocated(), stats["bytesAllocated"].numberLong());
+    ASSERT_EQ(1, stats["blocks"].numberLong());
+}
+
+TEST(OperationArenaTest, LargeObjectsComeFromHeap) {
+    QueryTestServiceContext serviceContext;
+    auto opCtx = serviceContext.makeOperationContext();
+
+    ScopedOperationArena scope(opCtx.get());
+    auto object = std::make_unique<LargeArenaObject>();
+    ASSERT_EQ(0, OperationArena::get(opCtx.get()).getAllocations());
+}
+
+TEST(OperationArenaTest, ObjectsMayOutliveOperation) {
+    QueryTestServiceContext serviceContext;
+    std::vector<std::unique_ptr<ArenaObject>> objects;
+    {
+        auto opCtx = serviceContext.makeOperationContext();
+        ScopedOperationArena scope(opCtx.get());
+        for (int i = 0; i < 100; ++i) {
+            objects.push_back(std::make_unique<ArenaObject>());
+        }
+    }
+
+    // The arena's memory stays valid until the last object allocated from it is deleted, and
+    // counts as retained until then.
+    ASSERT_GT(OperationArena::getRetainedBytes(), 0);
+    for (auto&& object : objects) {
+        object->payload[0] = 'x';
+    }
+    objects.clear();
+    ASSERT_EQ(0, OperationArena::getRetainedBytes());
+}
+
+TEST(OperationArenaTest, FallsBackToHeapWhileFinishedOperationsRetainTooMuch) {
+    const auto oldMaxRetainedBytes = internalQueryOperationArenaMaxRetainedBytes.load();
+    internalQueryOperationArenaMaxRetainedBytes.store(1);
+    ON_BLOCK_EXIT(
+        [&] { internalQueryOperationArenaMaxRetainedBytes.store(oldMaxRetainedBytes); });
+
+    QueryTestServiceContext serviceContext;
+    std::vector<std::unique_ptr<ArenaObject>> objects;
+    {
+        auto opCtx = serviceContext.makeOperationContext();
+        ScopedOperationArena scope(opCtx.get());
+        objects.push_back(std::make_unique<ArenaObject>());
+        ASSERT_EQ(1, OperationArena::get(opCtx.get()).getAllocations());
+    }
+
+    auto opCtx = serviceContext.makeOperationContext();
+    {
+        ScopedOperationArena scope(opCtx.get());
+        objects.push_back(std::make_unique<ArenaObject>());
+    }
+    ASSERT_EQ(0, OperationArena::get(opCtx.get()).getAllocations());
+
+    // Once the objects of the finished operation are gone, new operations use the arena again.
+    objects.clear();
+    {
+        ScopedOperationArena scope(opCtx.get());
+        objects.push_back(std::make_unique<ArenaObject>());
+    }
+    ASSERT_EQ(1, OperationArena::get(opCtx.get()).getAllocations());
+}
+
+TEST(OperationArenaTest, FallsBackToHeapOnceLimitIsReached) {
+    const auto oldMaxBytes = internalQueryOperationArenaMaxBytes.load();
+    internalQueryOperationArenaMaxBytes.store(8 * 1024);
+    ON_BLOCK_EXIT([&] { internalQueryOperationArenaMaxBytes.store(oldMaxBytes); });
+
+    QueryTestServiceContext serviceContext;
+    auto opCtx = serviceContext.makeOperationContext();
+    auto& arena = OperationArena::get(opCtx.get());
+
+    std::vector<std::unique_ptr<ArenaObject>> objects;
+    ScopedOperationArena scope(opCtx.get());
+    for (int i = 0; i < 1000; ++i) {
+        objects.push_back(std::make_unique<ArenaObject>());
+    }
+    ASSERT_GT(arena.getAllocations(), 0);
+    ASSERT_LT(arena.getAllocations(), 1000);
+    ASSERT_LTE(arena.getBytesAllocated(), 8 * 1024);
+}
+
+TEST(OperationArenaTest, DisabledWhenLimitIsZero) {
+    const auto oldMaxBytes = internalQueryOperationArenaMaxBytes.load();
+    internalQueryOperationArenaMaxBytes.store(0);
+    ON_BLOCK_EXIT([&] { internalQueryOperationArenaMaxBytes.store(oldMaxBytes); });
+
+    QueryTestServiceContext serviceContext;
+    auto opCtx = serviceContext.makeOperationContext();
+
+    ScopedOperationArena scope(opCtx.get());
+    auto object = std::make_unique<ArenaObject>();
+    ASSERT_EQ(0, OperationArena::get(opCtx.get()).getAllocations());
+}
+
+TEST(OperationArenaTest, NestedScopesRestoreEnclosingArena) {
+    QueryTestServiceContext serviceContext;
+    auto opCtx = serviceContext.makeOperationContext();
+    auto& arena = OperationArena::get(opCtx.get());
+
+    std::vector<std::unique_ptr<ArenaObject>> objects;
+    {
+        ScopedOperationArena outer(opCtx.get());
+        {
+            // A scope without an operation leaves the enclosing arena in place.
+            ScopedOperationArena inner(nullptr);
+            objects.push_back(std::make_unique<ArenaObject>());
+        }
+        {
+            ScopedOperationArena inner(opCtx.get());
+            objects.push_back(std::make_unique<ArenaObject>());
+        }
+        objects.push_back(std::make_unique<ArenaObject>());
+    }
+    objects.push_back(std::make_unique<ArenaObject>());
+    ASSERT_EQ(3, arena.getAllocations());
+}
+
+TEST(OperationArenaTest, CanonicalizeAllocatesMatchExpressionsFromArena) {
+    QueryTestServiceContext serviceContext;
+    auto opCtx = serviceContext.makeOperationContext();
+
+    auto qr = std::make_unique<QueryRequest>(nss);
+    qr->setFilter(fromjson("{a: 1, b: {$gt: 2}, c: {$in: [1, 2, 3]}}"));
+    auto statusWithCQ = CanonicalQuery::canonicalize(opCtx.get(), std::move(qr));
+    ASSERT_OK(statusWithCQ.getStatus());
+
+    // The $and and its three children.
+    ASSERT_GTE(OperationArena::get(opCtx.get()).getAllocations(), 4);
+
+    // The query may be destroyed after the operation that parsed it.
+    opCtx.reset();
+    statusWithCQ.getValue().reset();
+}
+
+}  // namespace
+}  // namespace mongo
@@ -56,6 +56,7 @@
 #include "mongo/db/query/plan_yield_policy.h"
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/service_context.h"
+#include "mongo/db/stats/operation_phase_timers.h"
 #include "mongo/logv2/log.h"
 #include "mongo/util/fail_point.h"
 #include "mongo/util/scopeguard.h"
@@ -243,6 +244,7 @@ PlanExecutorImpl::PlanExecutorImpl(OperationContext* opCtx,
 
 Status PlanExecutorImpl::_pickBestPlan() {
     invariant(_currentState == kUsable);
+    ScopedOperationPhase planningPhase(_opCtx, OperationPhase::kPlanning);
 
     // First check if we need to do subplanning.
     PlanStage* foundStage = getStageByType(_root.get(), STAGE_SUBPLAN);
@@ -522,6 +524,8 @@ PlanExecutor::ExecState PlanExecutorImpl::_getNextImpl(Snapshotted<Document>* ob
         return PlanExecutor::ADVANCED;
     }
 
+    ScopedOperationPhase executionPhase(_opCtx, OperationPhase::kExecution);
+
     // Incremented on every writeConflict, reset to 0 on any successful call to _root->work.
     size_t writeConflictsInARow = 0;
 
@@ -634,7 +638,10 @@ PlanExecutor::ExecState PlanExecutorImpl::_getNextImpl(Snapshotted<Document>* ob
             if (!_shouldWaitForInserts()) {
                 return PlanExecutor::IS_EOF;
             }
-            const ExecState waitResult = _waitForInserts(&cappedInsertNotifierData, objOut);
+            const ExecState waitResult = [&] {
+                ScopedOperationPhase awaitDataPhase(_opCtx, OperationPhase::kAwaitDataWait);
+                return _waitForInserts(&cappedInsertNotifierData, objOut);
+            }();
             if (waitResult == PlanExecutor::ADVANCED) {
                 // There may be more results, keep going.
                 continue;
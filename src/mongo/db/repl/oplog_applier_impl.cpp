@@ -1021,6 +1021,9 @@ Status OplogApplierImpl::applyOplogBatchPerWorker(OperationContext* opCtx,
     // destroyed by unstash in its destructor. Thus we set the flag explicitly.
     opCtx->lockState()->setShouldConflictWithSecondaryBatchApplication(false);
 
+    // Applying the batch holds up replication, so it is admitted ahead of user operations.
+    opCtx->lockState()->setAdmissionPriority(AdmissionPriority::kHigh);
+
     // Explicitly start future read transactions without a timestamp.
     opCtx->recoveryUnit()->setTimestampReadSource(RecoveryUnit::ReadSource::kNoTimestamp);
 
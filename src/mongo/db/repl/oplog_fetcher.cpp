@@ -439,6 +439,10 @@ void OplogFetcher::_runQuery(const executor::TaskExecutor::CallbackArgs& callbac
         _conn = _createClientFn();
     }
 
+    // Oplog batches are large and highly compressible, so offer the preferred compressor first
+    // when negotiating compression with the sync source.
+    _conn->getCompressorManager().setClientPreferredCompressor(oplogFetcherPreferredCompressor);
+
     if (MONGO_unlikely(logAfterOplogFetcherConnCreated.shouldFail())) {
         // Used in tests that wait for this failpoint to be entered to ensure the DBClientConnection
         // was created.
@@ -0,0 +1,136 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+
+#include "mongo/db/commands/txn_two_phase_commit_cmds_gen.h"
+#include "mongo/db/logical_session_id.h"
+#include "mongo/db/s/transaction_coordinator_service.h"
+#include "mongo/db/s/transaction_coordinator_test_fixture.h"
+#include "mongo/db/s/transaction_coordinator_util.h"
+#include "mongo/unittest/log_test.h"
+
+namespace mongo {
+namespace {
+
+const BSONObj kPrepareOk = BSON("ok" << 1 << "prepareTimestamp" << Timestamp(1, 1));
+const BSONObj kOk = BSON("ok" << 1);
+
+/**
+ * Drives batches of concurrent two-phase commits through the TransactionCoordinatorService, with
+ * the participants mocked out by the network interface mock answering every prepare and commit
+ * successfully. Each benchmark iteration starts 'state.range(0)' coordinators for two participant
+ * shards each and waits for all of them to commit, so the throughput reported is that of the
+ * coordinator's durable writes and message handling rather than of the participants.
+ */
+class CoordinatorServiceThroughputFixture : public TransactionCoordinatorTestFixture {
+public:
+    explicit CoordinatorServiceThroughputFixture(benchmark::State& state) : _state(state) {}
+
+protected:
+    void setUp() override {
+        TransactionCoordinatorTestFixture::setUp();
+
+        // The test fixture turns up the transaction log verbosity, which would dominate the
+        // measurement.
+        _transactionLogSeverity.emplace(logv2::LogComponent::kTransaction,
+                                        logv2::LogSeverity::Log());
+
+        TransactionCoordinatorService::get(operationContext())->onStepUp(operationContext());
+    }
+
+    void tearDown() override {
+        auto coordinatorService = TransactionCoordinatorService::get(operationContext());
+        coordinatorService->onStepDown();
+        coordinatorService->joinPreviousRound();
+
+        TransactionCoordinatorTestFixture::tearDown();
+        _transactionLogSeverity.reset();
+    }
+
+private:
+    void _doTest() override {
+        auto coordinatorService = TransactionCoordinatorService::get(operationContext());
+        const auto numCoordinators = _state.range(0);
+        const TxnNumber txnNumber{1};
+        const auto statsBefore = txn::getCoordinatorDocWriteBatchStats(getServiceContext());
+
+        for (auto _ : _state) {
+            std::vector<SharedSemiFuture<txn::CommitDecision>> decisions;
+            for (int64_t i = 0; i < numCoordinators; ++i) {
+                const auto lsid = makeLogicalSessionIdForTest();
+                coordinatorService->createCoordinator(
+                    operationContext(), lsid, txnNumber, Date_t::max());
+                decisions.push_back(*coordinatorService->coordinateCommit(
+                    operationContext(), lsid, txnNumber, kTwoShardIdSet));
+            }
+
+            // Every coordinator sends prepareTransaction and then commitTransaction to each of its
+            // participants. Requests from different coordinators interleave, so answer them in
+            // whatever order they arrive.
+            for (int64_t i = 0; i < 4 * numCoordinators; ++i) {
+                onCommand([](const executor::RemoteCommandRequest& request) -> StatusWith<BSONObj> {
+                    if (request.cmdObj.firstElement().fieldNameStringData() ==
+                        PrepareTransaction::kCommandName) {
+                        return kPrepareOk;
+                    }
+                    return kOk;
+                });
+            }
+
+            for (auto& decision : decisions) {
+                benchmark::DoNotOptimize(decision.get());
+            }
+        }
+
+        // Each coordinator writes its participant list and its decision, so with no batching at
+        // all there would be two update commands per coordinator.
+        const auto statsAfter = txn::getCoordinatorDocWriteBatchStats(getServiceContext());
+        const auto numBatches = statsAfter.numBatches - statsBefore.numBatches;
+        _state.counters["statementsPerBatch"] = numBatches
+            ? static_cast<double>(statsAfter.numStatements - statsBefore.numStatements) / numBatches
+            : 0;
+        _state.SetItemsProcessed(_state.iterations() * numCoordinators);
+    }
+
+    benchmark::State& _state;
+    boost::optional<unittest::MinimumLoggedSeverityGuard> _transactionLogSeverity;
+};
+
+void BM_CoordinateCommit(benchmark::State& state) {
+    CoordinatorServiceThroughputFixture fixture(state);
+    fixture.run();
+}
+
+BENCHMARK(BM_CoordinateCommit)->Arg(1)->Arg(16)->Arg(64)->Unit(benchmark::kMicrosecond);
+
+}  // namespace
+}  // namespace mongo
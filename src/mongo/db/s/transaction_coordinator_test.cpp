@@ -40,6 +40,7 @@
 #include "mongo/db/s/transaction_coordinator_metrics_observer.h"
 #include "mongo/db/s/transaction_coordinator_test_fixture.h"
 #include "mongo/logv2/log.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/unittest/log_test.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/clock_source_mock.h"
@@ -806,6 +807,79 @@ TEST_F(TransactionCoordinatorDriverPersistenceTest,
     assertDocumentMatches(allCoordinatorDocs[0], _lsid, txnNumber2, _participants);
 }
 
+TEST_F(TransactionCoordinatorDriverPersistenceTest,
+       ConcurrentlyPersistedParticipantListsAndDecisionsAreWrittenInOneBatch) {
+    const int kNumTransactions = 20;
+
+    // Each transaction's statement is written from its own thread, since the test executor runs
+    // the futures-based API on a single thread. The first statement's write is held up until every
+    // other statement has queued up behind it, after which they must all go out in one batch.
+    auto persistConcurrently = [&](auto persistBlocking) {
+        const auto statsBefore = txn::getCoordinatorDocWriteBatchStats(getServiceContext());
+
+        std::vector<Status> statuses(kNumTransactions, Status::OK());
+        std::vector<stdx::thread> threads;
+        auto startWriter = [&](TxnNumber txnNumber) {
+            threads.emplace_back([&, txnNumber] {
+                ThreadClient tc("persistCoordinatorDoc", getServiceContext());
+                auto opCtx = tc->makeOperationContext();
+                try {
+                    persistBlocking(opCtx.get(), txnNumber);
+                } catch (const DBException& ex) {
+                    statuses[txnNumber - 1] = ex.toStatus();
+                }
+            });
+        };
+
+        {
+            FailPointEnableBlock fp("hangBeforeWritingCoordinatorDocBatch");
+            startWriter(1);
+            fp->waitForTimesEntered(fp.initialTimesEntered() + 1);
+
+            for (TxnNumber txnNumber = 2; txnNumber <= kNumTransactions; ++txnNumber) {
+                startWriter(txnNumber);
+            }
+            while (txn::getCoordinatorDocWriteBatchStats(getServiceContext()).numPending <
+                   kNumTransactions - 1) {
+                sleepmillis(1);
+            }
+        }
+
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        for (const auto& status : statuses) {
+            ASSERT_OK(status);
+        }
+
+        const auto statsAfter = txn::getCoordinatorDocWriteBatchStats(getServiceContext());
+        ASSERT_EQUALS(2, statsAfter.numBatches - statsBefore.numBatches);
+        ASSERT_EQUALS(kNumTransactions, statsAfter.numStatements - statsBefore.numStatements);
+        ASSERT_EQUALS(0, statsAfter.numPending);
+    };
+
+    persistConcurrently([&](OperationContext* opCtx, TxnNumber txnNumber) {
+        txn::persistParticipantListBlocking(opCtx, _lsid, txnNumber, _participants);
+    });
+
+    persistConcurrently([&](OperationContext* opCtx, TxnNumber txnNumber) {
+        txn::CoordinatorCommitDecision decision(txn::CommitDecision::kCommit);
+        decision.setCommitTimestamp(_commitTimestamp);
+        txn::persistDecisionBlocking(opCtx, _lsid, txnNumber, _participants, decision);
+    });
+
+    auto allCoordinatorDocs = txn::readAllCoordinatorDocs(operationContext());
+    ASSERT_EQUALS(allCoordinatorDocs.size(), size_t(kNumTransactions));
+    for (const auto& doc : allCoordinatorDocs) {
+        assertDocumentMatches(doc,
+                              _lsid,
+                              *doc.getId().getTxnNumber(),
+                              _participants,
+                              txn::CommitDecision::kCommit,
+                              _commitTimestamp);
+    }
+}
+
 
 using TransactionCoordinatorTest = TransactionCoordinatorTestBase;
 
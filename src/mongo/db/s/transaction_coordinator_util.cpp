@@ -33,6 +33,9 @@
 
 #include "mongo/db/s/transaction_coordinator_util.h"
 
+#include <algorithm>
+#include <memory>
+
 #include "mongo/client/remote_command_retry_scheduler.h"
 #include "mongo/db/commands/txn_cmds_gen.h"
 #include "mongo/db/commands/txn_two_phase_commit_cmds_gen.h"
@@ -42,10 +45,13 @@
 #include "mongo/db/repl/repl_client_info.h"
 #include "mongo/db/s/transaction_coordinator_futures_util.h"
 #include "mongo/db/s/transaction_coordinator_worker_curop_repository.h"
+#include "mongo/db/service_context.h"
 #include "mongo/db/storage/flow_control.h"
 #include "mongo/db/write_concern.h"
 #include "mongo/logv2/log.h"
+#include "mongo/platform/mutex.h"
 #include "mongo/rpc/get_status_from_command_result.h"
+#include "mongo/stdx/condition_variable.h"
 #include "mongo/util/fail_point.h"
 
 namespace mongo {
@@ -59,6 +65,7 @@ MONGO_FAIL_POINT_DEFINE(hangBeforeSendingCommit);
 MONGO_FAIL_POINT_DEFINE(hangBeforeSendingAbort);
 MONGO_FAIL_POINT_DEFINE(hangBeforeDeletingCoordinatorDoc);
 MONGO_FAIL_POINT_DEFINE(hangAfterDeletingCoordinatorDoc);
+MONGO_FAIL_POINT_DEFINE(hangBeforeWritingCoordinatorDocBatch);
 
 using ResponseStatus = executor::TaskExecutor::ResponseStatus;
 using CoordinatorAction = TransactionCoordinatorWorkerCurOpRepository::CoordinatorAction;
@@ -99,9 +106,192 @@ bool shouldRetryPersistingCoordinatorState(const StatusWith<T>& responseStatus)
         responseStatus != ErrorCodes::TransactionCoordinatorSteppingDown;
 }
 
+/**
+ * Group commit for the coordinator documents: updates to config.transaction_coordinators issued
+ * concurrently by different coordinators are combined into a single unordered update command, so
+ * that a burst of coordinators pays for one command and one round of replication bookkeeping
+ * rather than one each. The resulting opTime covers every statement in the batch, which lets
+ * WaitForMajorityService satisfy all of their majority waits at once.
+ *
+ * The first writer to arrive while no batch is in flight writes the batch on its own thread on
+ * behalf of every writer which queued up behind it. The others wait for the outcome of their own
+ * statement and one of them takes over as the writer for the next batch.
+ */
+class CoordinatorDocUpdateBatcher {
+public:
+    struct Result {
+        // Outcome of this particular statement.
+        Status status{Status::OK()};
+
+        // Whether every successful statement in the batch matched (or upserted) a document. Since
+        // the update reply only reports the total, a caller which needs to know whether its own
+        // statement matched must re-run it on its own if this is false.
+        bool allMatched{true};
+
+        // The opTime of the batch, which covers this statement.
+        repl::OpTime opTime;
+    };
+
+    Result update(OperationContext* opCtx, write_ops::UpdateOpEntry entry) {
+        auto pending = std::make_shared<Pending>();
+        pending->entry = std::move(entry);
+
+        stdx::unique_lock<Latch> lk(_mutex);
+        _pending.push_back(pending);
+
+        while (true) {
+            try {
+                opCtx->waitForConditionOrInterrupt(
+                    _batchWritten, lk, [&] { return pending->result || !_batchInFlight; });
+            } catch (const DBException&) {
+                // Withdraw the statement if it has not been picked up by a writer yet, so that it
+                // is not written on behalf of a coordinator which is no longer waiting for it.
+                auto it = std::find(_pending.begin(), _pending.end(), pending);
+                if (it != _pending.end()) {
+                    _pending.erase(it);
+                }
+                throw;
+            }
+
+            if (pending->result) {
+                if (pending->result->isOK()) {
+                    return pending->result->getValue();
+                }
+
+                // The writer was interrupted before this statement's outcome was known. The writes
+                // are idempotent, so queue it up again rather than failing this coordinator with
+                // the writer's interruption.
+                pending->result.reset();
+                _pending.push_back(pending);
+                continue;
+            }
+
+            _writeBatch(opCtx, lk, pending);
+        }
+    }
+
+    CoordinatorDocWriteBatchStats getStats() {
+        stdx::lock_guard<Latch> lk(_mutex);
+        auto stats = _stats;
+        stats.numPending = _pending.size();
+        return stats;
+    }
+
+private:
+    struct Pending {
+        write_ops::UpdateOpEntry entry;
+        boost::optional<StatusWith<Result>> result;
+    };
+
+    void _writeBatch(OperationContext* opCtx,
+                     stdx::unique_lock<Latch>& lk,
+                     const std::shared_ptr<Pending>& ownStatement) {
+        invariant(!_batchInFlight);
+        _batchInFlight = true;
+
+        std::vector<std::shared_ptr<Pending>> batch;
+        const auto batchSize = std::min(_pending.size(), write_ops::kMaxWriteBatchSize);
+        batch.assign(_pending.begin(), _pending.begin() + batchSize);
+        _pending.erase(_pending.begin(), _pending.begin() + batchSize);
+        _stats.numBatches++;
+        _stats.numStatements += batchSize;
+
+        lk.unlock();
+        // Not interruptible, since the batch must be written and handed back under the lock.
+        hangBeforeWritingCoordinatorDocBatch.pauseWhileSet();
+        auto results = _runUpdate(opCtx, batch);
+        lk.lock();
+
+        // If the writer was interrupted, the other statements may have failed with the writer's
+        // interruption rather than their own error, so they are handed back for another attempt.
+        const auto interruptStatus = opCtx->checkForInterruptNoAssert();
+        for (size_t i = 0; i < batch.size(); ++i) {
+            if (!interruptStatus.isOK() && batch[i] != ownStatement) {
+                batch[i]->result = interruptStatus;
+            } else {
+                batch[i]->result = std::move(results[i]);
+            }
+        }
+
+        _batchInFlight = false;
+        _batchWritten.notify_all();
+    }
+
+    std::vector<Result> _runUpdate(OperationContext* opCtx,
+                                   const std::vector<std::shared_ptr<Pending>>& batch) {
+        std::vector<Result> results(batch.size());
+
+        try {
+            DBDirectClient client(opCtx);
+
+            // Throws if serializing the request or deserializing the response fails.
+            const auto commandResponse = client.runCommand([&] {
+                write_ops::Update updateOp(NamespaceString::kTransactionCoordinatorsNamespace);
+                updateOp.setWriteCommandBase([] {
+                    write_ops::WriteCommandBase base;
+                    base.setOrdered(false);
+                    return base;
+                }());
+                updateOp.setUpdates([&] {
+                    std::vector<write_ops::UpdateOpEntry> entries;
+                    entries.reserve(batch.size());
+                    for (const auto& pending : batch) {
+                        entries.push_back(pending->entry);
+                    }
+                    return entries;
+                }());
+                return updateOp.serialize({});
+            }());
+
+            const auto commandReply = commandResponse->getCommandReply();
+            uassertStatusOK(getStatusFromCommandResult(commandReply));
+
+            if (auto writeErrors = commandReply["writeErrors"]; !writeErrors.eoo()) {
+                for (const auto& writeError : writeErrors.Array()) {
+                    const auto errorObj = writeError.Obj();
+                    results.at(errorObj["index"].numberInt()).status =
+                        Status(ErrorCodes::Error(errorObj["code"].numberInt()),
+                               errorObj["errmsg"].str());
+                }
+            }
+
+            const auto numSucceeded = std::count_if(
+                results.begin(), results.end(), [](const Result& r) { return r.status.isOK(); });
+            const bool allMatched = commandReply["n"].numberLong() == numSucceeded;
+            const auto opTime = repl::ReplClientInfo::forClient(opCtx->getClient()).getLastOp();
+            for (auto& result : results) {
+                result.allMatched = allMatched;
+                result.opTime = opTime;
+            }
+        } catch (const DBException& ex) {
+            for (auto& result : results) {
+                result.status = ex.toStatus();
+            }
+        }
+
+        return results;
+    }
+
+    Mutex _mutex = MONGO_MAKE_LATCH("CoordinatorDocUpdateBatcher::_mutex");
+
+    // Signalled every time a batch has been written.
+    stdx::condition_variable _batchWritten;
+
+    // Statements waiting to be picked up by the next batch, in arrival order.
+    std::vector<std::shared_ptr<Pending>> _pending;
+
+    // Whether some thread is currently writing a batch.
+    bool _batchInFlight{false};
+
+    // Counts of the batches picked up by writers so far. 'numPending' is filled in by getStats().
+    CoordinatorDocWriteBatchStats _stats;
+};
+
+const auto getCoordinatorDocUpdateBatcher =
+    ServiceContext::declareDecoration<CoordinatorDocUpdateBatcher>();
+
 }  // namespace
 
-namespace {
 repl::OpTime persistParticipantListBlocking(OperationContext* opCtx,
                                             const LogicalSessionId& lsid,
                                             TxnNumber txnNumber,
@@ -122,12 +312,8 @@ repl::OpTime persistParticipantListBlocking(OperationContext* opCtx,
     sessionInfo.setSessionId(lsid);
     sessionInfo.setTxnNumber(txnNumber);
 
-    DBDirectClient client(opCtx);
-
-    // Throws if serializing the request or deserializing the response fails.
-    const auto commandResponse = client.runCommand([&] {
-        write_ops::Update updateOp(NamespaceString::kTransactionCoordinatorsNamespace);
-        updateOp.setUpdates({[&] {
+    const auto upsertResult =
+        getCoordinatorDocUpdateBatcher(opCtx->getServiceContext()).update(opCtx, [&] {
             write_ops::UpdateOpEntry entry;
 
             // Ensure that the document for the (lsid, txnNumber) either has no participant list or
@@ -143,23 +329,22 @@ repl::OpTime persistParticipantListBlocking(OperationContext* opCtx,
 
             // Update with participant list.
             TransactionCoordinatorDocument doc;
-            doc.setId(std::move(sessionInfo));
-            doc.setParticipants(std::move(participantList));
+            doc.setId(sessionInfo);
+            doc.setParticipants(participantList);
             entry.setU(doc.toBSON());
 
             entry.setUpsert(true);
             return entry;
-        }()});
-        return updateOp.serialize({});
-    }());
+        }());
 
-    const auto upsertStatus = getStatusFromWriteCommandReply(commandResponse->getCommandReply());
+    const auto& upsertStatus = upsertResult.status;
 
     // Convert a DuplicateKey error to an anonymous error.
     if (upsertStatus.code() == ErrorCodes::DuplicateKey) {
         // Attempt to include the document for this (lsid, txnNumber) in the error message, if one
         // exists. Note that this is best-effort: the document may have been deleted or manually
         // changed since the update above ran.
+        DBDirectClient client(opCtx);
         const auto doc = client.findOne(
             NamespaceString::kTransactionCoordinatorsNamespace.toString(),
             QUERY(TransactionCoordinatorDocument::kIdFieldName << sessionInfo.toBSON()));
@@ -179,9 +364,8 @@ repl::OpTime persistParticipantListBlocking(OperationContext* opCtx,
                 "sessionId"_attr = lsid.getId(),
                 "txnNumber"_attr = txnNumber);
 
-    return repl::ReplClientInfo::forClient(opCtx->getClient()).getLastOp();
+    return upsertResult.opTime;
 }
-}  // namespace
 
 Future<repl::OpTime> persistParticipantsList(txn::AsyncWorkScheduler& scheduler,
                                              const LogicalSessionId& lsid,
@@ -293,7 +477,6 @@ Future<PrepareVoteConsensus> sendPrepare(ServiceContext* service,
         });
 }
 
-namespace {
 repl::OpTime persistDecisionBlocking(OperationContext* opCtx,
                                      const LogicalSessionId& lsid,
                                      TxnNumber txnNumber,
@@ -316,60 +499,74 @@ repl::OpTime persistDecisionBlocking(OperationContext* opCtx,
     sessionInfo.setSessionId(lsid);
     sessionInfo.setTxnNumber(txnNumber);
 
-    DBDirectClient client(opCtx);
-
-    // Throws if serializing the request or deserializing the response fails.
-    const auto commandResponse = client.runCommand([&] {
-        write_ops::Update updateOp(NamespaceString::kTransactionCoordinatorsNamespace);
-        updateOp.setUpdates({[&] {
-            write_ops::UpdateOpEntry entry;
+    const auto entry = [&] {
+        write_ops::UpdateOpEntry entry;
 
-            // Ensure that the document for the (lsid, txnNumber) has the same participant list and
-            // either has no decision or the same decision. The document may have the same decision
-            // if an earlier attempt to write the decision failed waiting for writeConcern.
-            BSONObj noDecision = BSON(TransactionCoordinatorDocument::kDecisionFieldName
-                                      << BSON("$exists" << false));
-            BSONObj sameDecision =
-                BSON(TransactionCoordinatorDocument::kDecisionFieldName << decision.toBSON());
-
-            entry.setQ(BSON(TransactionCoordinatorDocument::kIdFieldName
-                            << sessionInfo.toBSON() << "$and"
-                            << buildParticipantListMatchesConditions(participantList) << "$or"
-                            << BSON_ARRAY(noDecision << sameDecision)));
-
-            entry.setU([&] {
-                TransactionCoordinatorDocument doc;
-                doc.setId(sessionInfo);
-                doc.setParticipants(std::move(participantList));
-                doc.setDecision(decision);
-                return doc.toBSON();
-            }());
+        // Ensure that the document for the (lsid, txnNumber) has the same participant list and
+        // either has no decision or the same decision. The document may have the same decision if
+        // an earlier attempt to write the decision failed waiting for writeConcern.
+        BSONObj noDecision =
+            BSON(TransactionCoordinatorDocument::kDecisionFieldName << BSON("$exists" << false));
+        BSONObj sameDecision =
+            BSON(TransactionCoordinatorDocument::kDecisionFieldName << decision.toBSON());
 
-            return entry;
-        }()});
-        return updateOp.serialize({});
-    }());
+        entry.setQ(BSON(TransactionCoordinatorDocument::kIdFieldName
+                        << sessionInfo.toBSON() << "$and"
+                        << buildParticipantListMatchesConditions(participantList) << "$or"
+                        << BSON_ARRAY(noDecision << sameDecision)));
 
-    const auto commandReply = commandResponse->getCommandReply();
-    uassertStatusOK(getStatusFromWriteCommandReply(commandReply));
+        entry.setU([&] {
+            TransactionCoordinatorDocument doc;
+            doc.setId(sessionInfo);
+            doc.setParticipants(participantList);
+            doc.setDecision(decision);
+            return doc.toBSON();
+        }());
+
+        return entry;
+    }();
+
+    const auto updateResult =
+        getCoordinatorDocUpdateBatcher(opCtx->getServiceContext()).update(opCtx, entry);
+    uassertStatusOK(updateResult.status);
+
+    auto opTime = updateResult.opTime;
+    if (!updateResult.allMatched) {
+        // Some statement in the batch did not match a document, so run this one on its own to
+        // find out whether it was this one.
+        DBDirectClient client(opCtx);
+
+        // Throws if serializing the request or deserializing the response fails.
+        const auto commandResponse = client.runCommand([&] {
+            write_ops::Update updateOp(NamespaceString::kTransactionCoordinatorsNamespace);
+            updateOp.setUpdates({entry});
+            return updateOp.serialize({});
+        }());
+
+        const auto commandReply = commandResponse->getCommandReply();
+        uassertStatusOK(getStatusFromWriteCommandReply(commandReply));
+
+        // If no document matched, throw an anonymous error. (The update itself will not have
+        // thrown an error, because it's legal for an update to match no documents.)
+        if (commandReply.getIntField("n") != 1) {
+            // Attempt to include the document for this (lsid, txnNumber) in the error message, if
+            // one exists. Note that this is best-effort: the document may have been deleted or
+            // manually changed since the update above ran.
+            const auto doc = client.findOne(
+                NamespaceString::kTransactionCoordinatorsNamespace.ns(),
+                QUERY(TransactionCoordinatorDocument::kIdFieldName << sessionInfo.toBSON()));
+            uasserted(51026,
+                      str::stream()
+                          << "While attempting to write decision "
+                          << (isCommit ? "'commit'" : "'abort'") << " for" << lsid.getId() << ':'
+                          << txnNumber
+                          << ", either failed to find document for this lsid:txnNumber or "
+                             "document existed with a different participant list, decision "
+                             "or commitTimestamp: "
+                          << doc);
+        }
 
-    // If no document matched, throw an anonymous error. (The update itself will not have thrown an
-    // error, because it's legal for an update to match no documents.)
-    if (commandReply.getIntField("n") != 1) {
-        // Attempt to include the document for this (lsid, txnNumber) in the error message, if one
-        // exists. Note that this is best-effort: the document may have been deleted or manually
-        // changed since the update above ran.
-        const auto doc = client.findOne(
-            NamespaceString::kTransactionCoordinatorsNamespace.ns(),
-            QUERY(TransactionCoordinatorDocument::kIdFieldName << sessionInfo.toBSON()));
-        uasserted(51026,
-                  str::stream() << "While attempting to write decision "
-                                << (isCommit ? "'commit'" : "'abort'") << " for" << lsid.getId()
-                                << ':' << txnNumber
-                                << ", either failed to find document for this lsid:txnNumber or "
-                                   "document existed with a different participant list, decision "
-                                   "or commitTimestamp: "
-                                << doc);
+        opTime = repl::ReplClientInfo::forClient(opCtx->getClient()).getLastOp();
     }
 
     LOGV2_DEBUG(22469,
@@ -380,9 +577,8 @@ repl::OpTime persistDecisionBlocking(OperationContext* opCtx,
                 "txnNumber"_attr = txnNumber,
                 "decision"_attr = (isCommit ? "commit" : "abort"));
 
-    return repl::ReplClientInfo::forClient(opCtx->getClient()).getLastOp();
+    return opTime;
 }
-}  // namespace
 
 Future<repl::OpTime> persistDecision(txn::AsyncWorkScheduler& scheduler,
                                      const LogicalSessionId& lsid,
@@ -804,5 +1000,9 @@ std::string txnIdToString(const LogicalSessionId& lsid, TxnNumber txnNumber) {
     return str::stream() << lsid.getId() << ':' << txnNumber;
 }
 
+CoordinatorDocWriteBatchStats getCoordinatorDocWriteBatchStats(ServiceContext* service) {
+    return getCoordinatorDocUpdateBatcher(service).getStats();
+}
+
 }  // namespace txn
 }  // namespace mongo
@@ -46,7 +46,8 @@ namespace txn {
  *    participants: ["shard0000", "shard0001"]
  * }
  *
- * into config.transaction_coordinators and returns the opTime of the upsert.
+ * into config.transaction_coordinators and returns the opTime of the upsert. The upsert may be
+ * batched with the coordinator document writes of other concurrently running coordinators.
  *
  * Throws if the upsert fails or waiting for writeConcern fails.
  *
@@ -121,7 +122,8 @@ Future<PrepareVoteConsensus> sendPrepare(ServiceContext* service,
  *    commitTimestamp: Timestamp(xxxxxxxx, x),
  * }
  *
- * Returns the opTime of the write.
+ * Returns the opTime of the write. Like the participant list, the write may be batched with those
+ * of other concurrently running coordinators.
  *
  * Throws if the update fails or waiting for writeConcern fails.
  *
@@ -236,5 +238,31 @@ Future<void> sendDecisionToShard(ServiceContext* service,
  */
 std::string txnIdToString(const LogicalSessionId& lsid, TxnNumber txnNumber);
 
+/**
+ * The synchronous bodies of persistParticipantsList and persistDecision, which write the document
+ * with the calling thread's operation context and without retrying.
+ */
+repl::OpTime persistParticipantListBlocking(OperationContext* opCtx,
+                                            const LogicalSessionId& lsid,
+                                            TxnNumber txnNumber,
+                                            const std::vector<ShardId>& participantList);
+repl::OpTime persistDecisionBlocking(OperationContext* opCtx,
+                                     const LogicalSessionId& lsid,
+                                     TxnNumber txnNumber,
+                                     const std::vector<ShardId>& participantList,
+                                     const txn::CoordinatorCommitDecision& decision);
+
+/**
+ * Counts of the update commands which have written coordinator documents on this node and of the
+ * statements they carried, along with the number of statements currently queued up behind the
+ * batch in flight.
+ */
+struct CoordinatorDocWriteBatchStats {
+    long long numBatches{0};
+    long long numStatements{0};
+    long long numPending{0};
+};
+CoordinatorDocWriteBatchStats getCoordinatorDocWriteBatchStats(ServiceContext* service);
+
 }  // namespace txn
 }  // namespace mongo
@@ -80,6 +80,7 @@
 #include "mongo/db/session_catalog_mongod.h"
 #include "mongo/db/snapshot_window_util.h"
 #include "mongo/db/stats/counters.h"
+#include "mongo/db/stats/operation_phase_timers.h"
 #include "mongo/db/stats/server_read_concern_metrics.h"
 #include "mongo/db/stats/top.h"
 #include "mongo/db/transaction_participant.h"
@@ -793,6 +794,8 @@ bool runCommandImpl(OperationContext* opCtx,
                 });
             if (reallyWait) {
                 CurOp::get(opCtx)->debug().writeConcern.emplace(opCtx->getWriteConcern());
+                ScopedOperationPhase writeConcernWaitPhase(opCtx,
+                                                           OperationPhase::kWriteConcernWait);
                 behaviors.waitForWriteConcern(opCtx, invocation, lastOpBeforeRun, bb);
             }
         };
@@ -869,10 +872,13 @@ bool runCommandImpl(OperationContext* opCtx,
         }
     });
 
-    behaviors.waitForLinearizableReadConcern(opCtx);
+    {
+        ScopedOperationPhase readConcernWaitPhase(opCtx, OperationPhase::kReadConcernWait);
+        behaviors.waitForLinearizableReadConcern(opCtx);
 
-    // Wait for data to satisfy the read concern level, if necessary.
-    behaviors.waitForSpeculativeMajorityReadConcern(opCtx);
+        // Wait for data to satisfy the read concern level, if necessary.
+        behaviors.waitForSpeculativeMajorityReadConcern(opCtx);
+    }
 
     const bool ok = [&] {
         auto body = replyBuilder->getBodyBuilder();
@@ -1183,7 +1189,10 @@ void execCommandDatabase(OperationContext* opCtx,
             rpc::TrackingMetadata::get(opCtx).setIsLogged(true);
         }
 
-        behaviors.waitForReadConcern(opCtx, invocation.get(), request);
+        {
+            ScopedOperationPhase readConcernWaitPhase(opCtx, OperationPhase::kReadConcernWait);
+            behaviors.waitForReadConcern(opCtx, invocation.get(), request);
+        }
         behaviors.setPrepareConflictBehaviorForReadConcern(opCtx, invocation.get());
 
         try {
@@ -1298,6 +1307,11 @@ DbResponse receivedCommands(OperationContext* opCtx,
                             const Message& message,
                             const ServiceEntryPointCommon::Hooks& behaviors) {
     auto replyBuilder = rpc::makeReplyBuilder(rpc::protocolForMessage(message));
+    if (auto opMsgBuilder = replyBuilder->getOpMsgBuilder()) {
+        // The reply is only read through its Message, which flattens any spliced documents for
+        // callers other than the transport layer, so large documents need not be copied into it.
+        opMsgBuilder->setAllowSplicing(true);
+    }
     OpMsgRequest request;
     Command* c = nullptr;
     [&] {
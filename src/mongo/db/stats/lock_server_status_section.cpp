@@ -120,7 +120,7 @@ public:
         SingleThreadedLockStats stats;
         reportGlobalLockingStats(&stats);
 
-        stats.report(&ret);
+        stats.report(&ret, &getGlobalLockContentionStats());
 
         return ret.obj();
     }
@@ -0,0 +1,222 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/stats/operation_phase_timers.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/service_context.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/hex.h"
+
+namespace mongo {
+namespace {
+
+const auto getOperationPhaseStats = ServiceContext::declareDecoration<OperationPhaseStats>();
+
+constexpr unsigned long long kClaimedSlotBit = 1ULL << 32;
+
+size_t bucketFor(long long micros) {
+    size_t bucket = 0;
+    for (; micros > 0 && bucket < OperationPhaseStats::kNumBuckets - 1; micros >>= 1) {
+        ++bucket;
+    }
+    return bucket;
+}
+
+}  // namespace
+
+const OperationContext::Decoration<OperationPhaseTimers> OperationPhaseTimers::get =
+    OperationContext::declareDecoration<OperationPhaseTimers>();
+
+StringData toString(OperationPhase phase) {
+    switch (phase) {
+        case OperationPhase::kTicketWait:
+            return "ticketWait"_sd;
+        case OperationPhase::kReadConcernWait:
+            return "readConcernWait"_sd;
+        case OperationPhase::kPlanning:
+            return "planning"_sd;
+        case OperationPhase::kExecution:
+            return "execution"_sd;
+        case OperationPhase::kAwaitDataWait:
+            return "awaitDataWait"_sd;
+        case OperationPhase::kPrepareConflict:
+            return "prepareConflict"_sd;
+        case OperationPhase::kJournalWait:
+            return "journalWait"_sd;
+        case OperationPhase::kWriteConcernWait:
+            return "writeConcernWait"_sd;
+    }
+    MONGO_UNREACHABLE;
+}
+
+Microseconds OperationPhaseTimers::getDuration(OperationPhase phase) const {
+    const auto ticksPerSecond = _ticksPerSecond.loadRelaxed();
+    if (ticksPerSecond == 0) {
+        return Microseconds(0);
+    }
+    const auto ticks = _ticks[static_cast<size_t>(phase)].loadRelaxed();
+    return Microseconds(static_cast<long long>(static_cast<double>(ticks) * 1000 * 1000 /
+                                               static_cast<double>(ticksPerSecond)));
+}
+
+void OperationPhaseTimers::append(BSONObjBuilder* builder) const {
+    for (size_t phase = 0; phase < kNumOperationPhases; ++phase) {
+        auto micros = durationCount<Microseconds>(getDuration(static_cast<OperationPhase>(phase)));
+        if (micros > 0) {
+            builder->append(toString(static_cast<OperationPhase>(phase)).toString() + "Micros",
+                            micros);
+        }
+    }
+}
+
+BSONObj OperationPhaseTimers::toBSON() const {
+    BSONObjBuilder builder;
+    append(&builder);
+    return builder.obj();
+}
+
+void OperationPhaseTimers::_switchTo(int phase, TickSource* tickSource, TickSource::Tick now) {
+    if (_activePhase != kNoPhase && now > _activeSince) {
+        auto& ticks = _ticks[_activePhase];
+        ticks.storeRelaxed(ticks.loadRelaxed() + (now - _activeSince));
+    }
+    if (_ticksPerSecond.loadRelaxed() == 0) {
+        _ticksPerSecond.storeRelaxed(tickSource->getTicksPerSecond());
+    }
+    _activePhase = phase;
+    _activeSince = now;
+}
+
+ScopedOperationPhase::ScopedOperationPhase(OperationContext* opCtx, OperationPhase phase)
+    : ScopedOperationPhase(opCtx ? &OperationPhaseTimers::get(opCtx) : nullptr,
+                           opCtx ? opCtx->getServiceContext()->getTickSource() : nullptr,
+                           phase) {}
+
+ScopedOperationPhase::ScopedOperationPhase(OperationPhaseTimers* timers,
+                                           TickSource* tickSource,
+                                           OperationPhase phase)
+    : _timers(timers), _tickSource(tickSource) {
+    if (!_timers) {
+        return;
+    }
+    _previousPhase = _timers->_activePhase;
+    _timers->_switchTo(static_cast<int>(phase), _tickSource, _tickSource->getTicks());
+}
+
+ScopedOperationPhase::~ScopedOperationPhase() {
+    if (!_timers) {
+        return;
+    }
+    _timers->_switchTo(_previousPhase, _tickSource, _tickSource->getTicks());
+}
+
+OperationPhaseStats& OperationPhaseStats::get(ServiceContext* svcCtx) {
+    return getOperationPhaseStats(svcCtx);
+}
+
+void OperationPhaseStats::record(boost::optional<uint32_t> queryHash,
+                                 const OperationPhaseTimers& timers) {
+    _allOperations.record(timers);
+    if (!queryHash) {
+        return;
+    }
+
+    // Open addressing over a fixed set of slots, which are claimed for good by the first shapes.
+    const auto key = kClaimedSlotBit | *queryHash;
+    for (size_t probe = 0; probe < kMaxQueryShapes; ++probe) {
+        auto& slot = _queryShapes[(*queryHash + probe) % kMaxQueryShapes];
+        auto slotKey = slot.key.load();
+        if (slotKey == 0) {
+            // Whether or not the claim succeeds, 'slotKey' then holds the slot's key.
+            if (slot.key.compareAndSwap(&slotKey, key)) {
+                slotKey = key;
+            }
+        }
+        if (slotKey == key) {
+            slot.histograms.record(timers);
+            return;
+        }
+    }
+    _untrackedQueryShapeOperations.fetchAndAddRelaxed(1);
+}
+
+void OperationPhaseStats::append(BSONObjBuilder* builder, bool includeQueryShapes) const {
+    {
+        BSONObjBuilder allOperations(builder->subobjStart("allOperations"));
+        _allOperations.append(&allOperations);
+    }
+
+    if (includeQueryShapes) {
+        BSONObjBuilder queryShapes(builder->subobjStart("queryShapes"));
+        for (const auto& slot : _queryShapes) {
+            if (auto key = slot.key.load(); key != 0) {
+                BSONObjBuilder shape(queryShapes.subobjStart(
+                    unsignedIntToFixedLengthHex(static_cast<uint32_t>(key))));
+                slot.histograms.append(&shape);
+            }
+        }
+    }
+
+    builder->append("untrackedQueryShapeOperations", _untrackedQueryShapeOperations.loadRelaxed());
+}
+
+void OperationPhaseStats::Histograms::record(const OperationPhaseTimers& timers) {
+    count.fetchAndAddRelaxed(1);
+    for (size_t phase = 0; phase < kNumOperationPhases; ++phase) {
+        const auto micros =
+            durationCount<Microseconds>(timers.getDuration(static_cast<OperationPhase>(phase)));
+        if (micros <= 0) {
+            continue;
+        }
+        totalMicros[phase].fetchAndAddRelaxed(micros);
+        buckets[phase][bucketFor(micros)].fetchAndAddRelaxed(1);
+    }
+}
+
+void OperationPhaseStats::Histograms::append(BSONObjBuilder* builder) const {
+    // Every phase and bucket is always appended, zero or not, so that the layout of the output
+    // never changes. FTDC starts a new chunk whenever it does.
+    builder->append("count", count.loadRelaxed());
+    for (size_t phase = 0; phase < kNumOperationPhases; ++phase) {
+        BSONObjBuilder phaseBuilder(
+            builder->subobjStart(toString(static_cast<OperationPhase>(phase))));
+        phaseBuilder.append("totalMicros", totalMicros[phase].loadRelaxed());
+        BSONArrayBuilder histogram(phaseBuilder.subarrayStart("histogram"));
+        for (size_t bucket = 0; bucket < kNumBuckets; ++bucket) {
+            BSONObjBuilder entry(histogram.subobjStart());
+            entry.append("micros", bucket ? 1LL << (bucket - 1) : 0LL);
+            entry.append("count", buckets[phase][bucket].loadRelaxed());
+        }
+    }
+}
+
+}  // namespace mongo
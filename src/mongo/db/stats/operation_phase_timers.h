@@ -0,0 +1,183 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <array>
+#include <boost/optional.hpp>
+
+#include "mongo/base/string_data.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/util/tick_source.h"
+
+namespace mongo {
+
+class BSONObjBuilder;
+class ServiceContext;
+
+/**
+ * The phases that an operation's duration is broken down into. Time spent outside of all of them
+ * is not attributed to any phase.
+ */
+enum class OperationPhase {
+    kTicketWait,        // Queued for a storage engine ticket.
+    kReadConcernWait,   // Waiting for the read concern to be satisfied.
+    kPlanning,          // Selecting a query plan.
+    kExecution,         // Running a query plan.
+    kAwaitDataWait,     // Waiting on a tailable cursor for new data to return.
+    kPrepareConflict,   // Blocked behind a prepared transaction.
+    kJournalWait,       // Waiting for the storage engine's journal to be flushed.
+    kWriteConcernWait,  // Waiting for the write concern to be satisfied.
+};
+
+constexpr size_t kNumOperationPhases = 8;
+
+StringData toString(OperationPhase phase);
+
+/**
+ * Accumulates the time an operation spends in each OperationPhase. Phases nest, and time is charged
+ * to the innermost one only: while a nested phase runs, the enclosing phase's clock is stopped. The
+ * per-phase times therefore never add up to more than the operation's duration.
+ *
+ * Only the thread running the operation enters and leaves phases, but the accumulated times may be
+ * read concurrently, for instance by $currentOp.
+ */
+class OperationPhaseTimers {
+public:
+    static const OperationContext::Decoration<OperationPhaseTimers> get;
+
+    /**
+     * Returns the time charged to 'phase' so far. Time in a phase that has not yet been left is not
+     * included.
+     */
+    Microseconds getDuration(OperationPhase phase) const;
+
+    /**
+     * Appends "<phase>Micros" for each phase that time has been charged to.
+     */
+    void append(BSONObjBuilder* builder) const;
+
+    /**
+     * Returns the output of append() as an object, which is empty if no time has been charged.
+     */
+    BSONObj toBSON() const;
+
+private:
+    friend class ScopedOperationPhase;
+
+    static constexpr int kNoPhase = -1;
+
+    /**
+     * Charges the time since the last switch to the active phase, if any, and makes 'phase' the
+     * active phase as of 'now'.
+     */
+    void _switchTo(int phase, TickSource* tickSource, TickSource::Tick now);
+
+    // Phases are summed in ticks, because each slice of a phase can be much shorter than the unit
+    // that durations are reported in. They are converted on read, using the tick source's rate.
+    std::array<AtomicWord<long long>, kNumOperationPhases> _ticks{};
+    AtomicWord<long long> _ticksPerSecond{0};
+
+    int _activePhase = kNoPhase;
+    TickSource::Tick _activeSince = 0;
+};
+
+/**
+ * Charges the time until it goes out of scope to 'phase' of an operation's OperationPhaseTimers,
+ * then resumes charging whichever phase was active before. Does nothing without an operation.
+ */
+class ScopedOperationPhase {
+    ScopedOperationPhase(const ScopedOperationPhase&) = delete;
+    ScopedOperationPhase& operator=(const ScopedOperationPhase&) = delete;
+
+public:
+    ScopedOperationPhase(OperationContext* opCtx, OperationPhase phase);
+    ScopedOperationPhase(OperationPhaseTimers* timers,
+                         TickSource* tickSource,
+                         OperationPhase phase);
+
+    ~ScopedOperationPhase();
+
+private:
+    OperationPhaseTimers* const _timers;
+    TickSource* const _tickSource;
+    int _previousPhase = OperationPhaseTimers::kNoPhase;
+};
+
+/**
+ * Instance-wide histograms of the time operations spent in each phase, overall and for each query
+ * shape, as identified by its query hash. Only the first kMaxQueryShapes shapes seen are tracked
+ * individually; operations of other shapes are counted only in the overall histograms. Recording is
+ * lock-free, so that it can be done for every operation.
+ */
+class OperationPhaseStats {
+public:
+    static constexpr size_t kMaxQueryShapes = 32;
+
+    // Times are bucketed by powers of two microseconds; the last bucket is unbounded.
+    static constexpr size_t kNumBuckets = 24;
+
+    static OperationPhaseStats& get(ServiceContext* svcCtx);
+
+    /**
+     * Adds the phase times of a completed operation.
+     */
+    void record(boost::optional<uint32_t> queryHash, const OperationPhaseTimers& timers);
+
+    /**
+     * Appends the overall histograms under "allOperations", with every phase and bucket present
+     * whether or not anything was recorded in it. The per-shape histograms are appended under
+     * "queryShapes", keyed by query hash, only if 'includeQueryShapes' is set: which shapes are
+     * tracked changes as they are seen, so they are left out of the output that FTDC collects.
+     */
+    void append(BSONObjBuilder* builder, bool includeQueryShapes) const;
+
+private:
+    struct Histograms {
+        void record(const OperationPhaseTimers& timers);
+        void append(BSONObjBuilder* builder) const;
+
+        AtomicWord<long long> count{0};
+        std::array<AtomicWord<long long>, kNumOperationPhases> totalMicros{};
+        std::array<std::array<AtomicWord<long long>, kNumBuckets>, kNumOperationPhases> buckets{};
+    };
+
+    struct QueryShapeSlot {
+        // The query hash with bit 32 set once the slot is claimed; zero while it is free.
+        AtomicWord<unsigned long long> key{0};
+        Histograms histograms;
+    };
+
+    Histograms _allOperations;
+    std::array<QueryShapeSlot, kMaxQueryShapes> _queryShapes;
+    AtomicWord<long long> _untrackedQueryShapeOperations{0};
+};
+
+}  // namespace mongo
@@ -0,0 +1,183 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/stats/operation_phase_timers.h"
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mongo/db/jsobj.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/hex.h"
+#include "mongo/util/tick_source_mock.h"
+
+namespace mongo {
+namespace {
+
+TEST(OperationPhaseTimers, NestedPhasesChargeOnlyTheInnermostPhase) {
+    TickSourceMock<Microseconds> tickSource;
+    OperationPhaseTimers timers;
+    {
+        ScopedOperationPhase execution(&timers, &tickSource, OperationPhase::kExecution);
+        tickSource.advance(Microseconds(10));
+        {
+            ScopedOperationPhase ticketWait(&timers, &tickSource, OperationPhase::kTicketWait);
+            tickSource.advance(Microseconds(5));
+        }
+        tickSource.advance(Microseconds(3));
+    }
+    // Time outside of any phase is not charged.
+    tickSource.advance(Microseconds(100));
+
+    ASSERT_EQ(timers.getDuration(OperationPhase::kExecution), Microseconds(13));
+    ASSERT_EQ(timers.getDuration(OperationPhase::kTicketWait), Microseconds(5));
+    ASSERT_EQ(timers.getDuration(OperationPhase::kPlanning), Microseconds(0));
+
+    ASSERT_BSONOBJ_EQ(timers.toBSON(),
+                      BSON("ticketWaitMicros" << 5LL << "executionMicros" << 13LL));
+}
+
+TEST(OperationPhaseTimers, SubMicrosecondSlicesAreNotLost) {
+    TickSourceMock<Nanoseconds> tickSource;
+    OperationPhaseTimers timers;
+    for (int i = 0; i < 10; ++i) {
+        ScopedOperationPhase execution(&timers, &tickSource, OperationPhase::kExecution);
+        tickSource.advance(Nanoseconds(500));
+    }
+    ASSERT_EQ(timers.getDuration(OperationPhase::kExecution), Microseconds(5));
+}
+
+TEST(OperationPhaseTimers, NothingIsReportedWithoutPhases) {
+    OperationPhaseTimers timers;
+    ASSERT_BSONOBJ_EQ(timers.toBSON(), BSONObj());
+
+    // Without an operation, a scoped phase does nothing.
+    ScopedOperationPhase phase(static_cast<OperationContext*>(nullptr), OperationPhase::kPlanning);
+}
+
+TEST(OperationPhaseStats, RecordsHistogramsOverallAndPerQueryShape) {
+    TickSourceMock<Microseconds> tickSource;
+    OperationPhaseTimers timers;
+    {
+        ScopedOperationPhase execution(&timers, &tickSource, OperationPhase::kExecution);
+        tickSource.advance(Microseconds(13));
+    }
+
+    auto stats = std::make_unique<OperationPhaseStats>();
+    stats->record(uint32_t{0xabcd}, timers);
+    stats->record(boost::none, timers);
+
+    BSONObjBuilder builder;
+    stats->append(&builder, true /* includeQueryShapes */);
+    auto obj = builder.obj();
+
+    ASSERT_EQ(obj["allOperations"]["count"].numberLong(), 2);
+    ASSERT_EQ(obj["allOperations"]["execution"]["totalMicros"].numberLong(), 26);
+    ASSERT_EQ(obj["allOperations"]["planning"]["totalMicros"].numberLong(), 0);
+
+    // 13 microseconds falls in the bucket starting at 8.
+    auto histogram = obj["allOperations"]["execution"]["histogram"].Array();
+    ASSERT_EQ(histogram.size(), OperationPhaseStats::kNumBuckets);
+    ASSERT_EQ(histogram[4]["micros"].numberLong(), 8);
+    ASSERT_EQ(histogram[4]["count"].numberLong(), 2);
+    ASSERT_EQ(histogram[3]["count"].numberLong(), 0);
+
+    auto shape = obj["queryShapes"][unsignedIntToFixedLengthHex(0xabcd)];
+    ASSERT_EQ(shape["count"].numberLong(), 1);
+    ASSERT_EQ(shape["execution"]["totalMicros"].numberLong(), 13);
+    ASSERT_EQ(obj["queryShapes"].Obj().nFields(), 1);
+    ASSERT_EQ(obj["untrackedQueryShapeOperations"].numberLong(), 0);
+}
+
+TEST(OperationPhaseStats, TracksABoundedNumberOfQueryShapes) {
+    OperationPhaseTimers timers;
+    auto stats = std::make_unique<OperationPhaseStats>();
+
+    const uint32_t numShapes = OperationPhaseStats::kMaxQueryShapes + 3;
+    for (uint32_t hash = 0; hash < numShapes; ++hash) {
+        stats->record(hash, timers);
+    }
+    // Shapes already tracked keep being recorded once the table is full.
+    stats->record(uint32_t{0}, timers);
+
+    BSONObjBuilder builder;
+    stats->append(&builder, true /* includeQueryShapes */);
+    auto obj = builder.obj();
+
+    ASSERT_EQ(obj["allOperations"]["count"].numberLong(), numShapes + 1);
+    ASSERT_EQ(static_cast<size_t>(obj["queryShapes"].Obj().nFields()),
+              OperationPhaseStats::kMaxQueryShapes);
+    ASSERT_EQ(obj["queryShapes"][unsignedIntToFixedLengthHex(0)]["count"].numberLong(), 2);
+    ASSERT_EQ(obj["untrackedQueryShapeOperations"].numberLong(), 3);
+}
+
+TEST(OperationPhaseStats, DefaultOutputLayoutDoesNotDependOnWhatWasRecorded) {
+    // Collects the path and type of every field, which is what FTDC's schema is made of.
+    std::function<void(const BSONObj&, const std::string&, std::vector<std::string>*)> layoutOf =
+        [&](const BSONObj& obj, const std::string& prefix, std::vector<std::string>* layout) {
+            for (auto&& elem : obj) {
+                auto path = prefix + elem.fieldName();
+                layout->push_back(path + ":" + typeName(elem.type()));
+                if (elem.isABSONObj()) {
+                    layoutOf(elem.Obj(), path + ".", layout);
+                }
+            }
+        };
+    auto layoutOfStats = [&](const OperationPhaseStats& stats) {
+        BSONObjBuilder builder;
+        stats.append(&builder, false /* includeQueryShapes */);
+        std::vector<std::string> layout;
+        layoutOf(builder.obj(), "", &layout);
+        return layout;
+    };
+
+    auto stats = std::make_unique<OperationPhaseStats>();
+    const auto initialLayout = layoutOfStats(*stats);
+
+    TickSourceMock<Microseconds> tickSource;
+    OperationPhaseTimers timers;
+    {
+        ScopedOperationPhase planning(&timers, &tickSource, OperationPhase::kPlanning);
+        tickSource.advance(Microseconds(100));
+    }
+    stats->record(uint32_t{1}, timers);
+
+    ASSERT_TRUE(layoutOfStats(*stats) == initialLayout);
+
+    BSONObjBuilder builder;
+    stats->append(&builder, false /* includeQueryShapes */);
+    ASSERT_FALSE(builder.obj()["queryShapes"]);
+}
+
+}  // namespace
+}  // namespace mongo
@@ -35,6 +35,7 @@
 
 #include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/db/server_options.h"
+#include "mongo/db/stats/operation_phase_timers.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_begin_transaction_block.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_kv_engine.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_prepare_conflict.h"
@@ -254,6 +255,7 @@ bool WiredTigerRecoveryUnit::waitUntilDurable(OperationContext* opCtx) {
     invariant(!opCtx->lockState()->isLocked() || storageGlobalParams.repair);
 
     // Flushes the journal log to disk. Checkpoints all data if journaling is disabled.
+    ScopedOperationPhase journalWaitPhase(opCtx, OperationPhase::kJournalWait);
     _sessionCache->waitUntilDurable(opCtx,
                                     WiredTigerSessionCache::Fsync::kJournal,
                                     WiredTigerSessionCache::UseJournalListener::kUpdate);
@@ -275,6 +277,7 @@ bool WiredTigerRecoveryUnit::waitUntilUnjournaledWritesDurable(OperationContext*
     WiredTigerSessionCache::Fsync fsyncType = stableCheckpoint
         ? WiredTigerSessionCache::Fsync::kCheckpointStableTimestamp
         : WiredTigerSessionCache::Fsync::kCheckpointAll;
+    ScopedOperationPhase journalWaitPhase(opCtx, OperationPhase::kJournalWait);
     _sessionCache->waitUntilDurable(
         opCtx, fsyncType, WiredTigerSessionCache::UseJournalListener::kUpdate);
 
@@ -34,6 +34,7 @@
 #include <string>
 #include <sys/types.h>
 #include <vector>
+#include <zstd.h>
 
 #ifdef _WIN32
 #include <io.h>
@@ -48,6 +49,7 @@
 #include "mongo/base/data_view.h"
 #include "mongo/bson/bsonobj.h"
 #include "mongo/db/traffic_reader.h"
+#include "mongo/db/traffic_recording_format.h"
 #include "mongo/rpc/factory.h"
 #include "mongo/rpc/message.h"
 #include "mongo/rpc/op_msg.h"
@@ -71,16 +73,6 @@ namespace mongo {
 
 namespace {
 
-// Packet struct
-struct TrafficReaderPacket {
-    uint64_t id;
-    StringData local;
-    StringData remote;
-    Date_t date;
-    uint64_t order;
-    MsgData::ConstView message;
-};
-
 bool readBytes(size_t toRead, char* buf, int fd) {
     while (toRead) {
 #ifdef _WIN32
@@ -109,16 +101,7 @@ bool readBytes(size_t toRead, char* buf, int fd) {
     return true;
 }
 
-boost::optional<TrafficReaderPacket> readPacket(char* buf, int fd) {
-    if (!readBytes(4, buf, fd)) {
-        return boost::none;
-    }
-    auto len = ConstDataView(buf).read<LittleEndian<uint32_t>>();
-
-    uassert(ErrorCodes::FailedToParse, "packet too large", len < MaxMessageSizeBytes);
-    uassert(
-        ErrorCodes::FailedToParse, "could not read full packet", readBytes(len - 4, buf + 4, fd));
-
+TrafficReaderPacket parsePacket(const char* buf, uint32_t len) {
     ConstDataRangeCursor cdr(buf, buf + len);
 
     // Read the packet
@@ -203,6 +186,72 @@ void addOpType(TrafficReaderPacket& packet, BSONObjBuilder* builder) {
 
 }  // namespace
 
+TrafficRecordingReader::TrafficRecordingReader(int fd)
+    : _fd(fd), _buf(SharedBuffer::allocate(MaxMessageSizeBytes)) {}
+
+boost::optional<TrafficReaderPacket> TrafficRecordingReader::next() {
+    while (true) {
+        // Hand out the remaining packets of the current compressed block first
+        if (_blockOffset < _block.size()) {
+            uassert(ErrorCodes::FailedToParse,
+                    "truncated packet in compressed block",
+                    _block.size() - _blockOffset >= sizeof(uint32_t));
+
+            const char* data = _block.data() + _blockOffset;
+            auto len = ConstDataView(data).read<LittleEndian<uint32_t>>();
+            uassert(ErrorCodes::FailedToParse,
+                    "invalid packet length in compressed block",
+                    len >= sizeof(uint32_t) && len <= _block.size() - _blockOffset);
+
+            _blockOffset += len;
+            return parsePacket(data, len);
+        }
+
+        char* buf = _buf.get();
+        if (!readBytes(4, buf, _fd)) {
+            return boost::none;
+        }
+        auto len = ConstDataView(buf).read<LittleEndian<uint32_t>>();
+
+        if (len == traffic_recording_format::kCompressedBlockMarker) {
+            uassert(ErrorCodes::FailedToParse,
+                    "could not read compressed block header",
+                    readBytes(8, buf, _fd));
+            auto uncompressedLen = ConstDataView(buf).read<LittleEndian<uint32_t>>();
+            auto compressedLen = ConstDataView(buf + 4).read<LittleEndian<uint32_t>>();
+
+            uassert(ErrorCodes::FailedToParse,
+                    "compressed block too large",
+                    uncompressedLen <= traffic_recording_format::kMaxUncompressedBlockSize &&
+                        compressedLen <= ZSTD_compressBound(uncompressedLen));
+
+            _compressed.resize(compressedLen);
+            uassert(ErrorCodes::FailedToParse,
+                    "could not read full compressed block",
+                    readBytes(compressedLen, _compressed.data(), _fd));
+
+            _block.resize(uncompressedLen);
+            size_t ret =
+                ZSTD_decompress(_block.data(), _block.size(), _compressed.data(), compressedLen);
+            uassert(ErrorCodes::FailedToParse,
+                    str::stream() << "could not decompress block: "
+                                  << (ZSTD_isError(ret) ? ZSTD_getErrorName(ret)
+                                                        : "unexpected length"),
+                    !ZSTD_isError(ret) && ret == uncompressedLen);
+
+            _blockOffset = 0;
+            continue;
+        }
+
+        uassert(ErrorCodes::FailedToParse, "packet too large", len < MaxMessageSizeBytes);
+        uassert(ErrorCodes::FailedToParse,
+                "could not read full packet",
+                readBytes(len - 4, buf + 4, _fd));
+
+        return parsePacket(buf, len);
+    }
+}
+
 BSONArray trafficRecordingFileToBSONArr(const std::string& inputFile) {
     BSONArrayBuilder builder{};
 
@@ -219,8 +268,8 @@ BSONArray trafficRecordingFileToBSONArr(const std::string& inputFile) {
 
     const auto guard = makeGuard([&] { ::close(inputFd); });
 
-    auto buf = SharedBuffer::allocate(MaxMessageSizeBytes);
-    while (auto packet = readPacket(buf.get(), inputFd)) {
+    TrafficRecordingReader reader(inputFd);
+    while (auto packet = reader.next()) {
         BSONObjBuilder bob(builder.subobjStart());
         getBSONObjFromPacket(*packet, &bob);
         addOpType(*packet, &bob);
@@ -238,9 +287,9 @@ void trafficRecordingFileToMongoReplayFile(int inputFd, std::ostream& outputStre
     outputStream.write(optsObj.objdata(), optsObj.objsize());
 
     BSONObjBuilder bob;
-    auto buf = SharedBuffer::allocate(MaxMessageSizeBytes);
+    TrafficRecordingReader reader(inputFd);
 
-    while (auto packet = readPacket(buf.get(), inputFd)) {
+    while (auto packet = reader.next()) {
         getBSONObjFromPacket(*packet, &bob);
 
         auto obj = bob.asTempObj();
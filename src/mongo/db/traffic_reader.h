@@ -31,8 +31,53 @@
 
 #pragma once
 
+#include <boost/optional.hpp>
+#include <cstdint>
+#include <vector>
+
+#include "mongo/base/string_data.h"
+#include "mongo/rpc/message.h"
+#include "mongo/util/shared_buffer.h"
+#include "mongo/util/time_support.h"
+
 namespace mongo {
 
+/**
+ * A single recorded message. The string and message views point into the reader that produced
+ * the packet and are only valid until its next call to next().
+ */
+struct TrafficReaderPacket {
+    uint64_t id;
+    StringData local;
+    StringData remote;
+    Date_t date;
+    uint64_t order;
+    MsgData::ConstView message;
+};
+
+/**
+ * Reads the packets of a traffic recording, plain or compressed, from a file descriptor. See
+ * traffic_recording_format.h.
+ */
+class TrafficRecordingReader {
+public:
+    explicit TrafficRecordingReader(int fd);
+
+    /**
+     * Returns the next packet, or boost::none at the end of the recording. Throws if the
+     * recording is corrupt.
+     */
+    boost::optional<TrafficReaderPacket> next();
+
+private:
+    const int _fd;
+    SharedBuffer _buf;
+
+    std::vector<char> _compressed;
+    std::vector<char> _block;
+    size_t _blockOffset = 0;
+};
+
 // Method for testing, takes the recorded traffic and returns a BSONArray
 BSONArray trafficRecordingFileToBSONArr(const std::string& inputFile);
 
@@ -39,7 +39,9 @@
 #endif
 
 #include "mongo/base/initializer.h"
+#include "mongo/db/service_context.h"
 #include "mongo/db/traffic_reader.h"
+#include "mongo/db/traffic_replay.h"
 #include "mongo/util/signal_handlers.h"
 #include "mongo/util/text.h"
 
@@ -67,15 +69,26 @@ int main(int argc, char* argv[], char** envp) {
     int inputFd = 0;
     std::ofstream outputStream;
 
+    // replay settings, replay mode is used if a target is given
+    boost::optional<TrafficReplayOptions> replayOptions;
+
     try {
         // Define the program options
         auto inputStr = "Path to file input file (defaults to stdin)";
         auto outputStr =
             "Path to file that mongotrafficreader will place its output (defaults to stdout)";
+        auto replayStr =
+            "Replay the recorded requests against this host:port instead of converting them, and "
+            "write a summary of the replay to the output";
+        auto speedStr = "Multiple of the recorded pace to replay at, 0 for as fast as possible";
+        auto concurrencyStr = "Number of threads replaying recorded sessions";
         boost::program_options::options_description desc{"Options"};
         desc.add_options()("help,h", "help")(
             "input,i", boost::program_options::value<std::string>(), inputStr)(
-            "output,o", boost::program_options::value<std::string>(), outputStr);
+            "output,o", boost::program_options::value<std::string>(), outputStr)(
+            "replay", boost::program_options::value<std::string>(), replayStr)(
+            "speed", boost::program_options::value<double>()->default_value(1.0), speedStr)(
+            "concurrency", boost::program_options::value<int>()->default_value(4), concurrencyStr);
 
         // Parse the program options
         store(parse_command_line(argc, argv, desc), vm);
@@ -84,11 +97,33 @@ int main(int argc, char* argv[], char** envp) {
         // Handle the help option
         if (vm.count("help")) {
             std::cout << "Mongo Traffic Reader Help: \n\n\t./mongotrafficreader "
-                         "-i trafficinput.txt -o mongotrafficreader_dump.bson \n\n"
+                         "-i trafficinput.txt -o mongotrafficreader_dump.bson \n\t"
+                         "./mongotrafficreader -i trafficinput.txt --replay localhost:27017 "
+                         "--speed 2 --concurrency 16\n\n"
                       << desc << std::endl;
             return EXIT_SUCCESS;
         }
 
+        if (vm.count("replay")) {
+            auto swTarget = HostAndPort::parse(vm["replay"].as<std::string>());
+            if (!swTarget.isOK()) {
+                std::cerr << "Error: Invalid replay target: " << swTarget.getStatus() << std::endl;
+                return EXIT_FAILURE;
+            }
+
+            replayOptions.emplace();
+            replayOptions->target = swTarget.getValue();
+            replayOptions->speed = vm["speed"].as<double>();
+            replayOptions->concurrency = vm["concurrency"].as<int>();
+
+            if (replayOptions->speed < 0 || replayOptions->concurrency < 1) {
+                std::cerr << "Error: --speed must not be negative and --concurrency must be "
+                             "positive"
+                          << std::endl;
+                return EXIT_FAILURE;
+            }
+        }
+
         // User can specify a --input param and it must point to a valid file
         if (vm.count("input")) {
             auto inputFile = vm["input"].as<std::string>();
@@ -127,6 +162,15 @@ int main(int argc, char* argv[], char** envp) {
         return EXIT_FAILURE;
     }
 
+    if (replayOptions) {
+        // Replay connects through the egress transport layer of the global service context
+        setGlobalServiceContext(ServiceContext::make());
+
+        auto summary = mongo::replayTrafficRecording(inputFd, *replayOptions);
+        outputStream << summary.jsonString(ExtendedRelaxedV2_0_0, 1) << std::endl;
+        return 0;
+    }
+
     mongo::trafficRecordingFileToMongoReplayFile(inputFd, outputStream);
 
     return 0;
@@ -32,18 +32,25 @@
 #include "mongo/db/traffic_recorder.h"
 #include "mongo/db/traffic_recorder_gen.h"
 
+#include <algorithm>
 #include <boost/filesystem/operations.hpp>
 #include <fstream>
+#include <queue>
+#include <zstd.h>
 
 #include "mongo/base/data_builder.h"
+#include "mongo/base/data_range_cursor.h"
 #include "mongo/base/data_type_terminated.h"
 #include "mongo/base/init.h"
 #include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/db/commands/server_status.h"
 #include "mongo/db/service_context.h"
+#include "mongo/db/traffic_recording_format.h"
 #include "mongo/rpc/factory.h"
+#include "mongo/rpc/message.h"
+#include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/thread.h"
-#include "mongo/util/producer_consumer_queue.h"
+#include "mongo/util/scopeguard.h"
 #include "mongo/util/str.h"
 
 namespace mongo {
@@ -72,84 +79,159 @@ MONGO_INITIALIZER(ShouldAlwaysRecordTraffic)(InitializerContext*) {
     return Status::OK();
 }
 
+struct TrafficRecordingPacket {
+    uint64_t id;
+    std::string local;
+    std::string remote;
+    Date_t now;
+    uint64_t order;
+    Message message;
+};
+
+/**
+ * A bounded single producer, single consumer queue of packets. Each thread observing traffic
+ * pushes into its own ring so that recording never takes a lock on the hot path, and the
+ * recording's writer thread is the only consumer.
+ *
+ * A ring cannot be resized while the writer may be draining it. A thread that fills its ring
+ * moves on to one twice as big instead, see Recording::_getThreadRing(), so most threads only
+ * ever hold a few slots. Rings grow until they could hold the recording's whole byte budget of
+ * the smallest possible messages, so a recording only runs out of room when it runs out of bytes.
+ */
+class PacketRing {
+public:
+    // Number of packets a thread can have waiting for the writer when it first records.
+    static constexpr size_t kInitialCapacity = 16;
+
+    // Every message is at least a header, which bounds how many packets a byte budget can hold.
+    static constexpr size_t kMinPacketBytes = sizeof(MSGHEADER::Value);
+
+    explicit PacketRing(size_t capacity) : _slots(capacity) {}
+
+    size_t capacity() const {
+        return _slots.size();
+    }
+
+    size_t size() const {
+        return _head.loadRelaxed() - _tail.load();
+    }
+
+    bool full() const {
+        return size() == capacity();
+    }
+
+    /**
+     * Must only be called by the owning thread, after checking that the ring is not full. Returns
+     * the number of packets waiting in the ring, including this one.
+     */
+    size_t push(TrafficRecordingPacket packet) {
+        auto head = _head.loadRelaxed();
+        _slots[head % capacity()].emplace(std::move(packet));
+        _head.store(head + 1);
+        return head + 1 - _tail.load();
+    }
+
+    /**
+     * Must only be called by the writer thread. Returns the number of packets consumed.
+     */
+    template <typename Callback>
+    size_t drain(Callback&& callback) {
+        auto tail = _tail.loadRelaxed();
+        auto head = _head.load();
+
+        for (auto i = tail; i != head; ++i) {
+            auto& slot = _slots[i % capacity()];
+            callback(std::move(*slot));
+            slot = boost::none;
+        }
+
+        _tail.store(head);
+        return head - tail;
+    }
+
+    /**
+     * Called when the owning thread exits so that the writer can release the ring once it is
+     * drained.
+     */
+    void abandon() {
+        _abandoned.store(true);
+    }
+
+    bool isAbandoned() const {
+        return _abandoned.load();
+    }
+
+private:
+    std::vector<boost::optional<TrafficRecordingPacket>> _slots;
+    AtomicWord<uint64_t> _head{0};
+    AtomicWord<uint64_t> _tail{0};
+    AtomicWord<bool> _abandoned{false};
+};
+
+/**
+ * The ring of the current thread for the recording it was last used with.
+ */
+struct ThreadPacketRing {
+    ~ThreadPacketRing() {
+        if (ring) {
+            ring->abandon();
+        }
+    }
+
+    uint64_t recordingId = 0;
+    std::shared_ptr<PacketRing> ring;
+};
+
+thread_local ThreadPacketRing threadPacketRing;
+
+AtomicWord<uint64_t> nextRecordingId{1};
+
+// How long the writer sleeps after a pass that found nothing to write.
+constexpr auto kIdleWriterInterval = Milliseconds(10);
+
+// Uncompressed size at which the writer compresses and writes out a block.
+constexpr size_t kCompressedBlockSize = 1024 * 1024;
+
 }  // namespace
 
 /**
  * The Recording class represents a single recording that the recorder is exposing.  It's made up of
  * a background thread which flushes records to disk, and helper methods to push to that thread,
  * expose stats, and stop the recording.
+ *
+ * Observing threads push packets into per-thread rings without locking. The writer thread drains
+ * the rings, restores the global order of the packets, and writes them out, optionally as zstd
+ * compressed blocks.
  */
 class TrafficRecorder::Recording {
 public:
     Recording(const StartRecordingTraffic& options)
-        : _path(_getPath(options.getFilename().toString())), _maxLogSize(options.getMaxFileSize()) {
-
-        MultiProducerSingleConsumerQueue<TrafficRecordingPacket, CostFunction>::Options
-            queueOptions;
-        queueOptions.maxQueueDepth = options.getBufferSize();
-        if (!shouldAlwaysRecordTraffic) {
-            queueOptions.maxProducerQueueDepth = 0;
-        }
-        _pcqPipe = MultiProducerSingleConsumerQueue<TrafficRecordingPacket, CostFunction>::Pipe(
-            queueOptions);
-
+        : _id(nextRecordingId.fetchAndAdd(1)),
+          _path(_getPath(options.getFilename().toString())),
+          _maxLogSize(options.getMaxFileSize()),
+          _bufferSize(options.getBufferSize()),
+          _maxRingCapacity(
+              std::max(PacketRing::kInitialCapacity,
+                       static_cast<size_t>(_bufferSize) / PacketRing::kMinPacketBytes)),
+          _compress(options.getCompress()) {
         _trafficStats.setRunning(true);
         _trafficStats.setBufferSize(options.getBufferSize());
         _trafficStats.setRecordingFile(_path);
         _trafficStats.setMaxFileSize(_maxLogSize);
+        _trafficStats.setCompress(_compress);
     }
 
     void run() {
-        _thread = stdx::thread([consumer = std::move(_pcqPipe.consumer), this] {
+        _thread = stdx::thread([this] {
             try {
-                DataBuilder db;
-                std::fstream out(_path,
-                                 std::ios_base::binary | std::ios_base::trunc | std::ios_base::out);
-
-                while (true) {
-                    std::deque<TrafficRecordingPacket> storage;
-                    size_t bytes;
-
-                    std::tie(storage, bytes) = consumer.popManyUpTo(MaxMessageSizeBytes);
-
-                    // if this fired... somehow we got a message bigger than a message
-                    invariant(bytes);
-
-                    for (const auto& packet : storage) {
-                        db.clear();
-                        Message toWrite = packet.message;
-
-                        uassertStatusOK(db.writeAndAdvance<LittleEndian<uint32_t>>(0));
-                        uassertStatusOK(db.writeAndAdvance<LittleEndian<uint64_t>>(packet.id));
-                        uassertStatusOK(db.writeAndAdvance<Terminated<'\0', StringData>>(
-                            StringData(packet.local)));
-                        uassertStatusOK(db.writeAndAdvance<Terminated<'\0', StringData>>(
-                            StringData(packet.remote)));
-                        uassertStatusOK(db.writeAndAdvance<LittleEndian<uint64_t>>(
-                            packet.now.toMillisSinceEpoch()));
-                        uassertStatusOK(db.writeAndAdvance<LittleEndian<uint64_t>>(packet.order));
-
-                        auto size = db.size() + toWrite.size();
-                        db.getCursor().write<LittleEndian<uint32_t>>(size);
-
-                        {
-                            stdx::lock_guard<Latch> lk(_mutex);
-                            _written += size;
-                        }
-
-                        uassert(ErrorCodes::LogWriteFailed,
-                                "hit maximum log size",
-                                _written < _maxLogSize);
-
-                        out.write(db.getCursor().data(), db.size());
-                        out.write(toWrite.buf(), toWrite.size());
-                    }
-                }
-            } catch (const ExceptionFor<ErrorCodes::ProducerConsumerQueueConsumed>&) {
-                // Close naturally
+                _out.open(_path, std::ios_base::binary | std::ios_base::trunc | std::ios_base::out);
+                _writerLoop();
             } catch (...) {
                 auto status = exceptionToStatus();
 
+                // Stop accepting packets, nothing will drain them anymore
+                _closed.store(true);
+
                 stdx::lock_guard<Latch> lk(_mutex);
                 _result = status;
             }
@@ -157,30 +239,56 @@ public:
     }
 
     /**
-     * pushRecord returns false if the queue was full.  This is ultimately fatal to the recording
+     * pushRecord returns false if the buffer was full.  This is ultimately fatal to the recording
      */
-    bool pushRecord(const transport::SessionHandle& ts,
-                    Date_t now,
-                    const uint64_t order,
-                    const Message& message) {
-        try {
-            _pcqPipe.producer.push(
-                {ts->id(), ts->local().toString(), ts->remote().toString(), now, order, message});
-            return true;
-        } catch (const ExceptionFor<ErrorCodes::ProducerConsumerQueueProducerQueueDepthExceeded>&) {
-            invariant(!shouldAlwaysRecordTraffic);
-
-            // If we couldn't push our packet begin the process of failing the recording
-            _pcqPipe.producer.close();
+    bool pushRecord(const transport::SessionHandle& ts, Date_t now, const Message& message) {
+        _activeProducers.fetchAndAdd(1);
+        const auto guard = makeGuard([&] { _activeProducers.fetchAndSubtract(1); });
+
+        const int64_t bytes = message.size();
+
+        // Reserve room before taking an order so that every order taken is also pushed, which
+        // lets the writer emit packets as soon as their predecessors arrived.
+        while (!_closed.load()) {
+            auto& ring = _getThreadRing();
+            if (!ring.full()) {
+                if (_bufferedBytes.addAndFetch(bytes) <= _bufferSize) {
+                    const auto waiting = ring.push({ts->id(),
+                                                    ts->local().toString(),
+                                                    ts->remote().toString(),
+                                                    now,
+                                                    _order.addAndFetch(1),
+                                                    message});
+
+                    // Don't leave a filling ring until the writer's next timed pass
+                    if (waiting == ring.capacity() / 2) {
+                        _signalWriter();
+                    }
+                    return true;
+                }
 
-            stdx::lock_guard<Latch> lk(_mutex);
+                _bufferedBytes.subtractAndFetch(bytes);
+            }
+
+            if (!shouldAlwaysRecordTraffic) {
+                // If we couldn't push our packet begin the process of failing the recording
+                _closed.store(true);
+                _condvar.notify_one();
 
-            // If the result was otherwise okay, mark it as failed due to the queue blocking.  If
-            // it failed for another reason, don't overwrite that.
-            if (_result.isOK()) {
-                _result = Status(ErrorCodes::Error(51061), "queue was blocked in traffic recorder");
+                stdx::lock_guard<Latch> lk(_mutex);
+
+                // If the result was otherwise okay, mark it as failed due to the queue blocking.
+                // If it failed for another reason, don't overwrite that.
+                if (_result.isOK()) {
+                    _result =
+                        Status(ErrorCodes::Error(51061), "queue was blocked in traffic recorder");
+                }
+
+                return false;
             }
-        } catch (const ExceptionFor<ErrorCodes::ProducerConsumerQueueEndClosed>&) {
+
+            // Recording every packet was requested, wait for the writer to make room
+            _waitForRoom();
         }
 
         return false;
@@ -191,9 +299,11 @@ public:
 
         if (!_inShutdown) {
             _inShutdown = true;
+            _closed.store(true);
+            _condvar.notify_one();
+            _roomCondvar.notify_all();
             lk.unlock();
 
-            _pcqPipe.producer.close();
             _thread.join();
 
             lk.lock();
@@ -204,26 +314,16 @@ public:
 
     BSONObj getStats() {
         stdx::lock_guard<Latch> lk(_mutex);
-        _trafficStats.setBufferedBytes(_pcqPipe.controller.getStats().queueDepth);
-        _trafficStats.setCurrentFileSize(_written);
+        _trafficStats.setBufferedBytes(_bufferedBytes.load());
+        _trafficStats.setCurrentFileSize(_written.load());
         return _trafficStats.toBSON();
     }
 
-    AtomicWord<uint64_t> order{0};
-
 private:
-    struct TrafficRecordingPacket {
-        const uint64_t id;
-        const std::string local;
-        const std::string remote;
-        const Date_t now;
-        const uint64_t order;
-        const Message message;
-    };
-
-    struct CostFunction {
-        size_t operator()(const TrafficRecordingPacket& packet) const {
-            return packet.message.size();
+    struct OrderGreater {
+        bool operator()(const TrafficRecordingPacket& lhs,
+                        const TrafficRecordingPacket& rhs) const {
+            return lhs.order > rhs.order;
         }
     };
 
@@ -245,16 +345,228 @@ private:
         return path.string();
     }
 
+    PacketRing& _getThreadRing() {
+        if (threadPacketRing.recordingId != _id) {
+            _replaceThreadRing(PacketRing::kInitialCapacity);
+        } else if (threadPacketRing.ring->full() &&
+                   threadPacketRing.ring->capacity() < _maxRingCapacity) {
+            // The writer still drains the full ring, and releases it once it is empty
+            _replaceThreadRing(threadPacketRing.ring->capacity() * 2);
+        }
+
+        return *threadPacketRing.ring;
+    }
+
+    void _replaceThreadRing(size_t capacity) {
+        auto ring = std::make_shared<PacketRing>(capacity);
+        {
+            stdx::lock_guard<Latch> lk(_ringsMutex);
+            _newRings.push_back(ring);
+        }
+
+        if (threadPacketRing.ring) {
+            threadPacketRing.ring->abandon();
+        }
+        threadPacketRing.recordingId = _id;
+        threadPacketRing.ring = std::move(ring);
+    }
+
+    void _signalWriter() {
+        stdx::lock_guard<Latch> lk(_mutex);
+        _wakeWriter = true;
+        _condvar.notify_one();
+    }
+
+    /**
+     * Blocks a producer that found no room until the writer has drained packets, or for at most
+     * kIdleWriterInterval, since room may have been made before the producer started waiting.
+     */
+    void _waitForRoom() {
+        stdx::unique_lock<Latch> lk(_mutex);
+        if (_closed.load()) {
+            return;
+        }
+
+        _waitingProducers.fetchAndAdd(1);
+        const auto guard = makeGuard([&] { _waitingProducers.fetchAndSubtract(1); });
+
+        _wakeWriter = true;
+        _condvar.notify_one();
+        _roomCondvar.wait_for(lk, kIdleWriterInterval.toSystemDuration());
+    }
+
+    void _writerLoop() {
+        while (true) {
+            // Every producer that finished before this point is visible to the drain below
+            const bool closing = _closed.load() && _activeProducers.load() == 0;
+
+            const auto drained = _drainRings();
+            _writePending(closing);
+
+            if (closing) {
+                _flushBlock();
+                return;
+            }
+
+            if (drained && _waitingProducers.load()) {
+                stdx::lock_guard<Latch> lk(_mutex);
+                _roomCondvar.notify_all();
+            }
+
+            if (!drained) {
+                _flushBlock();
+
+                stdx::unique_lock<Latch> lk(_mutex);
+                _condvar.wait_for(lk, kIdleWriterInterval.toSystemDuration(), [&] {
+                    return _closed.load() || _wakeWriter;
+                });
+                _wakeWriter = false;
+            }
+        }
+    }
+
+    size_t _drainRings() {
+        {
+            stdx::lock_guard<Latch> lk(_ringsMutex);
+            std::move(_newRings.begin(), _newRings.end(), std::back_inserter(_rings));
+            _newRings.clear();
+        }
+
+        size_t drained = 0;
+        for (auto it = _rings.begin(); it != _rings.end();) {
+            // Check before draining so that no push can follow the drain of an abandoned ring
+            const bool abandoned = (*it)->isAbandoned();
+
+            drained += (*it)->drain(
+                [&](TrafficRecordingPacket&& packet) { _pending.push(std::move(packet)); });
+
+            if (abandoned) {
+                it = _rings.erase(it);
+            } else {
+                ++it;
+            }
+        }
+
+        return drained;
+    }
+
+    /**
+     * Writes the pending packets in order, stopping at the first gap unless the recording is
+     * closing, in which case the missing packets will never arrive.
+     */
+    void _writePending(bool closing) {
+        while (!_pending.empty() && (closing || _pending.top().order == _nextOrder)) {
+            const auto& packet = _pending.top();
+            _writePacket(packet);
+
+            _nextOrder = packet.order + 1;
+            _bufferedBytes.subtractAndFetch(packet.message.size());
+            _pending.pop();
+        }
+    }
+
+    void _writePacket(const TrafficRecordingPacket& packet) {
+        _db.clear();
+        const Message& toWrite = packet.message;
+
+        uassertStatusOK(_db.writeAndAdvance<LittleEndian<uint32_t>>(0));
+        uassertStatusOK(_db.writeAndAdvance<LittleEndian<uint64_t>>(packet.id));
+        uassertStatusOK(
+            _db.writeAndAdvance<Terminated<'\0', StringData>>(StringData(packet.local)));
+        uassertStatusOK(
+            _db.writeAndAdvance<Terminated<'\0', StringData>>(StringData(packet.remote)));
+        uassertStatusOK(
+            _db.writeAndAdvance<LittleEndian<uint64_t>>(packet.now.toMillisSinceEpoch()));
+        uassertStatusOK(_db.writeAndAdvance<LittleEndian<uint64_t>>(packet.order));
+
+        auto size = _db.size() + toWrite.size();
+        _db.getCursor().write<LittleEndian<uint32_t>>(size);
+
+        if (!_compress) {
+            _write(_db.getCursor().data(), _db.size(), toWrite.buf(), toWrite.size());
+            return;
+        }
+
+        _block.appendBuf(_db.getCursor().data(), _db.size());
+        _block.appendBuf(toWrite.buf(), toWrite.size());
+
+        if (static_cast<size_t>(_block.len()) >= kCompressedBlockSize) {
+            _flushBlock();
+        }
+    }
+
+    void _flushBlock() {
+        if (!_block.len()) {
+            return;
+        }
+
+        _compressedBlock.resize(ZSTD_compressBound(_block.len()));
+        size_t compressedSize = ZSTD_compress(_compressedBlock.data(),
+                                              _compressedBlock.size(),
+                                              _block.buf(),
+                                              _block.len(),
+                                              ZSTD_CLEVEL_DEFAULT);
+        uassert(ErrorCodes::BadValue,
+                str::stream() << "ZSTD_compress failed with " << ZSTD_getErrorName(compressedSize),
+                !ZSTD_isError(compressedSize));
+
+        char header[3 * sizeof(uint32_t)];
+        DataRangeCursor headerCursor(header, header + sizeof(header));
+        headerCursor.writeAndAdvance<LittleEndian<uint32_t>>(
+            traffic_recording_format::kCompressedBlockMarker);
+        headerCursor.writeAndAdvance<LittleEndian<uint32_t>>(_block.len());
+        headerCursor.writeAndAdvance<LittleEndian<uint32_t>>(compressedSize);
+
+        _write(header, sizeof(header), _compressedBlock.data(), compressedSize);
+        _block.setlen(0);
+    }
+
+    void _write(const char* header, size_t headerSize, const char* body, size_t bodySize) {
+        auto written = _written.addAndFetch(headerSize + bodySize);
+
+        uassert(ErrorCodes::LogWriteFailed, "hit maximum log size", written < _maxLogSize);
+
+        _out.write(header, headerSize);
+        _out.write(body, bodySize);
+    }
+
+    const uint64_t _id;
     const std::string _path;
     const size_t _maxLogSize;
-
-    MultiProducerSingleConsumerQueue<TrafficRecordingPacket, CostFunction>::Pipe _pcqPipe;
+    const int64_t _bufferSize;
+    const size_t _maxRingCapacity;
+    const bool _compress;
+
+    // Producer side
+    AtomicWord<bool> _closed{false};
+    AtomicWord<int64_t> _activeProducers{0};
+    AtomicWord<int64_t> _bufferedBytes{0};
+    AtomicWord<uint64_t> _order{0};
+    AtomicWord<int64_t> _waitingProducers{0};
+
+    // Rings registered since the writer last looked, protected by _ringsMutex
+    Mutex _ringsMutex = MONGO_MAKE_LATCH("Recording::_ringsMutex");
+    std::vector<std::shared_ptr<PacketRing>> _newRings;
+
+    // Writer side, only touched by the writer thread
+    std::vector<std::shared_ptr<PacketRing>> _rings;
+    std::priority_queue<TrafficRecordingPacket, std::vector<TrafficRecordingPacket>, OrderGreater>
+        _pending;
+    uint64_t _nextOrder = 1;
+    DataBuilder _db;
+    BufBuilder _block;
+    std::vector<char> _compressedBlock;
+    std::fstream _out;
     stdx::thread _thread;
 
+    AtomicWord<uint64_t> _written{0};
+
     Mutex _mutex = MONGO_MAKE_LATCH("Recording::_mutex");
+    stdx::condition_variable _condvar;
+    stdx::condition_variable _roomCondvar;
+    bool _wakeWriter = false;
     bool _inShutdown = false;
     TrafficRecorderStats _trafficStats;
-    size_t _written = 0;
     Status _result = Status::OK();
 };
 
@@ -326,7 +638,7 @@ void TrafficRecorder::observe(const transport::SessionHandle& ts,
             }
         }
 
-        invariant(_recording->pushRecord(ts, now, _recording->order.addAndFetch(1), message));
+        invariant(_recording->pushRecord(ts, now, message));
         return;
     }
 
@@ -342,7 +654,7 @@ void TrafficRecorder::observe(const transport::SessionHandle& ts,
     }
 
     // Try to record the message
-    if (recording->pushRecord(ts, now, recording->order.addAndFetch(1), message)) {
+    if (recording->pushRecord(ts, now, message)) {
         return;
     }
 
@@ -0,0 +1,56 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+namespace mongo {
+namespace traffic_recording_format {
+
+/**
+ * A traffic recording is a sequence of packets, each starting with its little endian uint32
+ * length, which is always less than MaxMessageSizeBytes:
+ *
+ *   uint32 length | uint64 session id | cstring local | cstring remote | uint64 date (millis) |
+ *   uint64 order | message
+ *
+ * Compressed recordings group consecutive packets into blocks. A block starts with this marker in
+ * place of a packet length, followed by the little endian uint32 uncompressed and compressed
+ * lengths and the zstd compressed packets.
+ */
+constexpr std::uint32_t kCompressedBlockMarker = 0xFFFFFFFF;
+
+/**
+ * Largest uncompressed block a reader accepts.
+ */
+constexpr std::uint32_t kMaxUncompressedBlockSize = 64 * 1024 * 1024;
+
+}  // namespace traffic_recording_format
+}  // namespace mongo
@@ -0,0 +1,281 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/traffic_replay.h"
+
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/client/dbclient_connection.h"
+#include "mongo/db/traffic_reader.h"
+#include "mongo/rpc/message.h"
+#include "mongo/rpc/op_msg.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/util/producer_consumer_queue.h"
+#include "mongo/util/time_support.h"
+#include "mongo/util/timer.h"
+
+namespace mongo {
+
+namespace {
+
+// Requests read ahead of each replay thread.
+constexpr size_t kMaxQueuedRequestsPerThread = 1024;
+
+struct ReplayRequest {
+    uint64_t session;
+    Date_t scheduledAt;
+    Message message;
+};
+
+struct ReplayThreadResults {
+    long long requests = 0;
+    long long networkErrors = 0;
+    long long commandErrors = 0;
+    std::vector<long long> latencyMicros;
+};
+
+/**
+ * Returns whether the server replies to the request.
+ */
+bool expectsReply(const Message& message) {
+    switch (message.operation()) {
+        case dbMsg:
+            return !OpMsg::isFlagSet(message, OpMsg::kMoreToCome);
+        case dbQuery:
+        case dbGetMore:
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool isCommandError(const Message& reply) {
+    if (reply.operation() != dbMsg) {
+        return false;
+    }
+
+    try {
+        return !OpMsg::parse(reply).body["ok"].trueValue();
+    } catch (const DBException&) {
+        return true;
+    }
+}
+
+class ReplayThread {
+public:
+    ReplayThread(const TrafficReplayOptions& options) : _options(options) {
+        SingleProducerSingleConsumerQueue<ReplayRequest>::Options queueOptions;
+        queueOptions.maxQueueDepth = kMaxQueuedRequestsPerThread;
+        _queue.emplace(std::move(queueOptions));
+    }
+
+    void start() {
+        _thread = stdx::thread([this] { _run(); });
+    }
+
+    void push(ReplayRequest request) {
+        _queue->push(std::move(request));
+    }
+
+    const ReplayThreadResults& finish() {
+        _queue->closeProducerEnd();
+        _thread.join();
+        return _results;
+    }
+
+private:
+    void _run() {
+        try {
+            while (true) {
+                auto request = _queue->pop();
+
+                auto now = Date_t::now();
+                if (request.scheduledAt > now) {
+                    sleepFor(request.scheduledAt - now);
+                }
+
+                _replay(request);
+            }
+        } catch (const ExceptionFor<ErrorCodes::ProducerConsumerQueueConsumed>&) {
+            // All requests replayed
+        }
+    }
+
+    void _replay(ReplayRequest& request) {
+        ++_results.requests;
+
+        try {
+            auto& conn = _connections[request.session];
+            if (!conn) {
+                auto newConn = std::make_unique<DBClientConnection>();
+                uassertStatusOK(newConn->connect(_options.target, "mongotrafficreader"));
+                conn = std::move(newConn);
+            }
+
+            Message& toSend = request.message;
+            if (toSend.operation() == dbMsg) {
+                // The request id changes, so the recorded checksum would not match, and exhaust
+                // replies would not be read.
+                OpMsg::removeChecksum(&toSend);
+                OpMsg::clearFlag(&toSend, OpMsg::kExhaustSupported);
+            }
+
+            if (!expectsReply(toSend)) {
+                conn->say(toSend);
+                return;
+            }
+
+            Message reply;
+            Timer timer;
+            conn->call(toSend, reply);
+            _results.latencyMicros.push_back(timer.micros());
+
+            if (isCommandError(reply)) {
+                ++_results.commandErrors;
+            }
+        } catch (const DBException&) {
+            ++_results.networkErrors;
+            _connections.erase(request.session);
+        }
+    }
+
+    const TrafficReplayOptions& _options;
+    boost::optional<SingleProducerSingleConsumerQueue<ReplayRequest>> _queue;
+    std::map<uint64_t, std::unique_ptr<DBClientConnection>> _connections;
+    ReplayThreadResults _results;
+    stdx::thread _thread;
+};
+
+long long percentile(const std::vector<long long>& sorted, double p) {
+    if (sorted.empty()) {
+        return 0;
+    }
+
+    auto index = static_cast<size_t>(p * (sorted.size() - 1) + 0.5);
+    return sorted[std::min(index, sorted.size() - 1)];
+}
+
+}  // namespace
+
+BSONObj replayTrafficRecording(int inputFd, const TrafficReplayOptions& options) {
+    uassert(ErrorCodes::BadValue, "concurrency must be positive", options.concurrency > 0);
+    uassert(ErrorCodes::BadValue, "speed must not be negative", options.speed >= 0);
+
+    std::vector<std::unique_ptr<ReplayThread>> threads;
+    for (int i = 0; i < options.concurrency; ++i) {
+        threads.push_back(std::make_unique<ReplayThread>(options));
+        threads.back()->start();
+    }
+
+    TrafficRecordingReader reader(inputFd);
+    boost::optional<Date_t> firstRecorded;
+    Date_t replayStart;
+    std::map<uint64_t, size_t> sessions;
+    Timer elapsed;
+
+    auto readRequests = [&] {
+        while (auto packet = reader.next()) {
+            // Only replay requests, the replies are recorded with a responseTo
+            if (packet->message.getResponseToMsgId() != 0) {
+                continue;
+            }
+
+            if (!firstRecorded) {
+                firstRecorded = packet->date;
+                replayStart = Date_t::now();
+            }
+
+            Date_t scheduledAt;
+            if (options.speed > 0) {
+                auto offset = durationCount<Milliseconds>(packet->date - *firstRecorded);
+                scheduledAt =
+                    replayStart + Milliseconds(static_cast<long long>(offset / options.speed));
+            }
+
+            auto size = packet->message.getLen();
+            auto buf = SharedBuffer::allocate(size);
+            std::memcpy(buf.get(), packet->message.view2ptr(), size);
+
+            // Keep every request of a session on one thread so that they are replayed in order
+            auto thread =
+                sessions.emplace(packet->id, sessions.size() % threads.size()).first->second;
+            threads[thread]->push({packet->id, scheduledAt, Message(std::move(buf))});
+        }
+    };
+
+    try {
+        readRequests();
+    } catch (...) {
+        for (auto& thread : threads) {
+            thread->finish();
+        }
+        throw;
+    }
+
+    ReplayThreadResults totals;
+    for (auto& thread : threads) {
+        const auto& results = thread->finish();
+        totals.requests += results.requests;
+        totals.networkErrors += results.networkErrors;
+        totals.commandErrors += results.commandErrors;
+        totals.latencyMicros.insert(totals.latencyMicros.end(),
+                                    results.latencyMicros.begin(),
+                                    results.latencyMicros.end());
+    }
+
+    std::sort(totals.latencyMicros.begin(), totals.latencyMicros.end());
+
+    BSONObjBuilder builder;
+    builder.append("sessions", static_cast<long long>(sessions.size()));
+    builder.append("requests", totals.requests);
+    builder.append("networkErrors", totals.networkErrors);
+    builder.append("commandErrors", totals.commandErrors);
+    builder.append("elapsedMillis", elapsed.millis());
+    {
+        BSONObjBuilder latency(builder.subobjStart("latencyMicros"));
+        latency.append("count", static_cast<long long>(totals.latencyMicros.size()));
+        latency.append("p50", percentile(totals.latencyMicros, 0.50));
+        latency.append("p90", percentile(totals.latencyMicros, 0.90));
+        latency.append("p99", percentile(totals.latencyMicros, 0.99));
+        latency.append("p999", percentile(totals.latencyMicros, 0.999));
+        latency.append("max",
+                       totals.latencyMicros.empty() ? 0LL : totals.latencyMicros.back());
+    }
+
+    return builder.obj();
+}
+
+}  // namespace mongo
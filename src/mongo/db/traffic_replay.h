@@ -0,0 +1,59 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include "mongo/bson/bsonobj.h"
+#include "mongo/util/net/hostandport.h"
+
+namespace mongo {
+
+struct TrafficReplayOptions {
+    // Server to send the recorded requests to
+    HostAndPort target;
+
+    // Multiple of the recorded pace to replay at, 0 replays as fast as possible
+    double speed = 1.0;
+
+    // Number of threads issuing requests. Each recorded session is replayed in order on a single
+    // thread over its own connection.
+    int concurrency = 4;
+};
+
+/**
+ * Re-issues the requests of a traffic recording against options.target and returns a summary of
+ * the replay, including latency percentiles in microseconds.
+ *
+ * Only requests are replayed, recorded replies are skipped. Requests that depend on server state
+ * from the recording, like authentication conversations and getMores on recorded cursors, are
+ * sent as they are and counted as errors if they fail.
+ */
+BSONObj replayTrafficRecording(int inputFd, const TrafficReplayOptions& options);
+
+}  // namespace mongo
@@ -126,6 +126,9 @@ private:
         const ServiceContext::UniqueOperationContext opCtxPtr = cc().makeOperationContext();
         OperationContext& opCtx = *opCtxPtr;
 
+        // TTL deletions can wait for tickets until user operations have been admitted.
+        opCtx.lockState()->setAdmissionPriority(AdmissionPriority::kLow);
+
         // If part of replSet but not in a readable state (e.g. during initial sync), skip.
         if (repl::ReplicationCoordinator::get(&opCtx)->getReplicationMode() ==
                 repl::ReplicationCoordinator::modeReplSet &&
@@ -0,0 +1,75 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/update/delta_executor.h"
+
+#include "mongo/bson/mutable/document.h"
+#include "mongo/db/update/object_replace_executor.h"
+#include "mongo/db/update/storage_validation.h"
+
+namespace mongo {
+
+UpdateExecutor::ApplyResult DeltaExecutor::applyDiff(ApplyParams applyParams,
+                                                     const doc_diff::Diff& diff,
+                                                     const BSONObj& originalDoc) {
+    if (diff.isEmpty()) {
+        return ApplyResult::noopResult();
+    }
+
+    ApplyResult applyResult;
+    applyResult.indexesAffected =
+        doc_diff::applyDiff(diff, applyParams.element, applyParams.indexData);
+
+    // Validate for storage.
+    if (applyParams.validateForStorage) {
+        storage_validation::storageValid(applyParams.element.getDocument());
+    }
+
+    // Check immutable paths.
+    ObjectReplaceExecutor::checkImmutablePaths(applyParams, originalDoc);
+
+    if (applyParams.logBuilder) {
+        invariant(applyParams.logBuilder->setDeltaDiff(diff));
+    }
+
+    return applyResult;
+}
+
+UpdateExecutor::ApplyResult DeltaExecutor::applyUpdate(ApplyParams applyParams) const {
+    // Serializing the document is only needed to check immutable paths, which are never set when
+    // applying oplog entries.
+    auto originalDoc = applyParams.immutablePaths.empty()
+        ? BSONObj()
+        : applyParams.element.getDocument().getObject();
+    return applyDiff(applyParams, _diff, originalDoc);
+}
+
+}  // namespace mongo
@@ -0,0 +1,75 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include "mongo/db/update/doc_diff.h"
+#include "mongo/db/update/update_executor.h"
+
+namespace mongo {
+
+/**
+ * An UpdateExecutor representing a delta-style update, which applies a diff between the pre- and
+ * post-image of a document (see doc_diff.h). Delta-style updates are only ever parsed from '$v: 2'
+ * oplog entries.
+ */
+class DeltaExecutor : public UpdateExecutor {
+public:
+    /**
+     * Applies 'diff' to the document that 'applyParams.element' belongs to, validates the result
+     * and, if 'applyParams.logBuilder' is provided, logs the diff. 'originalDoc' is the document
+     * before the update and is only consulted when 'applyParams.immutablePaths' is not empty.
+     * Indexes are reported as affected only if the diff touches a path which might be indexed.
+     */
+    static ApplyResult applyDiff(ApplyParams applyParams,
+                                 const doc_diff::Diff& diff,
+                                 const BSONObj& originalDoc);
+
+    explicit DeltaExecutor(doc_diff::Diff diff) : _diff(diff.getOwned()) {}
+
+    /**
+     * Applies the diff to 'applyParams.element', which must be the root of the document.
+     */
+    ApplyResult applyUpdate(ApplyParams applyParams) const final;
+
+    Value serialize() const final {
+        return Value(BSON(LogBuilder::kUpdateSemanticsFieldName
+                          << static_cast<int>(UpdateSemantics::kDelta)
+                          << LogBuilder::kDeltaDiffFieldName << _diff));
+    }
+
+    const doc_diff::Diff& getDiff() const {
+        return _diff;
+    }
+
+private:
+    doc_diff::Diff _diff;
+};
+
+}  // namespace mongo
@@ -0,0 +1,106 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/update/delta_executor.h"
+
+#include "mongo/bson/mutable/mutable_bson_test_utils.h"
+#include "mongo/db/exec/document_value/document_value_test_util.h"
+#include "mongo/db/json.h"
+#include "mongo/db/update/update_node_test_fixture.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+using DeltaExecutorTest = UpdateNodeTest;
+
+TEST_F(DeltaExecutorTest, Noop) {
+    DeltaExecutor exec(BSONObj{});
+
+    mutablebson::Document doc(fromjson("{a: 1, b: 2}"));
+    auto result = exec.applyUpdate(getApplyParams(doc.root()));
+    ASSERT_TRUE(result.noop);
+    ASSERT_FALSE(result.indexesAffected);
+    ASSERT_EQUALS(fromjson("{a: 1, b: 2}"), doc);
+    ASSERT_TRUE(doc.isInPlaceModeEnabled());
+    ASSERT_EQUALS(fromjson("{}"), getLogDoc());
+}
+
+TEST_F(DeltaExecutorTest, AppliesAndLogsDiff) {
+    DeltaExecutor exec(fromjson("{d: {c: false}, u: {a: 2}, i: {e: 1}}"));
+
+    mutablebson::Document doc(fromjson("{_id: 0, a: 1, c: 1}"));
+    auto result = exec.applyUpdate(getApplyParams(doc.root()));
+    ASSERT_FALSE(result.noop);
+    ASSERT_FALSE(result.indexesAffected);
+    ASSERT_EQUALS(fromjson("{_id: 0, a: 2, e: 1}"), doc);
+    ASSERT_FALSE(doc.isInPlaceModeEnabled());
+    ASSERT_EQUALS(fromjson("{$v: 2, diff: {d: {c: false}, u: {a: 2}, i: {e: 1}}}"), getLogDoc());
+}
+
+TEST_F(DeltaExecutorTest, SameSizeUpdateStaysInPlace) {
+    DeltaExecutor exec(fromjson("{u: {a: 2}}"));
+
+    mutablebson::Document doc(fromjson("{_id: 0, a: 1, b: 'unchanged'}"));
+    auto result = exec.applyUpdate(getApplyParams(doc.root()));
+    ASSERT_FALSE(result.noop);
+    ASSERT_EQUALS(fromjson("{_id: 0, a: 2, b: 'unchanged'}"), doc);
+    ASSERT_TRUE(doc.isInPlaceModeEnabled());
+}
+
+TEST_F(DeltaExecutorTest, IndexesAffectedOnlyByIndexedPaths) {
+    addIndexedPath("b");
+    DeltaExecutor unindexed(fromjson("{u: {a: 2}}"));
+    DeltaExecutor indexed(fromjson("{u: {b: 2}}"));
+
+    mutablebson::Document doc(fromjson("{_id: 0, a: 1, b: 1}"));
+    setLogBuilderToNull();
+    ASSERT_FALSE(unindexed.applyUpdate(getApplyParams(doc.root())).indexesAffected);
+    ASSERT_TRUE(indexed.applyUpdate(getApplyParams(doc.root())).indexesAffected);
+}
+
+TEST_F(DeltaExecutorTest, CannotModifyImmutablePath) {
+    DeltaExecutor exec(fromjson("{u: {_id: 1}}"));
+
+    mutablebson::Document doc(fromjson("{_id: 0, a: 1}"));
+    addImmutablePath("_id");
+    ASSERT_THROWS_CODE(exec.applyUpdate(getApplyParams(doc.root())),
+                       AssertionException,
+                       ErrorCodes::ImmutableField);
+}
+
+TEST_F(DeltaExecutorTest, Serialize) {
+    DeltaExecutor exec(fromjson("{u: {a: 1}}"));
+    ASSERT_VALUE_EQ(exec.serialize(), Value(fromjson("{$v: 2, diff: {u: {a: 1}}}")));
+}
+
+}  // namespace
+}  // namespace mongo
@@ -0,0 +1,261 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/update/doc_diff.h"
+
+#include "mongo/bson/mutable/document.h"
+#include "mongo/db/field_ref.h"
+#include "mongo/db/update_index_data.h"
+#include "mongo/util/str.h"
+#include "mongo/util/string_map.h"
+
+namespace mongo {
+namespace doc_diff {
+
+namespace {
+
+bool valuesEqual(const BSONElement& lhs, const BSONElement& rhs) {
+    return lhs.type() == rhs.type() && lhs.binaryEqualValues(rhs);
+}
+
+// Appends the diff between 'pre' and 'post' to 'builder'. Returns false if either object contains
+// duplicate field names, in which case the contents of 'builder' must be discarded.
+bool computeObjectDiff(const BSONObj& pre, const BSONObj& post, BSONObjBuilder* builder) {
+    StringMap<BSONElement> postFields;
+    for (auto&& elem : post) {
+        if (!postFields.emplace(elem.fieldName(), elem).second) {
+            return false;
+        }
+    }
+
+    // Fields which do not survive into 'post' are deleted first. The fields that remain keep their
+    // relative order, so 'post' can be described as a common prefix of those fields (updated in
+    // place) followed by a suffix which is rewritten at the end of the object.
+    StringSet preFields;
+    std::vector<StringData> deletes;
+    std::vector<BSONElement> remaining;
+    for (auto&& elem : pre) {
+        auto fieldName = elem.fieldNameStringData();
+        if (!preFields.insert(fieldName.toString()).second) {
+            return false;
+        }
+        if (postFields.find(fieldName) == postFields.end()) {
+            deletes.push_back(fieldName);
+        } else {
+            remaining.push_back(elem);
+        }
+    }
+
+    std::vector<BSONElement> updates;
+    std::vector<std::pair<StringData, BSONObj>> subDiffs;
+    BSONObjIterator postIt(post);
+    auto preIt = remaining.begin();
+    for (; postIt.more() && preIt != remaining.end(); ++preIt) {
+        auto postElem = *postIt;
+        if (postElem.fieldNameStringData() != preIt->fieldNameStringData()) {
+            break;
+        }
+        postIt.next();
+
+        if (valuesEqual(*preIt, postElem)) {
+            continue;
+        }
+
+        if (preIt->type() == BSONType::Object && postElem.type() == BSONType::Object) {
+            BSONObjBuilder subDiffBuilder;
+            if (!computeObjectDiff(
+                    preIt->embeddedObject(), postElem.embeddedObject(), &subDiffBuilder)) {
+                return false;
+            }
+            auto subDiff = subDiffBuilder.obj();
+            if (subDiff.objsize() < postElem.valuesize()) {
+                subDiffs.emplace_back(postElem.fieldNameStringData(), std::move(subDiff));
+                continue;
+            }
+        }
+        updates.push_back(postElem);
+    }
+
+    if (!deletes.empty()) {
+        BSONObjBuilder deleteBuilder(builder->subobjStart(kDeleteSectionFieldName));
+        for (auto&& fieldName : deletes) {
+            deleteBuilder.append(fieldName, false);
+        }
+    }
+
+    if (!updates.empty()) {
+        BSONObjBuilder updateBuilder(builder->subobjStart(kUpdateSectionFieldName));
+        for (auto&& elem : updates) {
+            updateBuilder.append(elem);
+        }
+    }
+
+    for (auto&& [fieldName, subDiff] : subDiffs) {
+        builder->append(std::string(str::stream() << kSubDiffSectionFieldPrefix << fieldName),
+                        subDiff);
+    }
+
+    if (postIt.more()) {
+        BSONObjBuilder insertBuilder(builder->subobjStart(kInsertSectionFieldName));
+        while (postIt.more()) {
+            insertBuilder.append(postIt.next());
+        }
+    }
+
+    return true;
+}
+
+BSONObj getSection(const BSONElement& section) {
+    uassert(4772600,
+            str::stream() << "Update diff section '" << section.fieldNameStringData()
+                          << "' must be an object, found " << typeName(section.type()),
+            section.type() == BSONType::Object);
+    return section.embeddedObject();
+}
+
+StringData getSubDiffFieldName(const BSONElement& section) {
+    auto sectionName = section.fieldNameStringData();
+    uassert(4772601,
+            str::stream() << "Unrecognized section in update diff: '" << sectionName << "'",
+            !sectionName.empty() && sectionName[0] == kSubDiffSectionFieldPrefix);
+    return sectionName.substr(1);
+}
+
+bool applyObjectDiff(const Diff& diff,
+                     mutablebson::Element obj,
+                     FieldRef* path,
+                     const UpdateIndexData* indexData) {
+    bool indexesAffected = false;
+    auto recordModifiedField = [&](StringData fieldName) {
+        if (indexData && !indexesAffected) {
+            FieldRef::FieldRefTempAppend tempAppend(*path, fieldName);
+            indexesAffected = indexData->mightBeIndexed(*path);
+        }
+    };
+
+    for (auto&& section : diff) {
+        auto sectionName = section.fieldNameStringData();
+        if (sectionName == kDeleteSectionFieldName) {
+            for (auto&& field : getSection(section)) {
+                auto child = obj.findFirstChildNamed(field.fieldNameStringData());
+                if (child.ok()) {
+                    uassertStatusOK(child.remove());
+                    recordModifiedField(field.fieldNameStringData());
+                }
+            }
+        } else if (sectionName == kUpdateSectionFieldName) {
+            for (auto&& field : getSection(section)) {
+                // Overwriting the existing element lets mutable BSON record the change as damage
+                // events when the new value has the same size.
+                auto child = obj.findFirstChildNamed(field.fieldNameStringData());
+                if (child.ok()) {
+                    uassertStatusOK(child.setValueBSONElement(field));
+                } else {
+                    uassertStatusOK(obj.appendElement(field));
+                }
+                recordModifiedField(field.fieldNameStringData());
+            }
+        } else if (sectionName == kInsertSectionFieldName) {
+            for (auto&& field : getSection(section)) {
+                auto child = obj.findFirstChildNamed(field.fieldNameStringData());
+                if (child.ok()) {
+                    uassertStatusOK(child.remove());
+                }
+                uassertStatusOK(obj.appendElement(field));
+                recordModifiedField(field.fieldNameStringData());
+            }
+        } else {
+            auto fieldName = getSubDiffFieldName(section);
+            auto subDiff = getSection(section);
+            auto child = obj.findFirstChildNamed(fieldName);
+            if (!child.ok()) {
+                child = obj.getDocument().makeElementObject(fieldName);
+                uassertStatusOK(obj.pushBack(child));
+            } else if (child.getType() != BSONType::Object) {
+                uassertStatusOK(child.setValueObject(BSONObj()));
+            }
+
+            FieldRef::FieldRefTempAppend tempAppend(*path, fieldName);
+            indexesAffected = applyObjectDiff(subDiff, child, path, indexData) || indexesAffected;
+        }
+    }
+
+    return indexesAffected;
+}
+
+void describeObjectDiff(const Diff& diff,
+                        const std::string& prefix,
+                        BSONObjBuilder* updatedFields,
+                        std::vector<std::string>* removedFields) {
+    for (auto&& section : diff) {
+        auto sectionName = section.fieldNameStringData();
+        if (sectionName == kDeleteSectionFieldName) {
+            for (auto&& field : getSection(section)) {
+                removedFields->push_back(prefix + field.fieldName());
+            }
+        } else if (sectionName == kUpdateSectionFieldName ||
+                   sectionName == kInsertSectionFieldName) {
+            for (auto&& field : getSection(section)) {
+                updatedFields->appendAs(field, prefix + field.fieldName());
+            }
+        } else {
+            auto fieldName = getSubDiffFieldName(section);
+            describeObjectDiff(getSection(section),
+                               str::stream() << prefix << fieldName << '.',
+                               updatedFields,
+                               removedFields);
+        }
+    }
+}
+
+}  // namespace
+
+boost::optional<Diff> computeDiff(const BSONObj& pre, const BSONObj& post) {
+    BSONObjBuilder builder;
+    if (!computeObjectDiff(pre, post, &builder)) {
+        return boost::none;
+    }
+    return builder.obj();
+}
+
+bool applyDiff(const Diff& diff, mutablebson::Element root, const UpdateIndexData* indexData) {
+    FieldRef path;
+    return applyObjectDiff(diff, root, &path, indexData);
+}
+
+void describeDiff(const Diff& diff,
+                  BSONObjBuilder* updatedFields,
+                  std::vector<std::string>* removedFields) {
+    describeObjectDiff(diff, "", updatedFields, removedFields);
+}
+
+}  // namespace doc_diff
+}  // namespace mongo
@@ -0,0 +1,94 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <boost/optional.hpp>
+#include <string>
+#include <vector>
+
+#include "mongo/bson/bsonobj.h"
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/bson/mutable/element.h"
+
+namespace mongo {
+
+class UpdateIndexData;
+
+namespace doc_diff {
+
+/**
+ * A structural diff between two versions of a document, as recorded in '$v: 2' update oplog
+ * entries. A diff is an object with up to four kinds of fields:
+ *
+ *   d: {<field>: false, ...}       Fields removed from the object.
+ *   u: {<field>: <value>, ...}     Fields whose value is replaced, keeping their position.
+ *   s<field>: <diff>               A nested diff applied to the embedded object '<field>'.
+ *   i: {<field>: <value>, ...}     Fields (re)inserted, in order, at the end of the object.
+ *
+ * An empty diff means the two versions are identical. Arrays are never diffed element-wise; an
+ * array that changed is recorded as a whole in the 'u' section.
+ */
+using Diff = BSONObj;
+
+constexpr StringData kDeleteSectionFieldName = "d"_sd;
+constexpr StringData kUpdateSectionFieldName = "u"_sd;
+constexpr StringData kInsertSectionFieldName = "i"_sd;
+constexpr char kSubDiffSectionFieldPrefix = 's';
+
+/**
+ * Computes the diff which transforms 'pre' into 'post'. Returns boost::none if either object has
+ * duplicate field names at some level, since such documents cannot be described by a diff.
+ */
+boost::optional<Diff> computeDiff(const BSONObj& pre, const BSONObj& post);
+
+/**
+ * Applies 'diff' to the object 'root'. Values are overwritten with Element::setValue*() wherever
+ * the target field exists, so when 'root' belongs to a Document with in-place updates enabled and
+ * the new values have the same size as the old ones, the change is recorded as damage events
+ * rather than forcing the document to be rewritten. The application is lenient towards the
+ * differences that oplog application must tolerate: deleting a missing field is a no-op and a
+ * nested diff on a missing or non-object field is applied to an empty object.
+ *
+ * Returns true if any path touched by the diff might be indexed according to 'indexData'.
+ */
+bool applyDiff(const Diff& diff, mutablebson::Element root, const UpdateIndexData* indexData);
+
+/**
+ * Flattens 'diff' into the '$set'/'$unset' shape used to describe operator-style updates: every
+ * replaced or inserted field is appended to 'updatedFields' under its dotted path, and the dotted
+ * path of every removed field is appended to 'removedFields'.
+ */
+void describeDiff(const Diff& diff,
+                  BSONObjBuilder* updatedFields,
+                  std::vector<std::string>* removedFields);
+
+}  // namespace doc_diff
+
+}  // namespace mongo
@@ -0,0 +1,200 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/update/doc_diff.h"
+
+#include "mongo/bson/mutable/document.h"
+#include "mongo/db/field_ref.h"
+#include "mongo/db/json.h"
+#include "mongo/db/update_index_data.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+BSONObj computeDiffOrFail(const BSONObj& pre, const BSONObj& post) {
+    auto diff = doc_diff::computeDiff(pre, post);
+    ASSERT(diff);
+    return *diff;
+}
+
+// Applies the diff between 'pre' and 'post' to 'pre' and checks that it yields exactly 'post'.
+void assertRoundTrips(const BSONObj& pre, const BSONObj& post) {
+    auto diff = computeDiffOrFail(pre, post);
+    mutablebson::Document doc(pre);
+    doc_diff::applyDiff(diff, doc.root(), nullptr);
+    ASSERT(doc.getObject().binaryEqual(post))
+        << "pre: " << pre << ", post: " << post << ", diff: " << diff
+        << ", result: " << doc.getObject();
+}
+
+TEST(DocDiffTest, IdenticalObjectsHaveEmptyDiff) {
+    auto obj = fromjson("{_id: 0, a: 1, b: {c: 'x'}, d: [1, 2]}");
+    ASSERT_BSONOBJ_EQ(computeDiffOrFail(obj, obj), BSONObj());
+}
+
+TEST(DocDiffTest, ChangedValueIsUpdated) {
+    auto diff = computeDiffOrFail(fromjson("{_id: 0, a: 1, b: 'x'}"),
+                                  fromjson("{_id: 0, a: 2, b: 'x'}"));
+    ASSERT_BSONOBJ_EQ(diff, fromjson("{u: {a: 2}}"));
+}
+
+TEST(DocDiffTest, TypeChangeIsUpdated) {
+    auto diff = computeDiffOrFail(BSON("a" << 1), BSON("a" << 1.0));
+    ASSERT_EQ(diff["u"]["a"].type(), BSONType::NumberDouble);
+}
+
+TEST(DocDiffTest, RemovedAndAppendedFields) {
+    auto diff =
+        computeDiffOrFail(fromjson("{a: 1, b: 2, c: 3}"), fromjson("{a: 1, c: 3, d: 4}"));
+    ASSERT_BSONOBJ_EQ(diff, fromjson("{d: {b: false}, i: {d: 4}}"));
+}
+
+TEST(DocDiffTest, ReorderedFieldsAreReinserted) {
+    auto diff = computeDiffOrFail(fromjson("{a: 1, b: 2, c: 3}"), fromjson("{a: 1, c: 3, b: 2}"));
+    ASSERT_BSONOBJ_EQ(diff, fromjson("{i: {c: 3, b: 2}}"));
+}
+
+TEST(DocDiffTest, ChangedEmbeddedObjectIsDiffedWhenSmaller) {
+    auto diff = computeDiffOrFail(
+        fromjson("{a: {b: 1, c: 'a long string which should not be logged again'}}"),
+        fromjson("{a: {b: 2, c: 'a long string which should not be logged again'}}"));
+    ASSERT_BSONOBJ_EQ(diff, fromjson("{sa: {u: {b: 2}}}"));
+}
+
+TEST(DocDiffTest, ChangedEmbeddedObjectIsReplacedWhenDiffIsLarger) {
+    auto diff = computeDiffOrFail(fromjson("{a: {b: 1}}"), fromjson("{a: {b: 2}}"));
+    ASSERT_BSONOBJ_EQ(diff, fromjson("{u: {a: {b: 2}}}"));
+}
+
+TEST(DocDiffTest, ChangedArrayIsReplaced) {
+    auto diff = computeDiffOrFail(fromjson("{a: [1, 2, 3]}"), fromjson("{a: [1, 2, 4]}"));
+    ASSERT_BSONOBJ_EQ(diff, fromjson("{u: {a: [1, 2, 4]}}"));
+}
+
+TEST(DocDiffTest, DuplicateFieldNamesCannotBeDiffed) {
+    ASSERT_FALSE(doc_diff::computeDiff(fromjson("{a: 1, a: 2}"), fromjson("{a: 1}")));
+    ASSERT_FALSE(doc_diff::computeDiff(fromjson("{a: 1}"), fromjson("{a: 1, a: 2}")));
+    ASSERT_FALSE(doc_diff::computeDiff(fromjson("{a: {b: 1, b: 2}}"), fromjson("{a: {b: 3}}")));
+}
+
+TEST(DocDiffTest, ApplyingDiffProducesPostImage) {
+    assertRoundTrips(fromjson("{_id: 0, a: 1}"), fromjson("{_id: 0, a: 2}"));
+    assertRoundTrips(fromjson("{_id: 0, a: 1, b: 2, c: 3}"), fromjson("{_id: 0, c: 3, d: 4}"));
+    assertRoundTrips(fromjson("{a: 1, b: 2, c: 3}"), fromjson("{c: 3, a: 1, b: 2}"));
+    assertRoundTrips(fromjson("{a: 1, b: 2}"), fromjson("{}"));
+    assertRoundTrips(fromjson("{}"), fromjson("{a: 1, b: {c: 2}}"));
+    assertRoundTrips(
+        fromjson("{a: {b: {c: 1, d: 'some padding to force a nested diff'}, e: [1]}, f: 'x'}"),
+        fromjson("{a: {b: {c: 2, d: 'some padding to force a nested diff'}, e: [1], g: 1}}"));
+    assertRoundTrips(fromjson("{a: 1, b: 'string'}"), fromjson("{a: 'string', b: 1}"));
+}
+
+TEST(DocDiffTest, SameSizeUpdateIsAppliedInPlace) {
+    auto pre = fromjson("{_id: 0, counter: 1, payload: 'some payload which is not rewritten'}");
+    auto post = fromjson("{_id: 0, counter: 2, payload: 'some payload which is not rewritten'}");
+    auto diff = computeDiffOrFail(pre, post);
+
+    mutablebson::Document doc(pre);
+    doc_diff::applyDiff(diff, doc.root(), nullptr);
+
+    mutablebson::DamageVector damages;
+    const char* source = nullptr;
+    ASSERT_TRUE(doc.getInPlaceUpdates(&damages, &source));
+    ASSERT_EQ(damages.size(), 1U);
+    ASSERT_EQ(damages[0].size, 4U);
+}
+
+TEST(DocDiffTest, NestedSameSizeUpdateIsAppliedInPlace) {
+    auto pre = fromjson("{_id: 0, a: {b: 1, c: 'padding so that the nested diff is chosen'}}");
+    auto post = fromjson("{_id: 0, a: {b: 2, c: 'padding so that the nested diff is chosen'}}");
+    auto diff = computeDiffOrFail(pre, post);
+
+    mutablebson::Document doc(pre);
+    doc_diff::applyDiff(diff, doc.root(), nullptr);
+
+    mutablebson::DamageVector damages;
+    const char* source = nullptr;
+    ASSERT_TRUE(doc.getInPlaceUpdates(&damages, &source));
+    ASSERT_EQ(damages.size(), 1U);
+}
+
+TEST(DocDiffTest, ApplyIsLenientTowardsMissingFields) {
+    mutablebson::Document doc(fromjson("{a: 1, b: 2}"));
+    doc_diff::applyDiff(fromjson("{d: {x: false}, u: {y: 1}, sb: {u: {c: 1}}, sz: {i: {w: 1}}}"),
+                        doc.root(),
+                        nullptr);
+    ASSERT_BSONOBJ_EQ(doc.getObject(), fromjson("{a: 1, b: {c: 1}, y: 1, z: {w: 1}}"));
+}
+
+TEST(DocDiffTest, ApplyRejectsMalformedDiff) {
+    mutablebson::Document doc(fromjson("{a: 1}"));
+    ASSERT_THROWS_CODE(
+        doc_diff::applyDiff(fromjson("{x: {a: 1}}"), doc.root(), nullptr), DBException, 4772601);
+    ASSERT_THROWS_CODE(
+        doc_diff::applyDiff(fromjson("{u: 1}"), doc.root(), nullptr), DBException, 4772600);
+}
+
+TEST(DocDiffTest, ApplyReportsWhetherIndexesAreAffected) {
+    UpdateIndexData indexData;
+    indexData.addPath(FieldRef("a.b"));
+
+    {
+        mutablebson::Document doc(fromjson("{a: {b: 1, c: 1}, d: 1}"));
+        ASSERT_FALSE(doc_diff::applyDiff(
+            fromjson("{u: {d: 2}, sa: {u: {c: 2}}}"), doc.root(), &indexData));
+    }
+    {
+        mutablebson::Document doc(fromjson("{a: {b: 1, c: 1}, d: 1}"));
+        ASSERT_TRUE(doc_diff::applyDiff(fromjson("{sa: {u: {b: 2}}}"), doc.root(), &indexData));
+    }
+    {
+        mutablebson::Document doc(fromjson("{a: {b: 1, c: 1}, d: 1}"));
+        ASSERT_TRUE(doc_diff::applyDiff(fromjson("{d: {a: false}}"), doc.root(), &indexData));
+    }
+    {
+        mutablebson::Document doc(fromjson("{a: {b: 1, c: 1}, d: 1}"));
+        ASSERT_FALSE(doc_diff::applyDiff(fromjson("{u: {d: 2}}"), doc.root(), nullptr));
+    }
+}
+
+TEST(DocDiffTest, DescribeDiff) {
+    BSONObjBuilder updatedFields;
+    std::vector<std::string> removedFields;
+    doc_diff::describeDiff(fromjson("{d: {x: false}, u: {a: 1}, sb: {d: {y: false}, i: {c: 2}}}"),
+                           &updatedFields,
+                           &removedFields);
+    ASSERT_BSONOBJ_EQ(updatedFields.obj(), fromjson("{a: 1, 'b.c': 2}"));
+    ASSERT_EQ(removedFields, (std::vector<std::string>{"x", "b.y"}));
+}
+
+}  // namespace
+}  // namespace mongo
@@ -0,0 +1,214 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/update/in_place_update.h"
+
+#include <algorithm>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/update/log_builder.h"
+#include "mongo/db/update/modifier_table.h"
+#include "mongo/util/safe_num.h"
+
+namespace mongo {
+namespace {
+
+// Types whose values have the same size no matter what they hold, so that one value can overwrite
+// another of the same type without changing the layout of the document.
+bool isFixedWidthType(BSONType type) {
+    switch (type) {
+        case BSONType::NumberInt:
+        case BSONType::NumberLong:
+        case BSONType::NumberDouble:
+        case BSONType::NumberDecimal:
+        case BSONType::Date:
+        case BSONType::Bool:
+            return true;
+        default:
+            return false;
+    }
+}
+
+// Returns the element at 'path' in 'doc', or EOO if there is none or if the path goes through
+// anything but embedded objects.
+BSONElement findElement(const BSONObj& doc, const FieldRef& path) {
+    BSONElement elem = doc.getField(path.getPart(0));
+    for (FieldRef::FieldIndex i = 1; i < path.numParts(); ++i) {
+        if (elem.type() != BSONType::Object) {
+            return BSONElement();
+        }
+        elem = elem.embeddedObject().getField(path.getPart(i));
+    }
+    return elem;
+}
+
+}  // namespace
+
+boost::optional<InPlaceUpdate> InPlaceUpdate::parse(const BSONObj& updateExpr) {
+    InPlaceUpdate update(updateExpr.getOwned());
+
+    for (auto&& mod : update._updateExpr) {
+        // Oplog entries carry a $v field next to their modifiers.
+        if (mod.fieldNameStringData() == LogBuilder::kUpdateSemanticsFieldName) {
+            continue;
+        }
+
+        Op op;
+        switch (modifiertable::getType(mod.fieldName())) {
+            case modifiertable::MOD_INC:
+                op = Op::kInc;
+                break;
+            case modifiertable::MOD_SET:
+                op = Op::kSet;
+                break;
+            case modifiertable::MOD_MAX:
+                op = Op::kMax;
+                break;
+            case modifiertable::MOD_MIN:
+                op = Op::kMin;
+                break;
+            case modifiertable::MOD_SET_ON_INSERT:
+                continue;
+            default:
+                return boost::none;
+        }
+
+        for (auto&& field : mod.Obj()) {
+            FieldRef path(field.fieldNameStringData());
+            for (FieldRef::FieldIndex i = 0; i < path.numParts(); ++i) {
+                // Positional operators and '$'-prefixed names such as DBRef fields need the
+                // checks of the update tree.
+                const auto part = path.getPart(i);
+                if (part.empty() || part[0] == '$') {
+                    return boost::none;
+                }
+            }
+            update._mods.push_back({std::move(path), op, field});
+        }
+    }
+
+    std::sort(update._mods.begin(),
+              update._mods.end(),
+              [](const Modification& lhs, const Modification& rhs) { return lhs.path < rhs.path; });
+    return update;
+}
+
+bool InPlaceUpdate::apply(const BSONObj& doc,
+                          const FieldRefSet& protectedPaths,
+                          const UpdateIndexData* indexData,
+                          mutablebson::DamageVector* damages,
+                          BSONObj* logEntry) const {
+    // The regular update path moves '_id' to the front of the document, or generates one if it is
+    // missing, so leave any document that does not already start with it to that path.
+    if (doc.firstElementFieldNameStringData() != "_id"_sd) {
+        return false;
+    }
+
+    damages->clear();
+
+    // The new values are written straight into the oplog entry, which then serves as the source
+    // buffer of the damage events.
+    BSONObjBuilder logBuilder;
+    logBuilder.append(LogBuilder::kUpdateSemanticsFieldName,
+                      static_cast<int>(UpdateSemantics::kUpdateNode));
+    BSONObjBuilder setBuilder(logBuilder.subobjStart("$set"));
+
+    for (auto&& mod : _mods) {
+        const BSONElement elem = findElement(doc, mod.path);
+        if (!isFixedWidthType(elem.type())) {
+            return false;
+        }
+
+        // The new value is either 'newNumber' or, if that is not valid, 'mod.operand'.
+        SafeNum newNumber;
+        switch (mod.op) {
+            case Op::kInc: {
+                if (!elem.isNumber()) {
+                    return false;
+                }
+                const SafeNum original(elem);
+                newNumber = mod.operand;
+                newNumber += original;
+                if (newNumber.isIdentical(original)) {
+                    continue;
+                }
+                // Overflowing into a wider type changes the size of the value.
+                if (!newNumber.isValid() || newNumber.type() != elem.type()) {
+                    return false;
+                }
+                break;
+            }
+            case Op::kSet:
+                if (mod.operand.type() != elem.type()) {
+                    return false;
+                }
+                if (elem.binaryEqualValues(mod.operand)) {
+                    continue;
+                }
+                break;
+            case Op::kMax:
+            case Op::kMin: {
+                if (mod.operand.type() != elem.type()) {
+                    return false;
+                }
+                const int compareVal = elem.woCompare(mod.operand, false);
+                if (compareVal == 0 || (mod.op == Op::kMax ? compareVal > 0 : compareVal < 0)) {
+                    continue;
+                }
+                break;
+            }
+        }
+
+        if (protectedPaths.findConflicts(&mod.path, nullptr) ||
+            (indexData && indexData->mightBeIndexed(mod.path))) {
+            return false;
+        }
+
+        const auto fieldName = mod.path.dottedField();
+        const auto sourceOffset = setBuilder.len() + 1 + fieldName.size() + 1;
+        if (newNumber.isValid()) {
+            newNumber.toBSON(fieldName, &setBuilder);
+        } else {
+            setBuilder.appendAs(mod.operand, fieldName);
+        }
+
+        damages->push_back({static_cast<mutablebson::DamageEvent::OffsetSizeType>(sourceOffset),
+                            static_cast<mutablebson::DamageEvent::OffsetSizeType>(
+                                elem.value() - doc.objdata()),
+                            static_cast<size_t>(elem.valuesize())});
+    }
+
+    setBuilder.doneFast();
+    *logEntry = damages->empty() ? BSONObj() : logBuilder.obj();
+    return true;
+}
+
+}  // namespace mongo
@@ -0,0 +1,98 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <boost/optional.hpp>
+#include <vector>
+
+#include "mongo/bson/bsonobj.h"
+#include "mongo/bson/mutable/damage_vector.h"
+#include "mongo/db/field_ref.h"
+#include "mongo/db/field_ref_set.h"
+#include "mongo/db/update_index_data.h"
+
+namespace mongo {
+
+/**
+ * A fast path for the common case of an operator-style update that only overwrites fixed-width
+ * scalars, such as incrementing a counter. If every modifier is $inc, $set, $max or $min on a
+ * field that already exists with a fixed-width type (number, date or bool) and the new value keeps
+ * that type, the update can be expressed as damage events against the original BSON and logged
+ * as a $set of the new values, without building a mutable document. $setOnInsert modifiers are
+ * ignored, since the fast path only ever updates existing documents.
+ *
+ * Anything else makes apply() decline, and the caller falls back to the regular update path,
+ * which also produces any error the update should raise.
+ */
+class InPlaceUpdate {
+public:
+    /**
+     * Returns an InPlaceUpdate for 'updateExpr', or boost::none if 'updateExpr' uses a modifier or
+     * path the fast path does not handle. 'updateExpr' must already have been parsed successfully
+     * into an update tree, so that it is known to be free of conflicting paths and its operands
+     * are known to be valid.
+     */
+    static boost::optional<InPlaceUpdate> parse(const BSONObj& updateExpr);
+
+    /**
+     * Computes the update of 'doc'. Returns false if the update cannot be applied in place, in
+     * which case 'damages' and 'logEntry' are unspecified. Otherwise returns true, and fills
+     * 'damages' with the changes to make to 'doc' and 'logEntry' with the oplog entry for the
+     * update. The source offsets of the damages point into 'logEntry'. Both are left empty if the
+     * update turns out to be a no-op.
+     *
+     * The update declines to modify 'doc' in place if a modified path conflicts with a path in
+     * 'protectedPaths' or might be indexed according to 'indexData', which may be null.
+     */
+    bool apply(const BSONObj& doc,
+               const FieldRefSet& protectedPaths,
+               const UpdateIndexData* indexData,
+               mutablebson::DamageVector* damages,
+               BSONObj* logEntry) const;
+
+private:
+    enum class Op { kInc, kSet, kMax, kMin };
+
+    struct Modification {
+        FieldRef path;
+        Op op;
+        BSONElement operand;
+    };
+
+    explicit InPlaceUpdate(BSONObj updateExpr) : _updateExpr(std::move(updateExpr)) {}
+
+    // Owns the operands referenced by '_mods'.
+    BSONObj _updateExpr;
+
+    // Sorted by path, which is the order in which the update tree logs its changes.
+    std::vector<Modification> _mods;
+};
+
+}  // namespace mongo
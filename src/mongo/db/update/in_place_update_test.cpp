@@ -0,0 +1,159 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/update/in_place_update.h"
+
+#include <cstring>
+#include <limits>
+#include <string>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/json.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+// Returns a copy of 'doc' with 'damages' applied, reading the new values from 'source'.
+BSONObj applyDamages(const BSONObj& doc,
+                     const mutablebson::DamageVector& damages,
+                     const char* source) {
+    std::string buffer(doc.objdata(), doc.objsize());
+    for (auto&& damage : damages) {
+        std::memcpy(&buffer[damage.targetOffset], source + damage.sourceOffset, damage.size);
+    }
+    return BSONObj(buffer.data()).getOwned();
+}
+
+class InPlaceUpdateTest : public unittest::Test {
+protected:
+    /**
+     * Applies 'updateExpr' to 'doc' and returns whether it could be applied in place. If so,
+     * '_updated' holds the resulting document and '_logEntry' the oplog entry.
+     */
+    bool apply(const BSONObj& updateExpr, const BSONObj& doc) {
+        auto update = InPlaceUpdate::parse(updateExpr);
+        ASSERT(update);
+        if (!update->apply(doc, _protectedPaths, &_indexData, &_damages, &_logEntry)) {
+            return false;
+        }
+        _updated = applyDamages(doc, _damages, _logEntry.objdata());
+        return true;
+    }
+
+    FieldRefSet _protectedPaths;
+    UpdateIndexData _indexData;
+    mutablebson::DamageVector _damages;
+    BSONObj _logEntry;
+    BSONObj _updated;
+};
+
+TEST_F(InPlaceUpdateTest, IncrementsCountersInPlace) {
+    ASSERT_TRUE(apply(fromjson("{$inc: {'b.c': 1.5, a: 1}}"),
+                      fromjson("{_id: 0, a: 5, b: {c: 2.5}, d: 'x'}")));
+    ASSERT_EQ(_damages.size(), 2U);
+    ASSERT_BSONOBJ_EQ(_updated, fromjson("{_id: 0, a: 6, b: {c: 4.0}, d: 'x'}"));
+    ASSERT_BSONOBJ_EQ(_logEntry, fromjson("{$v: 1, $set: {a: 6, 'b.c': 4.0}}"));
+}
+
+TEST_F(InPlaceUpdateTest, SetsMaxAndMinOfFixedWidthFields) {
+    const auto doc = BSON("_id" << 0 << "flag" << false << "ts" << Date_t::fromMillisSinceEpoch(100)
+                                << "low" << 5LL);
+    ASSERT_TRUE(apply(BSON("$set" << BSON("flag" << true) << "$max"
+                                  << BSON("ts" << Date_t::fromMillisSinceEpoch(200)) << "$min"
+                                  << BSON("low" << 3LL)),
+                      doc));
+    ASSERT_EQ(_damages.size(), 3U);
+    ASSERT_BSONOBJ_EQ(_updated,
+                      BSON("_id" << 0 << "flag" << true << "ts"
+                                 << Date_t::fromMillisSinceEpoch(200) << "low" << 3LL));
+}
+
+TEST_F(InPlaceUpdateTest, NoopsProduceNoDamages) {
+    ASSERT_TRUE(apply(fromjson("{$inc: {a: 0}, $max: {b: 1}, $set: {c: true}}"),
+                      fromjson("{_id: 0, a: 1, b: 2, c: true}")));
+    ASSERT(_damages.empty());
+    ASSERT(_logEntry.isEmpty());
+}
+
+TEST_F(InPlaceUpdateTest, IgnoresSetOnInsert) {
+    ASSERT_TRUE(apply(fromjson("{$inc: {a: 1}, $setOnInsert: {b: 'created'}}"),
+                      fromjson("{_id: 0, a: 1}")));
+    ASSERT_BSONOBJ_EQ(_updated, fromjson("{_id: 0, a: 2}"));
+    ASSERT_BSONOBJ_EQ(_logEntry, fromjson("{$v: 1, $set: {a: 2}}"));
+}
+
+TEST_F(InPlaceUpdateTest, DeclinesUpdatesThatChangeTheLayout) {
+    const auto doc = BSON("_id" << 0 << "i" << std::numeric_limits<int>::max() << "s"
+                                << "str"
+                                << "arr" << BSON_ARRAY(1 << 2));
+    // Overflows into a long.
+    ASSERT_FALSE(apply(fromjson("{$inc: {i: 1}}"), doc));
+    // Changes the type.
+    ASSERT_FALSE(apply(fromjson("{$set: {i: 1.5}}"), doc));
+    ASSERT_FALSE(apply(fromjson("{$max: {i: {$numberLong: '1'}}}"), doc));
+    // Not a fixed-width field.
+    ASSERT_FALSE(apply(fromjson("{$set: {s: 'abc'}}"), doc));
+    // Goes through an array.
+    ASSERT_FALSE(apply(fromjson("{$inc: {'arr.0': 1}}"), doc));
+    // Creates a field.
+    ASSERT_FALSE(apply(fromjson("{$inc: {missing: 1}}"), doc));
+}
+
+TEST_F(InPlaceUpdateTest, DeclinesDocumentsWithoutLeadingId) {
+    ASSERT_FALSE(apply(fromjson("{$inc: {a: 1}}"), fromjson("{a: 1, _id: 0}")));
+    ASSERT_FALSE(apply(fromjson("{$inc: {a: 1}}"), fromjson("{a: 1}")));
+}
+
+TEST_F(InPlaceUpdateTest, DeclinesProtectedAndIndexedPaths) {
+    const FieldRef idPath("_id");
+    _protectedPaths.insert(&idPath);
+    _indexData.addPath(FieldRef("b"));
+
+    const auto doc = fromjson("{_id: 0, a: 1, b: {c: 1}}");
+    ASSERT_FALSE(apply(fromjson("{$set: {_id: 1}}"), doc));
+    ASSERT_FALSE(apply(fromjson("{$inc: {a: 1, 'b.c': 1}}"), doc));
+
+    // A no-op on a protected or indexed path does not get in the way.
+    ASSERT_TRUE(apply(fromjson("{$set: {_id: 0}, $inc: {a: 1, 'b.c': 0}}"), doc));
+    ASSERT_BSONOBJ_EQ(_updated, fromjson("{_id: 0, a: 2, b: {c: 1}}"));
+}
+
+TEST(InPlaceUpdateParseTest, RejectsOtherModifiersAndPositionalPaths) {
+    ASSERT_FALSE(InPlaceUpdate::parse(fromjson("{$inc: {a: 1}, $unset: {b: 1}}")));
+    ASSERT_FALSE(InPlaceUpdate::parse(fromjson("{$push: {a: 1}}")));
+    ASSERT_FALSE(InPlaceUpdate::parse(fromjson("{$inc: {'a.$': 1}}")));
+    ASSERT_FALSE(InPlaceUpdate::parse(fromjson("{$set: {'a.$[]': 1}}")));
+    ASSERT_TRUE(InPlaceUpdate::parse(fromjson("{$v: 1, $set: {a: 1}}")));
+}
+
+}  // namespace
+}  // namespace mongo
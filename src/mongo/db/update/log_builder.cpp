@@ -40,6 +40,7 @@ const char kUnset[] = "$unset";
 }  // namespace
 
 constexpr StringData LogBuilder::kUpdateSemanticsFieldName;
+constexpr StringData LogBuilder::kDeltaDiffFieldName;
 
 inline Status LogBuilder::addToSection(Element newElt, Element* section, const char* sectionName) {
     // If we don't already have this section, try to create it now.
@@ -50,6 +51,11 @@ inline Status LogBuilder::addToSection(Element newElt, Element* section, const c
                           "LogBuilder: Invalid attempt to add a $set/$unset entry"
                           "to a log with an existing object replacement");
 
+        if (_deltaDiff.ok())
+            return Status(ErrorCodes::IllegalOperation,
+                          "LogBuilder: Invalid attempt to add a $set/$unset entry "
+                          "to a log with an existing diff");
+
         mutablebson::Document& doc = _logRoot.getDocument();
 
         // We should not already have an element with the section name under the root.
@@ -150,10 +156,10 @@ Status LogBuilder::getReplacementObject(Element* outElt) {
     // If the replacement accumulator is not ok, we must have started a $set or $unset
     // already, so an object replacement is not permitted.
     if (!_objectReplacementAccumulator.ok()) {
-        dassert(_setAccumulator.ok() || _unsetAccumulator.ok());
+        dassert(_setAccumulator.ok() || _unsetAccumulator.ok() || _deltaDiff.ok());
         return Status(ErrorCodes::IllegalOperation,
                       "LogBuilder: Invalid attempt to obtain the object replacement slot "
-                      "for a log containing $set or $unset entries");
+                      "for a log containing $set, $unset or diff entries");
     }
 
     if (hasObjectReplacement())
@@ -172,6 +178,30 @@ Status LogBuilder::getReplacementObject(Element* outElt) {
     return Status::OK();
 }
 
+Status LogBuilder::setDeltaDiff(const BSONObj& diff) {
+    if (hasObjectReplacement() || _setAccumulator.ok() || _unsetAccumulator.ok() ||
+        _updateSemantics.ok()) {
+        return Status(ErrorCodes::IllegalOperation,
+                      "LogBuilder: Invalid attempt to record a diff in a log with existing "
+                      "entries");
+    }
+
+    mutablebson::Document& doc = _logRoot.getDocument();
+    const Element diffElement = doc.makeElementObject(kDeltaDiffFieldName, diff);
+    if (!diffElement.ok())
+        return Status(ErrorCodes::InternalError,
+                      "LogBuilder: failed to construct Object Element for the diff");
+
+    Status result = setUpdateSemantics(UpdateSemantics::kDelta);
+    if (!result.isOK())
+        return result;
+
+    // Invalidate attempts to add an object replacement, now that the log holds a diff.
+    _objectReplacementAccumulator = doc.end();
+    _deltaDiff = diffElement;
+    return _logRoot.pushBack(diffElement);
+}
+
 inline bool LogBuilder::hasObjectReplacement() const {
     if (!_objectReplacementAccumulator.ok())
         return false;
@@ -43,6 +43,10 @@ enum class UpdateSemantics {
     // system introduces support for arrayFilters and $[] syntax.
     kUpdateNode = 1,
 
+    // Update oplog entries which record a structural diff between the pre- and post-image of the
+    // document, see doc_diff.h. Currently only produced for pipeline-style updates.
+    kDelta = 2,
+
     // Must be last.
     kNumUpdateSemantics
 };
@@ -55,6 +59,7 @@ enum class UpdateSemantics {
 class LogBuilder {
 public:
     static constexpr StringData kUpdateSemanticsFieldName = "$v"_sd;
+    static constexpr StringData kDeltaDiffFieldName = "diff"_sd;
 
     /** Construct a new LogBuilder. Log entries will be recorded as new children under the
      *  'logRoot' Element, which must be of type mongo::Object and have no children.
@@ -64,7 +69,8 @@ public:
           _objectReplacementAccumulator(_logRoot),
           _setAccumulator(_logRoot.getDocument().end()),
           _unsetAccumulator(_setAccumulator),
-          _updateSemantics(_setAccumulator) {
+          _updateSemantics(_setAccumulator),
+          _deltaDiff(_setAccumulator) {
         dassert(logRoot.isType(mongo::Object));
         dassert(!logRoot.hasChildren());
     }
@@ -125,6 +131,13 @@ public:
      */
     Status getReplacementObject(mutablebson::Element* outElt);
 
+    /**
+     * Records 'diff' as a delta-style log entry of the form {$v: 2, diff: <diff>}. It is an error
+     * to call this if the log already contains any other entries, and no entries may be added
+     * afterwards.
+     */
+    Status setDeltaDiff(const BSONObj& diff);
+
 private:
     // Returns true if the object replacement accumulator is valid and has children, false
     // otherwise.
@@ -139,6 +152,7 @@ private:
     mutablebson::Element _setAccumulator;
     mutablebson::Element _unsetAccumulator;
     mutablebson::Element _updateSemantics;
+    mutablebson::Element _deltaDiff;
 };
 
 }  // namespace mongo
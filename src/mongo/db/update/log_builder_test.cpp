@@ -270,4 +270,34 @@ TEST(LogBuilder, CantReacquireObjectReplacementData) {
     ASSERT_FALSE(again.ok());
 }
 
+TEST(LogBuilder, SetDeltaDiff) {
+    mmb::Document doc;
+    LogBuilder lb(doc.root());
+
+    ASSERT_OK(lb.setDeltaDiff(mongo::fromjson("{u: {a: 1}}")));
+    ASSERT_EQUALS(mongo::fromjson("{$v: 2, diff: {u: {a: 1}}}"), doc);
+}
+
+TEST(LogBuilder, CantAddSetOrReplacementAfterDeltaDiff) {
+    mmb::Document doc;
+    LogBuilder lb(doc.root());
+
+    ASSERT_OK(lb.setDeltaDiff(mongo::fromjson("{u: {a: 1}}")));
+    ASSERT_NOT_OK(lb.addToSets(doc.makeElementInt("x", 0)));
+    ASSERT_NOT_OK(lb.addToUnsets("x"));
+    ASSERT_NOT_OK(lb.setDeltaDiff(mongo::fromjson("{u: {b: 1}}")));
+
+    mmb::Element replacement = doc.end();
+    ASSERT_NOT_OK(lb.getReplacementObject(&replacement));
+    ASSERT_FALSE(replacement.ok());
+}
+
+TEST(LogBuilder, CantSetDeltaDiffWithSetPresent) {
+    mmb::Document doc;
+    LogBuilder lb(doc.root());
+
+    ASSERT_OK(lb.addToSets(doc.makeElementInt("x", 0)));
+    ASSERT_NOT_OK(lb.setDeltaDiff(mongo::fromjson("{u: {a: 1}}")));
+}
+
 }  // namespace
@@ -70,41 +70,8 @@ ObjectReplaceExecutor::ObjectReplaceExecutor(BSONObj replacement)
     }
 }
 
-UpdateExecutor::ApplyResult ObjectReplaceExecutor::applyReplacementUpdate(
-    ApplyParams applyParams, const BSONObj& replacementDoc, bool replacementDocContainsIdField) {
-    auto originalDoc = applyParams.element.getDocument().getObject();
-
-    // Check for noop.
-    if (originalDoc.binaryEqual(replacementDoc)) {
-        return ApplyResult::noopResult();
-    }
-
-    // Remove the contents of the provided document.
-    auto current = applyParams.element.leftChild();
-    while (current.ok()) {
-
-        // Keep the _id if the replacement document does not have one.
-        if (!replacementDocContainsIdField && current.getFieldName() == kIdFieldName) {
-            current = current.rightSibling();
-            continue;
-        }
-
-        auto toRemove = current;
-        current = current.rightSibling();
-        invariant(toRemove.remove());
-    }
-
-    // Insert the provided contents instead.
-    for (auto&& elem : replacementDoc) {
-        invariant(applyParams.element.appendElement(elem));
-    }
-
-    // Validate for storage.
-    if (applyParams.validateForStorage) {
-        storage_validation::storageValid(applyParams.element.getDocument());
-    }
-
-    // Check immutable paths.
+void ObjectReplaceExecutor::checkImmutablePaths(const ApplyParams& applyParams,
+                                                const BSONObj& originalDoc) {
     for (auto path = applyParams.immutablePaths.begin(); path != applyParams.immutablePaths.end();
          ++path) {
 
@@ -140,6 +107,44 @@ UpdateExecutor::ApplyResult ObjectReplaceExecutor::applyReplacementUpdate(
                     newElem.compareWithBSONElement(oldElem, nullptr, false) == 0);
         }
     }
+}
+
+UpdateExecutor::ApplyResult ObjectReplaceExecutor::applyReplacementUpdate(
+    ApplyParams applyParams, const BSONObj& replacementDoc, bool replacementDocContainsIdField) {
+    auto originalDoc = applyParams.element.getDocument().getObject();
+
+    // Check for noop.
+    if (originalDoc.binaryEqual(replacementDoc)) {
+        return ApplyResult::noopResult();
+    }
+
+    // Remove the contents of the provided document.
+    auto current = applyParams.element.leftChild();
+    while (current.ok()) {
+
+        // Keep the _id if the replacement document does not have one.
+        if (!replacementDocContainsIdField && current.getFieldName() == kIdFieldName) {
+            current = current.rightSibling();
+            continue;
+        }
+
+        auto toRemove = current;
+        current = current.rightSibling();
+        invariant(toRemove.remove());
+    }
+
+    // Insert the provided contents instead.
+    for (auto&& elem : replacementDoc) {
+        invariant(applyParams.element.appendElement(elem));
+    }
+
+    // Validate for storage.
+    if (applyParams.validateForStorage) {
+        storage_validation::storageValid(applyParams.element.getDocument());
+    }
+
+    // Check immutable paths.
+    checkImmutablePaths(applyParams, originalDoc);
 
     if (applyParams.logBuilder) {
         auto replacementObject = applyParams.logBuilder->getDocument().end();
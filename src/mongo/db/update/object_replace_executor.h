@@ -52,6 +52,10 @@ public:
                                               const BSONObj& replacementDoc,
                                               bool replacementDocContainsIdField);
 
+    // Uasserts if the value at any of 'applyParams.immutablePaths' in the updated document rooted
+    // at 'applyParams.element' was removed or differs from its value in 'originalDoc'.
+    static void checkImmutablePaths(const ApplyParams& applyParams, const BSONObj& originalDoc);
+
     /**
      * Initializes the node with the document to replace with. Any zero-valued timestamps (except
      * for the _id) are updated to the current time.
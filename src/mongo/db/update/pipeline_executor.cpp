@@ -34,13 +34,31 @@
 #include "mongo/db/bson/dotted_path_support.h"
 #include "mongo/db/pipeline/document_source_queue.h"
 #include "mongo/db/pipeline/lite_parsed_pipeline.h"
+#include "mongo/db/server_options.h"
+#include "mongo/db/update/delta_executor.h"
 #include "mongo/db/update/object_replace_executor.h"
 #include "mongo/db/update/storage_validation.h"
+#include "mongo/db/update/update_server_parameters_gen.h"
 
 namespace mongo {
 
 namespace {
 constexpr StringData kIdFieldName = "_id"_sd;
+
+/**
+ * '$v: 2' oplog entries can only be logged once every member of the replica set can apply them,
+ * which the knob alone cannot guarantee across an upgrade or downgrade of the feature
+ * compatibility version.
+ */
+bool shouldLogDeltaOplogEntries() {
+    if (!gEnableDeltaOplogEntriesForPipelineUpdates.load()) {
+        return false;
+    }
+
+    const auto& fcv = serverGlobalParams.featureCompatibility;
+    return fcv.isVersionInitialized() &&
+        fcv.getVersion() == ServerGlobalParams::FeatureCompatibility::Version::kFullyUpgradedTo46;
+}
 }  // namespace
 
 PipelineExecutor::PipelineExecutor(const boost::intrusive_ptr<ExpressionContext>& expCtx,
@@ -87,10 +105,30 @@ PipelineExecutor::PipelineExecutor(const boost::intrusive_ptr<ExpressionContext>
 
 UpdateExecutor::ApplyResult PipelineExecutor::applyUpdate(ApplyParams applyParams) const {
     DocumentSourceQueue* queueStage = static_cast<DocumentSourceQueue*>(_pipeline->peekFront());
-    queueStage->emplace_back(Document{applyParams.element.getDocument().getObject()});
+    auto originalDoc = applyParams.element.getDocument().getObject();
+    queueStage->emplace_back(Document{originalDoc});
     auto transformedDoc = _pipeline->getNext()->toBson();
     auto transformedDocHasIdField = transformedDoc.hasField(kIdFieldName);
 
+    if (shouldLogDeltaOplogEntries()) {
+        // Build the document the replacement would produce, preserving the original _id, and
+        // apply it as a diff when that is cheaper to log than the whole post-image.
+        BSONObj postImage = transformedDoc;
+        if (!transformedDocHasIdField) {
+            BSONObjBuilder postImageBuilder;
+            if (auto idElem = originalDoc[kIdFieldName]) {
+                postImageBuilder.append(idElem);
+            }
+            postImageBuilder.appendElements(transformedDoc);
+            postImage = postImageBuilder.obj();
+        }
+
+        auto diff = doc_diff::computeDiff(originalDoc, postImage);
+        if (diff && diff->objsize() < postImage.objsize()) {
+            return DeltaExecutor::applyDiff(applyParams, *diff, originalDoc);
+        }
+    }
+
     return ObjectReplaceExecutor::applyReplacementUpdate(
         applyParams, transformedDoc, transformedDocHasIdField);
 }
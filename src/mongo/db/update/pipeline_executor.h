@@ -55,10 +55,13 @@ public:
                               boost::optional<BSONObj> constants = boost::none);
 
     /**
-     * Replaces the document that 'applyParams.element' belongs to with 'val'. If 'val' does not
-     * contain an _id, the _id from the original document is preserved. 'applyParams.element' must
-     * be the root of the document. Always returns a result stating that indexes are affected when
-     * the replacement is not a noop.
+     * Replaces the document that 'applyParams.element' belongs to with the output of the pipeline.
+     * If the output does not contain an _id, the _id from the original document is preserved.
+     * 'applyParams.element' must be the root of the document. When
+     * 'enableDeltaOplogEntriesForPipelineUpdates' is set and the diff between the original and the
+     * new document is smaller than the new document, the diff is applied and logged instead, and
+     * indexes are reported as affected only if the diff touches an indexed path. Otherwise, always
+     * returns a result stating that indexes are affected when the replacement is not a noop.
      */
     ApplyResult applyUpdate(ApplyParams applyParams) const final;
 
@@ -38,6 +38,8 @@
 #include "mongo/db/logical_clock.h"
 #include "mongo/db/pipeline/expression_context_for_test.h"
 #include "mongo/db/update/update_node_test_fixture.h"
+#include "mongo/db/update/update_server_parameters_gen.h"
+#include "mongo/unittest/ensure_fcv.h"
 #include "mongo/unittest/unittest.h"
 
 namespace mongo {
@@ -362,5 +364,108 @@ TEST_F(PipelineExecutorTest, NoopWithConstants) {
     ASSERT_EQUALS(fromjson("{}"), getLogDoc());
 }
 
+class PipelineExecutorDeltaTest : public UpdateNodeTest {
+protected:
+    void setUp() override {
+        UpdateNodeTest::setUp();
+        gEnableDeltaOplogEntriesForPipelineUpdates.store(true);
+    }
+
+    void tearDown() override {
+        gEnableDeltaOplogEntriesForPipelineUpdates.store(false);
+        UpdateNodeTest::tearDown();
+    }
+};
+
+TEST_F(PipelineExecutorDeltaTest, SmallChangeIsLoggedAsDiffAndAppliedInPlace) {
+    boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+
+    std::vector<BSONObj> pipeline{fromjson("{$set: {counter: {$add: ['$counter', 1]}}}")};
+    PipelineExecutor exec(expCtx, pipeline);
+
+    mutablebson::Document doc(
+        fromjson("{_id: 0, counter: 1.0, payload: 'a payload which is not logged again'}"));
+    addImmutablePath("_id");
+    auto result = exec.applyUpdate(getApplyParams(doc.root()));
+    ASSERT_FALSE(result.noop);
+    ASSERT_FALSE(result.indexesAffected);
+    ASSERT_EQUALS(
+        fromjson("{_id: 0, counter: 2.0, payload: 'a payload which is not logged again'}"), doc);
+    ASSERT_TRUE(doc.isInPlaceModeEnabled());
+    ASSERT_EQUALS(fromjson("{$v: 2, diff: {u: {counter: 2.0}}}"), getLogDoc());
+}
+
+TEST_F(PipelineExecutorDeltaTest, IndexesAffectedWhenDiffTouchesIndexedPath) {
+    boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+
+    std::vector<BSONObj> pipeline{fromjson("{$unset: 'a'}")};
+    PipelineExecutor exec(expCtx, pipeline);
+
+    mutablebson::Document doc(fromjson("{_id: 0, a: 1, b: 'a payload which is not logged again'}"));
+    addIndexedPath("a");
+    auto result = exec.applyUpdate(getApplyParams(doc.root()));
+    ASSERT_FALSE(result.noop);
+    ASSERT_TRUE(result.indexesAffected);
+    ASSERT_EQUALS(fromjson("{_id: 0, b: 'a payload which is not logged again'}"), doc);
+    ASSERT_EQUALS(fromjson("{$v: 2, diff: {d: {a: false}}}"), getLogDoc());
+}
+
+TEST_F(PipelineExecutorDeltaTest, PreservesIdOfExistingDocument) {
+    boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+
+    std::vector<BSONObj> pipeline{fromjson("{$project: {_id: 0, a: 1, b: 1}}")};
+    PipelineExecutor exec(expCtx, pipeline);
+
+    mutablebson::Document doc(
+        fromjson("{_id: 0, a: 'some long value', b: 'another long value', c: 1}"));
+    auto result = exec.applyUpdate(getApplyParams(doc.root()));
+    ASSERT_FALSE(result.noop);
+    ASSERT_EQUALS(fromjson("{_id: 0, a: 'some long value', b: 'another long value'}"), doc);
+    ASSERT_EQUALS(fromjson("{$v: 2, diff: {d: {c: false}}}"), getLogDoc());
+}
+
+TEST_F(PipelineExecutorDeltaTest, LargeChangeIsLoggedAsReplacement) {
+    boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+
+    std::vector<BSONObj> pipeline{fromjson("{$replaceWith: {_id: '$_id', x: 1}}")};
+    PipelineExecutor exec(expCtx, pipeline);
+
+    mutablebson::Document doc(fromjson("{_id: 0, a: 1}"));
+    auto result = exec.applyUpdate(getApplyParams(doc.root()));
+    ASSERT_FALSE(result.noop);
+    ASSERT_TRUE(result.indexesAffected);
+    ASSERT_EQUALS(fromjson("{_id: 0, x: 1}"), doc);
+    ASSERT_EQUALS(fromjson("{_id: 0, x: 1}"), getLogDoc());
+}
+
+TEST_F(PipelineExecutorDeltaTest, SmallChangeIsLoggedAsReplacementBeforeFCVAllowsDiffs) {
+    boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+
+    std::vector<BSONObj> pipeline{fromjson("{$set: {counter: {$add: ['$counter', 1]}}}")};
+    PipelineExecutor exec(expCtx, pipeline);
+
+    unittest::EnsureFCV ensureFCV(unittest::EnsureFCV::Version::kFullyDowngradedTo44);
+
+    mutablebson::Document doc(fromjson("{_id: 0, counter: 1.0, payload: 'logged again'}"));
+    addImmutablePath("_id");
+    auto result = exec.applyUpdate(getApplyParams(doc.root()));
+    ASSERT_FALSE(result.noop);
+    ASSERT_EQUALS(fromjson("{_id: 0, counter: 2.0, payload: 'logged again'}"), doc);
+    ASSERT_EQUALS(fromjson("{_id: 0, counter: 2.0, payload: 'logged again'}"), getLogDoc());
+}
+
+TEST_F(PipelineExecutorDeltaTest, CannotModifyImmutableId) {
+    boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+
+    std::vector<BSONObj> pipeline{fromjson("{$set: {_id: 1}}")};
+    PipelineExecutor exec(expCtx, pipeline);
+
+    mutablebson::Document doc(fromjson("{_id: 0, a: 'a payload which is not logged again'}"));
+    addImmutablePath("_id");
+    ASSERT_THROWS_CODE(exec.applyUpdate(getApplyParams(doc.root())),
+                       AssertionException,
+                       ErrorCodes::ImmutableField);
+}
+
 }  // namespace
 }  // namespace mongo
@@ -44,6 +44,7 @@
 #include "mongo/db/update/object_replace_executor.h"
 #include "mongo/db/update/path_support.h"
 #include "mongo/db/update/storage_validation.h"
+#include "mongo/db/update/update_server_parameters_gen.h"
 #include "mongo/util/embedded_builder.h"
 #include "mongo/util/str.h"
 
@@ -60,8 +61,10 @@ StatusWith<UpdateSemantics> updateSemanticsFromElement(BSONElement element) {
 
     auto updateSemantics = element.numberLong();
 
-    // As of 3.7, we only support one version of the update language.
-    if (updateSemantics != static_cast<int>(UpdateSemantics::kUpdateNode)) {
+    // As of 3.7, we only support one version of the update language. Oplog entries may also carry
+    // a diff of the document instead of an update expression.
+    if (updateSemantics != static_cast<int>(UpdateSemantics::kUpdateNode) &&
+        updateSemantics != static_cast<int>(UpdateSemantics::kDelta)) {
         return {ErrorCodes::Error(40682),
                 str::stream() << "Unrecognized value for '$v' (UpdateSemantics) field: "
                               << updateSemantics};
@@ -178,7 +181,8 @@ void UpdateDriver::parse(
     // Some versions of mongod support more than one version of the update language and look for a
     // $v "UpdateSemantics" field when applying an oplog entry, in order to know which version of
     // the update language to apply with. We currently only support the 'kUpdateNode' version, but
-    // we parse $v and check its value for compatibility.
+    // we parse $v and check its value for compatibility. A 'kDelta' entry holds a diff rather than
+    // an update expression.
     auto updateExpr = updateMod.getUpdateClassic();
     BSONElement updateSemanticsElement = updateExpr[LogBuilder::kUpdateSemanticsFieldName];
     if (updateSemanticsElement) {
@@ -186,12 +190,32 @@ void UpdateDriver::parse(
                 "The $v update field is only recognized internally",
                 _fromOplogApplication);
 
-        uassertStatusOK(updateSemanticsFromElement(updateSemanticsElement));
+        auto updateSemantics = uassertStatusOK(updateSemanticsFromElement(updateSemanticsElement));
+        if (updateSemantics == UpdateSemantics::kDelta) {
+            uassert(ErrorCodes::FailedToParse,
+                    "arrayFilters may not be specified for delta-style updates",
+                    arrayFilters.empty());
+
+            auto diffElement = updateExpr[LogBuilder::kDeltaDiffFieldName];
+            uassert(ErrorCodes::FailedToParse,
+                    str::stream() << "A '$v: " << static_cast<int>(UpdateSemantics::kDelta)
+                                  << "' update must contain a '" << LogBuilder::kDeltaDiffFieldName
+                                  << "' object",
+                    diffElement.type() == BSONType::Object && updateExpr.nFields() == 2);
+
+            _updateExecutor = std::make_unique<DeltaExecutor>(diffElement.embeddedObject());
+            _updateType = UpdateType::kDelta;
+            return;
+        }
     }
 
     auto root = std::make_unique<UpdateObjectNode>();
     _positional = parseUpdateExpression(updateExpr, root.get(), _expCtx, arrayFilters);
     _updateExecutor = std::make_unique<UpdateTreeExecutor>(std::move(root));
+
+    if (!_positional && gEnableInPlaceUpdateFastPath.load()) {
+        _inPlaceUpdate = InPlaceUpdate::parse(updateExpr);
+    }
 }
 
 Status UpdateDriver::populateDocumentWithQueryFields(OperationContext* opCtx,
@@ -253,9 +277,9 @@ Status UpdateDriver::update(StringData matchedField,
                             FieldRefSetWithStorage* modifiedPaths) {
     // TODO: assert that update() is called at most once in a !_multi case.
 
-    _affectIndices =
-        ((_updateType == UpdateType::kReplacement || _updateType == UpdateType::kPipeline) &&
-         (_indexedFields != nullptr));
+    // Pipeline-style and delta-style updates report whether indexes are affected through the
+    // ApplyResult, since they may be applied as a diff which only touches unindexed fields.
+    _affectIndices = (_updateType == UpdateType::kReplacement && _indexedFields != nullptr);
 
     _logDoc.reset();
     LogBuilder logBuilder(_logDoc.root());
@@ -303,6 +327,27 @@ Status UpdateDriver::update(StringData matchedField,
     return Status::OK();
 }
 
+bool UpdateDriver::updateInPlace(const BSONObj& original,
+                                 const FieldRefSet& protectedPaths,
+                                 mutablebson::DamageVector* damages,
+                                 const char** damageSource,
+                                 BSONObj* logOpRec,
+                                 bool* docWasModified) {
+    if (!_inPlaceUpdate ||
+        !_inPlaceUpdate->apply(
+            original, protectedPaths, _indexedFields, damages, &_inPlaceLogEntry)) {
+        return false;
+    }
+
+    _affectIndices = false;
+    *damageSource = _inPlaceLogEntry.objdata();
+    *docWasModified = !damages->empty();
+    if (_logOp && logOpRec) {
+        *logOpRec = _inPlaceLogEntry;
+    }
+    return true;
+}
+
 void UpdateDriver::setCollator(const CollatorInterface* collator) {
     if (_updateExecutor) {
         _updateExecutor->setCollator(collator);
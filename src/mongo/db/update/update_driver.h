@@ -41,6 +41,8 @@
 #include "mongo/db/ops/write_ops_parsers.h"
 #include "mongo/db/pipeline/pipeline.h"
 #include "mongo/db/query/canonical_query.h"
+#include "mongo/db/update/delta_executor.h"
+#include "mongo/db/update/in_place_update.h"
 #include "mongo/db/update/modifier_table.h"
 #include "mongo/db/update/object_replace_executor.h"
 #include "mongo/db/update/pipeline_executor.h"
@@ -56,7 +58,7 @@ class OperationContext;
 
 class UpdateDriver {
 public:
-    enum class UpdateType { kOperator, kReplacement, kPipeline };
+    enum class UpdateType { kOperator, kReplacement, kPipeline, kDelta };
 
     UpdateDriver(const boost::intrusive_ptr<ExpressionContext>& expCtx);
 
@@ -124,6 +126,23 @@ public:
                   bool* docWasModified = nullptr,
                   FieldRefSetWithStorage* modifiedPaths = nullptr);
 
+    /**
+     * Applies the update to the existing document 'original' without building a mutable document,
+     * if it is an operator-style update that only overwrites fixed-width values (see
+     * InPlaceUpdate). Returns false if it is not, in which case the caller must use update().
+     *
+     * Otherwise returns true, sets 'docWasModified', and fills 'damages' and 'damageSource' with
+     * the changes to make to 'original'. 'damageSource' stays valid until the next call. If the
+     * driver's '_logOp' mode is turned on and 'logOpRec' is not null, fills the latter with the
+     * oplog entry for the update. No modified path conflicts with 'protectedPaths' or is indexed.
+     */
+    bool updateInPlace(const BSONObj& original,
+                       const FieldRefSet& protectedPaths,
+                       mutablebson::DamageVector* damages,
+                       const char** damageSource,
+                       BSONObj* logOpRec,
+                       bool* docWasModified);
+
     /**
      * Passes the visitor through to the root of the update tree. The visitor is responsible for
      * implementing methods that operate on the nodes of the tree.
@@ -212,6 +231,9 @@ private:
 
     std::unique_ptr<UpdateExecutor> _updateExecutor;
 
+    // Set for operator-style updates that might be applied without a mutable document.
+    boost::optional<InPlaceUpdate> _inPlaceUpdate;
+
     // What are the list of fields in the collection over which the update is going to be
     // applied that participate in indices?
     //
@@ -242,6 +264,10 @@ private:
 
     // The document used to build the oplog entry for the update.
     mutablebson::Document _logDoc;
+
+    // The oplog entry of the last update applied by updateInPlace(), which also holds the new
+    // values its damages are copied from.
+    BSONObj _inPlaceLogEntry;
 };
 
 }  // namespace mongo
@@ -30,6 +30,7 @@
 #include "mongo/db/update/update_driver.h"
 
 
+#include <cstring>
 #include <map>
 
 #include "mongo/base/owned_pointer_vector.h"
@@ -44,8 +45,10 @@
 #include "mongo/db/pipeline/expression_context_for_test.h"
 #include "mongo/db/query/collation/collator_interface_mock.h"
 #include "mongo/db/query/query_test_service_context.h"
+#include "mongo/db/update/update_server_parameters_gen.h"
 #include "mongo/db/update_index_data.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
 
 #define ASSERT_DOES_NOT_THROW(EXPRESSION)                                          \
     try {                                                                          \
@@ -170,6 +173,34 @@ TEST(Parse, SetOnInsert) {
     ASSERT_FALSE(driver.type() == UpdateDriver::UpdateType::kReplacement);
 }
 
+TEST(Parse, DeltaUpdateFromOplog) {
+    boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    UpdateDriver driver(expCtx);
+    driver.setFromOplogApplication(true);
+    std::map<StringData, std::unique_ptr<ExpressionWithPlaceholder>> arrayFilters;
+    ASSERT_DOES_NOT_THROW(driver.parse(fromjson("{$v: 2, diff: {u: {a: 1}}}"), arrayFilters));
+    ASSERT_TRUE(driver.type() == UpdateDriver::UpdateType::kDelta);
+}
+
+TEST(Parse, DeltaUpdateRequiresDiffObject) {
+    boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    UpdateDriver driver(expCtx);
+    driver.setFromOplogApplication(true);
+    std::map<StringData, std::unique_ptr<ExpressionWithPlaceholder>> arrayFilters;
+    ASSERT_THROWS_CODE(driver.parse(fromjson("{$v: 2, diff: 1}"), arrayFilters),
+                       AssertionException,
+                       ErrorCodes::FailedToParse);
+}
+
+TEST(Parse, DeltaUpdateIsOnlyRecognizedInternally) {
+    boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    UpdateDriver driver(expCtx);
+    std::map<StringData, std::unique_ptr<ExpressionWithPlaceholder>> arrayFilters;
+    ASSERT_THROWS_CODE(driver.parse(fromjson("{$v: 2, diff: {u: {a: 1}}}"), arrayFilters),
+                       AssertionException,
+                       ErrorCodes::FailedToParse);
+}
+
 TEST(Collator, SetCollationUpdatesModifierInterfaces) {
     boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
     CollatorInterfaceMock reverseStringCollator(CollatorInterfaceMock::MockType::kReverseString);
@@ -557,6 +588,74 @@ TEST_F(CreateFromQuery, NotFullShardKeyRepl) {
         driverRepl().populateDocumentWithQueryFields(opCtx(), query, immutablePaths, doc()));
 }
 
+TEST(UpdateInPlace, MatchesMutableDocumentUpdate) {
+    boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    std::map<StringData, std::unique_ptr<ExpressionWithPlaceholder>> arrayFilters;
+    const BSONObj updateExpr = fromjson("{$max: {b: 5}, $inc: {a: 1, 'c.d': 2.5}}");
+    const BSONObj original = fromjson("{_id: 0, a: 1, b: 2, c: {d: 1.0}}");
+    FieldRefSet immutablePaths;
+
+    UpdateDriver driver(expCtx);
+    driver.parse(updateExpr, arrayFilters);
+    driver.setLogOp(true);
+    mutablebson::DamageVector damages;
+    const char* source = nullptr;
+    BSONObj logObj;
+    bool docWasModified = false;
+    ASSERT_TRUE(driver.updateInPlace(
+        original, immutablePaths, &damages, &source, &logObj, &docWasModified));
+    ASSERT_TRUE(docWasModified);
+    ASSERT_FALSE(driver.modsAffectIndices());
+
+    std::string updated(original.objdata(), original.objsize());
+    for (auto&& damage : damages) {
+        std::memcpy(&updated[damage.targetOffset], source + damage.sourceOffset, damage.size);
+    }
+
+    UpdateDriver mutableDriver(expCtx);
+    mutableDriver.parse(updateExpr, arrayFilters);
+    mutableDriver.setLogOp(true);
+    mutablebson::Document doc(original);
+    BSONObj mutableLogObj;
+    ASSERT_OK(mutableDriver.update(
+        StringData(), &doc, false, immutablePaths, false, &mutableLogObj, &docWasModified));
+    ASSERT_BSONOBJ_EQ(BSONObj(updated.data()), doc.getObject());
+    ASSERT_TRUE(logObj.binaryEqual(mutableLogObj));
+}
+
+TEST(UpdateInPlace, DeclinesIndexedPaths) {
+    boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    std::map<StringData, std::unique_ptr<ExpressionWithPlaceholder>> arrayFilters;
+    UpdateIndexData indexData;
+    indexData.addPath(FieldRef("a"));
+    FieldRefSet immutablePaths;
+
+    UpdateDriver driver(expCtx);
+    driver.parse(fromjson("{$inc: {a: 1}}"), arrayFilters);
+    driver.refreshIndexKeys(&indexData);
+    mutablebson::DamageVector damages;
+    const char* source = nullptr;
+    bool docWasModified = false;
+    ASSERT_FALSE(driver.updateInPlace(
+        fromjson("{_id: 0, a: 1}"), immutablePaths, &damages, &source, nullptr, &docWasModified));
+}
+
+TEST(UpdateInPlace, CanBeDisabled) {
+    boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    std::map<StringData, std::unique_ptr<ExpressionWithPlaceholder>> arrayFilters;
+    FieldRefSet immutablePaths;
+
+    gEnableInPlaceUpdateFastPath.store(false);
+    ON_BLOCK_EXIT([] { gEnableInPlaceUpdateFastPath.store(true); });
+    UpdateDriver driver(expCtx);
+    driver.parse(fromjson("{$inc: {a: 1}}"), arrayFilters);
+    mutablebson::DamageVector damages;
+    const char* source = nullptr;
+    bool docWasModified = false;
+    ASSERT_FALSE(driver.updateInPlace(
+        fromjson("{_id: 0, a: 1}"), immutablePaths, &damages, &source, nullptr, &docWasModified));
+}
+
 class ModifiedPathsTestFixture : public mongo::unittest::Test {
 public:
     std::string getModifiedPaths(mutablebson::Document* doc,
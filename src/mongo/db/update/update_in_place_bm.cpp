@@ -0,0 +1,97 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/bson/mutable/document.h"
+#include "mongo/db/pipeline/expression_context_for_test.h"
+#include "mongo/db/update/update_driver.h"
+
+namespace mongo {
+namespace {
+
+// A document with a handful of counters among other fields, as kept by a page view tracker.
+BSONObj makeCounterDocument() {
+    BSONObjBuilder builder;
+    builder.append("_id", OID::gen());
+    builder.append("url", "https://www.example.com/some/fairly/long/path/to/a/page");
+    builder.append("title", "A page that gets a lot of views");
+    for (int i = 0; i < 16; ++i) {
+        builder.append("attr" + std::to_string(i), "value" + std::to_string(i));
+    }
+    builder.append("views", 100LL);
+    builder.append("stats", BSON("clicks" << 10 << "shares" << 1 << "ratio" << 0.1));
+    builder.appendDate("lastSeen", Date_t::fromMillisSinceEpoch(1000));
+    return builder.obj();
+}
+
+// The argument selects the update path: 0 applies the update to a mutable document and extracts
+// its damages, 1 computes the damages from the BSON directly.
+void BM_counterIncrement(benchmark::State& state) {
+    auto expCtx = make_intrusive<ExpressionContextForTest>();
+    std::map<StringData, std::unique_ptr<ExpressionWithPlaceholder>> arrayFilters;
+    UpdateDriver driver(expCtx);
+    driver.parse(BSON("$inc" << BSON("views" << 1 << "stats.clicks" << 1) << "$max"
+                             << BSON("lastSeen" << Date_t::fromMillisSinceEpoch(2000))),
+                 arrayFilters);
+    driver.setLogOp(true);
+
+    const BSONObj original = makeCounterDocument();
+    const FieldRefSet immutablePaths;
+    mutablebson::Document doc;
+    mutablebson::DamageVector damages;
+    const char* source = nullptr;
+    BSONObj logObj;
+    bool docWasModified = false;
+    const bool inPlace = state.range(0);
+
+    for (auto _ : state) {
+        benchmark::ClobberMemory();
+        if (inPlace) {
+            invariant(driver.updateInPlace(
+                original, immutablePaths, &damages, &source, &logObj, &docWasModified));
+        } else {
+            doc.reset(original, mutablebson::Document::kInPlaceEnabled);
+            uassertStatusOK(driver.update(
+                StringData(), &doc, true, immutablePaths, false, &logObj, &docWasModified));
+            invariant(doc.getInPlaceUpdates(&damages, &source));
+        }
+        benchmark::DoNotOptimize(damages.data());
+        benchmark::DoNotOptimize(logObj.objdata());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_counterIncrement)->Arg(0)->Arg(1);
+
+}  // namespace
+}  // namespace mongo
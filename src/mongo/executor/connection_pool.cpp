@@ -36,6 +36,8 @@
 
 #include "mongo/executor/connection_pool.h"
 
+#include <algorithm>
+#include <cmath>
 #include <fmt/format.h>
 
 #include "mongo/bson/bsonobjbuilder.h"
@@ -77,6 +79,27 @@ void emplaceOrInvariant(Map&& map, Args&&... args) noexcept {
     invariant(ret.second, "Element already existed in map/set");
 }
 
+/**
+ * An exponentially weighted moving average, for smoothing a pool's traffic measurements.
+ */
+class MovingAverage {
+public:
+    void add(double sample) {
+        _value = _hasSamples ? _value + kWeight * (sample - _value) : sample;
+        _hasSamples = true;
+    }
+
+    double get() const {
+        return _value;
+    }
+
+private:
+    static constexpr double kWeight = 0.2;
+
+    double _value = 0;
+    bool _hasSamples = false;
+};
+
 bool shouldInvariantOnPoolCorrectness() noexcept {
     return kDebugBuild;
 }
@@ -132,8 +155,37 @@ std::string ConnectionPool::ConnectionControls::toString() const {
 }
 
 std::string ConnectionPool::HostState::toString() const {
-    return "{{ requests: {}, ready: {}, pending: {}, active: {}, isExpired: {} }}"_format(
-        requests, ready, pending, active, health.isExpired);
+    return "{{ requests: {}, ready: {}, pending: {}, active: {}, isExpired: {}, "
+           "requestsPerSecond: {}, requestWait: {}, connectionSetup: {}, checkoutDuration: {} }}"_format(
+               requests,
+               ready,
+               pending,
+               active,
+               health.isExpired,
+               requestsPerSecond,
+               requestWait,
+               connectionSetup,
+               checkoutDuration);
+}
+
+size_t ConnectionPool::adaptiveTargetConnections(const HostState& state,
+                                                 size_t minConnections,
+                                                 size_t maxConnections) {
+    // Spare capacity over the average demand, to cover its variance.
+    constexpr double kHeadroom = 1.5;
+
+    const double holdSeconds = durationCount<Microseconds>(state.checkoutDuration) / 1e6;
+    auto target = static_cast<size_t>(std::ceil(state.requestsPerSecond * holdSeconds * kHeadroom));
+
+    target = std::max(target, state.active);
+    if (state.requests > 0) {
+        // Always make progress on a queue, even before there is any traffic history.
+        const auto queued =
+            (state.requestWait >= state.connectionSetup) ? state.requests : size_t(1);
+        target = std::max(target, state.active + queued);
+    }
+
+    return std::clamp(target, minConnections, maxConnections);
 }
 
 /**
@@ -210,6 +262,72 @@ auto ConnectionPool::makeLimitController() noexcept -> std::shared_ptr<Controlle
     return std::make_shared<LimitController>();
 }
 
+/**
+ * Controller for the ConnectionPool that sizes each host's pool from its measured traffic
+ *
+ * This class uses adaptiveTargetConnections() within the Options in the ConnectionPool.
+ */
+class ConnectionPool::AdaptiveController final : public ConnectionPool::ControllerInterface {
+public:
+    void addHost(PoolId id, const HostAndPort& host) override {
+        stdx::lock_guard lk(_mutex);
+        PoolData poolData;
+        poolData.host = host;
+
+        emplaceOrInvariant(_poolData, id, std::move(poolData));
+    }
+    HostGroupState updateHost(PoolId id, const HostState& stats) override {
+        stdx::lock_guard lk(_mutex);
+        auto& data = getOrInvariant(_poolData, id);
+
+        data.target = adaptiveTargetConnections(
+            stats, getPool()->_options.minConnections, getPool()->_options.maxConnections);
+
+        return {{data.host}, stats.health.isExpired};
+    }
+    void removeHost(PoolId id) override {
+        stdx::lock_guard lk(_mutex);
+        invariant(_poolData.erase(id));
+    }
+
+    ConnectionControls getControls(PoolId id) override {
+        stdx::lock_guard lk(_mutex);
+        const auto& data = getOrInvariant(_poolData, id);
+
+        return {
+            getPool()->_options.maxConnecting,
+            data.target,
+        };
+    }
+
+    Milliseconds hostTimeout() const override {
+        return getPool()->_options.hostTimeout;
+    }
+    Milliseconds pendingTimeout() const override {
+        return getPool()->_options.refreshTimeout;
+    }
+    Milliseconds toRefreshTimeout() const override {
+        return getPool()->_options.refreshRequirement;
+    }
+
+    StringData name() const override {
+        return "AdaptiveController"_sd;
+    }
+
+private:
+    struct PoolData {
+        HostAndPort host;
+        size_t target = 0;
+    };
+
+    Mutex _mutex = MONGO_MAKE_LATCH(HierarchicalAcquisitionLevel(0), "AdaptiveController::_mutex");
+    stdx::unordered_map<PoolId, PoolData> _poolData;
+};
+
+auto ConnectionPool::makeAdaptiveController() noexcept -> std::shared_ptr<ControllerInterface> {
+    return std::make_shared<AdaptiveController>();
+}
+
 /**
  * A pool for a specific HostAndPort
  *
@@ -324,6 +442,20 @@ public:
         return _hostAndPort;
     }
 
+    /**
+     * Returns the id the controller knows this pool by.
+     */
+    PoolId id() const {
+        return _id;
+    }
+
+    /**
+     * Returns how long requests have waited for connections from this pool.
+     */
+    const ConnectionWaitTimeHistogram& waitTimes() const {
+        return _waitTimes;
+    }
+
     /**
      * Return true if the tags on the specific pool match the passed in tags
      */
@@ -349,15 +481,30 @@ private:
     using OwnedConnection = std::shared_ptr<ConnectionInterface>;
     using OwnershipPool = stdx::unordered_map<ConnectionInterface*, OwnedConnection>;
     using LRUOwnershipPool = LRUCache<OwnershipPool::key_type, OwnershipPool::mapped_type>;
-    using Request = std::pair<Date_t, Promise<ConnectionHandle>>;
+    struct Request {
+        Date_t expiration;
+        Date_t requestedAt;
+        Promise<ConnectionHandle> promise;
+    };
     struct RequestComparator {
         bool operator()(const Request& a, const Request& b) {
-            return a.first > b.first;
+            return a.expiration > b.expiration;
         }
     };
 
     ConnectionHandle makeHandle(ConnectionInterface* connection);
 
+    /**
+     * Records that a request which arrived at 'requestedAt' has been handed a connection.
+     */
+    void recordRequestServed(Date_t requestedAt, Date_t now);
+
+    /**
+     * Folds the requests seen since the last call into the request rate, once enough time has
+     * passed for the rate to be meaningful.
+     */
+    void updateRequestRate(Date_t now);
+
     /**
      * Establishes connections until the ControllerInterface's target is met.
      */
@@ -426,6 +573,16 @@ private:
     transport::Session::TagMask _tags = transport::Session::kPending;
 
     HostHealth _health;
+
+    // Measurements of this host's traffic, reported to the controller in HostState.
+    MovingAverage _requestRate;
+    MovingAverage _requestWaitMicros;
+    MovingAverage _connectionSetupMicros;
+    MovingAverage _checkoutDurationMicros;
+    size_t _requestsSinceRateUpdate = 0;
+    Date_t _rateWindowStart;
+
+    ConnectionWaitTimeHistogram _waitTimes;
 };
 
 auto ConnectionPool::SpecificPool::make(std::shared_ptr<ConnectionPool> parent,
@@ -573,6 +730,8 @@ void ConnectionPool::appendConnectionStats(ConnectionPoolStats* stats) const {
                                      pool->availableConnections(),
                                      pool->createdConnections(),
                                      pool->refreshingConnections()};
+        hostStats.targetSize = _controller->getControls(pool->id()).targetConnections;
+        hostStats.acquisitionWaitTimes = pool->waitTimes();
         stats->updateStatsForHost(_name, host, hostStats);
     }
 }
@@ -597,6 +756,7 @@ ConnectionPool::SpecificPool::SpecificPool(std::shared_ptr<ConnectionPool> paren
       _readyPool(std::numeric_limits<size_t>::max()) {
     invariant(_parent);
     _eventTimer = _parent->_factory->makeTimer();
+    _rateWindowStart = _parent->_factory->now();
 }
 
 ConnectionPool::SpecificPool::~SpecificPool() {
@@ -638,12 +798,14 @@ Future<ConnectionPool::ConnectionHandle> ConnectionPool::SpecificPool::getConnec
     // Reset our activity timestamp
     auto now = _parent->_factory->now();
     _lastActiveTime = now;
+    ++_requestsSinceRateUpdate;
 
     // If we do not have requests, then we can fulfill immediately
     if (_requests.size() == 0) {
         auto conn = tryGetConnection();
 
         if (conn) {
+            recordRequestServed(now, now);
             LOGV2_DEBUG(22559,
                         kDiagnosticLogLevel,
                         "Using existing idle connection to {hostAndPort}",
@@ -667,17 +829,38 @@ Future<ConnectionPool::ConnectionHandle> ConnectionPool::SpecificPool::getConnec
     const auto expiration = now + timeout;
     auto pf = makePromiseFuture<ConnectionHandle>();
 
-    _requests.push_back(make_pair(expiration, std::move(pf.promise)));
+    _requests.push_back({expiration, now, std::move(pf.promise)});
     std::push_heap(begin(_requests), end(_requests), RequestComparator{});
 
     return std::move(pf.future);
 }
 
+void ConnectionPool::SpecificPool::recordRequestServed(Date_t requestedAt, Date_t now) {
+    const auto waitTime = now - requestedAt;
+    _requestWaitMicros.add(durationCount<Microseconds>(waitTime));
+    _waitTimes.record(waitTime);
+}
+
+void ConnectionPool::SpecificPool::updateRequestRate(Date_t now) {
+    constexpr auto kMinRateWindow = Milliseconds(100);
+
+    const auto elapsed = now - _rateWindowStart;
+    if (elapsed < kMinRateWindow) {
+        return;
+    }
+
+    _requestRate.add(_requestsSinceRateUpdate * 1000.0 / durationCount<Milliseconds>(elapsed));
+    _requestsSinceRateUpdate = 0;
+    _rateWindowStart = now;
+}
+
 auto ConnectionPool::SpecificPool::makeHandle(ConnectionInterface* connection) -> ConnectionHandle {
-    auto deleter = [this, anchor = shared_from_this()](ConnectionInterface* connection) {
+    auto deleter = [this, anchor = shared_from_this(), checkedOutAt = _parent->_factory->now()](
+                       ConnectionInterface* connection) {
         stdx::lock_guard lk(_parent->_mutex);
-        returnConnection(connection);
         _lastActiveTime = _parent->_factory->now();
+        _checkoutDurationMicros.add(durationCount<Microseconds>(_lastActiveTime - checkedOutAt));
+        returnConnection(connection);
         updateState();
     };
     return ConnectionHandle(connection, std::move(deleter));
@@ -944,7 +1127,7 @@ void ConnectionPool::SpecificPool::processFailure(const Status& status) {
     }
 
     for (auto& request : _requests) {
-        request.second.setError(status);
+        request.promise.setError(status);
     }
 
     LOGV2_DEBUG(22573,
@@ -973,7 +1156,8 @@ void ConnectionPool::SpecificPool::fulfillRequests() {
         }
 
         // Grab the request and callback
-        auto promise = std::move(_requests.front().second);
+        auto promise = std::move(_requests.front().promise);
+        recordRequestServed(_requests.front().requestedAt, _lastActiveTime);
         std::pop_heap(begin(_requests), end(_requests), RequestComparator{});
         _requests.pop_back();
 
@@ -1047,7 +1231,12 @@ void ConnectionPool::SpecificPool::spawnConnections() {
 
         // Run the setup callback
         handle->setup(_parent->_controller->pendingTimeout(),
-                      guardCallback([this](auto conn, auto status) {
+                      guardCallback([this, startedAt = _parent->_factory->now()](auto conn,
+                                                                                 auto status) {
+                          if (status.isOK()) {
+                              _connectionSetupMicros.add(durationCount<Microseconds>(
+                                  _parent->_factory->now() - startedAt));
+                          }
                           finishRefresh(std::move(conn), std::move(status));
                       }));
     }
@@ -1105,8 +1294,8 @@ void ConnectionPool::SpecificPool::updateEventTimer() {
     }
 
     // If a request would timeout before the next event, then it is the next event
-    if (_requests.size() && (_requests.front().first < nextEventTime)) {
-        nextEventTime = _requests.front().first;
+    if (_requests.size() && (_requests.front().expiration < nextEventTime)) {
+        nextEventTime = _requests.front().expiration;
     }
 
     // If our timer is already set to the next event, then we're done
@@ -1126,11 +1315,11 @@ void ConnectionPool::SpecificPool::updateEventTimer() {
 
         _health.isFailed = false;
 
-        while (_requests.size() && (_requests.front().first <= now)) {
+        while (_requests.size() && (_requests.front().expiration <= now)) {
             std::pop_heap(begin(_requests), end(_requests), RequestComparator{});
 
             auto& request = _requests.back();
-            request.second.setError(Status(
+            request.promise.setError(Status(
                 ErrorCodes::NetworkInterfaceExceededTimeLimit,
                 fmt::format("Couldn't get a connection within the time limit of {}", timeout)));
             _requests.pop_back();
@@ -1150,6 +1339,8 @@ void ConnectionPool::SpecificPool::updateController() {
     auto& controller = *_parent->_controller;
 
     // Update our own state
+    auto now = _parent->_factory->now();
+    updateRequestRate(now);
     HostState state{
         _health,
         requestsPending(),
@@ -1157,6 +1348,13 @@ void ConnectionPool::SpecificPool::updateController() {
         availableConnections(),
         inUseConnections(),
     };
+    state.requestsPerSecond = _requestRate.get();
+    state.requestWait = Microseconds(static_cast<int64_t>(_requestWaitMicros.get()));
+    for (const auto& request : _requests) {
+        state.requestWait = std::max(state.requestWait, Microseconds(now - request.requestedAt));
+    }
+    state.connectionSetup = Microseconds(static_cast<int64_t>(_connectionSetupMicros.get()));
+    state.checkoutDuration = Microseconds(static_cast<int64_t>(_checkoutDurationMicros.get()));
     LOGV2_DEBUG(22578,
                 kDiagnosticLogLevel,
                 "Updating pool controller for {hostAndPort} with state: {poolState}",
@@ -65,6 +65,7 @@ struct ConnectionPoolStats;
  */
 class ConnectionPool : public EgressTagCloser, public std::enable_shared_from_this<ConnectionPool> {
     class LimitController;
+    class AdaptiveController;
 
 public:
     class SpecificPool;
@@ -96,6 +97,12 @@ public:
      */
     static std::shared_ptr<ControllerInterface> makeLimitController() noexcept;
 
+    /**
+     * Make a controller which sizes each host's pool from its measured traffic, within the
+     * Options' minConnections and maxConnections. See adaptiveTargetConnections().
+     */
+    static std::shared_ptr<ControllerInterface> makeAdaptiveController() noexcept;
+
     struct Options {
         Options() {}
 
@@ -150,6 +157,15 @@ public:
          */
         bool skipAuthentication = false;
 
+        /**
+         * The most requests that may be in flight at once on one connection. Above one,
+         * connections ask the remote host to accept multiplexed requests, and the
+         * NetworkInterfaceTL shares a connection to each host that agrees among that many
+         * concurrent requests. Such connections can not run exhaust commands. Connections that
+         * use TLS never multiplex requests.
+         */
+        size_t maxMultiplexedRequests = 1;
+
         std::function<std::shared_ptr<ControllerInterface>(void)> controllerFactory =
             &ConnectionPool::makeLimitController;
     };
@@ -201,9 +217,35 @@ public:
         size_t ready = 0;
         size_t active = 0;
 
+        // Moving averages of the host's recent traffic, for controllers that size pools from
+        // demand rather than from fixed limits.
+        double requestsPerSecond = 0;
+        // How long a request waited for a connection, including requests served immediately, or
+        // how long the oldest queued request has waited if that is longer.
+        Microseconds requestWait{0};
+        // How long it took to establish a new connection.
+        Microseconds connectionSetup{0};
+        // How long a connection stayed checked out, i.e. the host's response time.
+        Microseconds checkoutDuration{0};
+
         std::string toString() const;
     };
 
+    /**
+     * Returns the number of connections to target for a host in the given state, between
+     * minConnections and maxConnections.
+     *
+     * By Little's law, the number of connections busy on average is the rate of requests times
+     * how long each is held, so the target is that with some headroom; the idle connections this
+     * keeps open are warm when traffic rises. Connections in use now are always kept. Queued
+     * requests get one more connection at a time until they have been waiting longer than it
+     * takes to open one, so a spike is absorbed by connections that are about to be returned
+     * instead of by a burst of new ones whose handshakes load the host further.
+     */
+    static size_t adaptiveTargetConnections(const HostState& state,
+                                            size_t minConnections,
+                                            size_t maxConnections);
+
     /**
      * A simple set of controls to direct a single host
      *
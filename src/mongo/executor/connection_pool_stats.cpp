@@ -31,11 +31,54 @@
 
 #include "mongo/executor/connection_pool_stats.h"
 
+#include <algorithm>
+
 #include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/util/map_util.h"
+#include "mongo/util/str.h"
 
 namespace mongo {
 namespace executor {
+namespace {
+
+void appendSizingStats(const ConnectionStatsPer& stats, BSONObjBuilder* builder) {
+    builder->appendNumber("targetSize", stats.targetSize);
+    builder->appendNumber("currentSize", stats.inUse + stats.available + stats.refreshing);
+    BSONObjBuilder waitTimes(builder->subobjStart("acquisitionWaitTimesMillis"));
+    stats.acquisitionWaitTimes.appendToBSON(&waitTimes);
+}
+
+}  // namespace
+
+constexpr std::array<int64_t, 10> ConnectionWaitTimeHistogram::kBucketBoundsMillis;
+
+void ConnectionWaitTimeHistogram::record(Milliseconds waitTime) {
+    const auto millis = durationCount<Milliseconds>(waitTime);
+    const auto bucket = std::upper_bound(kBucketBoundsMillis.begin(),
+                                         kBucketBoundsMillis.end(),
+                                         millis) -
+        kBucketBoundsMillis.begin();
+    ++counts[bucket];
+}
+
+ConnectionWaitTimeHistogram& ConnectionWaitTimeHistogram::operator+=(
+    const ConnectionWaitTimeHistogram& other) {
+    for (size_t i = 0; i < counts.size(); ++i) {
+        counts[i] += other.counts[i];
+    }
+    return *this;
+}
+
+void ConnectionWaitTimeHistogram::appendToBSON(BSONObjBuilder* builder) const {
+    int64_t lowerBound = 0;
+    for (size_t i = 0; i < kBucketBoundsMillis.size(); ++i) {
+        const std::string bucketName = str::stream() << lowerBound << "-" << kBucketBoundsMillis[i];
+        builder->appendNumber(bucketName, static_cast<long long>(counts[i]));
+        lowerBound = kBucketBoundsMillis[i];
+    }
+    const std::string lastBucketName = str::stream() << lowerBound << "+";
+    builder->appendNumber(lastBucketName, static_cast<long long>(counts.back()));
+}
 
 ConnectionStatsPer::ConnectionStatsPer(size_t nInUse,
                                        size_t nAvailable,
@@ -50,6 +93,8 @@ ConnectionStatsPer& ConnectionStatsPer::operator+=(const ConnectionStatsPer& oth
     available += other.available;
     created += other.created;
     refreshing += other.refreshing;
+    targetSize += other.targetSize;
+    acquisitionWaitTimes += other.acquisitionWaitTimes;
 
     return *this;
 }
@@ -115,6 +160,7 @@ void ConnectionPoolStats::appendToBSON(mongo::BSONObjBuilder& result, bool forFT
                 hostInfo.appendNumber("available", hostStats.available);
                 hostInfo.appendNumber("created", hostStats.created);
                 hostInfo.appendNumber("refreshing", hostStats.refreshing);
+                appendSizingStats(hostStats, &hostInfo);
             }
         }
     }
@@ -127,6 +173,7 @@ void ConnectionPoolStats::appendToBSON(mongo::BSONObjBuilder& result, bool forFT
             hostInfo.appendNumber("available", hostStats.available);
             hostInfo.appendNumber("created", hostStats.created);
             hostInfo.appendNumber("refreshing", hostStats.refreshing);
+            appendSizingStats(hostStats, &hostInfo);
         }
     }
 }
@@ -29,12 +29,39 @@
 
 #pragma once
 
+#include <array>
+#include <cstdint>
+
 #include "mongo/stdx/unordered_map.h"
+#include "mongo/util/duration.h"
 #include "mongo/util/net/hostandport.h"
 
 namespace mongo {
+
+class BSONObjBuilder;
+
 namespace executor {
 
+/**
+ * Counts how long requests waited to be handed a connection, in buckets bounded by
+ * kBucketBoundsMillis. The last bucket holds every wait of at least the largest bound.
+ */
+struct ConnectionWaitTimeHistogram {
+    static constexpr std::array<int64_t, 10> kBucketBoundsMillis{
+        1, 2, 5, 10, 20, 50, 100, 200, 500, 1000};
+
+    void record(Milliseconds waitTime);
+
+    ConnectionWaitTimeHistogram& operator+=(const ConnectionWaitTimeHistogram& other);
+
+    /**
+     * Appends one field per bucket, named for its range in milliseconds (e.g. "5-10", "1000+").
+     */
+    void appendToBSON(BSONObjBuilder* builder) const;
+
+    std::array<uint64_t, kBucketBoundsMillis.size() + 1> counts{};
+};
+
 /**
  * Holds connection information for a specific pool or remote host. These objects are maintained by
  * a parent ConnectionPoolStats object and should not need to be created directly.
@@ -50,6 +77,10 @@ struct ConnectionStatsPer {
     size_t available = 0u;
     size_t created = 0u;
     size_t refreshing = 0u;
+
+    // The number of connections the pool's controller currently wants open.
+    size_t targetSize = 0u;
+    ConnectionWaitTimeHistogram acquisitionWaitTimes;
 };
 
 /**
@@ -41,6 +41,7 @@
 #include <fmt/ostream.h>
 
 #include "mongo/executor/connection_pool.h"
+#include "mongo/executor/connection_pool_stats.h"
 #include "mongo/stdx/future.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/scopeguard.h"
@@ -1532,6 +1533,97 @@ TEST_F(ConnectionPoolTest, ReturnAfterShutdown) {
     pool->shutdown();
 }
 
+TEST(AdaptiveTargetConnectionsTest, FollowsRateTimesCheckoutDuration) {
+    ConnectionPool::HostState state;
+    state.requestsPerSecond = 1000;
+    state.checkoutDuration = Milliseconds(10);
+
+    // 1000/s held for 10ms keeps 10 connections busy, plus headroom.
+    ASSERT_EQ(ConnectionPool::adaptiveTargetConnections(state, 0, 100), 15u);
+
+    // Limits still apply.
+    ASSERT_EQ(ConnectionPool::adaptiveTargetConnections(state, 0, 8), 8u);
+    state.requestsPerSecond = 0;
+    ASSERT_EQ(ConnectionPool::adaptiveTargetConnections(state, 4, 100), 4u);
+}
+
+TEST(AdaptiveTargetConnectionsTest, KeepsActiveConnections) {
+    ConnectionPool::HostState state;
+    state.active = 12;
+
+    ASSERT_EQ(ConnectionPool::adaptiveTargetConnections(state, 0, 100), 12u);
+}
+
+TEST(AdaptiveTargetConnectionsTest, QueuedRequestsGrowPoolOnceWaitExceedsSetup) {
+    ConnectionPool::HostState state;
+    state.active = 4;
+    state.requests = 10;
+    state.connectionSetup = Milliseconds(50);
+
+    // Requests that have not waited as long as a new connection would take only get one more.
+    state.requestWait = Milliseconds(5);
+    ASSERT_EQ(ConnectionPool::adaptiveTargetConnections(state, 0, 100), 5u);
+
+    state.requestWait = Milliseconds(50);
+    ASSERT_EQ(ConnectionPool::adaptiveTargetConnections(state, 0, 100), 14u);
+
+    // Without a measured setup time, every queued request gets a connection.
+    state.connectionSetup = Microseconds(0);
+    state.requestWait = Microseconds(0);
+    ASSERT_EQ(ConnectionPool::adaptiveTargetConnections(state, 0, 100), 14u);
+}
+
+/**
+ * Verify that the pool reports how long requests waited and the size its controller targets.
+ */
+TEST_F(ConnectionPoolTest, ReportsWaitTimesAndTargetSize) {
+    ConnectionPool::Options options;
+    options.controllerFactory = &ConnectionPool::makeAdaptiveController;
+    auto pool = makePool(options);
+
+    auto now = Date_t::now();
+    PoolImpl::setNow(now);
+
+    // The first request waits for its connection to be set up.
+    auto connFuture = getFromPool(HostAndPort(), transport::kGlobalSSLMode, Seconds(1));
+    PoolImpl::setNow(now + Milliseconds(30));
+    ConnectionImpl::pushSetup(Status::OK());
+    auto conn = std::move(connFuture).get();
+
+    {
+        ConnectionPoolStats stats;
+        pool->appendConnectionStats(&stats);
+        const auto& hostStats = stats.statsByHost[HostAndPort()];
+        ASSERT_EQ(hostStats.inUse, 1u);
+        ASSERT_EQ(hostStats.targetSize, 1u);
+        // The 30ms wait falls in the 20-50ms bucket.
+        ASSERT_EQ(hostStats.acquisitionWaitTimes.counts[5], 1u);
+    }
+
+    doneWith(conn);
+
+    // The second request is handed the now idle connection without waiting.
+    auto conn2 = std::move(getFromPool(HostAndPort(), transport::kGlobalSSLMode, Seconds(1))).get();
+
+    {
+        ConnectionPoolStats stats;
+        pool->appendConnectionStats(&stats);
+        const auto& hostStats = stats.statsByHost[HostAndPort()];
+        ASSERT_EQ(hostStats.acquisitionWaitTimes.counts[0], 1u);
+        ASSERT_EQ(hostStats.acquisitionWaitTimes.counts[5], 1u);
+
+        BSONObjBuilder bob;
+        stats.appendToBSON(bob);
+        const auto host = bob.obj()["hosts"].Obj()[HostAndPort().toString()].Obj();
+        ASSERT_EQ(host["targetSize"].numberLong(), 1);
+        ASSERT_EQ(host["currentSize"].numberLong(), 1);
+        ASSERT_EQ(host["acquisitionWaitTimesMillis"]["0-1"].numberLong(), 1);
+        ASSERT_EQ(host["acquisitionWaitTimesMillis"]["20-50"].numberLong(), 1);
+    }
+
+    doneWith(conn2);
+}
+
 }  // namespace connection_pool_test_details
 }  // namespace executor
 }  // namespace mongo
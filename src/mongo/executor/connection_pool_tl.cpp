@@ -36,6 +36,7 @@
 #include "mongo/client/authenticate.h"
 #include "mongo/db/auth/authorization_manager.h"
 #include "mongo/logv2/log.h"
+#include "mongo/util/net/ssl_options.h"
 
 namespace mongo {
 namespace executor {
@@ -261,7 +262,8 @@ void TLConnection::setup(Milliseconds timeout, SetupCallback cb) {
         })
         .then([this, isMasterHook](AsyncDBClient::Handle client) {
             _client = std::move(client);
-            return _client->initWireVersion("NetworkInterfaceTL", isMasterHook.get());
+            return _client->initWireVersion(
+                "NetworkInterfaceTL", isMasterHook.get(), _requestMultiplexing);
         })
         .then([this, isMasterHook]() -> Future<bool> {
             if (_skipAuth) {
@@ -369,6 +371,21 @@ void TLConnection::cancelAsync() {
         _client->cancel();
 }
 
+bool connectsWithTLS(transport::ConnectSSLMode sslMode) {
+#ifdef MONGO_CONFIG_SSL
+    if (sslMode != transport::kGlobalSSLMode) {
+        return sslMode == transport::kEnableSSL;
+    }
+
+    // Mirrors the choice that TransportLayerASIO::asyncConnect() makes.
+    const auto globalSSLMode = getSSLGlobalParams().sslMode.load();
+    return globalSSLMode == SSLParams::SSLMode_preferSSL ||
+        globalSSLMode == SSLParams::SSLMode_requireSSL;
+#else
+    return false;
+#endif
+}
+
 auto TLTypeFactory::reactor() {
     return checked_pointer_cast<transport::Reactor>(_executor);
 }
@@ -382,7 +399,9 @@ std::shared_ptr<ConnectionPool::ConnectionInterface> TLTypeFactory::makeConnecti
                                                sslMode,
                                                generation,
                                                _onConnectHook.get(),
-                                               _connPoolOptions.skipAuthentication);
+                                               _connPoolOptions.skipAuthentication,
+                                               _connPoolOptions.maxMultiplexedRequests > 1 &&
+                                                   !connectsWithTLS(sslMode));
     fasten(conn.get());
     return conn;
 }
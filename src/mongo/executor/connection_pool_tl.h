@@ -140,13 +140,15 @@ public:
                  transport::ConnectSSLMode sslMode,
                  size_t generation,
                  NetworkConnectionHook* onConnectHook,
-                 bool skipAuth)
+                 bool skipAuth,
+                 bool requestMultiplexing)
         : ConnectionInterface(generation),
           TLTypeFactory::Type(factory),
           _reactor(reactor),
           _serviceContext(serviceContext),
           _timer(factory->makeTimer()),
           _skipAuth(skipAuth),
+          _requestMultiplexing(requestMultiplexing),
           _peer(std::move(peer)),
           _sslMode(sslMode),
           _onConnectHook(onConnectHook) {}
@@ -177,6 +179,7 @@ private:
     ServiceContext* const _serviceContext;
     std::shared_ptr<ConnectionPool::TimerInterface> _timer;
     const bool _skipAuth;
+    const bool _requestMultiplexing;
 
     HostAndPort _peer;
     transport::ConnectSSLMode _sslMode;
@@ -184,6 +187,11 @@ private:
     AsyncDBClient::Handle _client;
 };
 
+/**
+ * Whether connections made with 'sslMode' use TLS. Such connections never multiplex requests.
+ */
+bool connectsWithTLS(transport::ConnectSSLMode sslMode);
+
 }  // namespace connection_pool_tl
 }  // namespace executor
 }  // namespace mongo
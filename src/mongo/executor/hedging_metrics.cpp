@@ -29,10 +29,23 @@
 
 #include "mongo/executor/hedging_metrics.h"
 
+#include <algorithm>
+
+#include "mongo/bson/bsonobjbuilder.h"
+
 namespace mongo {
 
 namespace {
 const auto HedgingMetricsDecoration = ServiceContext::declareDecoration<HedgingMetrics>();
+
+size_t latencyBucket(Milliseconds latency) {
+    size_t bucket = 0;
+    for (auto millis = latency.count(); millis > 0; millis >>= 1) {
+        ++bucket;
+    }
+    return std::min(bucket, HedgingMetrics::kNumLatencyBuckets - 1);
+}
+
 }  // namespace
 
 HedgingMetrics* HedgingMetrics::get(ServiceContext* service) {
@@ -67,12 +80,93 @@ void HedgingMetrics::incrementNumAdvantageouslyHedgedOperations() {
     _numAdvantageouslyHedgedOperations.fetchAndAdd(1);
 }
 
+long long HedgingMetrics::getNumDelayedHedgesNotSent() const {
+    return _numDelayedHedgesNotSent.load();
+}
+
+void HedgingMetrics::incrementNumDelayedHedgesNotSent() {
+    _numDelayedHedgesNotSent.fetchAndAdd(1);
+}
+
+void HedgingMetrics::recordLatency(const HostAndPort& host, Milliseconds latency) {
+    const auto bucket = latencyBucket(latency);
+
+    stdx::lock_guard<Latch> lk(_latencyMutex);
+    auto it = _latencies.find(host);
+    if (it == _latencies.end()) {
+        if (_latencies.size() >= kMaxTrackedHosts) {
+            _latencies.erase(std::min_element(
+                _latencies.begin(), _latencies.end(), [](const auto& lhs, const auto& rhs) {
+                    return lhs.second.lastRecorded < rhs.second.lastRecorded;
+                }));
+        }
+        it = _latencies.emplace(host, LatencyHistogram{}).first;
+    }
+
+    auto& histogram = it->second;
+    histogram.lastRecorded = ++_numLatenciesRecorded;
+    if (histogram.count >= kMaxLatencySamples) {
+        histogram.count = 0;
+        for (auto& bucketCount : histogram.buckets) {
+            bucketCount /= 2;
+            histogram.count += bucketCount;
+        }
+    }
+    ++histogram.buckets[bucket];
+    ++histogram.count;
+}
+
+boost::optional<Milliseconds> HedgingMetrics::getLatencyPercentile(const HostAndPort& host,
+                                                                   int percentile) const {
+    stdx::lock_guard<Latch> lk(_latencyMutex);
+    auto it = _latencies.find(host);
+    if (it == _latencies.end() || it->second.count < kMinLatencySamples) {
+        return boost::none;
+    }
+
+    const auto& histogram = it->second;
+    const auto rank = (histogram.count * percentile + 99) / 100;
+    long long seen = 0;
+    for (size_t bucket = 0; bucket < kNumLatencyBuckets - 1; ++bucket) {
+        seen += histogram.buckets[bucket];
+        if (seen >= rank) {
+            return Milliseconds(1LL << bucket);
+        }
+    }
+    return Milliseconds(1LL << (kNumLatencyBuckets - 2));
+}
+
 BSONObj HedgingMetrics::toBSON() const {
     BSONObjBuilder builder;
 
+    const auto numTotalHedgedOperations = _numTotalHedgedOperations.load();
+    const auto numAdvantageouslyHedgedOperations = _numAdvantageouslyHedgedOperations.load();
     builder.append("numTotalOperations", _numTotalOperations.load());
-    builder.append("numTotalHedgedOperations", _numTotalHedgedOperations.load());
-    builder.append("numAdvantageouslyHedgedOperations", _numAdvantageouslyHedgedOperations.load());
+    builder.append("numTotalHedgedOperations", numTotalHedgedOperations);
+    builder.append("numAdvantageouslyHedgedOperations", numAdvantageouslyHedgedOperations);
+    builder.append("numDelayedHedgesNotSent", _numDelayedHedgesNotSent.load());
+    builder.append("hedgeWinRate",
+                   numTotalHedgedOperations
+                       ? double(numAdvantageouslyHedgedOperations) / numTotalHedgedOperations
+                       : 0.0);
+
+    BSONObjBuilder hostsBuilder(builder.subobjStart("hostLatencies"));
+    stdx::lock_guard<Latch> lk(_latencyMutex);
+    for (const auto& [host, histogram] : _latencies) {
+        BSONObjBuilder hostBuilder(hostsBuilder.subobjStart(host.toString()));
+        hostBuilder.append("count", histogram.count);
+
+        BSONArrayBuilder histogramBuilder(hostBuilder.subarrayStart("histogram"));
+        for (size_t bucket = 0; bucket < kNumLatencyBuckets; ++bucket) {
+            if (!histogram.buckets[bucket]) {
+                continue;
+            }
+            BSONObjBuilder entryBuilder(histogramBuilder.subobjStart());
+            entryBuilder.append("millis", bucket ? 1LL << (bucket - 1) : 0LL);
+            entryBuilder.append("count", histogram.buckets[bucket]);
+        }
+    }
+    hostsBuilder.doneFast();
 
     return builder.obj();
 }
@@ -29,8 +29,15 @@
 
 #pragma once
 
+#include <array>
+#include <boost/optional.hpp>
+#include <map>
+
 #include "mongo/db/operation_context.h"
 #include "mongo/db/service_context.h"
+#include "mongo/platform/mutex.h"
+#include "mongo/util/duration.h"
+#include "mongo/util/net/hostandport.h"
 
 namespace mongo {
 
@@ -56,9 +63,49 @@ public:
     long long getNumAdvantageouslyHedgedOperations() const;
     void incrementNumAdvantageouslyHedgedOperations();
 
+    long long getNumDelayedHedgesNotSent() const;
+    void incrementNumDelayedHedgesNotSent();
+
+    /**
+     * Records the latency of a successful response from 'host' to a command which could have been
+     * hedged.
+     */
+    void recordLatency(const HostAndPort& host, Milliseconds latency);
+
+    /**
+     * Returns an upper bound on the given percentile of the recent latencies recorded for 'host',
+     * or boost::none if too few latencies have been recorded for it to be meaningful.
+     */
+    boost::optional<Milliseconds> getLatencyPercentile(const HostAndPort& host,
+                                                       int percentile) const;
+
     BSONObj toBSON() const;
 
+    // Latencies are bucketed by powers of two milliseconds: bucket 0 holds latencies below 1ms and
+    // bucket i holds latencies in [2^(i-1), 2^i) ms. The last bucket is unbounded.
+    static constexpr size_t kNumLatencyBuckets = 20;
+
+    // A host's latency percentiles are only used once it has this many recorded latencies.
+    static constexpr long long kMinLatencySamples = 100;
+
+    // Once a host has this many recorded latencies, all of its buckets are halved, so that the
+    // percentiles follow changes in the host's latency rather than its whole history.
+    static constexpr long long kMaxLatencySamples = 1 << 14;
+
+    // At most this many hosts have their latencies tracked. Recording a latency for a new host
+    // beyond that evicts the host whose latency was recorded least recently, so that hosts which
+    // have left the topology do not accumulate.
+    static constexpr size_t kMaxTrackedHosts = 256;
+
 private:
+    struct LatencyHistogram {
+        std::array<long long, kNumLatencyBuckets> buckets{};
+        long long count{0};
+
+        // The value of '_numLatenciesRecorded' when a latency was last recorded for this host.
+        long long lastRecorded{0};
+    };
+
     // The number of all operations with readPreference options such that they could be hedged.
     AtomicWord<long long> _numTotalOperations{0};
 
@@ -68,6 +115,15 @@ private:
     // The number of all operations where a rpc other than the first one fulfilled the client
     // request.
     AtomicWord<long long> _numAdvantageouslyHedgedOperations{0};
+
+    // The number of hedged requests which were held back until the first request had been
+    // outstanding for longer than its host's tail latency, and which were never sent because the
+    // first request completed in the meantime.
+    AtomicWord<long long> _numDelayedHedgesNotSent{0};
+
+    mutable Mutex _latencyMutex = MONGO_MAKE_LATCH("HedgingMetrics::_latencyMutex");
+    std::map<HostAndPort, LatencyHistogram> _latencies;
+    long long _numLatenciesRecorded{0};
 };
 
 }  // namespace mongo
@@ -0,0 +1,134 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/executor/hedging_metrics.h"
+
+#include "mongo/bson/bsonobj.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+const HostAndPort kHost("a.example.com", 27017);
+const HostAndPort kOtherHost("b.example.com", 27017);
+
+TEST(HedgingMetricsTest, NoPercentileUntilEnoughLatenciesAreRecorded) {
+    HedgingMetrics metrics;
+    for (long long i = 0; i < HedgingMetrics::kMinLatencySamples - 1; ++i) {
+        metrics.recordLatency(kHost, Milliseconds(5));
+    }
+    ASSERT_FALSE(metrics.getLatencyPercentile(kHost, 95));
+
+    metrics.recordLatency(kHost, Milliseconds(5));
+    ASSERT_EQ(Milliseconds(8), *metrics.getLatencyPercentile(kHost, 95));
+    ASSERT_FALSE(metrics.getLatencyPercentile(kOtherHost, 95));
+}
+
+TEST(HedgingMetricsTest, PercentileIsAnUpperBoundOnTheTailLatency) {
+    HedgingMetrics metrics;
+    for (int i = 0; i < 90; ++i) {
+        metrics.recordLatency(kHost, Milliseconds(3));
+    }
+    for (int i = 0; i < 10; ++i) {
+        metrics.recordLatency(kHost, Milliseconds(100));
+    }
+
+    ASSERT_EQ(Milliseconds(4), *metrics.getLatencyPercentile(kHost, 90));
+    ASSERT_EQ(Milliseconds(128), *metrics.getLatencyPercentile(kHost, 95));
+}
+
+TEST(HedgingMetricsTest, OldLatenciesDecay) {
+    HedgingMetrics metrics;
+    for (long long i = 0; i < HedgingMetrics::kMaxLatencySamples; ++i) {
+        metrics.recordLatency(kHost, Milliseconds(100));
+    }
+    ASSERT_EQ(Milliseconds(128), *metrics.getLatencyPercentile(kHost, 50));
+
+    // Each time the histogram fills up, the weight of the older latencies is halved.
+    for (long long i = 0; i < HedgingMetrics::kMaxLatencySamples; ++i) {
+        metrics.recordLatency(kHost, Milliseconds(1));
+    }
+    ASSERT_EQ(Milliseconds(2), *metrics.getLatencyPercentile(kHost, 50));
+}
+
+TEST(HedgingMetricsTest, ToBSONReportsWinRateAndHostLatencies) {
+    HedgingMetrics metrics;
+    metrics.incrementNumTotalOperations();
+    metrics.incrementNumTotalOperations();
+    metrics.incrementNumTotalHedgedOperations();
+    metrics.incrementNumTotalHedgedOperations();
+    metrics.incrementNumAdvantageouslyHedgedOperations();
+    metrics.incrementNumDelayedHedgesNotSent();
+    metrics.recordLatency(kHost, Milliseconds(0));
+    metrics.recordLatency(kHost, Milliseconds(6));
+    metrics.recordLatency(kHost, Milliseconds(7));
+
+    auto obj = metrics.toBSON();
+    ASSERT_EQ(2, obj["numTotalOperations"].numberLong());
+    ASSERT_EQ(2, obj["numTotalHedgedOperations"].numberLong());
+    ASSERT_EQ(1, obj["numAdvantageouslyHedgedOperations"].numberLong());
+    ASSERT_EQ(1, obj["numDelayedHedgesNotSent"].numberLong());
+    ASSERT_EQ(0.5, obj["hedgeWinRate"].numberDouble());
+
+    auto hostObj = obj["hostLatencies"].Obj()[kHost.toString()].Obj();
+    ASSERT_EQ(3, hostObj["count"].numberLong());
+    ASSERT_BSONOBJ_EQ(BSON_ARRAY(BSON("millis" << 0LL << "count" << 1LL)
+                                 << BSON("millis" << 4LL << "count" << 2LL)),
+                      hostObj["histogram"].Obj());
+}
+
+TEST(HedgingMetricsTest, LeastRecentlyRecordedHostIsEvictedWhenFull) {
+    HedgingMetrics metrics;
+    for (long long i = 0; i < HedgingMetrics::kMinLatencySamples; ++i) {
+        metrics.recordLatency(kHost, Milliseconds(5));
+        metrics.recordLatency(kOtherHost, Milliseconds(5));
+    }
+
+    // Fill up the remaining slots with hosts that come and go, then touch kOtherHost again so that
+    // kHost is the least recently recorded host.
+    for (size_t i = 2; i < HedgingMetrics::kMaxTrackedHosts; ++i) {
+        const HostAndPort transientHost("transient.example.com", static_cast<int>(20000 + i));
+        metrics.recordLatency(transientHost, Milliseconds(1));
+    }
+    metrics.recordLatency(kOtherHost, Milliseconds(5));
+    ASSERT_EQ(HedgingMetrics::kMaxTrackedHosts,
+              size_t(metrics.toBSON()["hostLatencies"].Obj().nFields()));
+    ASSERT(metrics.getLatencyPercentile(kHost, 95));
+
+    metrics.recordLatency(HostAndPort("new.example.com", 27017), Milliseconds(1));
+    ASSERT_EQ(HedgingMetrics::kMaxTrackedHosts,
+              size_t(metrics.toBSON()["hostLatencies"].Obj().nFields()));
+    ASSERT_FALSE(metrics.getLatencyPercentile(kHost, 95));
+    ASSERT(metrics.getLatencyPercentile(kOtherHost, 95));
+}
+
+}  // namespace
+}  // namespace mongo
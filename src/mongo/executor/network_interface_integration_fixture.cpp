@@ -47,8 +47,7 @@
 namespace mongo {
 namespace executor {
 
-void NetworkInterfaceIntegrationFixture::createNet(
-    std::unique_ptr<NetworkConnectionHook> connectHook) {
+ConnectionPool::Options NetworkInterfaceIntegrationFixture::makeDefaultConnectionPoolOptions() {
     ConnectionPool::Options options;
 
     options.minConnections = 0u;
@@ -60,14 +59,19 @@ void NetworkInterfaceIntegrationFixture::createNet(
 #else
     options.maxConnections = 256u;
 #endif
+    return options;
+}
+
+void NetworkInterfaceIntegrationFixture::createNet(
+    std::unique_ptr<NetworkConnectionHook> connectHook, ConnectionPool::Options options) {
     _net = makeNetworkInterface(
         "NetworkInterfaceIntegrationFixture", std::move(connectHook), nullptr, std::move(options));
 }
 
 void NetworkInterfaceIntegrationFixture::startNet(
-    std::unique_ptr<NetworkConnectionHook> connectHook) {
+    std::unique_ptr<NetworkConnectionHook> connectHook, ConnectionPool::Options options) {
 
-    createNet(std::move(connectHook));
+    createNet(std::move(connectHook), std::move(options));
     net().startup();
 }
 
@@ -34,6 +34,7 @@
 #include <algorithm>
 #include <exception>
 #include <memory>
+#include <vector>
 
 #include "mongo/base/status_with.h"
 #include "mongo/client/connection_string.h"
@@ -162,7 +163,11 @@ public:
 
     void setUp() override {
         setTestCommandsEnabled(true);
-        startNet(std::make_unique<WaitForIsMasterHook>(this));
+        startNet(std::make_unique<WaitForIsMasterHook>(this), makeConnectionPoolOptions());
+    }
+
+    virtual ConnectionPool::Options makeConnectionPoolOptions() {
+        return makeDefaultConnectionPoolOptions();
     }
 
     RemoteCommandRequest makeTestCommand(
@@ -741,6 +746,138 @@ TEST_F(NetworkInterfaceTest, IsMasterRequestMissingInternalClientInfoWhenNotInte
     assertNumOps(0u, 0u, 0u, 1u);
 }
 
+class NetworkInterfaceMultiplexingTest : public NetworkInterfaceTest {
+public:
+    static constexpr size_t kMaxMultiplexedRequests = 16;
+
+    ConnectionPool::Options makeConnectionPoolOptions() override {
+        auto options = makeDefaultConnectionPoolOptions();
+        options.maxMultiplexedRequests = kMaxMultiplexedRequests;
+        return options;
+    }
+
+    size_t totalConnectionsCreated() {
+        ConnectionPoolStats stats;
+        net().appendConnectionStats(&stats);
+        return stats.totalCreated;
+    }
+};
+
+TEST_F(NetworkInterfaceMultiplexingTest, IsMasterNegotiatesRequestMultiplexing) {
+    auto deferred = runCommand(makeCallbackHandle(), makeTestCommand(kNoTimeout, makeEchoCmdObj()));
+    auto isMasterHandshake = waitForIsMaster();
+
+    ASSERT_TRUE(isMasterHandshake.request["requestMultiplexing"].trueValue());
+    ASSERT_TRUE(isMasterHandshake.response.data["requestMultiplexing"].trueValue());
+
+    ASSERT_OK(deferred.get().status);
+    assertNumOps(0u, 0u, 0u, 1u);
+}
+
+TEST_F(NetworkInterfaceMultiplexingTest, ConcurrentRequestsShareOneConnection) {
+    // Establish the connection up front so that every request below finds it ready to share.
+    auto warmUp = makeTestCommand(kNoTimeout, makeEchoCmdObj());
+    ASSERT_OK(runCommandSync(warmUp).status);
+    ASSERT_EQ(totalConnectionsCreated(), 1u);
+
+    std::vector<Future<RemoteCommandResponse>> futures;
+    for (size_t i = 0; i < kMaxMultiplexedRequests; ++i) {
+        futures.push_back(runCommand(
+            makeCallbackHandle(),
+            makeTestCommand(kNoTimeout, BSON("echo" << 1 << "i" << static_cast<int>(i)))));
+    }
+
+    for (size_t i = 0; i < futures.size(); ++i) {
+        auto res = futures[i].get();
+        ASSERT_OK(res.status);
+        ASSERT_OK(getStatusFromCommandResult(res.data));
+        // Each reply must be routed back to the request that produced it.
+        ASSERT_EQ(res.data["echo"]["i"].numberInt(), static_cast<int>(i));
+    }
+
+    ASSERT_EQ(totalConnectionsCreated(), 1u);
+    assertNumOps(0u, 0u, 0u, kMaxMultiplexedRequests + 1);
+}
+
+TEST_F(NetworkInterfaceMultiplexingTest, SharedConnectionIsReturnedHealthyByTheLastSharer) {
+    auto warmUp = makeTestCommand(kNoTimeout, makeEchoCmdObj());
+    ASSERT_OK(runCommandSync(warmUp).status);
+
+    std::vector<Future<RemoteCommandResponse>> futures;
+    for (size_t i = 0; i < kMaxMultiplexedRequests; ++i) {
+        futures.push_back(
+            runCommand(makeCallbackHandle(), makeTestCommand(kNoTimeout, makeEchoCmdObj())));
+    }
+    for (auto& future : futures) {
+        ASSERT_OK(future.get().status);
+    }
+
+    // The connection goes back to the pool once, when the last request sharing it lets go, and it
+    // must come back as a healthy idle connection rather than being dropped.
+    ConnectionPoolStats stats;
+    for (auto start = Date_t::now(); Date_t::now() - start < Seconds(30); sleepmillis(10)) {
+        stats = ConnectionPoolStats();
+        net().appendConnectionStats(&stats);
+        if (stats.totalInUse == 0u) {
+            break;
+        }
+    }
+    ASSERT_EQ(stats.totalInUse, 0u);
+    ASSERT_EQ(stats.totalAvailable, 1u);
+    ASSERT_EQ(stats.totalCreated, 1u);
+
+    ASSERT_OK(runCommandSync(warmUp).status);
+    ASSERT_EQ(totalConnectionsCreated(), 1u);
+}
+
+TEST_F(NetworkInterfaceMultiplexingTest, TransactionRequestsDoNotShareConnections) {
+    auto warmUp = makeTestCommand(kNoTimeout, makeEchoCmdObj());
+    ASSERT_OK(runCommandSync(warmUp).status);
+    ASSERT_EQ(totalConnectionsCreated(), 1u);
+
+    // Keep the shared connection busy, so that only a connection of its own can run the request.
+    auto sleeping = runCommand(makeCallbackHandle(),
+                               makeTestCommand(kNoTimeout,
+                                               BSON("sleep" << 1 << "lock"
+                                                            << "none"
+                                                            << "millis" << 500)));
+
+    // Whether the host accepts the statement does not matter, only which connection carries it.
+    auto transactionStatement =
+        makeTestCommand(kNoTimeout, BSON("echo" << 1 << "autocommit" << false));
+    ASSERT_OK(runCommandSync(transactionStatement).status);
+    ASSERT_EQ(totalConnectionsCreated(), 2u);
+
+    ASSERT_OK(sleeping.get().status);
+}
+
+TEST_F(NetworkInterfaceMultiplexingTest, CancelingOneRequestLeavesTheConnectionUsable) {
+    auto warmUp = makeTestCommand(kNoTimeout, makeEchoCmdObj());
+    ASSERT_OK(runCommandSync(warmUp).status);
+
+    auto sleepCbh = makeCallbackHandle();
+    auto sleeping = runCommand(sleepCbh,
+                               makeTestCommand(kNoTimeout,
+                                               BSON("sleep" << 1 << "lock"
+                                                            << "none"
+                                                            << "millis" << 500)));
+    auto echoing = runCommand(makeCallbackHandle(), makeTestCommand(kNoTimeout, makeEchoCmdObj()));
+
+    net().cancelCommand(sleepCbh);
+
+    ASSERT_EQ(ErrorCodes::CallbackCanceled, sleeping.getNoThrow().getStatus());
+
+    // The reply to the canceled request is discarded when it arrives, and the request queued
+    // behind it on the same connection still completes.
+    auto res = echoing.get();
+    ASSERT_OK(res.status);
+    auto cmdObj = res.data.getObjectField("echo");
+    ASSERT_EQ(1, cmdObj.getIntField("echo"));
+    ASSERT_EQ("bar"_sd, cmdObj.getStringField("foo"));
+
+    ASSERT_EQ(totalConnectionsCreated(), 1u);
+}
+
 class ExhaustRequestHandlerUtil {
 public:
     struct responseOutcomeCount {
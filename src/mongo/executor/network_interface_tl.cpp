@@ -42,6 +42,7 @@
 #include "mongo/transport/transport_layer_manager.h"
 #include "mongo/util/concurrency/idle_thread_block.h"
 #include "mongo/util/net/socket_utils.h"
+#include "mongo/util/string_map.h"
 
 namespace mongo {
 namespace executor {
@@ -98,7 +99,22 @@ private:
 namespace {
 const Status kNetworkInterfaceShutdownInProgress = {ErrorCodes::ShutdownInProgress,
                                                     "NetworkInterface shutdown in progress"};
+
+/**
+ * Whether 'cmdObj' is part of a multi-statement transaction or of its two phase commit. A host
+ * runs the requests on a connection one after another, so a statement blocked behind a prepared
+ * transaction would hold up a commit or abort of that transaction queued after it on a shared
+ * connection. These requests therefore keep connections of their own.
+ */
+bool isTransactionRequest(const BSONObj& cmdObj) {
+    static const StringDataSet kTransactionCommands{"abortTransaction",
+                                                   "commitTransaction",
+                                                   "coordinateCommitTransaction",
+                                                   "prepareTransaction"};
+    return cmdObj.hasField("autocommit") || cmdObj.hasField("startTransaction") ||
+        kTransactionCommands.count(cmdObj.firstElementFieldNameStringData());
 }
+}  // namespace
 
 NetworkInterfaceTL::NetworkInterfaceTL(std::string instanceName,
                                        ConnectionPool::Options connPoolOpts,
@@ -365,6 +381,18 @@ void NetworkInterfaceTL::RequestState::returnConnection(Status status) noexcept
 
     auto connToReturn = std::exchange(conn, {});
 
+    if (cmdState->sharesConnection(connToReturn.get())) {
+        // Other requests may still be using the connection, and the last of them reports how it
+        // fared. See _shareMultiplexedConnection().
+        return;
+    }
+
+    if (auto client = getClient(connToReturn); client && client->isMultiplexing()) {
+        // A multiplexing connection is only as bad as its session, whatever became of this one
+        // request. Other requests may still be sharing it.
+        status = client->getMultiplexingStatus();
+    }
+
     if (!status.isOK()) {
         connToReturn->indicateFailure(std::move(status));
         return;
@@ -374,6 +402,12 @@ void NetworkInterfaceTL::RequestState::returnConnection(Status status) noexcept
     connToReturn->indicateSuccess();
 }
 
+bool NetworkInterfaceTL::CommandStateBase::sharesConnection(
+    ConnectionPool::ConnectionInterface* conn) const noexcept {
+    return multiplexed &&
+        checked_cast<connection_pool_tl::TLConnection*>(conn)->client()->isMultiplexing();
+}
+
 void NetworkInterfaceTL::CommandStateBase::tryFinish(Status status) noexcept {
     invariant(finishLine.isReady());
 
@@ -400,6 +434,11 @@ void NetworkInterfaceTL::CommandStateBase::tryFinish(Status status) noexcept {
         interface->_inProgress.erase(cbHandle);
     }
 
+    if (requestManager) {
+        // Hedged requests which have not been sent yet are no longer needed.
+        requestManager->cancelHedgeTimers();
+    }
+
     if (operationKey && requestManager) {
         // Kill operations for requests that we didn't use to fulfill the promise.
         requestManager->killOperationsForPendingRequests();
@@ -425,6 +464,12 @@ void NetworkInterfaceTL::CommandStateBase::tryFinish(Status status) noexcept {
 void NetworkInterfaceTL::RequestState::cancel() noexcept {
     auto connToCancel = weakConn.lock();
     if (auto clientPtr = getClient(connToCancel)) {
+        if (clientPtr->isMultiplexing()) {
+            // Leave any other requests on the connection running
+            clientPtr->cancelRequest(request->id);
+            return;
+        }
+
         // If we have a client, cancel it
         clientPtr->cancel(cmdState->baton);
     }
@@ -538,9 +583,21 @@ Status NetworkInterfaceTL::startCommand(const TaskExecutor::CallbackHandle& cbHa
 
     RequestManager* rm = cmdState->requestManager.get();
 
+    // Hedged requests and fire-and-forget requests keep connections of their own. So do requests
+    // bound to a baton, since the requests sharing a connection are all driven by the reactor,
+    // requests over TLS, and transaction requests, see isTransactionRequest().
+    const bool canMultiplex = _connPoolOpts.maxMultiplexedRequests > 1 &&
+        request.target.size() == 1 && request.sslMode == transport::kGlobalSSLMode &&
+        !connection_pool_tl::connectsWithTLS(request.sslMode) &&
+        request.fireAndForgetMode == RemoteCommandRequest::FireAndForgetMode::kOff && !baton &&
+        !isTransactionRequest(request.cmdObj);
+    cmdState->multiplexed = canMultiplex;
+
     // Attempt to get a connection to every target host
     for (size_t idx = 0; idx < request.target.size() && !rm->usedAllConn(); ++idx) {
-        auto connFuture = _pool->get(request.target[idx], request.sslMode, request.timeout);
+        auto connFuture = canMultiplex
+            ? _getMultiplexedConnection(request.target[idx], request.timeout)
+            : _pool->get(request.target[idx], request.sslMode, request.timeout);
 
         // If connection future is ready or requests should be sent in order, send the request
         // immediately.
@@ -560,6 +617,86 @@ Status NetworkInterfaceTL::startCommand(const TaskExecutor::CallbackHandle& cbHa
     return ex.toStatus();
 }
 
+SemiFuture<ConnectionPool::ConnectionHandle> NetworkInterfaceTL::_getMultiplexedConnection(
+    const HostAndPort& target, Milliseconds timeout) {
+    RequestState::ConnectionHandle shared;
+    {
+        stdx::lock_guard lk(_multiplexedMutex);
+        if (auto it = _multiplexedConnections.find(target); it != _multiplexedConnections.end()) {
+            shared = it->second.lock();
+        }
+    }
+
+    // The use count includes our own reference.
+    if (shared && RequestState::getClient(shared)->getMultiplexingStatus().isOK() &&
+        static_cast<size_t>(shared.use_count() - 1) < _connPoolOpts.maxMultiplexedRequests) {
+        auto connPtr = shared.get();
+        return ConnectionPool::ConnectionHandle(connPtr, [shared = std::move(shared)](auto*) {});
+    }
+    // Drop our reference before asking the pool, since it may be the last one.
+    shared.reset();
+
+    auto connFuture = _pool->get(target, transport::kGlobalSSLMode, timeout);
+    if (connFuture.isReady()) {
+        return _shareMultiplexedConnection(target, std::move(connFuture).getNoThrow());
+    }
+
+    // The pool fulfills its requests under its mutex, so look at the connection on the reactor.
+    return std::move(connFuture)
+        .thenRunOn(_reactor)
+        .onCompletion([this, target](StatusWith<ConnectionPool::ConnectionHandle> swConn) {
+            return _shareMultiplexedConnection(target, std::move(swConn));
+        })
+        .semi();
+}
+
+StatusWith<ConnectionPool::ConnectionHandle> NetworkInterfaceTL::_shareMultiplexedConnection(
+    const HostAndPort& target, StatusWith<ConnectionPool::ConnectionHandle> swConn) {
+    if (!swConn.isOK()) {
+        return swConn;
+    }
+
+    // Servers that did not agree to multiplexing get a connection per request, as usual.
+    auto& conn = swConn.getValue();
+    if (!checked_cast<connection_pool_tl::TLConnection*>(conn.get())->client()->isMultiplexing()) {
+        return swConn;
+    }
+
+    // The requests sharing the connection finish concurrently, so rather than each of them
+    // telling the pool how the connection fared, the last one to let go of it does so once.
+    auto deleter = conn.get_deleter();
+    RequestState::ConnectionHandle shared(
+        conn.release(), [deleter](ConnectionPool::ConnectionInterface* connPtr) mutable {
+            auto status = checked_cast<connection_pool_tl::TLConnection*>(connPtr)
+                              ->client()
+                              ->getMultiplexingStatus();
+            if (status.isOK()) {
+                connPtr->indicateUsed();
+                connPtr->indicateSuccess();
+            } else {
+                connPtr->indicateFailure(std::move(status));
+            }
+            deleter(connPtr);
+        });
+
+    // Held until we return, since it may be the last reference and return its connection to the
+    // pool, which must not happen under the mutex.
+    RequestState::ConnectionHandle previous;
+    {
+        stdx::lock_guard lk(_multiplexedMutex);
+        auto& entry = _multiplexedConnections[target];
+        previous = entry.lock();
+        if (!previous || !RequestState::getClient(previous)->getMultiplexingStatus().isOK()) {
+            entry = shared;
+        }
+        // Otherwise another request started sharing a connection first, and this one keeps its
+        // connection to itself.
+    }
+
+    auto connPtr = shared.get();
+    return ConnectionPool::ConnectionHandle(connPtr, [shared = std::move(shared)](auto*) {});
+}
+
 void NetworkInterfaceTL::testEgress(const HostAndPort& hostAndPort,
                                     transport::ConnectSSLMode sslMode,
                                     Milliseconds timeout,
@@ -619,7 +756,7 @@ std::shared_ptr<NetworkInterfaceTL::RequestState> NetworkInterfaceTL::RequestMan
 }
 
 std::shared_ptr<NetworkInterfaceTL::RequestState>
-NetworkInterfaceTL::RequestManager::getNextRequest() {
+NetworkInterfaceTL::RequestManager::getNextRequest(size_t idx) {
     stdx::lock_guard<Latch> lk(mutex);
     if (sentIdx.load() < requests.size()) {
         auto requestState = requests[sentIdx.fetchAndAdd(1)].lock();
@@ -627,6 +764,8 @@ NetworkInterfaceTL::RequestManager::getNextRequest() {
 
         if (sentIdx.load() > 1) {
             requestState->isHedge = true;
+        } else {
+            firstTarget = cmdState.lock()->requestOnAny.target[idx];
         }
         return requestState;
     } else {
@@ -712,6 +851,57 @@ void NetworkInterfaceTL::RequestManager::killOperationsForPendingRequests() {
     }
 }
 
+void NetworkInterfaceTL::RequestManager::cancelHedgeTimers() {
+    std::vector<std::shared_ptr<RequestState>> delayedRequests;
+    {
+        stdx::lock_guard<Latch> lk(mutex);
+        for (size_t i = 0; i < requests.size(); i++) {
+            auto requestState = requests[i].lock();
+            if (requestState && requestState->hedgeTimer) {
+                delayedRequests.push_back(std::move(requestState));
+            }
+        }
+    }
+
+    // Cancel outside of the mutex, since cancellation may run the timer's callback inline.
+    for (auto& requestState : delayedRequests) {
+        requestState->hedgeTimer->cancel(requestState->cmdState->baton);
+    }
+}
+
+boost::optional<Milliseconds> NetworkInterfaceTL::RequestManager::getHedgeDelay() {
+    auto cmdStatePtr = cmdState.lock();
+    invariant(cmdStatePtr);
+
+    const auto& hedgeOptions = cmdStatePtr->requestOnAny.hedgeOptions;
+    auto svcCtx = cmdStatePtr->interface->_svcCtx;
+    if (!hedgeOptions || hedgeOptions->delayPercentile <= 0 || !svcCtx) {
+        return boost::none;
+    }
+
+    boost::optional<HostAndPort> target;
+    {
+        stdx::lock_guard<Latch> lk(mutex);
+        target = firstTarget;
+    }
+    if (!target) {
+        return boost::none;
+    }
+
+    auto tailLatency =
+        HedgingMetrics::get(svcCtx)->getLatencyPercentile(*target, hedgeOptions->delayPercentile);
+    if (!tailLatency) {
+        // Too little is known about the host's latency, so hedge straight away.
+        return boost::none;
+    }
+
+    auto delay = *tailLatency - cmdStatePtr->stopwatch.elapsed();
+    if (delay <= Milliseconds(0)) {
+        return boost::none;
+    }
+    return delay;
+}
+
 void NetworkInterfaceTL::RequestManager::trySend(
     StatusWith<ConnectionPool::ConnectionHandle> swConn, size_t idx) noexcept {
     auto cmdStatePtr = cmdState.lock();
@@ -745,12 +935,14 @@ void NetworkInterfaceTL::RequestManager::trySend(
         if (cmdStatePtr->finishLine.isReady() || sentAll() || isLocked) {
             // Our command has already been satisfied or we have already sent out all
             // the requests.
-            swConn.getValue()->indicateSuccess();
+            if (!cmdStatePtr->sharesConnection(swConn.getValue().get())) {
+                swConn.getValue()->indicateSuccess();
+            }
             return;
         }
     }
 
-    auto requestState = getNextRequest();
+    auto requestState = getNextRequest(idx);
     invariant(requestState);
 
     LOGV2_DEBUG(4646300,
@@ -777,11 +969,65 @@ void NetworkInterfaceTL::RequestManager::trySend(
                     "requestId"_attr = cmdStatePtr->requestOnAny.id,
                     "target"_attr = cmdStatePtr->requestOnAny.target[idx]);
 
-        if (cmdStatePtr->interface->_svcCtx) {
-            auto hm = HedgingMetrics::get(cmdStatePtr->interface->_svcCtx);
-            invariant(hm);
-            hm->incrementNumTotalHedgedOperations();
+        if (auto delay = getHedgeDelay()) {
+            LOGV2_DEBUG(4647201,
+                        2,
+                        "Delaying hedged request until the first request exceeds its host's "
+                        "tail latency",
+                        "delay"_attr = *delay,
+                        "requestId"_attr = cmdStatePtr->requestOnAny.id,
+                        "target"_attr = cmdStatePtr->requestOnAny.target[idx]);
+
+            auto interface = cmdStatePtr->interface;
+            {
+                stdx::lock_guard<Latch> lk(mutex);
+                if (cmdStatePtr->finishLine.isReady() || isLocked) {
+                    swConn.getValue()->indicateSuccess();
+                    if (auto svcCtx = interface->_svcCtx) {
+                        HedgingMetrics::get(svcCtx)->incrementNumDelayedHedgesNotSent();
+                    }
+                    return;
+                }
+                requestState->hedgeTimer = interface->_reactor->makeTimer();
+            }
+
+            requestState->hedgeTimer->waitUntil(interface->now() + *delay, cmdStatePtr->baton)
+                .getAsync([this,
+                           cmdStatePtr,
+                           requestState,
+                           request = std::move(request),
+                           swConn = std::move(swConn)](Status status) mutable {
+                    {
+                        stdx::lock_guard<Latch> lk(mutex);
+                        if (!status.isOK() || cmdStatePtr->finishLine.isReady() || isLocked) {
+                            // The first request finished before the hedge was needed.
+                            swConn.getValue()->indicateSuccess();
+                            if (auto svcCtx = cmdStatePtr->interface->_svcCtx) {
+                                HedgingMetrics::get(svcCtx)->incrementNumDelayedHedgesNotSent();
+                            }
+                            return;
+                        }
+                    }
+                    sendHedge(std::move(swConn), std::move(request), std::move(requestState));
+                });
+            return;
         }
+
+        sendHedge(std::move(swConn), std::move(request), std::move(requestState));
+        return;
+    }
+
+    requestState->send(std::move(swConn), request);
+}
+
+void NetworkInterfaceTL::RequestManager::sendHedge(
+    StatusWith<ConnectionPool::ConnectionHandle> swConn,
+    RemoteCommandRequest request,
+    std::shared_ptr<RequestState> requestState) noexcept {
+    if (auto svcCtx = requestState->interface()->_svcCtx) {
+        auto hm = HedgingMetrics::get(svcCtx);
+        invariant(hm);
+        hm->incrementNumTotalHedgedOperations();
     }
 
     requestState->send(std::move(swConn), request);
@@ -842,6 +1088,13 @@ void NetworkInterfaceTL::RequestState::resolve(Future<RemoteCommandResponse> fut
         .getAsync([ this, anchor = shared_from_this() ](auto swr) noexcept {
             auto response = uassertStatusOK(std::move(swr));
             auto commandStatus = getStatusFromCommandResult(response.data);
+
+            // Feed the latencies of commands which could be hedged into the per-host histograms
+            // used to decide when to hedge.
+            if (auto svcCtx = interface()->_svcCtx; svcCtx && cmdState->requestOnAny.hedgeOptions &&
+                commandStatus.isOK() && response.elapsedMillis) {
+                HedgingMetrics::get(svcCtx)->recordLatency(host, *response.elapsedMillis);
+            }
             // Ignore maxTimeMS expiration errors for hedged reads without triggering the finish
             // line.
             if (isHedge && commandStatus == ErrorCodes::MaxTimeMSExpired) {
@@ -1295,6 +1548,10 @@ bool NetworkInterfaceTL::onNetworkThread() {
 }
 
 void NetworkInterfaceTL::dropConnections(const HostAndPort& hostAndPort) {
+    {
+        stdx::lock_guard lk(_multiplexedMutex);
+        _multiplexedConnections.erase(hostAndPort);
+    }
     _pool->dropConnections(hostAndPort);
 }
 
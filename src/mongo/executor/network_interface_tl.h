@@ -148,6 +148,12 @@ private:
          */
         void doMetadataHook(const RemoteCommandOnAnyResponse& response);
 
+        /**
+         * Whether 'conn' may be shared with the requests of other commands, in which case how it
+         * fared is reported to the pool by the last request to let go of it rather than by each.
+         */
+        bool sharesConnection(ConnectionPool::ConnectionInterface* conn) const noexcept;
+
         NetworkInterfaceTL* interface;
 
         RemoteCommandRequestOnAny requestOnAny;
@@ -164,6 +170,9 @@ private:
         StrongWeakFinishLine finishLine;
 
         boost::optional<UUID> operationKey;
+
+        // Whether this command gets its connections through _getMultiplexedConnection().
+        bool multiplexed = false;
     };
 
     struct CommandState final : public CommandStateBase {
@@ -223,11 +232,24 @@ private:
 
         std::shared_ptr<RequestState> makeRequest();
         std::shared_ptr<RequestState> getRequest(size_t reqId);
-        std::shared_ptr<RequestState> getNextRequest();
+        std::shared_ptr<RequestState> getNextRequest(size_t idx);
 
         void trySend(StatusWith<ConnectionPool::ConnectionHandle> swConn, size_t idx) noexcept;
         void cancelRequests();
         void killOperationsForPendingRequests();
+        void cancelHedgeTimers();
+
+        /**
+         * Returns how much longer a hedged request should be held back before it is sent, or
+         * boost::none if it should be sent immediately. Hedged requests are held back until the
+         * first request has been outstanding for longer than the configured latency percentile of
+         * its target host.
+         */
+        boost::optional<Milliseconds> getHedgeDelay();
+
+        void sendHedge(StatusWith<ConnectionPool::ConnectionHandle> swConn,
+                       RemoteCommandRequest request,
+                       std::shared_ptr<RequestState> requestState) noexcept;
 
         bool sentNone() const;
         bool sentAll() const;
@@ -245,6 +267,9 @@ private:
         // Number of requests to send.
         AtomicWord<size_t> requestCount{0};
 
+        // Target of the first request sent, against whose latency hedged requests are delayed.
+        boost::optional<HostAndPort> firstTarget;
+
         // Set to true when the command finishes or is canceled to block remaining requests.
         bool isLocked{false};
 
@@ -265,7 +290,8 @@ private:
         static AsyncDBClient* getClient(const ConnectionHandle& conn) noexcept;
 
         /**
-         * Cancel the current client operation or do nothing if there is no client.
+         * Cancel the current client operation or do nothing if there is no client. On a
+         * multiplexing connection, only this request is canceled.
          */
         void cancel() noexcept;
 
@@ -310,6 +336,10 @@ private:
         // True if this request is an additional request sent to hedge the operation.
         bool isHedge{false};
 
+        // Set while this hedged request holds a connection but waits for the first request to
+        // exceed its host's tail latency before being sent. Guarded by the RequestManager mutex.
+        std::unique_ptr<transport::ReactorTimer> hedgeTimer;
+
         // Set to true if the response to the request is used to fulfill the command's
         // promise (i.e. arrives before the responses to all other requests and is not
         // a MaxTimeMSExpired error response if this is a hedged request).
@@ -341,6 +371,17 @@ private:
 
     Status _killOperation(std::shared_ptr<RequestState> requestStateToKill);
 
+    /**
+     * Gets a connection to 'target' that up to _connPoolOpts.maxMultiplexedRequests concurrent
+     * requests share, if the host agreed to multiplexed requests, or a connection of its own
+     * otherwise. The shared connection goes back to the pool when its last request finishes, and
+     * only then reports to the pool how it fared.
+     */
+    SemiFuture<ConnectionPool::ConnectionHandle> _getMultiplexedConnection(
+        const HostAndPort& target, Milliseconds timeout);
+    StatusWith<ConnectionPool::ConnectionHandle> _shareMultiplexedConnection(
+        const HostAndPort& target, StatusWith<ConnectionPool::ConnectionHandle> swConn);
+
     std::string _instanceName;
     ServiceContext* _svcCtx = nullptr;
     transport::TransportLayer* _tl = nullptr;
@@ -351,6 +392,11 @@ private:
     mutable Mutex _mutex =
         MONGO_MAKE_LATCH(HierarchicalAcquisitionLevel(3), "NetworkInterfaceTL::_mutex");
     ConnectionPool::Options _connPoolOpts;
+
+    Mutex _multiplexedMutex = MONGO_MAKE_LATCH(HierarchicalAcquisitionLevel(0),
+                                               "NetworkInterfaceTL::_multiplexedMutex");
+    // The connection to each host that requests are currently sharing.
+    stdx::unordered_map<HostAndPort, RequestState::WeakConnectionHandle> _multiplexedConnections;
     std::unique_ptr<NetworkConnectionHook> _onConnectHook;
     std::shared_ptr<ConnectionPool> _pool;
 
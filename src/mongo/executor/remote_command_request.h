@@ -46,6 +46,10 @@ struct RemoteCommandRequestBase {
     struct HedgeOptions {
         size_t count;
         int maxTimeMSForHedgedReads;
+
+        // If positive, hedged requests are only sent once the first request has been outstanding
+        // for longer than this percentile of its target host's recent latencies.
+        int delayPercentile = 0;
     };
 
     enum FireAndForgetMode { kOn, kOff };
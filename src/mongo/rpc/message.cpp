@@ -31,7 +31,10 @@
 
 #include "mongo/rpc/message.h"
 
+#include <cstring>
+
 #include "mongo/platform/atomic_word.h"
+#include "mongo/util/assert_util.h"
 
 namespace mongo {
 
@@ -39,6 +42,52 @@ namespace {
 AtomicWord<int32_t> NextMsgId;
 }  // namespace
 
+Message::Message(SharedBuffer data, std::vector<Fragment> fragments)
+    : _buf(std::move(data)), _fragments(std::move(fragments)) {
+    std::size_t lastOffset = sizeof(MSGHEADER::Value);
+    for (const auto& fragment : _fragments) {
+        invariant(fragment.offset >= lastOffset);
+        lastOffset = fragment.offset;
+    }
+}
+
+std::vector<ConstDataRange> Message::dataRanges() const {
+    std::vector<ConstDataRange> ranges;
+    if (empty()) {
+        return ranges;
+    }
+
+    std::size_t headLen = size();
+    for (const auto& fragment : _fragments) {
+        headLen -= fragment.size;
+    }
+
+    ranges.reserve(2 * _fragments.size() + 1);
+    std::size_t headPos = 0;
+    for (const auto& fragment : _fragments) {
+        if (fragment.offset > headPos) {
+            ranges.emplace_back(_buf.get() + headPos, fragment.offset - headPos);
+            headPos = fragment.offset;
+        }
+        ranges.emplace_back(fragment.data, fragment.size);
+    }
+    if (headLen > headPos) {
+        ranges.emplace_back(_buf.get() + headPos, headLen - headPos);
+    }
+    return ranges;
+}
+
+void Message::_flatten() const {
+    auto flat = SharedBuffer::allocate(size());
+    char* out = flat.get();
+    for (const auto& range : dataRanges()) {
+        std::memcpy(out, range.data(), range.length());
+        out += range.length();
+    }
+    _buf = std::move(flat);
+    _fragments.clear();
+}
+
 int32_t nextMessageId() {
     return NextMsgId.fetchAndAdd(1);
 }
@@ -30,11 +30,14 @@
 #pragma once
 
 #include <cstdint>
+#include <vector>
 
+#include "mongo/base/data_range.h"
 #include "mongo/base/data_type_endian.h"
 #include "mongo/base/data_view.h"
 #include "mongo/base/encoded_value_storage.h"
 #include "mongo/base/static_assert.h"
+#include "mongo/util/shared_buffer.h"
 #include "mongo/util/str.h"
 
 namespace mongo {
@@ -392,9 +395,27 @@ inline int ConstView::dataLen() const {
 
 class Message {
 public:
+    /**
+     * A run of bytes that belongs on the wire at 'offset' within the message's own buffer but is
+     * not copied into it. 'owner' keeps 'data' alive for as long as the message references it.
+     */
+    struct Fragment {
+        std::size_t offset;
+        ConstSharedBuffer owner;
+        const char* data;
+        std::size_t size;
+    };
+
     Message() = default;
     explicit Message(SharedBuffer data) : _buf(std::move(data)) {}
 
+    /**
+     * Builds a message whose wire bytes are 'data' with 'fragments' spliced in at their offsets.
+     * The length in the header must already count the fragments' bytes, and the fragments must be
+     * ordered by offset and lie after the header.
+     */
+    Message(SharedBuffer data, std::vector<Fragment> fragments);
+
     MsgData::View header() const {
         verify(!empty());
         return _buf.get();
@@ -406,6 +427,7 @@ public:
 
     MsgData::View singleData() const {
         massert(13273, "single data buffer expected", _buf);
+        flatten();
         return header();
     }
 
@@ -425,15 +447,18 @@ public:
     }
 
     size_t capacity() const {
+        flatten();
         return _buf.capacity();
     }
 
     void realloc(size_t size) {
+        flatten();
         _buf.reallocOrCopy(size);
     }
 
     void reset() {
         _buf = {};
+        _fragments.clear();
     }
 
     // use to set first buffer if empty
@@ -456,23 +481,54 @@ public:
     }
 
     char* buf() {
+        flatten();
         return _buf.get();
     }
 
     const char* buf() const {
+        flatten();
         return _buf.get();
     }
 
     SharedBuffer sharedBuffer() {
+        flatten();
         return _buf;
     }
 
     ConstSharedBuffer sharedBuffer() const {
+        flatten();
         return _buf;
     }
 
+    /**
+     * Returns true if some of this message's bytes live in fragments outside its own buffer.
+     */
+    bool isFragmented() const {
+        return !_fragments.empty();
+    }
+
+    /**
+     * Returns the byte ranges that make up this message, in wire order, without copying any
+     * fragments. This lets the transport layer send a fragmented message with one gathering write.
+     */
+    std::vector<ConstDataRange> dataRanges() const;
+
 private:
-    SharedBuffer _buf;
+    /**
+     * Copies any fragments into a single contiguous buffer. Every accessor that hands out a pointer
+     * into the message's bytes does this first, so only dataRanges() ever sees fragments.
+     */
+    void flatten() const {
+        if (MONGO_unlikely(!_fragments.empty())) {
+            _flatten();
+        }
+    }
+    void _flatten() const;
+
+    // Mutable so that const accessors can flatten. As with the rest of Message, concurrent access
+    // to one instance must be externally synchronized.
+    mutable SharedBuffer _buf;
+    mutable std::vector<Fragment> _fragments;
 };
 
 /**
@@ -83,8 +83,8 @@ uint32_t OpMsg::flags(const Message& message) {
     if (message.operation() != dbMsg)
         return 0;  // Other command protocols are the same as no flags set.
 
-    return BufReader(message.singleData().data(), message.dataSize())
-        .read<LittleEndian<uint32_t>>();
+    // The flags always sit in the message's own buffer, so read them without flattening.
+    return BufReader(message.header().data(), message.dataSize()).read<LittleEndian<uint32_t>>();
 }
 
 void OpMsg::replaceFlags(Message* message, uint32_t flags) {
@@ -92,7 +92,7 @@ void OpMsg::replaceFlags(Message* message, uint32_t flags) {
     invariant(message->operation() == dbMsg);
     invariant(message->dataSize() >= static_cast<int>(sizeof(uint32_t)));
 
-    DataView(message->singleData().data()).write<LittleEndian<uint32_t>>(flags);
+    DataView(message->header().data()).write<LittleEndian<uint32_t>>(flags);
 }
 
 uint32_t OpMsg::getChecksum(const Message& message) {
@@ -284,7 +284,8 @@ void OpMsgBuilder::finishDocumentStream(DocSequenceBuilder* docSequenceBuilder)
     invariant(_state == kDocSequence);
     invariant(_openBuilder);
     _openBuilder = false;
-    const int32_t size = _buf.len() - docSequenceBuilder->_sizeOffset;
+    const int32_t size = _buf.len() - docSequenceBuilder->_sizeOffset +
+        splicedBytesWithin(docSequenceBuilder->_sizeOffset, _buf.len());
     invariant(size > 0);
     DataView(_buf.buf()).write<LittleEndian<int32_t>>(size, docSequenceBuilder->_sizeOffset);
 }
@@ -304,10 +305,46 @@ BSONObjBuilder OpMsgBuilder::resumeBody() {
     return BSONObjBuilder(BSONObjBuilder::ResumeBuildingTag(), _buf, _bodyStart);
 }
 
+void OpMsgBuilder::splice(const BSONObj& obj) {
+    invariant(canSplice(obj));
+    invariant(_state == kDocSequence || _state == kBody);
+    _fragments.push_back({static_cast<std::size_t>(_buf.len()),
+                          obj.sharedBuffer(),
+                          obj.objdata(),
+                          static_cast<std::size_t>(obj.objsize())});
+    _splicedBytes += obj.objsize();
+}
+
+int OpMsgBuilder::splicedBytesWithin(std::size_t begin, std::size_t end) const {
+    int bytes = 0;
+    for (const auto& fragment : _fragments) {
+        if (fragment.offset > begin && fragment.offset <= end) {
+            bytes += fragment.size;
+        }
+    }
+    return bytes;
+}
+
+void OpMsgBuilder::fixupSplicedObjectSizes() {
+    // The builders that wrote these sizes only saw the bytes in _buf, and the objects nest, so work
+    // out every new size from the physical ones before writing any of them back.
+    _splicedObjectOffsets.push_back(_bodyStart);
+    std::vector<int32_t> sizes;
+    sizes.reserve(_splicedObjectOffsets.size());
+    for (auto offset : _splicedObjectOffsets) {
+        const int32_t physicalSize = DataView(_buf.buf()).read<LittleEndian<int32_t>>(offset);
+        // Spliced documents always come before the object's EOO byte.
+        sizes.push_back(physicalSize + splicedBytesWithin(offset, offset + physicalSize - 1));
+    }
+    for (std::size_t i = 0; i < sizes.size(); ++i) {
+        DataView(_buf.buf()).write<LittleEndian<int32_t>>(sizes[i], _splicedObjectOffsets[i]);
+    }
+}
+
 AtomicWord<bool> OpMsgBuilder::disableDupeFieldCheck_forTest{false};
 
 Message OpMsgBuilder::finish() {
-    const auto size = _buf.len();
+    const auto size = _buf.len() + _splicedBytes;
     uassert(ErrorCodes::BSONObjectTooLarge,
             str::stream() << "BSON size limit hit while building Message. Size: " << size << " (0x"
                           << integerToHex(size) << "); maxSize: " << BSONObjMaxInternalSize << "("
@@ -336,13 +373,20 @@ Message OpMsgBuilder::finishWithoutSizeChecking() {
     invariant(!_openBuilder);
     _state = kDone;
 
-    const auto size = _buf.len();
+    if (!_fragments.empty()) {
+        fixupSplicedObjectSizes();
+    }
+
+    const auto size = _buf.len() + _splicedBytes;
     MSGHEADER::View header(_buf.buf());
     header.setMessageLength(size);
     // header.setRequestMsgId(...); // These are currently filled in by the networking layer.
     // header.setResponseToMsgId(...);
     header.setOpCode(dbMsg);
-    return Message(_buf.release());
+    if (_fragments.empty()) {
+        return Message(_buf.release());
+    }
+    return Message(_buf.release(), std::move(_fragments));
 }
 
 BSONObj OpMsgBuilder::releaseBody() {
@@ -350,6 +394,7 @@ BSONObj OpMsgBuilder::releaseBody() {
     invariant(_bodyStart);
     invariant(_bodyStart == sizeof(MSGHEADER::Layout) + 4 /*flags*/ + 1 /*body kind byte*/);
     invariant(!_openBuilder);
+    invariant(_fragments.empty());
     _state = kDone;
 
     auto bson = BSONObj(_buf.buf() + _bodyStart);
@@ -253,7 +253,8 @@ public:
     Message finishWithoutSizeChecking();
 
     /**
-     * Reset this object to its initial empty state. All previously appended data is lost.
+     * Reset this object to its initial empty state. All previously appended data is lost. Whether
+     * splicing is allowed is kept.
      */
     void reset() {
         invariant(!_openBuilder);
@@ -263,6 +264,55 @@ public:
         _bodyStart = 0;
         _state = kEmpty;
         _openBuilder = false;
+        _fragments.clear();
+        _splicedObjectOffsets.clear();
+        _splicedBytes = 0;
+    }
+
+    /**
+     * Documents at least this large are spliced rather than copied when splicing is allowed.
+     * Smaller ones are cheaper to copy than to write from their own buffer.
+     */
+    static constexpr int kMinSplicedDocumentBytes = 16 * 1024;
+
+    /**
+     * Allows splice() to reference documents rather than copy them into the message. Only allow
+     * this when the finished Message goes straight to the network: until finish(), spliced bytes
+     * are missing from the builder's own buffer, so the body must not be read below its top-level
+     * fields, and releaseBody() is illegal once anything has been spliced.
+     */
+    void setAllowSplicing(bool allowSplicing) {
+        _allowSplicing = allowSplicing;
+    }
+    bool allowsSplicing() const {
+        return _allowSplicing;
+    }
+
+    /**
+     * Returns true if splice() may be used for 'obj': splicing is allowed and 'obj' is an owned
+     * document of at least kMinSplicedDocumentBytes.
+     */
+    bool canSplice(const BSONObj& obj) const {
+        return _allowSplicing && obj.isOwned() && obj.objsize() >= kMinSplicedDocumentBytes;
+    }
+
+    /**
+     * Appends 'obj' to the section being built by reference, keeping its buffer alive until the
+     * Message is destroyed. The caller writes any bytes that precede it, such as the element type
+     * and field name inside an array. If 'obj' lands inside the body, the offset of every enclosing
+     * object other than the body itself must be passed to trackSplicedObject() so that finish()
+     * can count the spliced bytes in their sizes.
+     */
+    void splice(const BSONObj& obj);
+    void trackSplicedObject(std::size_t offset) {
+        _splicedObjectOffsets.push_back(offset);
+    }
+
+    /**
+     * Returns the number of bytes spliced into the message so far.
+     */
+    int splicedBytes() const {
+        return _splicedBytes;
     }
 
     /**
@@ -304,6 +354,16 @@ private:
 
     void finishDocumentStream(DocSequenceBuilder* docSequenceBuilder);
 
+    /**
+     * Returns the number of bytes spliced in after 'begin' and no later than 'end'.
+     */
+    int splicedBytesWithin(std::size_t begin, std::size_t end) const;
+
+    /**
+     * Adds the spliced bytes to the sizes of the body and every tracked object within it.
+     */
+    void fixupSplicedObjectSizes();
+
     void skipHeaderAndFlags() {
         _buf.skip(sizeof(MSGHEADER::Layout));  // This is filled in by finish().
         _buf.appendNum(uint32_t(0));           // flags (currently always 0).
@@ -314,6 +374,10 @@ private:
     int _bodyStart = 0;
     State _state = kEmpty;
     bool _openBuilder = false;
+    bool _allowSplicing = false;
+    std::vector<Message::Fragment> _fragments;
+    std::vector<std::size_t> _splicedObjectOffsets;
+    int _splicedBytes = 0;
 };
 
 /**
@@ -373,7 +437,7 @@ public:
     }
 
     int len() const {
-        return _buf->len();
+        return _buf->len() + _msgBuilder->splicedBytes();
     }
 
 private:
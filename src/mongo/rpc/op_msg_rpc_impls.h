@@ -78,6 +78,9 @@ public:
     void reserveBytes(const std::size_t bytes) override {
         _builder.reserveBytes(bytes);
     }
+    OpMsgBuilder* getOpMsgBuilder() override {
+        return &_builder;
+    }
     BSONObj releaseBody() {
         return _builder.releaseBody();
     }
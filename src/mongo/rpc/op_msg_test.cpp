@@ -876,6 +876,79 @@ TEST(OpMsgSerializer, SetFlagWorks) {
     }
 }
 
+BSONObj makeSpliceableDoc(int id) {
+    return BSON("_id" << id << "pad"
+                      << std::string(OpMsgBuilder::kMinSplicedDocumentBytes, 'x'));
+}
+
+TEST(OpMsgSerializer, SplicedSequenceMatchesCopiedSequence) {
+    const auto small = fromjson("{a: 1}");
+    const auto large = makeSpliceableDoc(2);
+
+    OpMsgBuilder builder;
+    builder.setAllowSplicing(true);
+    {
+        auto docSeq = builder.beginDocSequence("docs");
+        docSeq.append(small);
+        ASSERT(builder.canSplice(large));
+        const auto lenBeforeSplice = docSeq.len();
+        builder.splice(large);
+        ASSERT_EQ(docSeq.len(), lenBeforeSplice + large.objsize());
+        docSeq.append(small);
+    }
+    builder.beginBody().append("ok", 1);
+    auto msg = builder.finish();
+
+    // The large document is written from its own buffer rather than copied.
+    ASSERT(msg.isFragmented());
+    size_t totalLength = 0;
+    bool foundLarge = false;
+    for (const auto& range : msg.dataRanges()) {
+        totalLength += range.length();
+        foundLarge |= range.data() == large.objdata();
+    }
+    ASSERT_EQ(totalLength, static_cast<size_t>(msg.size()));
+    ASSERT(foundLarge);
+
+    // Flags are read and written without flattening the message.
+    OpMsg::setFlag(&msg, OpMsg::kMoreToCome);
+    ASSERT(OpMsg::isFlagSet(msg, OpMsg::kMoreToCome));
+    ASSERT(msg.isFragmented());
+    OpMsg::clearFlag(&msg, OpMsg::kMoreToCome);
+
+    testSerializer(msg,
+                   OpMsgBytes{
+                       kNoFlags,  //
+                       kDocSequenceSection,
+                       Sized{
+                           "docs",  //
+                           small,
+                           large,
+                           small,
+                       },
+
+                       kBodySection,
+                       fromjson("{ok: 1}"),
+                   });
+    ASSERT_FALSE(msg.isFragmented());
+}
+
+TEST(OpMsgSerializer, OnlySplicesLargeOwnedDocumentsWhenAllowed) {
+    const auto large = makeSpliceableDoc(1);
+
+    OpMsgBuilder builder;
+    ASSERT_FALSE(builder.canSplice(large));
+
+    builder.setAllowSplicing(true);
+    ASSERT(builder.canSplice(large));
+    ASSERT_FALSE(builder.canSplice(fromjson("{a: 1}")));
+    ASSERT_FALSE(builder.canSplice(BSONObj(large.objdata())));
+
+    // Resetting the builder keeps splicing allowed.
+    builder.reset();
+    ASSERT(builder.canSplice(large));
+}
+
 TEST(OpMsgRequest, GetDatabaseWorks) {
     OpMsgRequest msg;
     msg.body = fromjson("{$db: 'foo'}");
@@ -205,5 +205,11 @@ Status validateWireVersion(const WireVersionInfo client, const WireVersionInfo s
     return Status::OK();
 }
 
+void negotiateRequestMultiplexing(const BSONObj& isMasterRequest, BSONObjBuilder* isMasterReply) {
+    if (isMasterRequest[kRequestMultiplexingFieldName].trueValue()) {
+        isMasterReply->append(kRequestMultiplexingFieldName, true);
+    }
+}
+
 }  // namespace rpc
 }  // namespace mongo
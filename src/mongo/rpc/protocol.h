@@ -34,14 +34,23 @@
 #include <type_traits>
 
 #include "mongo/base/status_with.h"
+#include "mongo/base/string_data.h"
 #include "mongo/db/wire_version.h"
 #include "mongo/rpc/message.h"
 
 namespace mongo {
 class BSONObj;
+class BSONObjBuilder;
 class OperationContext;
 namespace rpc {
 
+/**
+ * The isMaster field with which a client asks to send requests on its connection without waiting
+ * for the replies to earlier ones, and with which the server agrees to. The server still runs the
+ * requests one at a time, in the order they arrive, and replies to each by its request id.
+ */
+constexpr StringData kRequestMultiplexingFieldName = "requestMultiplexing"_sd;
+
 /**
  * Bit flags representing support for a particular RPC protocol.
  * This is just an internal representation, and is never transmitted over the wire. It should
@@ -137,5 +146,10 @@ StatusWith<ProtocolSetAndWireVersionInfo> parseProtocolSetFromIsMasterReply(
  */
 ProtocolSet computeProtocolSet(const WireVersionInfo version);
 
+/**
+ * Agrees to request multiplexing in an isMaster reply if the isMaster request asked for it.
+ */
+void negotiateRequestMultiplexing(const BSONObj& isMasterRequest, BSONObjBuilder* isMasterReply);
+
 }  // namespace rpc
 }  // namespace mongo
@@ -138,6 +138,15 @@ public:
      */
     virtual void reserveBytes(const std::size_t bytes) = 0;
 
+    /**
+     * Returns the OpMsgBuilder this reply is built in, or nullptr if the reply is not an OP_MSG.
+     * Lets callers splice large documents into the reply rather than copy them; see
+     * OpMsgBuilder::splice().
+     */
+    virtual OpMsgBuilder* getOpMsgBuilder() {
+        return nullptr;
+    }
+
     /**
      * For exhaust commands, returns whether the command should be run again.
      */
@@ -37,6 +37,9 @@
 #include <memory>
 
 #include "mongo/client/remote_command_targeter.h"
+#include "mongo/client/sdam/server_selector.h"
+#include "mongo/db/commands/server_status_metric.h"
+#include "mongo/db/repl/read_concern_args.h"
 #include "mongo/executor/remote_command_request.h"
 #include "mongo/logv2/log.h"
 #include "mongo/rpc/get_status_from_command_result.h"
@@ -57,6 +60,49 @@ namespace {
 // Maximum number of retries for network and replication notMaster errors (per host).
 const int kMaxNumFailedHostRetryAttempts = 3;
 
+// How often server selection avoided sending a read with a minOpTime to a member which would have
+// had to catch up first, versus how often the selected member had not reached it.
+ServerStatusMetricField<Counter64> displayMinOpTimeWaitsAvoided(
+    "serverSelection.minOpTime.waitsAvoided", &sdam::gMinOpTimeSelectionStats.waitsAvoided);
+ServerStatusMetricField<Counter64> displayMinOpTimeWaitsNotAvoided(
+    "serverSelection.minOpTime.waitsNotAvoided", &sdam::gMinOpTimeSelectionStats.waitsNotAvoided);
+
+/**
+ * Returns the afterClusterTime of a causally consistent read which may run on a secondary, unless
+ * the caller already chose a minOpTime.
+ */
+boost::optional<LogicalTime> getCausalReadTime(OperationContext* opCtx,
+                                               const ReadPreferenceSetting& readPref) {
+    if (readPref.pref == ReadPreference::PrimaryOnly || !readPref.minOpTime.isNull()) {
+        return boost::none;
+    }
+    return repl::ReadConcernArgs::get(opCtx).getArgsAfterClusterTime();
+}
+
+/**
+ * The afterClusterTime is cluster-wide and often ahead of anything an idle shard has written, so
+ * no member of that shard would meet it as a minOpTime. Instead, server selection prefers members
+ * which have applied the latest opTime the shard has reported to this node, or the
+ * afterClusterTime if that is earlier, and falls back to any eligible member when none has. The
+ * term is left uninitialized so that only the timestamps are compared.
+ */
+ReadPreferenceSetting withCausalMinOpTime(ReadPreferenceSetting readPref,
+                                          const boost::optional<LogicalTime>& causalReadTime,
+                                          const Shard& shard) {
+    if (!causalReadTime) {
+        return readPref;
+    }
+
+    const auto shardOpTime = shard.getLastCommittedOpTime();
+    if (shardOpTime == LogicalTime::kUninitialized) {
+        return readPref;
+    }
+
+    readPref.minOpTime = repl::OpTime(std::min(*causalReadTime, shardOpTime).asTimestamp(),
+                                      repl::OpTime::kUninitializedTerm);
+    return readPref;
+}
+
 }  // namespace
 
 AsyncRequestsSender::AsyncRequestsSender(OperationContext* opCtx,
@@ -68,6 +114,7 @@ AsyncRequestsSender::AsyncRequestsSender(OperationContext* opCtx,
     : _opCtx(opCtx),
       _db(dbName.toString()),
       _readPreference(readPreference),
+      _causalReadTime(getCausalReadTime(opCtx, readPreference)),
       _retryPolicy(retryPolicy),
       _subExecutor(std::move(executor)),
       _subBaton(opCtx->getBaton()->makeSubBaton()) {
@@ -177,7 +224,8 @@ SemiFuture<std::vector<HostAndPort>> AsyncRequestsSender::RemoteData::resolveSha
                       str::stream() << "Could not find shard " << _shardId);
     }
 
-    return shard->getTargeter()->findHostsWithMaxWait(readPref, Seconds(20));
+    return shard->getTargeter()->findHostsWithMaxWait(
+        withCausalMinOpTime(readPref, _ars->_causalReadTime, *shard), Seconds(20));
 }
 
 auto AsyncRequestsSender::RemoteData::scheduleRemoteCommand(std::vector<HostAndPort>&& hostAndPorts)
@@ -264,6 +264,10 @@ private:
     // The readPreference to use for all requests.
     ReadPreferenceSetting _readPreference;
 
+    // The afterClusterTime of a causally consistent read which may run on a secondary. Each
+    // request turns it into a minOpTime for its own shard.
+    const boost::optional<LogicalTime> _causalReadTime;
+
     // The policy to use when deciding whether to retry on an error.
     Shard::RetryPolicy _retryPolicy;
 
@@ -984,6 +984,11 @@ DbResponse Strategy::queryOp(OperationContext* opCtx, const NamespaceString& nss
 
 DbResponse Strategy::clientCommand(OperationContext* opCtx, const Message& m) {
     auto reply = rpc::makeReplyBuilder(rpc::protocolForMessage(m));
+    if (auto opMsgBuilder = reply->getOpMsgBuilder()) {
+        // Documents from shard replies are owned, so large ones can be spliced into our reply
+        // rather than copied.
+        opMsgBuilder->setAllowSplicing(true);
+    }
     BSONObjBuilder errorBuilder;
 
     bool propagateException = false;
@@ -85,7 +85,8 @@ protected:
                            const BSONObj& cmdObj,
                            const BSONObj& rspObj,
                            const bool hedge,
-                           const int maxTimeMSForHedgedReads = kMaxTimeMSForHedgedReadsDefault) {
+                           const int maxTimeMSForHedgedReads = kMaxTimeMSForHedgedReadsDefault,
+                           const int delayPercentile = kReadHedgingDelayPercentileDefault) {
         setParameters(serverParameters);
 
         auto readPref = uassertStatusOK(ReadPreferenceSetting::fromInnerBSON(rspObj));
@@ -94,6 +95,7 @@ protected:
         if (hedge) {
             ASSERT_TRUE(hedgeOptions.has_value());
             ASSERT_EQ(hedgeOptions->maxTimeMSForHedgedReads, maxTimeMSForHedgedReads);
+            ASSERT_EQ(hedgeOptions->delayPercentile, delayPercentile);
         } else {
             ASSERT_FALSE(hedgeOptions.has_value());
         }
@@ -108,10 +110,15 @@ protected:
     static inline const std::string kReadHedgingModeFieldName = "readHedgingMode";
     static inline const std::string kMaxTimeMSForHedgedReadsFieldName = "maxTimeMSForHedgedReads";
     static inline const int kMaxTimeMSForHedgedReadsDefault = 10;
+    static inline const std::string kReadHedgingDelayPercentileFieldName =
+        "readHedgingDelayPercentile";
+    static inline const int kReadHedgingDelayPercentileDefault = 95;
 
     static inline const BSONObj kDefaultParameters =
         BSON(kReadHedgingModeFieldName << "on" << kMaxTimeMSForHedgedReadsFieldName
-                                       << kMaxTimeMSForHedgedReadsDefault);
+                                       << kMaxTimeMSForHedgedReadsDefault
+                                       << kReadHedgingDelayPercentileFieldName
+                                       << kReadHedgingDelayPercentileDefault);
 
 private:
     ServiceContext::UniqueServiceContext _serviceCtx = ServiceContext::make();
@@ -206,5 +213,17 @@ TEST_F(HedgeOptionsUtilTestFixture, MaxTimeMSForHedgedReads) {
     checkHedgeOptions(parameters, cmdObj, rspObj, true, 100);
 }
 
+TEST_F(HedgeOptionsUtilTestFixture, ReadHedgingDelayPercentile) {
+    const auto parameters =
+        BSON(kReadHedgingModeFieldName << "on" << kReadHedgingDelayPercentileFieldName << 0);
+    const auto cmdObj = BSON("find" << kCollName);
+    const auto rspObj = BSON("mode"
+                             << "nearest"
+                             << "hedge" << BSONObj());
+
+    checkHedgeOptions(
+        parameters, cmdObj, rspObj, true, kMaxTimeMSForHedgedReadsDefault, /*delayPercentile*/ 0);
+}
+
 }  // namespace
 }  // namespace mongo
@@ -33,6 +33,8 @@
 
 #include "mongo/s/query/async_results_merger.h"
 
+#include <cmath>
+
 #include "mongo/bson/simple_bsonobj_comparator.h"
 #include "mongo/client/remote_command_targeter.h"
 #include "mongo/db/pipeline/change_stream_constants.h"
@@ -41,6 +43,7 @@
 #include "mongo/db/query/killcursors_request.h"
 #include "mongo/executor/remote_command_request.h"
 #include "mongo/executor/remote_command_response.h"
+#include "mongo/s/query/cluster_query_knobs_gen.h"
 #include "mongo/util/assert_util.h"
 
 namespace mongo {
@@ -53,6 +56,15 @@ namespace {
 // Maximum number of retries for network and replication notMaster errors (per host).
 const int kMaxNumFailedHostRetryAttempts = 3;
 
+// When sizing getMores for a sorted merge with a limit, each remote is asked for this multiple of
+// its expected share of the remaining results, so that a remote which is contributing slightly more
+// than its history suggests does not need an extra round trip.
+const double kAdaptiveBatchSizeSlackFactor = 2.0;
+
+// The smallest batchSize that adaptive sizing will request from a remote, so that remotes which
+// have contributed few results so far are not starved into many tiny round trips.
+const long long kMinAdaptiveBatchSize = 16;
+
 /**
  * Returns the sort key out of the $sortKey metadata field in 'obj'. The sort key should be
  * formatted as an array with one value per field of the sort pattern:
@@ -104,8 +116,15 @@ AsyncResultsMerger::AsyncResultsMerger(OperationContext* opCtx,
       // since that is not supported we treat boost::none (unspecified) to mean 'kNormal'.
       _tailableMode(params.getTailableMode().value_or(TailableModeEnum::kNormal)),
       _params(std::move(params)),
-      _mergeQueue(MergingComparator(
-          _remotes, _params.getSort().value_or(BSONObj()), _params.getCompareWholeSortKey())),
+      _sortKeyOrdering(_params.getSort() &&
+                               static_cast<size_t>(_params.getSort()->nFields()) <=
+                                   Ordering::kMaxCompoundIndexKeys
+                           ? boost::make_optional(Ordering::make(*_params.getSort()))
+                           : boost::none),
+      _mergeQueue(MergingComparator(_remotes,
+                                    _params.getSort().value_or(BSONObj()),
+                                    _params.getCompareWholeSortKey(),
+                                    _sortKeyOrdering.is_initialized())),
       _promisedMinSortKeys(PromisedMinSortKeyComparator(_params.getSort().value_or(BSONObj()))) {
     if (params.getTxnNumber()) {
         invariant(params.getSessionId());
@@ -334,7 +353,20 @@ StatusWith<ClusterQueryResult> AsyncResultsMerger::nextReady() {
     return _params.getSort() ? _nextReadySorted(lk) : _nextReadyUnsorted(lk);
 }
 
-ClusterQueryResult AsyncResultsMerger::_nextReadySorted(WithLock) {
+ClusterQueryResult AsyncResultsMerger::_popNextResult(WithLock, size_t remoteIndex) {
+    auto& remote = _remotes[remoteIndex];
+    ClusterQueryResult front = std::move(remote.docBuffer.front());
+    remote.docBuffer.pop();
+    if (!remote.sortKeyBuffer.empty()) {
+        remote.sortKeyBuffer.pop();
+    }
+
+    ++remote.numReturned;
+    ++_numReturned;
+    return front;
+}
+
+ClusterQueryResult AsyncResultsMerger::_nextReadySorted(WithLock lk) {
     // Tailable non-awaitData cursors cannot have a sort.
     invariant(_tailableMode != TailableModeEnum::kTailable);
 
@@ -348,8 +380,7 @@ ClusterQueryResult AsyncResultsMerger::_nextReadySorted(WithLock) {
     invariant(!_remotes[smallestRemote].docBuffer.empty());
     invariant(_remotes[smallestRemote].status.isOK());
 
-    ClusterQueryResult front = _remotes[smallestRemote].docBuffer.front();
-    _remotes[smallestRemote].docBuffer.pop();
+    ClusterQueryResult front = _popNextResult(lk, smallestRemote);
 
     // Re-populate the merging queue with the next result from 'smallestRemote', if it has a
     // next result.
@@ -357,6 +388,8 @@ ClusterQueryResult AsyncResultsMerger::_nextReadySorted(WithLock) {
         _mergeQueue.push(smallestRemote);
     }
 
+    _prefetchNextBatchIfNeeded(lk, smallestRemote);
+
     // For sorted tailable awaitData cursors, update the high water mark to the document's sort key.
     if (_tailableMode == TailableModeEnum::kTailableAndAwaitData) {
         _highWaterMark =
@@ -366,15 +399,14 @@ ClusterQueryResult AsyncResultsMerger::_nextReadySorted(WithLock) {
     return front;
 }
 
-ClusterQueryResult AsyncResultsMerger::_nextReadyUnsorted(WithLock) {
+ClusterQueryResult AsyncResultsMerger::_nextReadyUnsorted(WithLock lk) {
     size_t remotesAttempted = 0;
     while (remotesAttempted < _remotes.size()) {
         // It is illegal to call this method if there is an error received from any shard.
         invariant(_remotes[_gettingFromRemote].status.isOK());
 
         if (_remotes[_gettingFromRemote].hasNext()) {
-            ClusterQueryResult front = _remotes[_gettingFromRemote].docBuffer.front();
-            _remotes[_gettingFromRemote].docBuffer.pop();
+            ClusterQueryResult front = _popNextResult(lk, _gettingFromRemote);
 
             if (_tailableMode == TailableModeEnum::kTailable &&
                 !_remotes[_gettingFromRemote].hasNext()) {
@@ -384,6 +416,7 @@ ClusterQueryResult AsyncResultsMerger::_nextReadyUnsorted(WithLock) {
                 _eofNext = true;
             }
 
+            _prefetchNextBatchIfNeeded(lk, _gettingFromRemote);
             return front;
         }
 
@@ -397,11 +430,9 @@ ClusterQueryResult AsyncResultsMerger::_nextReadyUnsorted(WithLock) {
     return {};
 }
 
-Status AsyncResultsMerger::_askForNextBatch(WithLock, size_t remoteIndex) {
-    invariant(_opCtx, "Cannot schedule a getMore without an OperationContext");
-    auto& remote = _remotes[remoteIndex];
-
-    invariant(!remote.cbHandle.isValid());
+boost::optional<std::int64_t> AsyncResultsMerger::_getNextBatchSize(WithLock,
+                                                                    size_t remoteIndex) const {
+    const auto& remote = _remotes[remoteIndex];
 
     // If mongod returned less docs than the requested batchSize then modify the next getMore
     // request to fetch the remaining docs only. If the remote node has a plan with OR for top k and
@@ -412,9 +443,44 @@ Status AsyncResultsMerger::_askForNextBatch(WithLock, size_t remoteIndex) {
         adjustedBatchSize = *_params.getBatchSize() - remote.fetchedCount;
     }
 
+    // Tailable cursors pass each remote's batches through as they arrive, so a limit does not
+    // bound how much may be requested.
+    if (!_params.getLimit() || _tailableMode != TailableModeEnum::kNormal) {
+        return adjustedBatchSize;
+    }
+
+    // The merged stream will consume at most 'remaining' further results, so no remote ever needs
+    // to return more than that beyond what it already has buffered.
+    const long long remaining = std::max(
+        *_params.getLimit() - _numReturned - static_cast<long long>(remote.docBuffer.size()), 1LL);
+    long long target = remaining;
+
+    // For a sorted merge, the results consumed so far are a good predictor of how the remaining
+    // results will be distributed among the remotes. Add-one smoothing ensures that a remote which
+    // has not yet contributed is still asked for a reasonable batch.
+    if (_params.getSort() && _remotes.size() > 1 &&
+        internalQueryAdaptiveMergeGetMoreBatchSize.load()) {
+        const double share = static_cast<double>(remote.numReturned + 1) /
+            static_cast<double>(_numReturned + static_cast<long long>(_remotes.size()));
+        const double expected = std::ceil(share * remaining * kAdaptiveBatchSizeSlackFactor);
+        if (expected < static_cast<double>(remaining)) {
+            target = std::min(remaining,
+                              std::max(kMinAdaptiveBatchSize, static_cast<long long>(expected)));
+        }
+    }
+
+    return std::min<std::int64_t>(adjustedBatchSize.value_or(target), target);
+}
+
+Status AsyncResultsMerger::_askForNextBatch(WithLock lk, size_t remoteIndex) {
+    invariant(_opCtx, "Cannot schedule a getMore without an OperationContext");
+    auto& remote = _remotes[remoteIndex];
+
+    invariant(!remote.cbHandle.isValid());
+
     BSONObj cmdObj = GetMoreRequest(remote.cursorNss,
                                     remote.cursorId,
-                                    adjustedBatchSize,
+                                    _getNextBatchSize(lk, remoteIndex),
                                     _awaitDataTimeout,
                                     boost::none,
                                     boost::none)
@@ -456,6 +522,28 @@ Status AsyncResultsMerger::_askForNextBatch(WithLock, size_t remoteIndex) {
     return Status::OK();
 }
 
+void AsyncResultsMerger::_prefetchNextBatchIfNeeded(WithLock lk, size_t remoteIndex) {
+    auto& remote = _remotes[remoteIndex];
+    const long long threshold = internalQueryMergePrefetchThreshold.load();
+
+    // Batches from tailable cursors are passed through to the client as they arrive, so there is
+    // nothing to be gained by requesting them early.
+    if (threshold <= 0 || _tailableMode != TailableModeEnum::kNormal || !_opCtx ||
+        remote.exhausted() || remote.cbHandle.isValid() || !remote.status.isOK() ||
+        static_cast<long long>(remote.docBuffer.size()) >= threshold) {
+        return;
+    }
+
+    // Don't fetch anything further if the results already buffered from this remote are enough to
+    // satisfy the limit.
+    if (_params.getLimit() &&
+        _numReturned + static_cast<long long>(remote.docBuffer.size()) >= *_params.getLimit()) {
+        return;
+    }
+
+    remote.status = _askForNextBatch(lk, remoteIndex);
+}
+
 Status AsyncResultsMerger::scheduleGetMores() {
     stdx::lock_guard<Latch> lk(_mutex);
     return _scheduleGetMores(lk);
@@ -622,11 +710,12 @@ void AsyncResultsMerger::_cleanUpFailedBatch(WithLock lk, Status status, size_t
     // communicate that an error has occurred, but some other thread is responsible for returning
     // the error to the user. In order to avoid polluting the user's error message, we ignore such
     // errors with the expectation that all outstanding cursors will be closed promptly.
+    //
+    // Any results which were buffered before a prefetched batch failed are still returned, since
+    // they were retrieved successfully and are already accounted for in the merge queue.
     if (_params.getAllowPartialResults() || remote.status == ErrorCodes::ExchangePassthrough) {
-        // Clear the results buffer and cursor id, and set 'partialResultsReturned' if appropriate.
+        // Clear the cursor id, and set 'partialResultsReturned' if appropriate.
         remote.partialResultsReturned = (remote.status != ErrorCodes::ExchangePassthrough);
-        std::queue<ClusterQueryResult> emptyBuffer;
-        std::swap(remote.docBuffer, emptyBuffer);
         remote.status = Status::OK();
         remote.cursorId = 0;
     }
@@ -681,6 +770,9 @@ bool AsyncResultsMerger::_addBatchToBuffer(WithLock lk,
                                            size_t remoteIndex,
                                            const CursorResponse& response) {
     auto& remote = _remotes[remoteIndex];
+    // A prefetched batch may arrive while the remote still has buffered results, in which case the
+    // remote is already present in the merge queue.
+    const bool wasBufferEmpty = remote.docBuffer.empty();
     _updateRemoteMetadata(lk, remoteIndex, response);
     for (const auto& obj : response.getBatch()) {
         // If there's a sort, we're expecting the remote node to have given us back a sort key.
@@ -701,6 +793,14 @@ bool AsyncResultsMerger::_addBatchToBuffer(WithLock lk,
             }
         }
 
+        if (_sortKeyOrdering) {
+            remote.sortKeyBuffer.push(
+                KeyString::HeapBuilder(KeyString::Version::kLatestVersion,
+                                       extractSortKey(obj, _params.getCompareWholeSortKey()),
+                                       *_sortKeyOrdering)
+                    .release());
+        }
+
         ClusterQueryResult result(obj);
         remote.docBuffer.push(result);
         ++remote.fetchedCount;
@@ -708,7 +808,7 @@ bool AsyncResultsMerger::_addBatchToBuffer(WithLock lk,
 
     // If we're doing a sorted merge, then we have to make sure to put this remote onto the merge
     // queue.
-    if (_params.getSort() && !response.getBatch().empty()) {
+    if (_params.getSort() && wasBufferEmpty && !response.getBatch().empty()) {
         _mergeQueue.push(remoteIndex);
     }
     return true;
@@ -826,6 +926,10 @@ bool AsyncResultsMerger::RemoteCursorData::exhausted() const {
 //
 
 bool AsyncResultsMerger::MergingComparator::operator()(const size_t& lhs, const size_t& rhs) {
+    if (_compareKeyStrings) {
+        return _remotes[lhs].sortKeyBuffer.front().compare(_remotes[rhs].sortKeyBuffer.front()) > 0;
+    }
+
     const ClusterQueryResult& leftDoc = _remotes[lhs].docBuffer.front();
     const ClusterQueryResult& rightDoc = _remotes[rhs].docBuffer.front();
 
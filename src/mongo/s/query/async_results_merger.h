@@ -35,7 +35,9 @@
 
 #include "mongo/base/status_with.h"
 #include "mongo/bson/bsonobj.h"
+#include "mongo/bson/ordering.h"
 #include "mongo/db/cursor_id.h"
+#include "mongo/db/storage/key_string.h"
 #include "mongo/executor/task_executor.h"
 #include "mongo/platform/mutex.h"
 #include "mongo/s/query/async_results_merger_params_gen.h"
@@ -67,6 +69,13 @@ class CursorResponse;
  * This requires waiting until we have a response from every remote before returning results.
  * Without a sort, we are ready to return results as soon as we have *any* response from a remote.
  *
+ * When merging sorted streams, each result's sort key is encoded as a KeyString when it is
+ * buffered, so that the merge itself compares flat byte strings rather than walking BSON.
+ *
+ * If the params specify a limit, the ARM never asks a remote for more results than could still be
+ * consumed, and for sorted merges it further sizes each getMore by the share of the merged results
+ * that the remote has contributed so far.
+ *
  * On any error, the caller is responsible for shutting down the ARM using the kill() method.
  *
  * Does not throw exceptions.
@@ -305,6 +314,11 @@ private:
         // The buffer of results that have been retrieved but not yet returned to the caller.
         std::queue<ClusterQueryResult> docBuffer;
 
+        // The sort keys of the results in 'docBuffer', encoded as KeyStrings, in the same order.
+        // Only populated when merging sorted streams with a sort pattern that can be described by
+        // an Ordering.
+        std::queue<KeyString::Value> sortKeyBuffer;
+
         // Is valid if there is currently a pending request to this remote.
         executor::TaskExecutor::CallbackHandle cbHandle;
 
@@ -315,14 +329,22 @@ private:
         // Count of fetched docs during ARM processing of the current batch. Used to reduce the
         // batchSize in getMore when mongod returned less docs than the requested batchSize.
         long long fetchedCount = 0;
+
+        // Count of results from this remote which have been returned by the ARM. Used to estimate
+        // this remote's share of the merged stream when sizing getMore batches.
+        long long numReturned = 0;
     };
 
     class MergingComparator {
     public:
         MergingComparator(const std::vector<RemoteCursorData>& remotes,
                           const BSONObj& sort,
-                          bool compareWholeSortKey)
-            : _remotes(remotes), _sort(sort), _compareWholeSortKey(compareWholeSortKey) {}
+                          bool compareWholeSortKey,
+                          bool compareKeyStrings)
+            : _remotes(remotes),
+              _sort(sort),
+              _compareWholeSortKey(compareWholeSortKey),
+              _compareKeyStrings(compareKeyStrings) {}
 
         bool operator()(const size_t& lhs, const size_t& rhs);
 
@@ -335,6 +357,10 @@ private:
         // We extract the sort key {$sortKey: <value>}. The sort key pattern '_sort' is verified to
         // be {$sortKey: 1}.
         const bool _compareWholeSortKey;
+
+        // When '_compareKeyStrings' is true, results are ordered by the pre-encoded KeyStrings in
+        // each remote's 'sortKeyBuffer' rather than by their BSON sort keys.
+        const bool _compareKeyStrings;
     };
 
     using MinSortKeyRemoteIdPair = std::pair<BSONObj, size_t>;
@@ -369,6 +395,27 @@ private:
      */
     Status _askForNextBatch(WithLock, size_t remoteIndex);
 
+    /**
+     * Returns the batchSize to request in the next getMore sent to the remote at 'remoteIndex'.
+     * This is the configured batchSize, reduced if the remote returned fewer results than requested
+     * in its last batch, and bounded by the number of results which the ARM may still need if a
+     * limit is known.
+     */
+    boost::optional<std::int64_t> _getNextBatchSize(WithLock, size_t remoteIndex) const;
+
+    /**
+     * Schedules a getMore on the remote at 'remoteIndex' ahead of its buffer running dry, if
+     * prefetching is enabled and the remote's buffered results have fallen below the prefetch
+     * threshold. Any error in scheduling is recorded in the remote's status.
+     */
+    void _prefetchNextBatchIfNeeded(WithLock, size_t remoteIndex);
+
+    /**
+     * Removes and returns the front of the given remote's buffer, keeping its sort key buffer in
+     * step and recording that the result has been returned by the ARM.
+     */
+    ClusterQueryResult _popNextResult(WithLock, size_t remoteIndex);
+
     /**
      * Checks whether or not the remote cursors are all exhausted.
      */
@@ -463,6 +510,11 @@ private:
     TailableModeEnum _tailableMode;
     AsyncResultsMergerParams _params;
 
+    // The Ordering used to encode sort keys as KeyStrings. Unset if there is no sort, or if the
+    // sort pattern has too many fields to be described by an Ordering, in which case sort keys are
+    // compared as BSON.
+    boost::optional<Ordering> _sortKeyOrdering;
+
     // Must be acquired before accessing any data members (other than _params, which is read-only).
     mutable Mutex _mutex = MONGO_MAKE_LATCH("AsyncResultsMerger::_mutex");
 
@@ -477,6 +529,9 @@ private:
     // Used only if there is *not* a sort.
     size_t _gettingFromRemote = 0;
 
+    // The total number of results returned by nextReady(), not counting EOF markers.
+    long long _numReturned = 0;
+
     Status _status = Status::OK();
 
     executor::TaskExecutor::EventHandle _currentEvent;
@@ -0,0 +1,121 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+
+#include "mongo/db/query/cursor_response.h"
+#include "mongo/s/query/async_results_merger.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/str.h"
+
+namespace mongo {
+namespace {
+
+const NamespaceString kNss("test.coll");
+
+/**
+ * Generates the results of 'numRemotes' synthetic remotes, each of which returns 'docsPerRemote'
+ * documents. The values are interleaved across the remotes so that a sorted merge takes its next
+ * result from a different remote every time.
+ */
+std::vector<std::vector<BSONObj>> makeBatches(int numRemotes, int docsPerRemote, bool sorted) {
+    std::vector<std::vector<BSONObj>> batches(numRemotes);
+    for (int remote = 0; remote < numRemotes; ++remote) {
+        batches[remote].reserve(docsPerRemote);
+        for (int i = 0; i < docsPerRemote; ++i) {
+            const int value = i * numRemotes + remote;
+            BSONObjBuilder bob;
+            bob.append("_id", value);
+            bob.append("shard", remote);
+            bob.append("payload", "abcdefghijklmnopqrstuvwxyz");
+            if (sorted) {
+                bob.append(AsyncResultsMerger::kSortKeyField, BSON_ARRAY(value));
+            }
+            batches[remote].push_back(bob.obj());
+        }
+    }
+    return batches;
+}
+
+/**
+ * Makes an already-exhausted cursor for each batch, with the batch as its initial results, so that
+ * the merger can be driven without a network or task executor.
+ */
+std::vector<RemoteCursor> makeRemotes(const std::vector<std::vector<BSONObj>>& batches) {
+    std::vector<RemoteCursor> remotes;
+    remotes.reserve(batches.size());
+    for (size_t i = 0; i < batches.size(); ++i) {
+        RemoteCursor remote;
+        remote.setShardId(std::string(str::stream() << "shard" << i));
+        remote.setHostAndPort(HostAndPort("localhost", 20000 + static_cast<int>(i)));
+        remote.setCursorResponse(CursorResponse(kNss, CursorId(0), batches[i]));
+        remotes.push_back(std::move(remote));
+    }
+    return remotes;
+}
+
+void runMerge(benchmark::State& state, boost::optional<BSONObj> sort) {
+    const int numRemotes = state.range(0);
+    const int docsPerRemote = state.range(1);
+    const auto batches = makeBatches(numRemotes, docsPerRemote, sort.is_initialized());
+
+    for (auto keepRunning : state) {
+        AsyncResultsMergerParams params;
+        params.setNss(kNss);
+        params.setSort(sort);
+        params.setRemotes(makeRemotes(batches));
+
+        AsyncResultsMerger arm(nullptr, nullptr, std::move(params));
+        while (true) {
+            invariant(arm.ready());
+            auto next = uassertStatusOK(arm.nextReady());
+            if (next.isEOF()) {
+                break;
+            }
+            benchmark::DoNotOptimize(next);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * numRemotes * docsPerRemote);
+}
+
+void BM_MergeUnsorted(benchmark::State& state) {
+    runMerge(state, boost::none);
+}
+
+void BM_MergeSorted(benchmark::State& state) {
+    runMerge(state, BSON("_id" << 1));
+}
+
+BENCHMARK(BM_MergeUnsorted)->Args({2, 1000})->Args({8, 1000})->Args({64, 100})->Args({64, 1000});
+BENCHMARK(BM_MergeSorted)->Args({2, 1000})->Args({8, 1000})->Args({64, 100})->Args({64, 1000});
+
+}  // namespace
+}  // namespace mongo
@@ -41,9 +41,11 @@
 #include "mongo/db/query/query_request.h"
 #include "mongo/executor/task_executor.h"
 #include "mongo/s/client/shard_registry.h"
+#include "mongo/s/query/cluster_query_knobs_gen.h"
 #include "mongo/s/query/results_merger_test_fixture.h"
 #include "mongo/unittest/death_test.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 
@@ -1112,6 +1114,177 @@ TEST_F(AsyncResultsMergerTest, GetMoreBatchSizes) {
     ASSERT_TRUE(unittest::assertGet(arm->nextReady()).isEOF());
 }
 
+TEST_F(AsyncResultsMergerTest, GetMoreBatchSizeIsBoundedByLimit) {
+    std::vector<RemoteCursor> cursors;
+    std::vector<BSONObj> batch1 = {fromjson("{_id: 1}"), fromjson("{_id: 2}")};
+    cursors.push_back(makeRemoteCursor(
+        kTestShardIds[0], kTestShardHosts[0], CursorResponse(kTestNss, 1, batch1)));
+    auto params = makeARMParamsFromExistingCursors(std::move(cursors));
+    params.setLimit(5);
+    auto arm =
+        std::make_unique<AsyncResultsMerger>(operationContext(), executor(), std::move(params));
+
+    ASSERT_TRUE(arm->ready());
+    ASSERT_BSONOBJ_EQ(fromjson("{_id: 1}"), *unittest::assertGet(arm->nextReady()).getResult());
+    ASSERT_TRUE(arm->ready());
+    ASSERT_BSONOBJ_EQ(fromjson("{_id: 2}"), *unittest::assertGet(arm->nextReady()).getResult());
+    ASSERT_FALSE(arm->ready());
+
+    // Only three more results can be consumed, so the getMore should not ask for any more than
+    // that, even though no batchSize was specified.
+    auto readyEvent = unittest::assertGet(arm->nextEvent());
+    auto request = GetMoreRequest::parseFromBSON("anydbname", getNthPendingRequest(0).cmdObj);
+    ASSERT_OK(request.getStatus());
+    ASSERT_EQ(*request.getValue().batchSize, 3LL);
+
+    std::vector<CursorResponse> responses;
+    std::vector<BSONObj> batch2 = {fromjson("{_id: 3}"), fromjson("{_id: 4}"), fromjson("{_id: 5}")};
+    responses.emplace_back(kTestNss, CursorId(0), batch2);
+    scheduleNetworkResponses(std::move(responses));
+    executor()->waitForEvent(readyEvent);
+
+    for (int i = 3; i <= 5; ++i) {
+        ASSERT_TRUE(arm->ready());
+        ASSERT_BSONOBJ_EQ(BSON("_id" << i), *unittest::assertGet(arm->nextReady()).getResult());
+    }
+    ASSERT_TRUE(arm->ready());
+    ASSERT_TRUE(unittest::assertGet(arm->nextReady()).isEOF());
+}
+
+TEST_F(AsyncResultsMergerTest, SortedGetMoreBatchSizeReflectsRemoteContribution) {
+    BSONObj findCmd = fromjson("{find: 'testcoll', sort: {_id: 1}}");
+
+    // The first remote contributes nearly all of the initial results, while the second remote
+    // contributes only two of them.
+    std::vector<BSONObj> batch0;
+    for (int i = 1; i <= 29; ++i) {
+        batch0.push_back(BSON("$sortKey" << BSON_ARRAY(i)));
+    }
+    batch0.push_back(BSON("$sortKey" << BSON_ARRAY(31)));
+    std::vector<BSONObj> batch1 = {fromjson("{$sortKey: [0]}"), fromjson("{$sortKey: [30]}")};
+
+    std::vector<RemoteCursor> cursors;
+    cursors.push_back(makeRemoteCursor(
+        kTestShardIds[0], kTestShardHosts[0], CursorResponse(kTestNss, 1, batch0)));
+    cursors.push_back(makeRemoteCursor(
+        kTestShardIds[1], kTestShardHosts[1], CursorResponse(kTestNss, 2, batch1)));
+    auto params = makeARMParamsFromExistingCursors(std::move(cursors), findCmd);
+    params.setLimit(1000);
+    auto arm =
+        std::make_unique<AsyncResultsMerger>(operationContext(), executor(), std::move(params));
+
+    for (int i = 0; i <= 30; ++i) {
+        ASSERT_TRUE(arm->ready());
+        ASSERT_BSONOBJ_EQ(BSON("$sortKey" << BSON_ARRAY(i)),
+                          *unittest::assertGet(arm->nextReady()).getResult());
+    }
+    ASSERT_FALSE(arm->ready());
+
+    // The second remote has contributed 2 of the 31 results returned so far. It is asked for twice
+    // its smoothed share, (2 + 1) / (31 + 2), of the 969 results which may still be consumed,
+    // rather than all of them.
+    auto readyEvent = unittest::assertGet(arm->nextEvent());
+    auto request = GetMoreRequest::parseFromBSON("anydbname", getNthPendingRequest(0).cmdObj);
+    ASSERT_OK(request.getStatus());
+    ASSERT_EQ(request.getValue().cursorid, 2LL);
+    ASSERT_EQ(*request.getValue().batchSize, 177LL);
+
+    std::vector<CursorResponse> responses;
+    std::vector<BSONObj> batch2 = {fromjson("{$sortKey: [32]}")};
+    responses.emplace_back(kTestNss, CursorId(0), batch2);
+    scheduleNetworkResponses(std::move(responses));
+    executor()->waitForEvent(readyEvent);
+
+    ASSERT_TRUE(arm->ready());
+    ASSERT_BSONOBJ_EQ(fromjson("{$sortKey: [31]}"),
+                      *unittest::assertGet(arm->nextReady()).getResult());
+
+    auto killEvent = arm->kill(operationContext());
+    executor()->waitForEvent(killEvent);
+}
+
+TEST_F(AsyncResultsMergerTest, PrefetchesNextBatchBelowThreshold) {
+    internalQueryMergePrefetchThreshold.store(2);
+    ON_BLOCK_EXIT([] { internalQueryMergePrefetchThreshold.store(0); });
+
+    std::vector<RemoteCursor> cursors;
+    std::vector<BSONObj> batch1 = {fromjson("{_id: 1}"), fromjson("{_id: 2}"), fromjson("{_id: 3}")};
+    cursors.push_back(makeRemoteCursor(
+        kTestShardIds[0], kTestShardHosts[0], CursorResponse(kTestNss, 1, batch1)));
+    auto arm = makeARMFromExistingCursors(std::move(cursors));
+
+    ASSERT_TRUE(arm->ready());
+    ASSERT_BSONOBJ_EQ(fromjson("{_id: 1}"), *unittest::assertGet(arm->nextReady()).getResult());
+    ASSERT_FALSE(networkHasReadyRequests());
+
+    // Once fewer than two results remain buffered, the next batch is requested while the buffered
+    // result can still be returned.
+    ASSERT_TRUE(arm->ready());
+    ASSERT_BSONOBJ_EQ(fromjson("{_id: 2}"), *unittest::assertGet(arm->nextReady()).getResult());
+    ASSERT_TRUE(networkHasReadyRequests());
+    ASSERT_TRUE(arm->ready());
+
+    std::vector<CursorResponse> responses;
+    std::vector<BSONObj> batch2 = {fromjson("{_id: 4}")};
+    responses.emplace_back(kTestNss, CursorId(0), batch2);
+    scheduleNetworkResponses(std::move(responses));
+
+    for (int i = 3; i <= 4; ++i) {
+        ASSERT_TRUE(arm->ready());
+        ASSERT_BSONOBJ_EQ(BSON("_id" << i), *unittest::assertGet(arm->nextReady()).getResult());
+    }
+    ASSERT_TRUE(arm->ready());
+    ASSERT_TRUE(unittest::assertGet(arm->nextReady()).isEOF());
+}
+
+TEST_F(AsyncResultsMergerTest, SortedMergeOfPrefetchedBatches) {
+    internalQueryMergePrefetchThreshold.store(2);
+    ON_BLOCK_EXIT([] { internalQueryMergePrefetchThreshold.store(0); });
+
+    BSONObj findCmd = fromjson("{find: 'testcoll', sort: {_id: 1}}");
+    std::vector<RemoteCursor> cursors;
+    std::vector<BSONObj> batch0 = {
+        fromjson("{$sortKey: [1]}"), fromjson("{$sortKey: [3]}"), fromjson("{$sortKey: [5]}")};
+    std::vector<BSONObj> batch1 = {
+        fromjson("{$sortKey: [2]}"), fromjson("{$sortKey: [4]}"), fromjson("{$sortKey: [6]}")};
+    cursors.push_back(makeRemoteCursor(
+        kTestShardIds[0], kTestShardHosts[0], CursorResponse(kTestNss, 1, batch0)));
+    cursors.push_back(makeRemoteCursor(
+        kTestShardIds[1], kTestShardHosts[1], CursorResponse(kTestNss, 2, batch1)));
+    auto arm = makeARMFromExistingCursors(std::move(cursors), findCmd);
+
+    for (int i = 1; i <= 3; ++i) {
+        ASSERT_TRUE(arm->ready());
+        ASSERT_BSONOBJ_EQ(BSON("$sortKey" << BSON_ARRAY(i)),
+                          *unittest::assertGet(arm->nextReady()).getResult());
+    }
+
+    // The first remote's next batch arrives while it still has a result buffered.
+    std::vector<CursorResponse> responses;
+    std::vector<BSONObj> batch2 = {fromjson("{$sortKey: [7]}")};
+    responses.emplace_back(kTestNss, CursorId(0), batch2);
+    scheduleNetworkResponses(std::move(responses));
+
+    ASSERT_TRUE(arm->ready());
+    ASSERT_BSONOBJ_EQ(fromjson("{$sortKey: [4]}"),
+                      *unittest::assertGet(arm->nextReady()).getResult());
+
+    // Likewise for the second remote.
+    responses.clear();
+    std::vector<BSONObj> batch3 = {fromjson("{$sortKey: [8]}")};
+    responses.emplace_back(kTestNss, CursorId(0), batch3);
+    scheduleNetworkResponses(std::move(responses));
+
+    // Each result is returned exactly once, in order.
+    for (int i = 5; i <= 8; ++i) {
+        ASSERT_TRUE(arm->ready());
+        ASSERT_BSONOBJ_EQ(BSON("$sortKey" << BSON_ARRAY(i)),
+                          *unittest::assertGet(arm->nextReady()).getResult());
+    }
+    ASSERT_TRUE(arm->ready());
+    ASSERT_TRUE(unittest::assertGet(arm->nextReady()).isEOF());
+}
+
 TEST_F(AsyncResultsMergerTest, AllowPartialResults) {
     BSONObj findCmd = fromjson("{find: 'testcoll', allowPartialResults: true}");
     std::vector<RemoteCursor> cursors;
@@ -85,6 +85,11 @@ struct ClusterClientCursorParams {
         armParams.setRemotes(std::move(remotes));
         armParams.setTailableMode(tailableMode);
         armParams.setBatchSize(batchSize);
+        // The results skipped on the router are still consumed from the merged stream. The sum has
+        // already been checked for overflow when the query was transformed for the shards.
+        if (limit) {
+            armParams.setLimit(*limit + skipToApplyOnRouter.value_or(0));
+        }
         armParams.setNss(nsString);
         armParams.setAllowPartialResults(isAllowPartialResults);
 
@@ -195,6 +195,8 @@ Status initializeGlobalShardingState(OperationContext* opCtx,
     connPoolOptions.controllerFactory = []() noexcept {
         return std::make_shared<ShardingTaskExecutorPoolController>();
     };
+    connPoolOptions.maxMultiplexedRequests =
+        ShardingTaskExecutorPoolController::gParameters.maxMultiplexedRequests.load();
 
     auto network = executor::makeNetworkInterface(
         "ShardRegistry", std::make_unique<ShardingNetworkConnectionHook>(), hookBuilder());
@@ -216,12 +216,16 @@ auto ShardingTaskExecutorPoolController::updateHost(PoolId id, const HostState&
     const size_t maxConns = gParameters.maxConnections.load();
 
     // Update the target for just the pool first
-    poolData.target = stats.requests + stats.active;
+    if (gParameters.adaptiveSizing.load()) {
+        poolData.target = ConnectionPool::adaptiveTargetConnections(stats, minConns, maxConns);
+    } else {
+        poolData.target = stats.requests + stats.active;
 
-    if (poolData.target < minConns) {
-        poolData.target = minConns;
-    } else if (poolData.target > maxConns) {
-        poolData.target = maxConns;
+        if (poolData.target < minConns) {
+            poolData.target = minConns;
+        } else if (poolData.target > maxConns) {
+            poolData.target = maxConns;
+        }
     }
 
     poolData.isAbleToShutdown = stats.health.isExpired;
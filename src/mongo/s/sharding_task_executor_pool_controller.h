@@ -59,6 +59,9 @@ namespace mongo {
  * When the MatchingStrategy is kMatchBusiestNode, it operates like kMatchPrimaryNode, but any pool
  * can be responsible for increasing the targetConnections of each member of its set.
  *
+ * When adaptiveSizing is set, each pool's own target comes from
+ * ConnectionPool::adaptiveTargetConnections() instead of its requests plus active connections.
+ *
  * Note that, in essence, there are three outside elements that can mutate the state of this class:
  * * The ReplicaSetChangeNotifier can notify the listener which updates the host groups
  * * The ServerParameters can update the Parameters which will used in the next update
@@ -89,6 +92,10 @@ public:
 
         synchronized_value<std::string> matchingStrategyString;
         AtomicWord<MatchingStrategy> matchingStrategy;
+
+        AtomicWord<bool> adaptiveSizing;
+
+        AtomicWord<int> maxMultiplexedRequests;
     };
 
     static inline Parameters gParameters;
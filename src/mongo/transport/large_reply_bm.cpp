@@ -0,0 +1,214 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+/**
+ * Measures how fast large cursor batches reach a client over loopback, as when a getMore returns a
+ * full batch. Each request is answered with a reply built by CursorResponseBuilder from owned
+ * documents, either copying every document into the reply or splicing the large ones into it by
+ * reference and sending it with a single gathering write.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+#include <string>
+#include <vector>
+
+#include "mongo/db/query/cursor_response.h"
+#include "mongo/db/server_options.h"
+#include "mongo/db/service_context.h"
+#include "mongo/platform/mutex.h"
+#include "mongo/rpc/op_msg.h"
+#include "mongo/rpc/op_msg_rpc_impls.h"
+#include "mongo/transport/service_entry_point.h"
+#include "mongo/transport/transport_layer_asio.h"
+#include "mongo/util/assert_util.h"
+
+#include <asio.hpp>
+
+namespace mongo {
+namespace {
+
+// Leaves room for the reply's own fields under the maximum reply size.
+constexpr int kBatchBytes = 15 * 1024 * 1024;
+
+/**
+ * Answers every request on a session with a reply holding the same batch of documents, built the
+ * way a getMore builds its reply.
+ */
+class LargeReplyServiceEntryPoint final : public ServiceEntryPoint {
+public:
+    LargeReplyServiceEntryPoint(std::vector<BSONObj> batch, bool allowSplicing)
+        : _batch(std::move(batch)), _allowSplicing(allowSplicing) {}
+
+    void startSession(transport::SessionHandle session) override {
+        {
+            stdx::lock_guard<Latch> lk(_mutex);
+            _sessions.push_back(session);
+        }
+        _sourceMessage(std::move(session));
+    }
+
+    void endAllSessions(transport::Session::TagMask tags) override {
+        std::vector<transport::SessionHandle> sessions;
+        {
+            stdx::lock_guard<Latch> lk(_mutex);
+            sessions.swap(_sessions);
+        }
+        for (auto& session : sessions) {
+            session->end();
+        }
+    }
+
+    Status start() override {
+        return Status::OK();
+    }
+
+    bool shutdown(Milliseconds timeout) override {
+        return true;
+    }
+
+    void appendStats(BSONObjBuilder*) const override {}
+
+    size_t numOpenSessions() const override {
+        stdx::lock_guard<Latch> lk(_mutex);
+        return _sessions.size();
+    }
+
+    DbResponse handleRequest(OperationContext* opCtx, const Message& request) override {
+        MONGO_UNREACHABLE;
+    }
+
+    Message buildReply() const {
+        rpc::OpMsgReplyBuilder replyBuilder;
+        replyBuilder.getOpMsgBuilder()->setAllowSplicing(_allowSplicing);
+        {
+            CursorResponseBuilder responseBuilder(&replyBuilder, CursorResponseBuilder::Options());
+            for (const auto& doc : _batch) {
+                responseBuilder.append(doc);
+            }
+            responseBuilder.done(CursorId(1), "test.coll");
+        }
+        replyBuilder.getBodyBuilder().append("ok", 1.0);
+        return replyBuilder.done();
+    }
+
+private:
+    void _sourceMessage(transport::SessionHandle session) {
+        session->asyncSourceMessage().getAsync([this, session](StatusWith<Message> swMessage) {
+            if (!swMessage.isOK()) {
+                return;
+            }
+
+            auto reply = buildReply();
+            reply.header().setResponseToMsgId(swMessage.getValue().header().getId());
+            session->asyncSinkMessage(std::move(reply)).getAsync([this, session](Status status) {
+                if (status.isOK()) {
+                    _sourceMessage(session);
+                }
+            });
+        });
+    }
+
+    const std::vector<BSONObj> _batch;
+    const bool _allowSplicing;
+
+    mutable Mutex _mutex = MONGO_MAKE_LATCH("LargeReplyServiceEntryPoint::_mutex");
+    std::vector<transport::SessionHandle> _sessions;
+};
+
+/**
+ * Returns owned documents of about 'docBytes' each, in separate buffers as they would be when
+ * produced by a query, adding up to about kBatchBytes.
+ */
+std::vector<BSONObj> makeBatch(int docBytes) {
+    std::vector<BSONObj> batch;
+    const std::string pad(docBytes, 'x');
+    for (int i = 0; i < kBatchBytes / docBytes; ++i) {
+        batch.push_back(BSON("_id" << i << "pad" << pad));
+    }
+    return batch;
+}
+
+void BM_LargeReplyThroughput(benchmark::State& state) {
+    const auto docBytes = static_cast<int>(state.range(0));
+    const bool allowSplicing = state.range(1);
+    state.SetLabel(allowSplicing ? "spliced" : "copied");
+
+    setGlobalServiceContext(ServiceContext::make());
+
+    ServerGlobalParams params;
+    params.noUnixSocket = true;
+    transport::TransportLayerASIO::Options opts(&params);
+    opts.port = 0;
+    opts.ipList = {"127.0.0.1"};
+    opts.transportMode = transport::Mode::kAsynchronous;
+
+    LargeReplyServiceEntryPoint sep(makeBatch(docBytes), allowSplicing);
+    transport::TransportLayerASIO tla(opts, &sep);
+    uassertStatusOK(tla.setup());
+    uassertStatusOK(tla.start());
+
+    asio::io_context clientContext;
+    asio::ip::tcp::socket socket(clientContext);
+    socket.connect(asio::ip::tcp::endpoint(asio::ip::address_v4::loopback(), tla.listenerPort()));
+    socket.set_option(asio::ip::tcp::no_delay(true));
+
+    const auto request =
+        OpMsgRequest::fromDBAndBody("test", BSON("getMore" << 1LL << "collection" << "coll"))
+            .serialize();
+    std::vector<char> reply(sep.buildReply().size());
+
+    for (auto _ : state) {
+        asio::write(socket, asio::buffer(request.buf(), request.size()));
+        asio::read(socket, asio::buffer(reply));
+    }
+
+    state.SetBytesProcessed(state.iterations() * reply.size());
+
+    socket.close();
+    sep.endAllSessions({});
+    tla.shutdown();
+}
+
+void largeReplyArgs(benchmark::internal::Benchmark* b) {
+    for (int64_t docBytes : {1024, 16 * 1024, 256 * 1024, 1024 * 1024}) {
+        for (int64_t allowSplicing : {0, 1}) {
+            b->Args({docBytes, allowSplicing});
+        }
+    }
+}
+
+BENCHMARK(BM_LargeReplyThroughput)
+    ->Apply(largeReplyArgs)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+}  // namespace
+}  // namespace mongo
@@ -0,0 +1,160 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+/**
+ * Measures what each network compressor costs per oplog entry when a secondary fetches a batch:
+ * the bytes sent over the wire and the CPU spent compressing on the sync source and
+ * decompressing on the fetcher. Each benchmark takes the number of entries in the batch.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+#include <ctime>
+#include <memory>
+#include <vector>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/bson/timestamp.h"
+#include "mongo/transport/message_compressor_base.h"
+#include "mongo/transport/message_compressor_noop.h"
+#include "mongo/transport/message_compressor_snappy.h"
+#include "mongo/transport/message_compressor_zlib.h"
+#include "mongo/transport/message_compressor_zstd.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/uuid.h"
+
+namespace mongo {
+namespace {
+
+/**
+ * Builds the body of a getMore reply carrying 'numEntries' insert oplog entries, shaped like the
+ * ones the oplog fetcher receives.
+ */
+BSONObj makeOplogBatch(int numEntries) {
+    const auto uuid = UUID::gen();
+    BSONObjBuilder reply;
+    {
+        BSONObjBuilder cursor(reply.subobjStart("cursor"));
+        cursor.append("id", 12345LL);
+        cursor.append("ns", "local.oplog.rs");
+        BSONArrayBuilder batch(cursor.subarrayStart("nextBatch"));
+        for (int i = 0; i < numEntries; ++i) {
+            BSONObjBuilder entry(batch.subobjStart());
+            entry.append("ts", Timestamp(1600000000, i + 1));
+            entry.append("t", 7LL);
+            entry.append("v", 2);
+            entry.append("op", "i");
+            entry.append("ns", "app.users");
+            uuid.appendToBuilder(&entry, "ui");
+            entry.appendDate("wall", Date_t::fromMillisSinceEpoch(1600000000000LL + i));
+            BSONObjBuilder o(entry.subobjStart("o"));
+            o.append("_id", i);
+            o.append("name", "user" + std::to_string(i));
+            o.append("email", "user" + std::to_string(i) + "@example.com");
+            o.append("score", i * 0.75);
+            o.append("tags", BSON_ARRAY("alpha" << "beta" << i % 10));
+        }
+    }
+    reply.append("ok", 1.0);
+    return reply.obj();
+}
+
+/**
+ * Reports the compressed bytes and the process CPU time per oplog entry. 'cpuStart' is the
+ * std::clock() reading taken just before the timed loop.
+ */
+void setPerOpCounters(benchmark::State& state,
+                      int numEntries,
+                      size_t uncompressedBytes,
+                      size_t compressedBytes,
+                      std::clock_t cpuStart) {
+    const double cpuNanos =
+        static_cast<double>(std::clock() - cpuStart) * 1000 * 1000 * 1000 / CLOCKS_PER_SEC;
+    const double ops = static_cast<double>(state.iterations()) * numEntries;
+    state.counters["bytesPerOp"] = static_cast<double>(compressedBytes) / numEntries;
+    state.counters["uncompressedBytesPerOp"] = static_cast<double>(uncompressedBytes) / numEntries;
+    state.counters["cpuNanosPerOp"] = ops ? cpuNanos / ops : 0;
+    state.SetItemsProcessed(state.iterations() * numEntries);
+}
+
+template <typename Compressor>
+void BM_CompressOplogBatch(benchmark::State& state) {
+    const int numEntries = state.range(0);
+    const auto batch = makeOplogBatch(numEntries);
+    ConstDataRange input(batch.objdata(), batch.objsize());
+    Compressor compressor;
+    std::vector<char> output(compressor.getMaxCompressedSize(batch.objsize()));
+
+    size_t compressedBytes = 0;
+    const auto cpuStart = std::clock();
+    for (auto _ : state) {
+        auto sws = compressor.compressData(input, DataRange(output.data(), output.size()));
+        invariant(sws.isOK());
+        compressedBytes = sws.getValue();
+        benchmark::DoNotOptimize(output.data());
+    }
+    setPerOpCounters(state, numEntries, batch.objsize(), compressedBytes, cpuStart);
+}
+
+template <typename Compressor>
+void BM_DecompressOplogBatch(benchmark::State& state) {
+    const int numEntries = state.range(0);
+    const auto batch = makeOplogBatch(numEntries);
+    Compressor compressor;
+    std::vector<char> compressed(compressor.getMaxCompressedSize(batch.objsize()));
+    auto sws = compressor.compressData(ConstDataRange(batch.objdata(), batch.objsize()),
+                                       DataRange(compressed.data(), compressed.size()));
+    invariant(sws.isOK());
+    const size_t compressedBytes = sws.getValue();
+    ConstDataRange input(compressed.data(), compressedBytes);
+    std::vector<char> output(batch.objsize());
+
+    const auto cpuStart = std::clock();
+    for (auto _ : state) {
+        auto swDecompressed =
+            compressor.decompressData(input, DataRange(output.data(), output.size()));
+        invariant(swDecompressed.isOK());
+        benchmark::DoNotOptimize(output.data());
+    }
+    setPerOpCounters(state, numEntries, batch.objsize(), compressedBytes, cpuStart);
+}
+
+BENCHMARK_TEMPLATE(BM_CompressOplogBatch, NoopMessageCompressor)->Arg(100)->Arg(1000);
+BENCHMARK_TEMPLATE(BM_CompressOplogBatch, SnappyMessageCompressor)->Arg(100)->Arg(1000);
+BENCHMARK_TEMPLATE(BM_CompressOplogBatch, ZlibMessageCompressor)->Arg(100)->Arg(1000);
+BENCHMARK_TEMPLATE(BM_CompressOplogBatch, ZstdMessageCompressor)->Arg(100)->Arg(1000);
+
+BENCHMARK_TEMPLATE(BM_DecompressOplogBatch, NoopMessageCompressor)->Arg(100)->Arg(1000);
+BENCHMARK_TEMPLATE(BM_DecompressOplogBatch, SnappyMessageCompressor)->Arg(100)->Arg(1000);
+BENCHMARK_TEMPLATE(BM_DecompressOplogBatch, ZlibMessageCompressor)->Arg(100)->Arg(1000);
+BENCHMARK_TEMPLATE(BM_DecompressOplogBatch, ZstdMessageCompressor)->Arg(100)->Arg(1000);
+
+}  // namespace
+}  // namespace mongo
@@ -33,6 +33,8 @@
 
 #include "mongo/transport/message_compressor_manager.h"
 
+#include <algorithm>
+
 #include "mongo/base/data_range_cursor.h"
 #include "mongo/base/data_type_endian.h"
 #include "mongo/bson/bsonobj.h"
@@ -209,14 +211,33 @@ void MessageCompressorManager::clientBegin(BSONObjBuilder* output) {
     if (compressorList.size() == 0)
         return;
 
+    const bool offerPreferred = !_clientPreferredCompressor.empty() &&
+        std::find(compressorList.begin(), compressorList.end(), _clientPreferredCompressor) !=
+            compressorList.end();
+
     BSONArrayBuilder sub(output->subarrayStart("compression"));
+    if (offerPreferred) {
+        LOGV2_DEBUG(4951400,
+                    3,
+                    "Offering preferred {compressor} compressor to server",
+                    "Offering preferred compressor to server",
+                    "compressor"_attr = _clientPreferredCompressor);
+        sub.append(_clientPreferredCompressor);
+    }
     for (const auto e : _registry->getCompressorNames()) {
+        if (offerPreferred && e == _clientPreferredCompressor) {
+            continue;
+        }
         LOGV2_DEBUG(22929, 3, "Offering {e} compressor to server", "e"_attr = e);
         sub.append(e);
     }
     sub.doneFast();
 }
 
+void MessageCompressorManager::setClientPreferredCompressor(std::string name) {
+    _clientPreferredCompressor = std::move(name);
+}
+
 void MessageCompressorManager::clientFinish(const BSONObj& input) {
     auto elem = input.getField("compression");
     LOGV2_DEBUG(22930, 3, "Finishing client-side compression negotiation");
@@ -33,6 +33,7 @@
 #include "mongo/transport/message_compressor_base.h"
 #include "mongo/transport/session.h"
 
+#include <string>
 #include <vector>
 
 namespace mongo {
@@ -68,6 +69,14 @@ public:
      */
     void clientBegin(BSONObjBuilder* output);
 
+    /*
+     * Sets a compressor which the client will offer to the server ahead of the others configured
+     * in the registry, so that it is used for this connection if the server supports it. This
+     * takes effect at the next call to clientBegin, and is ignored if the named compressor is not
+     * enabled in the registry. An empty name restores the registry's order.
+     */
+    void setClientPreferredCompressor(std::string name);
+
     /*
      * Called by a client that has received an isMaster response (received after calling
      * clientBegin) and wants to finish negotiating compression.
@@ -129,6 +138,7 @@ public:
 private:
     std::vector<MessageCompressorBase*> _negotiated;
     MessageCompressorRegistry* _registry;
+    std::string _clientPreferredCompressor;
 };
 
 }  // namespace mongo
@@ -220,6 +220,52 @@ TEST(MessageCompressorManager, FullNormalCompression) {
     clientManager.clientFinish(serverObj);
 }
 
+TEST(MessageCompressorManager, ClientPreferredCompressorOfferedFirst) {
+    MessageCompressorRegistry registry;
+    registry.setSupportedCompressors({"snappy", "zstd"});
+    registry.registerImplementation(std::make_unique<SnappyMessageCompressor>());
+    registry.registerImplementation(std::make_unique<ZstdMessageCompressor>());
+    ASSERT_OK(registry.finalizeSupportedCompressors());
+
+    MessageCompressorManager clientManager(&registry);
+    MessageCompressorManager serverManager(&registry);
+    clientManager.setClientPreferredCompressor("zstd");
+
+    BSONObjBuilder clientOutput;
+    clientManager.clientBegin(&clientOutput);
+    auto clientObj = clientOutput.done();
+    checkNegotiationResult(clientObj, {"zstd", "snappy"});
+
+    BSONObjBuilder serverOutput;
+    serverManager.serverNegotiate(clientObj, &serverOutput);
+    auto serverObj = serverOutput.done();
+    checkNegotiationResult(serverObj, {"zstd", "snappy"});
+
+    clientManager.clientFinish(serverObj);
+
+    // Messages sent by the client are now compressed with the preferred compressor.
+    auto swm = clientManager.compressMessage(buildMessage());
+    ASSERT_OK(swm.getStatus());
+    MessageCompressorId compressorId;
+    ASSERT_OK(serverManager.decompressMessage(swm.getValue(), &compressorId).getStatus());
+    ASSERT_EQ(compressorId, ZstdMessageCompressor().getId());
+}
+
+TEST(MessageCompressorManager, ClientPreferredCompressorIgnoredIfNotEnabled) {
+    MessageCompressorRegistry registry;
+    registry.setSupportedCompressors({"snappy", "zstd"});
+    registry.registerImplementation(std::make_unique<SnappyMessageCompressor>());
+    registry.registerImplementation(std::make_unique<ZstdMessageCompressor>());
+    ASSERT_OK(registry.finalizeSupportedCompressors());
+
+    MessageCompressorManager clientManager(&registry);
+    clientManager.setClientPreferredCompressor("zlib");
+
+    BSONObjBuilder clientOutput;
+    clientManager.clientBegin(&clientOutput);
+    checkNegotiationResult(clientOutput.done(), {"snappy", "zstd"});
+}
+
 TEST(NoopMessageCompressor, Fidelity) {
     auto testMessage = buildMessage();
     checkFidelity(testMessage, std::make_unique<NoopMessageCompressor>());
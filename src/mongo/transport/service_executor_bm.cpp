@@ -0,0 +1,251 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+/**
+ * Load harness for the ingress service executors. Opens many loopback connections to a
+ * TransportLayerASIO whose sessions echo every message back through the ServiceExecutor under
+ * test, then measures round-trip throughput and tail latency with every connection in flight at
+ * once. Large connection counts need a file descriptor limit of at least twice their number.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <algorithm>
+#include <benchmark/benchmark.h>
+#include <vector>
+
+#include "mongo/db/server_options.h"
+#include "mongo/db/service_context.h"
+#include "mongo/platform/mutex.h"
+#include "mongo/rpc/op_msg.h"
+#include "mongo/transport/service_entry_point.h"
+#include "mongo/transport/service_executor_adaptive.h"
+#include "mongo/transport/service_executor_fixed.h"
+#include "mongo/transport/transport_layer_asio.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/timer.h"
+
+#include <asio.hpp>
+
+namespace mongo {
+namespace {
+
+enum class ExecutorKind { kAdaptive, kFixed };
+
+/**
+ * Echoes every message received on a session back to its sender, running each reply as a task on
+ * the given ServiceExecutor the way the ServiceStateMachine does.
+ */
+class EchoServiceEntryPoint final : public ServiceEntryPoint {
+public:
+    void setExecutor(transport::ServiceExecutor* executor) {
+        _executor = executor;
+    }
+
+    void startSession(transport::SessionHandle session) override {
+        {
+            stdx::lock_guard<Latch> lk(_mutex);
+            _sessions.push_back(session);
+        }
+        _sourceMessage(std::move(session));
+    }
+
+    void endAllSessions(transport::Session::TagMask tags) override {
+        std::vector<transport::SessionHandle> sessions;
+        {
+            stdx::lock_guard<Latch> lk(_mutex);
+            sessions.swap(_sessions);
+        }
+        for (auto& session : sessions) {
+            session->end();
+        }
+    }
+
+    Status start() override {
+        return Status::OK();
+    }
+
+    bool shutdown(Milliseconds timeout) override {
+        return true;
+    }
+
+    void appendStats(BSONObjBuilder*) const override {}
+
+    size_t numOpenSessions() const override {
+        stdx::lock_guard<Latch> lk(_mutex);
+        return _sessions.size();
+    }
+
+    DbResponse handleRequest(OperationContext* opCtx, const Message& request) override {
+        MONGO_UNREACHABLE;
+    }
+
+private:
+    void _sourceMessage(transport::SessionHandle session) {
+        session->asyncSourceMessage().getAsync([this, session](StatusWith<Message> swMessage) {
+            if (!swMessage.isOK()) {
+                return;
+            }
+
+            auto status = _executor->schedule(
+                [this, session, message = std::move(swMessage.getValue())] {
+                    session->asyncSinkMessage(message).getAsync([this, session](Status status) {
+                        if (status.isOK()) {
+                            _sourceMessage(session);
+                        }
+                    });
+                },
+                transport::ServiceExecutor::kMayRecurse,
+                transport::ServiceExecutorTaskName::kSSMProcessMessage);
+            if (!status.isOK()) {
+                session->end();
+            }
+        });
+    }
+
+    transport::ServiceExecutor* _executor = nullptr;
+
+    mutable Mutex _mutex = MONGO_MAKE_LATCH("EchoServiceEntryPoint::_mutex");
+    std::vector<transport::SessionHandle> _sessions;
+};
+
+/**
+ * A client connection which sends a request and waits for it to be echoed back, recording the
+ * round-trip latency. All clients share one io_context driven by the benchmark thread.
+ */
+class LoopbackClient {
+public:
+    LoopbackClient(asio::io_context& context, int port) : _socket(context) {
+        _socket.connect(asio::ip::tcp::endpoint(asio::ip::address_v4::loopback(), port));
+        _socket.set_option(asio::ip::tcp::no_delay(true));
+    }
+
+    void roundTrip(const Message& request, std::vector<long long>* latencies) {
+        _reply.resize(request.size());
+        _timer.reset();
+        asio::async_write(
+            _socket,
+            asio::buffer(request.buf(), request.size()),
+            [this, latencies](const std::error_code& ec, size_t) {
+                uassert(ErrorCodes::SocketException, ec.message(), !ec);
+                asio::async_read(_socket,
+                                 asio::buffer(_reply),
+                                 [this, latencies](const std::error_code& ec, size_t) {
+                                     uassert(ErrorCodes::SocketException, ec.message(), !ec);
+                                     latencies->push_back(_timer.micros());
+                                 });
+            });
+    }
+
+private:
+    asio::ip::tcp::socket _socket;
+    std::vector<char> _reply;
+    Timer _timer;
+};
+
+std::unique_ptr<transport::ServiceExecutor> makeExecutor(ExecutorKind kind,
+                                                         ServiceContext* svcCtx,
+                                                         transport::ReactorHandle reactor) {
+    switch (kind) {
+        case ExecutorKind::kAdaptive:
+            return std::make_unique<transport::ServiceExecutorAdaptive>(svcCtx,
+                                                                         std::move(reactor));
+        case ExecutorKind::kFixed:
+            return std::make_unique<transport::ServiceExecutorFixed>(svcCtx, std::move(reactor));
+    }
+    MONGO_UNREACHABLE;
+}
+
+void BM_LoopbackEcho(benchmark::State& state) {
+    const auto kind = static_cast<ExecutorKind>(state.range(0));
+    const auto numConnections = state.range(1);
+    state.SetLabel(kind == ExecutorKind::kFixed ? "fixed" : "adaptive");
+
+    setGlobalServiceContext(ServiceContext::make());
+    auto svcCtx = getGlobalServiceContext();
+
+    ServerGlobalParams params;
+    params.noUnixSocket = true;
+    transport::TransportLayerASIO::Options opts(&params);
+    opts.port = 0;
+    opts.ipList = {"127.0.0.1"};
+    opts.transportMode = transport::Mode::kAsynchronous;
+
+    EchoServiceEntryPoint sep;
+    transport::TransportLayerASIO tla(opts, &sep);
+    uassertStatusOK(tla.setup());
+
+    auto executor =
+        makeExecutor(kind, svcCtx, tla.getReactor(transport::TransportLayer::kIngress));
+    sep.setExecutor(executor.get());
+    uassertStatusOK(executor->start());
+    uassertStatusOK(tla.start());
+
+    asio::io_context clientContext;
+    std::vector<std::unique_ptr<LoopbackClient>> clients;
+    for (int64_t i = 0; i < numConnections; ++i) {
+        clients.push_back(std::make_unique<LoopbackClient>(clientContext, tla.listenerPort()));
+    }
+
+    const auto request = OpMsgRequest::fromDBAndBody("admin", BSON("ping" << 1)).serialize();
+    std::vector<long long> latencies;
+
+    for (auto _ : state) {
+        for (auto& client : clients) {
+            client->roundTrip(request, &latencies);
+        }
+        clientContext.restart();
+        clientContext.run();
+    }
+
+    state.SetItemsProcessed(state.iterations() * numConnections);
+    if (!latencies.empty()) {
+        std::sort(latencies.begin(), latencies.end());
+        state.counters["p50Micros"] = latencies[latencies.size() / 2];
+        state.counters["p99Micros"] = latencies[latencies.size() * 99 / 100];
+    }
+
+    clients.clear();
+    sep.endAllSessions({});
+    tla.shutdown();
+    uassertStatusOK(executor->shutdown(Seconds(10)));
+}
+
+void loopbackEchoArgs(benchmark::internal::Benchmark* b) {
+    for (auto kind : {ExecutorKind::kAdaptive, ExecutorKind::kFixed}) {
+        for (int64_t numConnections : {100, 1000, 4000}) {
+            b->Args({static_cast<int64_t>(kind), numConnections});
+        }
+    }
+}
+
+BENCHMARK(BM_LoopbackEcho)->Apply(loopbackEchoArgs)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+}  // namespace
+}  // namespace mongo
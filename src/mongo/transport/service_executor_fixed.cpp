@@ -0,0 +1,292 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOGV2_DEFAULT_COMPONENT ::mongo::logv2::LogComponent::kExecutor
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/transport/service_executor_fixed.h"
+
+#include <algorithm>
+
+#include "mongo/logv2/log.h"
+#include "mongo/transport/service_entry_point_utils.h"
+#include "mongo/transport/service_executor_gen.h"
+#include "mongo/util/concurrency/thread_name.h"
+#include "mongo/util/processinfo.h"
+#include "mongo/util/scopeguard.h"
+#include "mongo/util/str.h"
+
+namespace mongo {
+namespace transport {
+namespace {
+constexpr auto kTotalQueued = "totalQueued"_sd;
+constexpr auto kTotalExecuted = "totalExecuted"_sd;
+constexpr auto kTotalTimeExecutingUs = "totalTimeExecutingMicros"_sd;
+constexpr auto kTotalTimeQueuedUs = "totalTimeQueuedMicros"_sd;
+constexpr auto kThreadsInUse = "threadsInUse"_sd;
+constexpr auto kThreadsRunning = "threadsRunning"_sd;
+constexpr auto kTotalStuckThreadsReplaced = "totalStuckThreadsReplaced"_sd;
+constexpr auto kExecutorLabel = "executor"_sd;
+constexpr auto kExecutorName = "fixed"_sd;
+
+// Each worker thread returns from the reactor this often to check whether it should exit.
+constexpr Milliseconds kWorkerThreadRunTime{1000};
+
+int64_t ticksToMicros(TickSource::Tick ticks, TickSource* tickSource) {
+    invariant(tickSource->getTicksPerSecond() >= 1000000);
+    return tickSource->ticksTo<Microseconds>(ticks).count();
+}
+
+size_t defaultNumThreads() {
+    auto cores = std::max(ProcessInfo::getNumAvailableCores(), 1UL);
+    return static_cast<size_t>(cores * fixedServiceExecutorThreadsPerCore.load());
+}
+
+Milliseconds stuckThreadTimeout() {
+    return Milliseconds{fixedServiceExecutorStuckThreadTimeoutMillis.load()};
+}
+}  // namespace
+
+thread_local int ServiceExecutorFixed::_localRecursionDepth = 0;
+thread_local ServiceExecutorFixed::WorkerState* ServiceExecutorFixed::_localWorker = nullptr;
+
+ServiceExecutorFixed::ServiceExecutorFixed(ServiceContext* ctx, ReactorHandle reactor)
+    : ServiceExecutorFixed(ctx, std::move(reactor), defaultNumThreads()) {}
+
+ServiceExecutorFixed::ServiceExecutorFixed(ServiceContext* ctx,
+                                           ReactorHandle reactor,
+                                           size_t numThreads)
+    : _reactorHandle(std::move(reactor)),
+      _tickSource(ctx->getTickSource()),
+      _numThreads(numThreads),
+      _nextThreadId(numThreads) {
+    invariant(_numThreads > 0);
+}
+
+ServiceExecutorFixed::~ServiceExecutorFixed() {
+    invariant(!_isRunning.load());
+}
+
+Status ServiceExecutorFixed::start() {
+    invariant(!_isRunning.load());
+    _isRunning.store(true);
+
+    for (size_t threadId = 0; threadId < _numThreads; ++threadId) {
+        auto status = _startWorkerThread(threadId);
+        if (!status.isOK()) {
+            if (threadId == 0) {
+                _isRunning.store(false);
+                return status;
+            }
+            break;
+        }
+    }
+
+    _controllerThread = stdx::thread([this] { _controllerThreadRoutine(); });
+
+    LOGV2_DEBUG(4910701,
+                3,
+                "Started fixed executor worker threads",
+                "numThreads"_attr = _threadsRunning.load());
+    return Status::OK();
+}
+
+Status ServiceExecutorFixed::_startWorkerThread(size_t threadId) {
+    _threadsRunning.addAndFetch(1);
+    auto status = launchServiceWorkerThread([this, threadId] { _workerThreadRoutine(threadId); });
+    if (!status.isOK()) {
+        _threadsRunning.subtractAndFetch(1);
+        LOGV2_WARNING(4910700,
+                      "Failed to launch fixed executor worker thread",
+                      "threadId"_attr = threadId,
+                      "error"_attr = status);
+    }
+    return status;
+}
+
+Status ServiceExecutorFixed::shutdown(Milliseconds timeout) {
+    if (!_isRunning.load())
+        return Status::OK();
+
+    LOGV2_DEBUG(4910702, 3, "Shutting down fixed executor");
+
+    {
+        stdx::lock_guard<Latch> lk(_mutex);
+        _isRunning.store(false);
+        _controllerCondition.notify_all();
+    }
+    _controllerThread.join();
+    _reactorHandle->stop();
+
+    stdx::unique_lock<Latch> lk(_mutex);
+    bool result = _shutdownCondition.wait_for(
+        lk, timeout.toSystemDuration(), [this] { return _threadsRunning.load() == 0; });
+
+    return result
+        ? Status::OK()
+        : Status(ErrorCodes::Error::ExceededTimeLimit,
+                 "fixed executor couldn't shutdown all worker threads within time limit.");
+}
+
+Status ServiceExecutorFixed::schedule(Task task,
+                                      ScheduleFlags flags,
+                                      ServiceExecutorTaskName taskName) {
+    if (!_isRunning.load()) {
+        return {ErrorCodes::ShutdownInProgress, "Executor is not running"};
+    }
+
+    auto scheduleTime = _tickSource->getTicks();
+    auto wrappedTask = [this, task = std::move(task), scheduleTime](Status) {
+        auto start = _tickSource->getTicks();
+        _totalSpentQueued.addAndFetch(start - scheduleTime);
+
+        if (_localRecursionDepth++ == 0) {
+            _threadsInUse.addAndFetch(1);
+            if (_localWorker) {
+                _localWorker->taskStart.store(start);
+            }
+        }
+        const auto guard = makeGuard([this, start] {
+            if (--_localRecursionDepth == 0) {
+                _threadsInUse.subtractAndFetch(1);
+                if (_localWorker) {
+                    _localWorker->taskStart.store(kNotExecuting);
+                }
+            }
+            _totalExecuted.addAndFetch(1);
+            _totalSpentExecuting.addAndFetch(_tickSource->getTicks() - start);
+        });
+
+        task();
+    };
+
+    _totalQueued.addAndFetch(1);
+
+    // A task which may recurse runs inline when scheduled from a worker thread, so that the
+    // message which completed a read is handled on the thread that reaped it. Otherwise the task
+    // is posted to the reactor and runs once the current stack has unwound.
+    if ((flags & kMayRecurse) &&
+        (_localRecursionDepth + 1 < fixedServiceExecutorRecursionLimit.loadRelaxed())) {
+        _reactorHandle->dispatch(std::move(wrappedTask));
+    } else {
+        _reactorHandle->schedule(std::move(wrappedTask));
+    }
+
+    return Status::OK();
+}
+
+void ServiceExecutorFixed::_workerThreadRoutine(size_t threadId) {
+    setThreadName(str::stream() << "worker-fixed-" << threadId);
+
+    WorkerState state;
+    {
+        stdx::lock_guard<Latch> lk(_mutex);
+        _workers.push_back(&state);
+    }
+    _localWorker = &state;
+
+    const auto guard = makeGuard([this, &state] {
+        _localWorker = nullptr;
+        stdx::lock_guard<Latch> lk(_mutex);
+        _workers.erase(std::find(_workers.begin(), _workers.end(), &state));
+        if (_threadsRunning.subtractAndFetch(1) == 0) {
+            _shutdownCondition.notify_all();
+        }
+    });
+
+    while (_isRunning.load()) {
+        _reactorHandle->runFor(kWorkerThreadRunTime);
+
+        // A replacement worker is no longer needed once the stuck workers it stood in for, or
+        // enough others, are free to poll the reactor again.
+        if (threadId >= _numThreads) {
+            stdx::lock_guard<Latch> lk(_mutex);
+            const auto numFree =
+                _threadsRunning.load() - _countStuckWorkers(lk, stuckThreadTimeout());
+            if (numFree > _numThreads) {
+                LOGV2_DEBUG(4910704, 3, "Stopping replacement worker", "threadId"_attr = threadId);
+                break;
+            }
+        }
+    }
+}
+
+void ServiceExecutorFixed::_controllerThreadRoutine() {
+    setThreadName("worker-fixed-controller"_sd);
+
+    stdx::unique_lock<Latch> lk(_mutex);
+    while (_isRunning.load()) {
+        const auto timeout = stuckThreadTimeout();
+        _controllerCondition.wait_for(
+            lk, timeout.toSystemDuration(), [this] { return !_isRunning.load(); });
+        if (!_isRunning.load()) {
+            break;
+        }
+
+        // Keep the fixed number of workers free to poll the reactor by starting a replacement for
+        // each worker stuck in a task.
+        const auto numStuck = _countStuckWorkers(lk, timeout);
+        const auto numRunning = _threadsRunning.load();
+        for (auto numFree = numRunning - numStuck; numFree < _numThreads; ++numFree) {
+            const auto threadId = _nextThreadId++;
+            LOGV2_DEBUG(4910705,
+                        2,
+                        "Starting replacement worker for a stuck worker",
+                        "threadId"_attr = threadId,
+                        "numStuck"_attr = numStuck);
+            if (!_startWorkerThread(threadId).isOK()) {
+                break;
+            }
+            _totalStuckThreadsReplaced.addAndFetch(1);
+        }
+    }
+}
+
+size_t ServiceExecutorFixed::_countStuckWorkers(WithLock, Milliseconds timeout) const {
+    const auto now = _tickSource->getTicks();
+    const auto timeoutTicks = timeout.count() * _tickSource->getTicksPerSecond() / 1000;
+    return std::count_if(_workers.begin(), _workers.end(), [&](const WorkerState* worker) {
+        const auto start = worker->taskStart.load();
+        return start != kNotExecuting && now - start >= timeoutTicks;
+    });
+}
+
+void ServiceExecutorFixed::appendStats(BSONObjBuilder* bob) const {
+    *bob << kExecutorLabel << kExecutorName << kTotalQueued << _totalQueued.load()
+         << kTotalExecuted << _totalExecuted.load() << kThreadsInUse
+         << static_cast<int>(_threadsInUse.load()) << kTotalTimeExecutingUs
+         << ticksToMicros(_totalSpentExecuting.load(), _tickSource) << kTotalTimeQueuedUs
+         << ticksToMicros(_totalSpentQueued.load(), _tickSource) << kThreadsRunning
+         << static_cast<int>(_threadsRunning.load()) << kTotalStuckThreadsReplaced
+         << _totalStuckThreadsReplaced.load();
+}
+
+}  // namespace transport
+}  // namespace mongo
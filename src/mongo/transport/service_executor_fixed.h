@@ -0,0 +1,132 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <vector>
+
+#include "mongo/base/status.h"
+#include "mongo/db/service_context.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/platform/mutex.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/transport/service_executor.h"
+#include "mongo/transport/service_executor_task_names.h"
+#include "mongo/transport/transport_layer.h"
+#include "mongo/util/concurrency/with_lock.h"
+#include "mongo/util/tick_source.h"
+
+namespace mongo {
+namespace transport {
+
+/**
+ * The fixed service executor runs the ingress reactor on a fixed number of worker threads, by
+ * default one per core. Network events are demultiplexed by the reactor (epoll on Linux) in
+ * batches and their completions, including the handling of each complete message, run directly on
+ * the worker thread that reaped them.
+ *
+ * Commands may block their worker for a long time, for example an awaitable isMaster, an awaitData
+ * getMore or a wait for a lock, a ticket or write concern. So that such tasks cannot starve every
+ * other session, a controller thread checks every fixedServiceExecutorStuckThreadTimeoutMillis for
+ * workers which have been running the same task for longer than that, and starts a replacement
+ * worker for each of them. Replacement workers exit once the fixed number of workers is free to
+ * poll the reactor again.
+ */
+class ServiceExecutorFixed final : public ServiceExecutor {
+public:
+    explicit ServiceExecutorFixed(ServiceContext* ctx, ReactorHandle reactor);
+    explicit ServiceExecutorFixed(ServiceContext* ctx, ReactorHandle reactor, size_t numThreads);
+
+    ~ServiceExecutorFixed();
+
+    Status start() override;
+    Status shutdown(Milliseconds timeout) override;
+    Status schedule(Task task, ScheduleFlags flags, ServiceExecutorTaskName taskName) override;
+
+    Mode transportMode() const override {
+        return Mode::kAsynchronous;
+    }
+
+    void appendStats(BSONObjBuilder* bob) const override;
+
+    size_t threadsRunning() const {
+        return _threadsRunning.load();
+    }
+
+private:
+    // Registered by each worker thread for the duration of its routine.
+    struct WorkerState {
+        // When the worker's outermost current task started, or kNotExecuting while the worker is
+        // polling the reactor.
+        AtomicWord<TickSource::Tick> taskStart{kNotExecuting};
+    };
+
+    static constexpr TickSource::Tick kNotExecuting = -1;
+
+    Status _startWorkerThread(size_t threadId);
+    void _workerThreadRoutine(size_t threadId);
+    void _controllerThreadRoutine();
+
+    // Returns how many registered workers have been running their current task for at least
+    // 'timeout'.
+    size_t _countStuckWorkers(WithLock, Milliseconds timeout) const;
+
+    static thread_local int _localRecursionDepth;
+    static thread_local WorkerState* _localWorker;
+
+    ReactorHandle _reactorHandle;
+    TickSource* const _tickSource;
+    const size_t _numThreads;
+
+    AtomicWord<bool> _isRunning{false};
+
+    mutable Mutex _mutex = MONGO_MAKE_LATCH("ServiceExecutorFixed::_mutex");
+    stdx::condition_variable _shutdownCondition;
+    stdx::condition_variable _controllerCondition;
+    stdx::thread _controllerThread;
+
+    // The workers currently running, and the id to give the next replacement worker. Guarded by
+    // '_mutex'. Ids below '_numThreads' belong to the workers started with the executor.
+    std::vector<WorkerState*> _workers;
+    size_t _nextThreadId;
+
+    AtomicWord<size_t> _threadsRunning{0};
+    AtomicWord<size_t> _threadsInUse{0};
+
+    // These counters are only used for reporting in serverStatus.
+    AtomicWord<int64_t> _totalQueued{0};
+    AtomicWord<int64_t> _totalExecuted{0};
+    AtomicWord<TickSource::Tick> _totalSpentQueued{0};
+    AtomicWord<TickSource::Tick> _totalSpentExecuting{0};
+    AtomicWord<int64_t> _totalStuckThreadsReplaced{0};
+};
+
+}  // namespace transport
+}  // namespace mongo
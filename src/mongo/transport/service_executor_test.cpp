@@ -36,10 +36,13 @@
 #include "mongo/db/service_context.h"
 #include "mongo/logv2/log.h"
 #include "mongo/transport/service_executor_adaptive.h"
+#include "mongo/transport/service_executor_fixed.h"
+#include "mongo/transport/service_executor_gen.h"
 #include "mongo/transport/service_executor_synchronous.h"
 #include "mongo/transport/service_executor_task_names.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/scopeguard.h"
+#include "mongo/util/time_support.h"
 
 #include <asio.hpp>
 
@@ -165,6 +168,19 @@ protected:
     std::shared_ptr<asio::io_context> asioIOCtx;
 };
 
+class ServiceExecutorFixedFixture : public unittest::Test {
+protected:
+    void setUp() override {
+        auto scOwned = ServiceContext::make();
+        setGlobalServiceContext(std::move(scOwned));
+
+        executor = std::make_unique<ServiceExecutorFixed>(
+            getGlobalServiceContext(), std::make_shared<ASIOReactor>(), 2);
+    }
+
+    std::unique_ptr<ServiceExecutorFixed> executor;
+};
+
 class ServiceExecutorSynchronousFixture : public unittest::Test {
 protected:
     void setUp() override {
@@ -207,6 +223,93 @@ TEST_F(ServiceExecutorAdaptiveFixture, ScheduleFailsBeforeStartup) {
     scheduleBasicTask(executor.get(), false);
 }
 
+TEST_F(ServiceExecutorFixedFixture, BasicTaskRuns) {
+    ASSERT_OK(executor->start());
+    auto guard = makeGuard([this] { ASSERT_OK(executor->shutdown(kShutdownTime)); });
+
+    scheduleBasicTask(executor.get(), true);
+}
+
+TEST_F(ServiceExecutorFixedFixture, ScheduleFailsBeforeStartup) {
+    scheduleBasicTask(executor.get(), false);
+}
+
+TEST_F(ServiceExecutorFixedFixture, RunsAFixedNumberOfThreads) {
+    ASSERT_OK(executor->start());
+    auto guard = makeGuard([this] { ASSERT_OK(executor->shutdown(kShutdownTime)); });
+
+    for (int i = 0; i < 10; ++i) {
+        scheduleBasicTask(executor.get(), true);
+    }
+    ASSERT_EQ(2u, executor->threadsRunning());
+
+    BSONObjBuilder bob;
+    executor->appendStats(&bob);
+    auto stats = bob.obj();
+    ASSERT_EQ("fixed", stats["executor"].str());
+    ASSERT_EQ(10, stats["totalQueued"].numberLong());
+    ASSERT_EQ(2, stats["threadsRunning"].numberInt());
+}
+
+TEST_F(ServiceExecutorFixedFixture, ShutdownStopsWorkerThreads) {
+    ASSERT_OK(executor->start());
+    ASSERT_OK(executor->shutdown(kShutdownTime));
+    ASSERT_EQ(0u, executor->threadsRunning());
+
+    scheduleBasicTask(executor.get(), false);
+}
+
+TEST_F(ServiceExecutorFixedFixture, ReplacesWorkersStuckInBlockingTasks) {
+    const auto savedTimeout = fixedServiceExecutorStuckThreadTimeoutMillis.load();
+    fixedServiceExecutorStuckThreadTimeoutMillis.store(20);
+    const auto timeoutGuard = makeGuard(
+        [savedTimeout] { fixedServiceExecutorStuckThreadTimeoutMillis.store(savedTimeout); });
+
+    ASSERT_OK(executor->start());
+    auto guard = makeGuard([this] { ASSERT_OK(executor->shutdown(kShutdownTime)); });
+
+    // Block both workers, as an awaitable isMaster or a lock wait would.
+    auto mutex = MONGO_MAKE_LATCH();
+    stdx::condition_variable cond;
+    int numBlocked = 0;
+    bool release = false;
+    for (int i = 0; i < 2; ++i) {
+        ASSERT_OK(executor->schedule(
+            [&] {
+                stdx::unique_lock<Latch> lk(mutex);
+                ++numBlocked;
+                cond.notify_all();
+                cond.wait(lk, [&] { return release; });
+            },
+            ServiceExecutor::kEmptyFlags,
+            ServiceExecutorTaskName::kSSMProcessMessage));
+    }
+    {
+        stdx::unique_lock<Latch> lk(mutex);
+        cond.wait(lk, [&] { return numBlocked == 2; });
+    }
+
+    // Other sessions still make progress on the replacement workers.
+    scheduleBasicTask(executor.get(), true);
+    ASSERT_GTE(executor->threadsRunning(), 3u);
+
+    BSONObjBuilder bob;
+    executor->appendStats(&bob);
+    ASSERT_GTE(bob.obj()["totalStuckThreadsReplaced"].numberLong(), 1);
+
+    {
+        stdx::lock_guard<Latch> lk(mutex);
+        release = true;
+        cond.notify_all();
+    }
+
+    // Once the original workers are free again, the replacements exit.
+    for (int i = 0; i < 100 && executor->threadsRunning() > 2; ++i) {
+        sleepmillis(50);
+    }
+    ASSERT_EQ(2u, executor->threadsRunning());
+}
+
 TEST_F(ServiceExecutorSynchronousFixture, BasicTaskRuns) {
     ASSERT_OK(executor->start());
     auto guard = makeGuard([this] { ASSERT_OK(executor->shutdown(kShutdownTime)); });
@@ -69,5 +69,15 @@ Session::TagMask Session::getTags() const {
     return _tags.load();
 }
 
+Future<void> Session::asyncSinkMessages(std::vector<Message> messages, const BatonHandle& handle) {
+    auto future = Future<void>::makeReady();
+    for (auto& message : messages) {
+        future = std::move(future).then([this, message = std::move(message), handle]() mutable {
+            return asyncSinkMessage(std::move(message), handle);
+        });
+    }
+    return future;
+}
+
 }  // namespace transport
 }  // namespace mongo
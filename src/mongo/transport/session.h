@@ -30,6 +30,7 @@
 #pragma once
 
 #include <memory>
+#include <vector>
 
 #include "mongo/db/baton.h"
 #include "mongo/platform/atomic_word.h"
@@ -116,6 +117,15 @@ public:
     virtual Status sinkMessage(Message message) = 0;
     virtual Future<void> asyncSinkMessage(Message message, const BatonHandle& handle = nullptr) = 0;
 
+    /**
+     * Sink (send) several Messages to the remote host for this Session, in order.
+     *
+     * The default implementation sinks them one at a time. Implementations that can should send
+     * them with a single write, so that a client pipelining requests pays for one system call.
+     */
+    virtual Future<void> asyncSinkMessages(std::vector<Message> messages,
+                                           const BatonHandle& handle = nullptr);
+
     /**
      * Cancel any outstanding async operations. There is no way to cancel synchronous calls.
      * Futures will finish with an ErrorCodes::CallbackCancelled error if they haven't already
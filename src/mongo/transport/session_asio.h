@@ -30,6 +30,7 @@
 #pragma once
 
 #include <utility>
+#include <vector>
 
 #include "mongo/base/system_error.h"
 #include "mongo/config.h"
@@ -165,7 +166,7 @@ public:
     Status sinkMessage(Message message) override {
         ensureSync();
 
-        return write(asio::buffer(message.buf(), message.size()))
+        return writeMessage(message)
             .then([this, &message] {
                 if (_isIngressSession) {
                     networkCounter.hitPhysicalOut(message.size());
@@ -176,7 +177,7 @@ public:
 
     Future<void> asyncSinkMessage(Message message, const BatonHandle& baton = nullptr) override {
         ensureAsync();
-        return write(asio::buffer(message.buf(), message.size()), baton)
+        return writeMessage(message, baton)
             .then([this, message /*keep the buffer alive*/]() {
                 if (_isIngressSession) {
                     networkCounter.hitPhysicalOut(message.size());
@@ -184,6 +185,24 @@ public:
             });
     }
 
+    Future<void> asyncSinkMessages(std::vector<Message> messages,
+                                   const BatonHandle& baton = nullptr) override {
+        ensureAsync();
+        std::vector<asio::const_buffer> buffers;
+        for (const auto& message : messages) {
+            for (const auto& range : message.dataRanges()) {
+                buffers.emplace_back(range.data(), range.length());
+            }
+        }
+        return write(buffers, baton).then([this, messages = std::move(messages)]() {
+            if (_isIngressSession) {
+                for (const auto& message : messages) {
+                    networkCounter.hitPhysicalOut(message.size());
+                }
+            }
+        });
+    }
+
     void cancelAsyncOperations(const BatonHandle& baton = nullptr) override {
         LOGV2_DEBUG(4615608,
                     3,
@@ -449,6 +468,25 @@ private:
         return opportunisticRead(_socket, buffers, baton);
     }
 
+    /**
+     * Writes a message whose bytes are split across fragments with one gathering write rather than
+     * copying them into a contiguous buffer first. The caller keeps the message alive until the
+     * returned future is ready.
+     */
+    Future<void> writeMessage(const Message& message, const BatonHandle& baton = nullptr) {
+        if (!message.isFragmented()) {
+            return write(asio::buffer(message.buf(), message.size()), baton);
+        }
+
+        std::vector<asio::const_buffer> buffers;
+        const auto ranges = message.dataRanges();
+        buffers.reserve(ranges.size());
+        for (const auto& range : ranges) {
+            buffers.emplace_back(range.data(), range.length());
+        }
+        return write(buffers, baton);
+    }
+
     template <typename ConstBufferSequence>
     Future<void> write(const ConstBufferSequence& buffers, const BatonHandle& baton = nullptr) {
         // TODO SERVER-47229 Guard active ops for cancelation here.
@@ -566,6 +604,24 @@ private:
     }
 #endif
 
+    /**
+     * Advances 'buffers' past the first 'size' bytes, which have already been written.
+     */
+    template <typename Buffer>
+    static void consumeBuffers(Buffer* buffers, std::size_t size) {
+        *buffers += size;
+    }
+    static void consumeBuffers(std::vector<asio::const_buffer>* buffers, std::size_t size) {
+        auto it = buffers->begin();
+        for (; it != buffers->end() && size >= it->size(); ++it) {
+            size -= it->size();
+        }
+        it = buffers->erase(buffers->begin(), it);
+        if (it != buffers->end()) {
+            *it += size;
+        }
+    }
+
     template <typename Stream, typename ConstBufferSequence>
     Future<void> opportunisticWrite(Stream& stream,
                                     const ConstBufferSequence& buffers,
@@ -575,14 +631,14 @@ private:
 
         if (MONGO_unlikely(transportLayerASIOshortOpportunisticReadWrite.shouldFail()) &&
             _blockingMode == Async) {
-            asio::const_buffer localBuffer = buffers;
+            asio::const_buffer localBuffer = *asio::buffer_sequence_begin(buffers);
 
-            if (buffers.size()) {
-                localBuffer = asio::const_buffer(buffers.data(), 1);
+            if (localBuffer.size()) {
+                localBuffer = asio::const_buffer(localBuffer.data(), 1);
             }
 
             size = asio::write(stream, localBuffer, ec);
-            if (!ec && buffers.size() > 1) {
+            if (!ec && asio::buffer_size(buffers) > 1) {
                 ec = asio::error::would_block;
             }
         } else {
@@ -597,7 +653,7 @@ private:
             // size is > 0.
             ConstBufferSequence asyncBuffers(buffers);
             if (size > 0) {
-                asyncBuffers += size;
+                consumeBuffers(&asyncBuffers, size);
             }
 
             if (auto more = moreToSend(stream, asyncBuffers, baton)) {
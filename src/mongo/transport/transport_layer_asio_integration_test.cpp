@@ -31,6 +31,8 @@
 
 #include "mongo/platform/basic.h"
 
+#include <vector>
+
 #include "mongo/client/async_client.h"
 #include "mongo/client/connection_string.h"
 #include "mongo/db/client.h"
@@ -306,5 +308,109 @@ TEST(TransportLayerASIO, exhaustIsMasterShouldStopOnFailure) {
     }
 }
 
+TEST(TransportLayerASIO, multiplexedRequestsReceiveTheirOwnReplies) {
+    auto connectionString = unittest::getFixtureConnectionString();
+    auto server = connectionString.getServers().front();
+
+    auto sc = getGlobalServiceContext();
+    auto reactor = sc->getTransportLayer()->getReactor(transport::TransportLayer::kNewReactor);
+
+    stdx::thread thread([&] { reactor->run(); });
+    const auto threadGuard = makeGuard([&] {
+        reactor->stop();
+        thread.join();
+    });
+
+    AsyncDBClient::Handle handle =
+        AsyncDBClient::connect(server, transport::kGlobalSSLMode, sc, reactor, Milliseconds::max())
+            .get();
+
+    handle->initWireVersion(__FILE__, nullptr, true /* requestMultiplexing */).get();
+    ASSERT(handle->isMultiplexing());
+
+    // Issue every request before waiting on any reply, so they are all in flight on the same
+    // connection at once.
+    constexpr int kNumRequests = 32;
+    std::vector<Future<executor::RemoteCommandResponse>> futures;
+    for (int i = 0; i < kNumRequests; ++i) {
+        futures.push_back(handle->runCommandRequest(executor::RemoteCommandRequest{
+            server, "admin", BSON("echo" << 1 << "i" << i), BSONObj(), nullptr}));
+    }
+
+    for (int i = 0; i < kNumRequests; ++i) {
+        auto reply = futures[i].get();
+        ASSERT_OK(reply.status);
+        ASSERT_EQ(reply.data["echo"]["i"].numberInt(), i);
+    }
+
+    // Exhaust commands stream replies to a single request and cannot share the connection.
+    auto isMasterRequest =
+        executor::RemoteCommandRequest{server, "admin", BSON("isMaster" << 1), BSONObj(), nullptr};
+    ASSERT_EQ(handle->beginExhaustCommandRequest(isMasterRequest).getNoThrow().getStatus(),
+              ErrorCodes::IllegalOperation);
+}
+
+TEST(TransportLayerASIO, canceledMultiplexedRequestDoesNotAffectOthers) {
+    auto connectionString = unittest::getFixtureConnectionString();
+    auto server = connectionString.getServers().front();
+
+    auto sc = getGlobalServiceContext();
+    auto reactor = sc->getTransportLayer()->getReactor(transport::TransportLayer::kNewReactor);
+
+    stdx::thread thread([&] { reactor->run(); });
+    const auto threadGuard = makeGuard([&] {
+        reactor->stop();
+        thread.join();
+    });
+
+    AsyncDBClient::Handle handle =
+        AsyncDBClient::connect(server, transport::kGlobalSSLMode, sc, reactor, Milliseconds::max())
+            .get();
+
+    handle->initWireVersion(__FILE__, nullptr, true /* requestMultiplexing */).get();
+    ASSERT(handle->isMultiplexing());
+
+    auto sleepRequest = executor::RemoteCommandRequest{server,
+                                                       "admin",
+                                                       BSON("sleep" << 1 << "lock"
+                                                                    << "none"
+                                                                    << "millis" << 500),
+                                                       BSONObj(),
+                                                       nullptr};
+    auto sleeping = handle->runCommandRequest(sleepRequest);
+    auto echoing = handle->runCommandRequest(executor::RemoteCommandRequest{
+        server, "admin", BSON("echo" << 1 << "i" << 1), BSONObj(), nullptr});
+
+    handle->cancelRequest(sleepRequest.id);
+    ASSERT_EQ(sleeping.getNoThrow().getStatus(), ErrorCodes::CallbackCanceled);
+
+    // The late reply to the canceled request is dropped and the connection stays usable.
+    auto reply = echoing.get();
+    ASSERT_OK(reply.status);
+    ASSERT_EQ(reply.data["echo"]["i"].numberInt(), 1);
+    ASSERT_OK(handle->getMultiplexingStatus());
+}
+
+TEST(TransportLayerASIO, multiplexingIsOnlyUsedWhenRequested) {
+    auto connectionString = unittest::getFixtureConnectionString();
+    auto server = connectionString.getServers().front();
+
+    auto sc = getGlobalServiceContext();
+    auto reactor = sc->getTransportLayer()->getReactor(transport::TransportLayer::kNewReactor);
+
+    stdx::thread thread([&] { reactor->run(); });
+    const auto threadGuard = makeGuard([&] {
+        reactor->stop();
+        thread.join();
+    });
+
+    AsyncDBClient::Handle handle =
+        AsyncDBClient::connect(server, transport::kGlobalSSLMode, sc, reactor, Milliseconds::max())
+            .get();
+
+    handle->initWireVersion(__FILE__, nullptr).get();
+    ASSERT_FALSE(handle->isMultiplexing());
+}
+
 }  // namespace
 }  // namespace mongo
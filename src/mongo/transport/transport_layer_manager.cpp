@@ -39,6 +39,7 @@
 #include "mongo/db/server_options.h"
 #include "mongo/db/service_context.h"
 #include "mongo/transport/service_executor_adaptive.h"
+#include "mongo/transport/service_executor_fixed.h"
 #include "mongo/transport/service_executor_synchronous.h"
 #include "mongo/transport/session.h"
 #include "mongo/transport/transport_layer_asio.h"
@@ -134,7 +135,7 @@ std::unique_ptr<TransportLayer> TransportLayerManager::createWithConfig(
     auto sep = ctx->getServiceEntryPoint();
 
     transport::TransportLayerASIO::Options opts(config);
-    if (config->serviceExecutor == "adaptive") {
+    if (config->serviceExecutor == "adaptive" || config->serviceExecutor == "fixed") {
         opts.transportMode = transport::Mode::kAsynchronous;
     } else if (config->serviceExecutor == "synchronous") {
         opts.transportMode = transport::Mode::kSynchronous;
@@ -147,6 +148,9 @@ std::unique_ptr<TransportLayer> TransportLayerManager::createWithConfig(
     if (config->serviceExecutor == "adaptive") {
         auto reactor = transportLayerASIO->getReactor(TransportLayer::kIngress);
         ctx->setServiceExecutor(std::make_unique<ServiceExecutorAdaptive>(ctx, std::move(reactor)));
+    } else if (config->serviceExecutor == "fixed") {
+        auto reactor = transportLayerASIO->getReactor(TransportLayer::kIngress);
+        ctx->setServiceExecutor(std::make_unique<ServiceExecutorFixed>(ctx, std::move(reactor)));
     } else if (config->serviceExecutor == "synchronous") {
         ctx->setServiceExecutor(std::make_unique<ServiceExecutorSynchronous>(ctx));
     }
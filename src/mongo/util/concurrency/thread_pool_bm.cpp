@@ -0,0 +1,176 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+#include <functional>
+
+#include "mongo/platform/atomic_word.h"
+#include "mongo/platform/mutex.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/util/concurrency/thread_pool.h"
+#include "mongo/util/concurrency/work_stealing_thread_pool.h"
+
+namespace mongo {
+namespace {
+
+constexpr int kTasksPerIteration = 1000;
+
+std::unique_ptr<ThreadPoolInterface> makePool(ThreadPool*, size_t numThreads) {
+    ThreadPool::Options options;
+    options.minThreads = numThreads;
+    options.maxThreads = numThreads;
+    return std::make_unique<ThreadPool>(std::move(options));
+}
+
+std::unique_ptr<ThreadPoolInterface> makePool(WorkStealingThreadPool*, size_t numThreads) {
+    WorkStealingThreadPool::Options options;
+    options.numThreads = numThreads;
+    return std::make_unique<WorkStealingThreadPool>(std::move(options));
+}
+
+template <typename Pool>
+std::unique_ptr<ThreadPoolInterface> makeStartedPool(size_t numThreads) {
+    auto pool = makePool(static_cast<Pool*>(nullptr), numThreads);
+    pool->startup();
+    return pool;
+}
+
+/**
+ * Lets the benchmark thread wait for a number of tasks to run.
+ */
+class Countdown {
+public:
+    void reset(int count) {
+        _remaining.store(count);
+    }
+
+    void countDown() {
+        if (_remaining.subtractAndFetch(1) == 0) {
+            stdx::lock_guard<Latch> lk(_mutex);
+            _cv.notify_all();
+        }
+    }
+
+    void wait() {
+        stdx::unique_lock<Latch> lk(_mutex);
+        _cv.wait(lk, [&] { return _remaining.load() == 0; });
+    }
+
+private:
+    AtomicWord<int> _remaining{0};
+    Mutex _mutex = MONGO_MAKE_LATCH();
+    stdx::condition_variable _cv;
+};
+
+/**
+ * Schedules tasks from outside the pool as fast as it will take them.
+ */
+template <typename Pool>
+void BM_scheduleThroughput(benchmark::State& state) {
+    auto pool = makeStartedPool<Pool>(state.range(0));
+    Countdown countdown;
+
+    for (auto _ : state) {
+        countdown.reset(kTasksPerIteration);
+        for (int i = 0; i < kTasksPerIteration; ++i) {
+            pool->schedule([&](auto status) { countdown.countDown(); });
+        }
+        countdown.wait();
+    }
+
+    pool->shutdown();
+    pool->join();
+    state.SetItemsProcessed(state.iterations() * kTasksPerIteration);
+}
+
+/**
+ * Has each task schedule its successor from within the pool, as continuations do, with as many
+ * chains running at once as the pool has threads.
+ */
+template <typename Pool>
+void BM_scheduleFromTasks(benchmark::State& state) {
+    const auto numChains = static_cast<int>(state.range(0));
+    auto pool = makeStartedPool<Pool>(numChains);
+    Countdown countdown;
+
+    std::function<void(int)> runChain = [&](int remaining) {
+        countdown.countDown();
+        if (remaining > 1) {
+            pool->schedule([&, remaining](auto status) { runChain(remaining - 1); });
+        }
+    };
+
+    for (auto _ : state) {
+        countdown.reset(kTasksPerIteration * numChains);
+        for (int i = 0; i < numChains; ++i) {
+            pool->schedule([&](auto status) { runChain(kTasksPerIteration); });
+        }
+        countdown.wait();
+    }
+
+    pool->shutdown();
+    pool->join();
+    state.SetItemsProcessed(state.iterations() * kTasksPerIteration * numChains);
+}
+
+/**
+ * Measures the time from scheduling a single task on an idle pool to being told it has run, which
+ * includes waking a parked thread.
+ */
+template <typename Pool>
+void BM_scheduleLatency(benchmark::State& state) {
+    auto pool = makeStartedPool<Pool>(state.range(0));
+    Countdown countdown;
+
+    for (auto _ : state) {
+        countdown.reset(1);
+        pool->schedule([&](auto status) { countdown.countDown(); });
+        countdown.wait();
+    }
+
+    pool->shutdown();
+    pool->join();
+}
+
+void poolSizes(benchmark::internal::Benchmark* bm) {
+    bm->Arg(1)->Arg(4)->Arg(16)->UseRealTime();
+}
+
+BENCHMARK_TEMPLATE(BM_scheduleThroughput, ThreadPool)->Apply(poolSizes);
+BENCHMARK_TEMPLATE(BM_scheduleThroughput, WorkStealingThreadPool)->Apply(poolSizes);
+BENCHMARK_TEMPLATE(BM_scheduleFromTasks, ThreadPool)->Apply(poolSizes);
+BENCHMARK_TEMPLATE(BM_scheduleFromTasks, WorkStealingThreadPool)->Apply(poolSizes);
+BENCHMARK_TEMPLATE(BM_scheduleLatency, ThreadPool)->Apply(poolSizes);
+BENCHMARK_TEMPLATE(BM_scheduleLatency, WorkStealingThreadPool)->Apply(poolSizes);
+
+}  // namespace
+}  // namespace mongo
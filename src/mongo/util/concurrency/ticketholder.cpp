@@ -27,236 +27,369 @@
  *    it in the license file.
  */
 
-#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kDefault
+#define MONGO_LOGV2_DEFAULT_COMPONENT ::mongo::logv2::LogComponent::kDefault
 
 #include "mongo/platform/basic.h"
 
 #include "mongo/util/concurrency/ticketholder.h"
 
-#include <iostream>
+#include <algorithm>
 
+#include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/logv2/log.h"
 #include "mongo/util/str.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
-
-#if defined(__linux__)
 namespace {
 
-/**
- * Accepts an errno code, prints its error message, and exits.
- */
-void failWithErrno(int err) {
-    LOGV2_FATAL(28604,
-                "error in Ticketholder: {errnoWithDescription_err}",
-                "errnoWithDescription_err"_attr = errnoWithDescription(err));
-}
+// Threads are spread across the shards of every TicketHolder round-robin, in the order they first
+// acquire or release a ticket.
+AtomicWord<unsigned> nextShardIndex{0};
+thread_local const unsigned localShardIndex = nextShardIndex.fetchAndAdd(1);
 
-/*
- * Checks the return value from a Linux semaphore function call, and fails with the set errno if the
- * call was unsucessful.
- */
-void check(int ret) {
-    if (ret == 0)
-        return;
-    failWithErrno(errno);
+// How often the dynamic adjustment compares throughput, and how many releases pass between checks
+// of whether that much time has elapsed.
+constexpr Milliseconds kAdjustmentInterval{1000};
+constexpr long long kReleasesPerAdjustmentCheck = 256;
+
+}  // namespace
+
+StringData toString(AdmissionPriority priority) {
+    switch (priority) {
+        case AdmissionPriority::kHigh:
+            return "high"_sd;
+        case AdmissionPriority::kNormal:
+            return "normal"_sd;
+        case AdmissionPriority::kLow:
+            return "low"_sd;
+    }
+    MONGO_UNREACHABLE;
 }
 
-/**
- * Takes a Date_t deadline and sets the appropriate values in a timespec structure.
- */
-void tsFromDate(const Date_t& deadline, struct timespec& ts) {
-    ts.tv_sec = deadline.toTimeT();
-    ts.tv_nsec = (deadline.toMillisSinceEpoch() % 1000) * 1'000'000;
+TicketHolder::TicketHolder(int num) : _outof(num), _configuredOutOf(num) {
+    const int numShards = kNumShards;
+    for (int i = 0; i < numShards; ++i) {
+        _shards[i].available.store(num / numShards + (i < num % numShards ? 1 : 0));
+    }
 }
-}  // namespace
 
-TicketHolder::TicketHolder(int num) : _outof(num) {
-    check(sem_init(&_sem, 0, num));
+TicketHolder::~TicketHolder() = default;
+
+TicketHolder::Shard& TicketHolder::_localShard() {
+    return _shards[localShardIndex % kNumShards];
 }
 
-TicketHolder::~TicketHolder() {
-    check(sem_destroy(&_sem));
+bool TicketHolder::_tryAcquireFromShards() {
+    const auto first = localShardIndex % kNumShards;
+    for (size_t i = 0; i < kNumShards; ++i) {
+        auto& shard = _shards[(first + i) % kNumShards];
+        auto available = shard.available.load();
+        while (available > 0) {
+            if (shard.available.compareAndSwap(&available, available - 1)) {
+                return true;
+            }
+        }
+    }
+    return false;
 }
 
-bool TicketHolder::tryAcquire() {
-    while (0 != sem_trywait(&_sem)) {
-        if (errno == EAGAIN)
-            return false;
-        if (errno != EINTR)
-            failWithErrno(errno);
+bool TicketHolder::tryAcquire(AdmissionPriority priority) {
+    // Queued operations are owed the next tickets, so only take one if nobody is waiting.
+    if (_numQueued.load() > 0 || !_tryAcquireFromShards()) {
+        return false;
     }
+    _localShard().admittedImmediately[static_cast<size_t>(priority)].fetchAndAdd(1);
     return true;
 }
 
-void TicketHolder::waitForTicket(OperationContext* opCtx) {
-    waitForTicketUntil(opCtx, Date_t::max());
+void TicketHolder::waitForTicket(OperationContext* opCtx, AdmissionPriority priority) {
+    invariant(_waitForTicketUntil(opCtx, Date_t::max(), priority));
+}
+
+bool TicketHolder::waitForTicketUntil(OperationContext* opCtx,
+                                      Date_t until,
+                                      AdmissionPriority priority) {
+    return _waitForTicketUntil(opCtx, until, priority);
 }
 
-bool TicketHolder::waitForTicketUntil(OperationContext* opCtx, Date_t until) {
-    // Attempt to get a ticket without waiting in order to avoid expensive time calculations.
-    if (sem_trywait(&_sem) == 0) {
+bool TicketHolder::_waitForTicketUntil(OperationContext* opCtx,
+                                       Date_t until,
+                                       AdmissionPriority priority) {
+    if (tryAcquire(priority)) {
         return true;
     }
 
-    const Milliseconds intervalMs(500);
-    struct timespec ts;
-
-    // To support interrupting ticket acquisition while still benefiting from semaphores, we do a
-    // timed wait on an interval to periodically check for interrupts.
-    // The wait period interval is the smaller of the default interval and the provided
-    // deadline.
-    Date_t deadline = std::min(until, Date_t::now() + intervalMs);
-    tsFromDate(deadline, ts);
-
-    while (0 != sem_timedwait(&_sem, &ts)) {
-        if (errno == ETIMEDOUT) {
-            // If we reached the deadline without being interrupted, we have completely timed out.
-            if (deadline == until)
-                return false;
-
-            deadline = std::min(until, Date_t::now() + intervalMs);
-            tsFromDate(deadline, ts);
-        } else if (errno != EINTR) {
-            failWithErrno(errno);
+    const auto priorityIndex = static_cast<size_t>(priority);
+    auto& queue = _queues[priorityIndex];
+    auto& stats = _stats[priorityIndex];
+    Timer queuedTimer;
+    Waiter waiter;
+
+    stdx::unique_lock<Latch> lk(_mutex);
+    auto it = queue.insert(queue.end(), &waiter);
+    _numQueued.fetchAndAdd(1);
+    stats.queued.fetchAndAdd(1);
+    _queuedSinceAdjustment.fetchAndAdd(1);
+
+    // A ticket released after the attempt above, but before this operation was counted as
+    // queued, is left in the shards for whoever queues to claim.
+    _grantQueuedWaiters(lk);
+
+    const auto dequeue = [&] {
+        queue.erase(it);
+        _numQueued.subtractAndFetch(1);
+        stats.queued.subtractAndFetch(1);
+    };
+    const auto granted = [&] { return waiter.granted; };
+
+    bool acquired = true;
+    try {
+        if (opCtx && until == Date_t::max()) {
+            opCtx->waitForConditionOrInterrupt(waiter.cv, lk, granted);
+        } else if (opCtx) {
+            acquired = opCtx->waitForConditionOrInterruptUntil(waiter.cv, lk, until, granted);
+        } else if (until == Date_t::max()) {
+            waiter.cv.wait(lk, granted);
+        } else {
+            acquired = waiter.cv.wait_until(lk, until.toSystemTimePoint(), granted);
+        }
+    } catch (...) {
+        if (!lk.owns_lock()) {
+            lk.lock();
         }
+        if (waiter.granted) {
+            // The ticket was handed over just as the operation was interrupted.
+            lk.unlock();
+            _returnTicket();
+        } else {
+            dequeue();
+        }
+        throw;
+    }
+
+    if (!acquired) {
+        dequeue();
+        stats.timedOut.fetchAndAdd(1);
+        return false;
+    }
 
-        // To correctly handle errors from sem_timedwait, we should check for interrupts last.
-        // It is possible to unset 'errno' after a call to checkForInterrupt().
-        if (opCtx)
-            opCtx->checkForInterrupt();
+    // Whoever granted the ticket has already removed this operation from the queue.
+    const auto queuedMicros = queuedTimer.micros();
+    size_t bucket = 0;
+    for (auto micros = queuedMicros; micros > 0 && bucket < kNumWaitBuckets - 1; micros >>= 1) {
+        ++bucket;
     }
+    stats.admittedAfterQueueing.fetchAndAdd(1);
+    stats.totalQueuedMicros.fetchAndAdd(queuedMicros);
+    stats.queuedMicrosHistogram[bucket].fetchAndAdd(1);
     return true;
 }
 
-void TicketHolder::release() {
-    check(sem_post(&_sem));
+void TicketHolder::_grantQueuedWaiters(WithLock) {
+    for (size_t priorityIndex = 0; priorityIndex < kNumAdmissionPriorities; ++priorityIndex) {
+        auto& queue = _queues[priorityIndex];
+        while (!queue.empty()) {
+            if (!_tryAcquireFromShards()) {
+                return;
+            }
+
+            auto waiter = queue.front();
+            queue.pop_front();
+            _numQueued.subtractAndFetch(1);
+            _stats[priorityIndex].queued.subtractAndFetch(1);
+            waiter->granted = true;
+            waiter->cv.notify_one();
+        }
+    }
 }
 
-Status TicketHolder::resize(int newSize) {
-    stdx::lock_guard<Latch> lk(_resizeMutex);
-
-    if (newSize < 5)
-        return Status(ErrorCodes::BadValue,
-                      str::stream() << "Minimum value for semaphore is 5; given " << newSize);
-
-    if (newSize > SEM_VALUE_MAX)
-        return Status(ErrorCodes::BadValue,
-                      str::stream() << "Maximum value for semaphore is " << SEM_VALUE_MAX
-                                    << "; given " << newSize);
+void TicketHolder::release() {
+    _returnTicket();
 
-    while (_outof.load() < newSize) {
-        release();
-        _outof.fetchAndAdd(1);
+    if (_dynamic.load() && _releases.fetchAndAdd(1) % kReleasesPerAdjustmentCheck == 0) {
+        _maybeAdjust();
     }
+}
 
-    while (_outof.load() > newSize) {
-        waitForTicket();
-        _outof.subtractAndFetch(1);
+void TicketHolder::_returnTicket() {
+    // Retire the ticket instead if the holder shrank while it was in use.
+    auto debt = _debt.load();
+    while (debt > 0) {
+        if (_debt.compareAndSwap(&debt, debt - 1)) {
+            return;
+        }
     }
 
-    invariant(_outof.load() == newSize);
-    return Status::OK();
-}
+    _localShard().available.fetchAndAdd(1);
 
-int TicketHolder::available() const {
-    int val = 0;
-    check(sem_getvalue(&_sem, &val));
-    return val;
+    // Checking for queued operations only after making the ticket available pairs with operations
+    // counting themselves as queued before their last attempt to take one, so that a ticket is
+    // never left unclaimed while an operation waits.
+    if (_numQueued.load() > 0) {
+        stdx::lock_guard<Latch> lk(_mutex);
+        _grantQueuedWaiters(lk);
+    }
 }
 
-int TicketHolder::used() const {
-    return outof() - available();
-}
+Status TicketHolder::resize(int newSize) {
+    if (newSize < kMinTickets)
+        return Status(ErrorCodes::BadValue,
+                      str::stream() << "Minimum number of tickets is " << kMinTickets
+                                    << "; given " << newSize);
 
-int TicketHolder::outof() const {
-    return _outof.load();
+    _configuredOutOf.store(newSize);
+    _setOutOf(newSize);
+    return Status::OK();
 }
 
-#else
-
-TicketHolder::TicketHolder(int num) : _outof(num), _num(num) {}
-
-TicketHolder::~TicketHolder() = default;
-
-bool TicketHolder::tryAcquire() {
+void TicketHolder::_setOutOf(int newSize) {
     stdx::lock_guard<Latch> lk(_mutex);
-    return _tryAcquire();
-}
 
-void TicketHolder::waitForTicket(OperationContext* opCtx) {
-    stdx::unique_lock<Latch> lk(_mutex);
+    auto delta = newSize - _outof.load();
+    _outof.store(newSize);
 
-    if (opCtx) {
-        opCtx->waitForConditionOrInterrupt(_newTicket, lk, [this] { return _tryAcquire(); });
-    } else {
-        _newTicket.wait(lk, [this] { return _tryAcquire(); });
+    if (delta < 0) {
+        // Retire available tickets straight away, and the rest as they are released.
+        auto toRetire = -delta;
+        while (toRetire > 0 && _tryAcquireFromShards()) {
+            --toRetire;
+        }
+        _debt.addAndFetch(toRetire);
+        return;
     }
-}
-
-bool TicketHolder::waitForTicketUntil(OperationContext* opCtx, Date_t until) {
-    stdx::unique_lock<Latch> lk(_mutex);
 
-    if (opCtx) {
-        return opCtx->waitForConditionOrInterruptUntil(
-            _newTicket, lk, until, [this] { return _tryAcquire(); });
-    } else {
-        return _newTicket.wait_until(
-            lk, until.toSystemTimePoint(), [this] { return _tryAcquire(); });
+    // Forgive tickets still owed by an earlier shrink before adding new ones.
+    auto debt = _debt.load();
+    while (delta > 0 && debt > 0) {
+        if (_debt.compareAndSwap(&debt, debt - 1)) {
+            --delta;
+            --debt;
+        }
     }
+    _localShard().available.fetchAndAdd(delta);
+    _grantQueuedWaiters(lk);
 }
 
-void TicketHolder::release() {
-    {
-        stdx::lock_guard<Latch> lk(_mutex);
-        _num++;
+void TicketHolder::setDynamicAdjustment(bool enabled) {
+    _dynamic.store(enabled);
+    if (!enabled) {
+        _setOutOf(_configuredOutOf.load());
     }
-    _newTicket.notify_one();
 }
 
-Status TicketHolder::resize(int newSize) {
-    stdx::lock_guard<Latch> lk(_mutex);
+void TicketHolder::_maybeAdjust() {
+    stdx::unique_lock<Latch> lk(_adjustMutex, stdx::try_to_lock);
+    if (!lk.owns_lock()) {
+        return;
+    }
 
-    int used = _outof.load() - _num;
-    if (used > newSize) {
-        std::stringstream ss;
-        ss << "can't resize since we're using (" << used << ") "
-           << "more than newSize(" << newSize << ")";
+    const auto now = Date_t::now();
+    const auto releases = _releases.load();
+    if (_lastAdjustment == Date_t()) {
+        _lastAdjustment = now;
+        _releasesAtLastAdjustment = releases;
+        return;
+    }
 
-        std::string errmsg = ss.str();
-        LOGV2(23120, "{errmsg}", "errmsg"_attr = errmsg);
-        return Status(ErrorCodes::BadValue, errmsg);
+    const auto elapsed = now - _lastAdjustment;
+    if (elapsed < kAdjustmentInterval) {
+        return;
     }
 
-    _outof.store(newSize);
-    _num = _outof.load() - used;
+    const double throughput = static_cast<double>(releases - _releasesAtLastAdjustment) /
+        durationCount<Milliseconds>(elapsed);
+    _lastAdjustment = now;
+    _releasesAtLastAdjustment = releases;
 
-    // Potentially wasteful, but easier to see is correct
-    _newTicket.notify_all();
-    return Status::OK();
+    // The number of tickets only limits throughput while operations are queueing for them.
+    if (_queuedSinceAdjustment.swap(0) == 0) {
+        return;
+    }
+
+    // Keep moving in the same direction while it helps, and turn around once it stops helping.
+    if (throughput < _lastThroughput) {
+        _adjustmentDirection = -_adjustmentDirection;
+    }
+    _lastThroughput = throughput;
+
+    const auto current = _outof.load();
+    const auto maxTickets = std::max(kMinTickets, _configuredOutOf.load());
+    const auto step = std::max(1, current / 8);
+    const auto target = std::clamp(current + _adjustmentDirection * step, kMinTickets, maxTickets);
+    if (target == current) {
+        _adjustmentDirection = -_adjustmentDirection;
+        return;
+    }
+    _numAdjustments.fetchAndAdd(1);
+    lk.unlock();
+
+    LOGV2_DEBUG(4910800,
+                2,
+                "Adjusting the number of tickets",
+                "from"_attr = current,
+                "to"_attr = target,
+                "releasesPerMilli"_attr = throughput);
+    _setOutOf(target);
 }
 
 int TicketHolder::available() const {
-    return _num;
+    int available = 0;
+    for (const auto& shard : _shards) {
+        available += shard.available.load();
+    }
+    return available;
 }
 
 int TicketHolder::used() const {
-    return outof() - _num;
+    return std::max(0, outof() + _debt.load() - available());
 }
 
 int TicketHolder::outof() const {
     return _outof.load();
 }
 
-bool TicketHolder::_tryAcquire() {
-    if (_num <= 0) {
-        if (_num < 0) {
-            std::cerr << "DISASTER! in TicketHolder" << std::endl;
+int TicketHolder::queued() const {
+    return _numQueued.load();
+}
+
+void TicketHolder::appendStats(BSONObjBuilder* builder) const {
+    builder->append("out", used());
+    builder->append("available", available());
+    builder->append("totalTickets", outof());
+    builder->append("queueDepth", queued());
+    if (_dynamic.load()) {
+        builder->append("maxTickets", _configuredOutOf.load());
+        builder->append("adjustments", _numAdjustments.load());
+    }
+
+    BSONObjBuilder prioritiesBuilder(builder->subobjStart("priorities"));
+    for (size_t priorityIndex = 0; priorityIndex < kNumAdmissionPriorities; ++priorityIndex) {
+        const auto& stats = _stats[priorityIndex];
+        long long admittedImmediately = 0;
+        for (const auto& shard : _shards) {
+            admittedImmediately += shard.admittedImmediately[priorityIndex].load();
+        }
+
+        BSONObjBuilder priorityBuilder(
+            prioritiesBuilder.subobjStart(toString(static_cast<AdmissionPriority>(priorityIndex))));
+        priorityBuilder.append("queued", stats.queued.load());
+        priorityBuilder.append("admittedImmediately", admittedImmediately);
+        priorityBuilder.append("admittedAfterQueueing", stats.admittedAfterQueueing.load());
+        priorityBuilder.append("timedOut", stats.timedOut.load());
+        priorityBuilder.append("totalQueuedMicros", stats.totalQueuedMicros.load());
+
+        BSONArrayBuilder histogramBuilder(priorityBuilder.subarrayStart("queuedMicrosHistogram"));
+        for (size_t bucket = 0; bucket < kNumWaitBuckets; ++bucket) {
+            const auto count = stats.queuedMicrosHistogram[bucket].load();
+            if (count == 0) {
+                continue;
+            }
+            BSONObjBuilder entryBuilder(histogramBuilder.subobjStart());
+            entryBuilder.append("micros", bucket ? 1LL << (bucket - 1) : 0LL);
+            entryBuilder.append("count", count);
         }
-        return false;
     }
-    _num--;
-    return true;
 }
-#endif
+
 }  // namespace mongo
@@ -28,35 +28,51 @@
  */
 #pragma once
 
-#if defined(__linux__)
-#include <semaphore.h>
-#endif
+#include <array>
+#include <list>
 
 #include "mongo/db/operation_context.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/platform/mutex.h"
 #include "mongo/stdx/condition_variable.h"
+#include "mongo/util/concurrency/admission_priority.h"
 #include "mongo/util/concurrency/mutex.h"
+#include "mongo/util/concurrency/with_lock.h"
 #include "mongo/util/hierarchical_acquisition.h"
 #include "mongo/util/time_support.h"
 
 namespace mongo {
 
+class BSONObjBuilder;
+
+/**
+ * Admission control limiting how many operations may concurrently hold a ticket.
+ *
+ * Available tickets are spread across cache-line-aligned shards, so that acquiring and releasing
+ * a ticket while tickets are plentiful is a compare-and-swap on a shard picked per thread. Only
+ * when no ticket is available does an operation take the mutex and queue, after which released
+ * tickets are handed directly to the longest-waiting operation of the highest priority.
+ */
 class TicketHolder {
     TicketHolder(const TicketHolder&) = delete;
     TicketHolder& operator=(const TicketHolder&) = delete;
 
 public:
+    // The fewest tickets a holder may be resized to or may adjust itself down to.
+    static constexpr int kMinTickets = 5;
+
     explicit TicketHolder(int num);
     ~TicketHolder();
 
-    bool tryAcquire();
+    bool tryAcquire(AdmissionPriority priority = AdmissionPriority::kNormal);
 
     /**
      * Attempts to acquire a ticket. Blocks until a ticket is acquired or the OperationContext
      * 'opCtx' is killed, throwing an AssertionException.
      * If 'opCtx' is not provided or equal to nullptr, the wait is not interruptible.
      */
-    void waitForTicket(OperationContext* opCtx);
+    void waitForTicket(OperationContext* opCtx,
+                       AdmissionPriority priority = AdmissionPriority::kNormal);
     void waitForTicket() {
         waitForTicket(nullptr);
     }
@@ -68,36 +84,111 @@ public:
      * proceed.
      * If 'opCtx' is not provided or equal to nullptr, the wait is not interruptible.
      */
-    bool waitForTicketUntil(OperationContext* opCtx, Date_t until);
+    bool waitForTicketUntil(OperationContext* opCtx,
+                            Date_t until,
+                            AdmissionPriority priority = AdmissionPriority::kNormal);
     bool waitForTicketUntil(Date_t until) {
         return waitForTicketUntil(nullptr, until);
     }
     void release();
 
+    /**
+     * Sets the number of tickets. Shrinking never blocks: tickets in use beyond the new size are
+     * retired as they are released.
+     */
     Status resize(int newSize);
 
+    /**
+     * While enabled, the number of tickets is periodically moved between kMinTickets and the size
+     * set by the constructor or resize(), in whichever direction last increased the rate at which
+     * operations completed. Adjustments are only made while operations are queueing.
+     */
+    void setDynamicAdjustment(bool enabled);
+
     int available() const;
 
     int used() const;
 
     int outof() const;
 
+    /**
+     * Returns the number of operations currently queued for a ticket.
+     */
+    int queued() const;
+
+    /**
+     * Appends the queue depth and, per priority, the number of admissions and a histogram of the
+     * time spent queued.
+     */
+    void appendStats(BSONObjBuilder* builder) const;
+
 private:
-#if defined(__linux__)
-    mutable sem_t _sem;
+    static constexpr size_t kNumShards = 16;
 
-    // You can read _outof without a lock, but have to hold _resizeMutex to change.
-    AtomicWord<int> _outof;
-    Mutex _resizeMutex =
-        MONGO_MAKE_LATCH(HierarchicalAcquisitionLevel(0), "TicketHolder::_resizeMutex");
-#else
-    bool _tryAcquire();
+    // Queued waits are bucketed by powers of two microseconds; the last bucket is unbounded.
+    static constexpr size_t kNumWaitBuckets = 24;
+
+    struct Waiter {
+        stdx::condition_variable cv;
+        bool granted = false;
+    };
+
+    struct alignas(64) Shard {
+        AtomicWord<int> available{0};
+        std::array<AtomicWord<long long>, kNumAdmissionPriorities> admittedImmediately{};
+    };
+
+    struct PriorityStats {
+        AtomicWord<int> queued{0};
+        AtomicWord<long long> admittedAfterQueueing{0};
+        AtomicWord<long long> timedOut{0};
+        AtomicWord<long long> totalQueuedMicros{0};
+        std::array<AtomicWord<long long>, kNumWaitBuckets> queuedMicrosHistogram{};
+    };
+
+    Shard& _localShard();
+    bool _tryAcquireFromShards();
+    bool _waitForTicketUntil(OperationContext* opCtx, Date_t until, AdmissionPriority priority);
+
+    /**
+     * Returns a ticket to the holder, handing it to the next waiter if there is one. Tickets owed
+     * to a shrink are retired instead.
+     */
+    void _returnTicket();
 
+    /**
+     * Hands tickets sitting in the shards to queued waiters, in priority and arrival order.
+     */
+    void _grantQueuedWaiters(WithLock);
+
+    void _setOutOf(int newSize);
+    void _maybeAdjust();
+
+    std::array<Shard, kNumShards> _shards;
+
+    // The target number of tickets, and the number of tickets still to be retired because the
+    // target shrank while they were in use.
     AtomicWord<int> _outof;
-    int _num;
+    AtomicWord<int> _debt{0};
+
+    // The size set by the constructor or resize(), which bounds dynamic adjustment.
+    AtomicWord<int> _configuredOutOf;
+
+    AtomicWord<int> _numQueued{0};
     Mutex _mutex = MONGO_MAKE_LATCH(HierarchicalAcquisitionLevel(0), "TicketHolder::_mutex");
-    stdx::condition_variable _newTicket;
-#endif
+    std::array<std::list<Waiter*>, kNumAdmissionPriorities> _queues;
+    std::array<PriorityStats, kNumAdmissionPriorities> _stats;
+
+    // State of the dynamic adjustment, which is only read and written under _adjustMutex.
+    AtomicWord<bool> _dynamic{false};
+    AtomicWord<long long> _releases{0};
+    AtomicWord<long long> _queuedSinceAdjustment{0};
+    Mutex _adjustMutex = MONGO_MAKE_LATCH("TicketHolder::_adjustMutex");
+    Date_t _lastAdjustment;
+    long long _releasesAtLastAdjustment = 0;
+    double _lastThroughput = 0;
+    int _adjustmentDirection = -1;
+    AtomicWord<long long> _numAdjustments{0};
 };
 
 class ScopedTicket {
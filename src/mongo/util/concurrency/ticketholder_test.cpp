@@ -32,6 +32,11 @@
 
 #include "mongo/platform/basic.h"
 
+#include <vector>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/platform/mutex.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/concurrency/ticketholder.h"
 
@@ -72,4 +77,105 @@ TEST(TicketholderTest, BasicTimeout) {
     holder.release();
     ASSERT_EQ(holder.used(), 0);
 }
+
+void waitForQueueDepth(const TicketHolder& holder, int depth) {
+    while (holder.queued() != depth) {
+        sleepmillis(1);
+    }
+}
+
+TEST(TicketholderTest, QueuedWaitersAreAdmittedInPriorityThenArrivalOrder) {
+    TicketHolder holder(1);
+    holder.waitForTicket();
+
+    auto mutex = MONGO_MAKE_LATCH();
+    std::vector<int> admitted;
+    std::vector<stdx::thread> threads;
+    const std::vector<std::pair<int, AdmissionPriority>> waiters = {
+        {0, AdmissionPriority::kLow},
+        {1, AdmissionPriority::kNormal},
+        {2, AdmissionPriority::kHigh},
+        {3, AdmissionPriority::kNormal},
+        {4, AdmissionPriority::kHigh},
+    };
+    for (const auto& [id, priority] : waiters) {
+        threads.emplace_back([&, id = id, priority = priority] {
+            holder.waitForTicket(nullptr, priority);
+            {
+                stdx::lock_guard<Latch> lk(mutex);
+                admitted.push_back(id);
+            }
+            holder.release();
+        });
+        waitForQueueDepth(holder, threads.size());
+    }
+
+    holder.release();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    ASSERT_EQ(admitted, (std::vector<int>{2, 4, 1, 3, 0}));
+    ASSERT_EQ(holder.used(), 0);
+    ASSERT_EQ(holder.queued(), 0);
+}
+
+TEST(TicketholderTest, ResizeBelowUsedDoesNotBlock) {
+    TicketHolder holder(10);
+    for (int i = 0; i < 8; ++i) {
+        ASSERT(holder.tryAcquire());
+    }
+
+    ASSERT_OK(holder.resize(TicketHolder::kMinTickets));
+    ASSERT_EQ(holder.outof(), TicketHolder::kMinTickets);
+    ASSERT_EQ(holder.available(), 0);
+    ASSERT_FALSE(holder.tryAcquire());
+
+    // The first releases retire the tickets in use beyond the new size.
+    for (int i = 0; i < 3; ++i) {
+        holder.release();
+        ASSERT_EQ(holder.available(), 0);
+    }
+    holder.release();
+    ASSERT_EQ(holder.available(), 1);
+    ASSERT_EQ(holder.used(), 4);
+
+    for (int i = 0; i < 4; ++i) {
+        holder.release();
+    }
+    ASSERT_EQ(holder.available(), TicketHolder::kMinTickets);
+    ASSERT_EQ(holder.used(), 0);
+
+    ASSERT_EQ(holder.resize(TicketHolder::kMinTickets - 1), ErrorCodes::BadValue);
+}
+
+TEST(TicketholderTest, StatsCountImmediateAndQueuedAdmissions) {
+    TicketHolder holder(1);
+    ASSERT(holder.tryAcquire(AdmissionPriority::kHigh));
+    ASSERT_FALSE(holder.waitForTicketUntil(
+        nullptr, Date_t::now() + Milliseconds(1), AdmissionPriority::kLow));
+
+    stdx::thread waiter([&] { holder.waitForTicket(nullptr, AdmissionPriority::kNormal); });
+    waitForQueueDepth(holder, 1);
+    holder.release();
+    waiter.join();
+
+    BSONObjBuilder builder;
+    holder.appendStats(&builder);
+    const auto stats = builder.obj();
+    ASSERT_EQ(stats["out"].numberInt(), 1);
+    ASSERT_EQ(stats["available"].numberInt(), 0);
+    ASSERT_EQ(stats["totalTickets"].numberInt(), 1);
+    ASSERT_EQ(stats["queueDepth"].numberInt(), 0);
+
+    const auto priorities = stats["priorities"].Obj();
+    ASSERT_EQ(priorities["high"]["admittedImmediately"].numberLong(), 1);
+    ASSERT_EQ(priorities["high"]["admittedAfterQueueing"].numberLong(), 0);
+    ASSERT_EQ(priorities["normal"]["admittedAfterQueueing"].numberLong(), 1);
+    ASSERT_EQ(priorities["normal"]["queuedMicrosHistogram"].Array().size(), 1U);
+    ASSERT_EQ(priorities["low"]["timedOut"].numberLong(), 1);
+    ASSERT_EQ(priorities["low"]["admittedImmediately"].numberLong(), 0);
+
+    holder.release();
+}
 }  // namespace
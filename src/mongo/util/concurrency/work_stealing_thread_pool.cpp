@@ -0,0 +1,341 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#define MONGO_LOGV2_DEFAULT_COMPONENT ::mongo::logv2::LogComponent::kExecutor
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/concurrency/work_stealing_thread_pool.h"
+
+#include "mongo/base/status.h"
+#include "mongo/logv2/log.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/concurrency/idle_thread_block.h"
+#include "mongo/util/concurrency/thread_name.h"
+#include "mongo/util/str.h"
+
+namespace mongo {
+
+namespace {
+
+// Counter used to assign unique names to otherwise-unnamed thread pools.
+AtomicWord<int> nextUnnamedPoolId{1};
+
+// The pool and queue of the worker thread running on this thread, if any, so that tasks scheduled
+// by a task go to the queue of the thread which is already running.
+thread_local const void* currentPool = nullptr;
+thread_local size_t currentWorkerIndex = 0;
+
+WorkStealingThreadPool::Options cleanUpOptions(WorkStealingThreadPool::Options&& options) {
+    if (options.poolName.empty()) {
+        options.poolName = str::stream()
+            << "WorkStealingThreadPool" << nextUnnamedPoolId.fetchAndAdd(1);
+    }
+    if (options.threadNamePrefix.empty()) {
+        options.threadNamePrefix = str::stream() << options.poolName << '-';
+    }
+    if (options.numThreads < 1) {
+        LOGV2_FATAL(4911000,
+                    "Cannot create pool {poolName} with {numThreads} threads",
+                    "Cannot create pool with fewer than 1 thread",
+                    "poolName"_attr = options.poolName,
+                    "numThreads"_attr = options.numThreads);
+    }
+    return {std::move(options)};
+}
+
+}  // namespace
+
+WorkStealingThreadPool::WorkStealingThreadPool(Options options)
+    : _options(cleanUpOptions(std::move(options))) {
+    _workers.reserve(_options.numThreads);
+    for (size_t i = 0; i < _options.numThreads; ++i) {
+        _workers.push_back(std::make_unique<Worker>(static_cast<uint32_t>(i + 1)));
+    }
+}
+
+WorkStealingThreadPool::~WorkStealingThreadPool() {
+    shutdown();
+    if (_state.load() != shutdownComplete) {
+        join();
+    }
+    invariant(_threads.empty());
+    invariant(_numPendingTasks.load() == 0);
+}
+
+void WorkStealingThreadPool::startup() {
+    stdx::lock_guard<Latch> lk(_mutex);
+    if (_state.load() != preStart) {
+        LOGV2_FATAL(4911001,
+                    "Attempted to start pool {poolName}, but it has already started",
+                    "Attempted to start pool that has already started",
+                    "poolName"_attr = _options.poolName);
+    }
+    _setState_inlock(running);
+    for (size_t i = 0; i < _workers.size(); ++i) {
+        const std::string threadName = str::stream() << _options.threadNamePrefix << i;
+        _threads.emplace_back([this, i, threadName] { _workerThreadBody(this, i, threadName); });
+    }
+}
+
+void WorkStealingThreadPool::shutdown() {
+    stdx::lock_guard<Latch> lk(_mutex);
+    switch (_state.load()) {
+        case preStart:
+        case running:
+            _setState_inlock(joinRequired);
+            break;
+        default:
+            return;
+    }
+
+    stdx::lock_guard<Latch> parkLk(_parkMutex);
+    _workAvailable.notify_all();
+}
+
+void WorkStealingThreadPool::join() {
+    stdx::unique_lock<Latch> lk(_mutex);
+    _stateChange.wait(lk, [this] {
+        switch (_state.load()) {
+            case preStart:
+            case running:
+                return false;
+            case joinRequired:
+                return true;
+            case joining:
+            case shutdownComplete:
+                LOGV2_FATAL(4911002,
+                            "Attempted to join pool {poolName} more than once",
+                            "Attempted to join pool more than once",
+                            "poolName"_attr = _options.poolName);
+        }
+        MONGO_UNREACHABLE;
+    });
+    _setState_inlock(joining);
+    auto threadsToJoin = std::move(_threads);
+    _threads.clear();
+    lk.unlock();
+
+    // The workers drain the queues before returning. A pool which was never started has no
+    // workers, so its queues are drained here instead.
+    if (threadsToJoin.empty()) {
+        _drainPendingTasks();
+    }
+    for (auto& t : threadsToJoin) {
+        t.join();
+    }
+
+    lk.lock();
+    _setState_inlock(shutdownComplete);
+}
+
+void WorkStealingThreadPool::schedule(Task task) {
+    // Count the task as pending before checking the state, so that a worker which sees the pool
+    // shutting down with no pending tasks can be sure no task will be queued behind it.
+    _numPendingTasks.fetchAndAdd(1);
+    if (_state.load() >= joinRequired) {
+        _numPendingTasks.subtractAndFetch(1);
+        task(Status(ErrorCodes::ShutdownInProgress,
+                    str::stream() << "Shutdown of thread pool " << _options.poolName
+                                  << " in progress"));
+        return;
+    }
+
+    const auto workerIndex = currentPool == this
+        ? currentWorkerIndex
+        : _nextWorker.fetchAndAdd(1) % _workers.size();
+    auto& worker = *_workers[workerIndex];
+    {
+        stdx::lock_guard<Latch> lk(worker.mutex);
+        worker.tasks.emplace_back(std::move(task));
+    }
+
+    if (_numParked.load() > 0) {
+        stdx::lock_guard<Latch> lk(_parkMutex);
+        _workAvailable.notify_one();
+    }
+}
+
+WorkStealingThreadPool::Stats WorkStealingThreadPool::getStats() const {
+    Stats result;
+    {
+        stdx::lock_guard<Latch> lk(_mutex);
+        result.numThreads = _threads.size();
+    }
+    result.numPendingTasks = static_cast<size_t>(std::max(0LL, _numPendingTasks.load()));
+    result.numStolenTasks = _numStolenTasks.load();
+    result.numParks = _numParks.load();
+    return result;
+}
+
+void WorkStealingThreadPool::_workerThreadBody(WorkStealingThreadPool* pool,
+                                               size_t workerIndex,
+                                               const std::string& threadName) noexcept {
+    setThreadName(threadName);
+    pool->_options.onCreateThread(threadName);
+    LOGV2_DEBUG(4911003,
+                1,
+                "Starting thread {threadName} in pool {poolName}",
+                "Starting thread",
+                "threadName"_attr = threadName,
+                "poolName"_attr = pool->_options.poolName);
+
+    currentPool = pool;
+    currentWorkerIndex = workerIndex;
+    pool->_consumeTasks(workerIndex);
+    currentPool = nullptr;
+
+    LOGV2_DEBUG(4911004,
+                1,
+                "Shutting down thread {threadName} in pool {poolName}",
+                "Shutting down thread",
+                "threadName"_attr = threadName,
+                "poolName"_attr = pool->_options.poolName);
+}
+
+void WorkStealingThreadPool::_consumeTasks(size_t workerIndex) {
+    while (true) {
+        if (auto task = _takeTask(workerIndex)) {
+            _runTask(std::move(*task));
+            continue;
+        }
+
+        if (_state.load() >= joinRequired) {
+            if (_numPendingTasks.load() == 0) {
+                return;
+            }
+            // A task is on its way into a queue.
+            stdx::this_thread::yield();
+            continue;
+        }
+
+        _park();
+    }
+}
+
+boost::optional<WorkStealingThreadPool::Task> WorkStealingThreadPool::_takeTask(
+    size_t workerIndex) {
+    auto& self = *_workers[workerIndex];
+    {
+        stdx::lock_guard<Latch> lk(self.mutex);
+        if (auto task = _popTask(self)) {
+            return task;
+        }
+    }
+
+    const auto numWorkers = _workers.size();
+    const auto start =
+        static_cast<size_t>(self.random.nextInt32(static_cast<int32_t>(numWorkers)));
+    for (size_t i = 0; i < numWorkers; ++i) {
+        const auto victimIndex = (start + i) % numWorkers;
+        if (victimIndex == workerIndex) {
+            continue;
+        }
+
+        // A thief never waits on a contended queue. If every queue it skips still holds tasks,
+        // _numPendingTasks keeps it from parking and it comes straight back.
+        auto& victim = *_workers[victimIndex];
+        stdx::unique_lock<Latch> lk(victim.mutex, stdx::try_to_lock);
+        if (!lk.owns_lock()) {
+            continue;
+        }
+        if (auto task = _popTask(victim)) {
+            _numStolenTasks.fetchAndAdd(1);
+            return task;
+        }
+    }
+    return boost::none;
+}
+
+boost::optional<WorkStealingThreadPool::Task> WorkStealingThreadPool::_popTask(Worker& worker) {
+    if (worker.tasks.empty()) {
+        return boost::none;
+    }
+    auto task = std::move(worker.tasks.front());
+    worker.tasks.pop_front();
+    _numPendingTasks.subtractAndFetch(1);
+    return std::move(task);
+}
+
+void WorkStealingThreadPool::_park() {
+    stdx::unique_lock<Latch> lk(_parkMutex);
+
+    // Counting this worker as parked before checking for tasks pairs with schedule() counting a
+    // task as pending before checking for parked workers, so a task never waits on a sleeping
+    // pool.
+    _numParked.addAndFetch(1);
+    const auto shouldWake = [this] {
+        return _numPendingTasks.load() > 0 || _state.load() != running;
+    };
+    if (!shouldWake()) {
+        _numParks.fetchAndAdd(1);
+        MONGO_IDLE_THREAD_BLOCK;
+        _workAvailable.wait(lk, shouldWake);
+    }
+    _numParked.subtractAndFetch(1);
+}
+
+void WorkStealingThreadPool::_runTask(Task task) noexcept {
+    task(Status::OK());
+}
+
+void WorkStealingThreadPool::_drainPendingTasks() {
+    // Tasks cannot be run inline because they can create OperationContexts and the join() caller
+    // may already have one associated with the thread.
+    stdx::thread cleanThread = stdx::thread([&] {
+        const std::string threadName = str::stream() << _options.threadNamePrefix << "drain";
+        setThreadName(threadName);
+        _options.onCreateThread(threadName);
+        for (auto& worker : _workers) {
+            while (true) {
+                boost::optional<Task> task;
+                {
+                    stdx::lock_guard<Latch> lk(worker->mutex);
+                    task = _popTask(*worker);
+                }
+                if (!task) {
+                    break;
+                }
+                _runTask(std::move(*task));
+            }
+        }
+    });
+    cleanThread.join();
+}
+
+void WorkStealingThreadPool::_setState_inlock(LifecycleState newState) {
+    if (newState == _state.load()) {
+        return;
+    }
+    _state.store(newState);
+    _stateChange.notify_all();
+}
+
+}  // namespace mongo
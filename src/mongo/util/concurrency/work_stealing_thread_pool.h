@@ -0,0 +1,202 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <deque>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <boost/optional.hpp>
+
+#include "mongo/platform/atomic_word.h"
+#include "mongo/platform/mutex.h"
+#include "mongo/platform/random.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/util/concurrency/thread_pool_interface.h"
+
+namespace mongo {
+
+/**
+ * A thread pool with a fixed number of threads, each of which has its own queue of tasks.
+ *
+ * Tasks scheduled by a task running in the pool go to the queue of the thread running it, and
+ * other tasks are spread across the queues in turn, so that scheduling does not contend on a
+ * mutex shared by the whole pool. A thread whose queue is empty steals tasks from the queues of
+ * the other threads, visiting them from a random starting point, and parks only once every queue
+ * is empty.
+ *
+ * Tasks run in the order they were scheduled onto a queue, but tasks on different queues, or
+ * stolen from a queue, may run in any order. Callers which need tasks to run one at a time in the
+ * order they were scheduled should use a ThreadPool limited to one thread instead.
+ *
+ * Startup, shutdown and join behave as they do for ThreadPool.
+ */
+class WorkStealingThreadPool final : public ThreadPoolInterface {
+    WorkStealingThreadPool(const WorkStealingThreadPool&) = delete;
+    WorkStealingThreadPool& operator=(const WorkStealingThreadPool&) = delete;
+
+public:
+    /**
+     * Structure used to configure an instance of WorkStealingThreadPool.
+     */
+    struct Options {
+        // Name of the thread pool. If this string is empty, the pool will be assigned a
+        // name unique to the current process.
+        std::string poolName;
+
+        // Prefix used to name threads for logging purposes. An integer will be appended to this
+        // string to create the thread name for each thread in the pool. If you leave this empty,
+        // the prefix will be the pool name followed by a hyphen.
+        std::string threadNamePrefix;
+
+        // The number of threads started by startup(). Threads are neither added nor reaped
+        // afterwards.
+        size_t numThreads = 8;
+
+        // This function is run before each worker thread begins consuming tasks.
+        using OnCreateThreadFn = std::function<void(const std::string& threadName)>;
+        OnCreateThreadFn onCreateThread = [](const std::string&) {};
+    };
+
+    /**
+     * Structure used to return information about the thread pool via getStats().
+     */
+    struct Stats {
+        // The number of threads currently in the pool.
+        size_t numThreads;
+
+        // The number of tasks waiting to be executed by the pool.
+        size_t numPendingTasks;
+
+        // The number of tasks run by a thread other than the one whose queue they were on.
+        long long numStolenTasks;
+
+        // The number of times a thread found every queue empty and went to sleep.
+        long long numParks;
+    };
+
+    explicit WorkStealingThreadPool(Options options);
+
+    ~WorkStealingThreadPool() override;
+
+    void startup() override;
+    void shutdown() override;
+    void join() override;
+    void schedule(Task task) override;
+
+    /**
+     * Returns statistics about the thread pool's utilization.
+     */
+    Stats getStats() const;
+
+private:
+    /**
+     * Representation of the stage of life of a thread pool, with the same transitions as
+     * ThreadPool::LifecycleState.
+     */
+    enum LifecycleState { preStart, running, joinRequired, joining, shutdownComplete };
+
+    /**
+     * A queue of tasks, owned by one worker thread but open to theft by the others.
+     */
+    struct alignas(64) Worker {
+        explicit Worker(uint32_t seed) : random(seed) {}
+
+        Mutex mutex = MONGO_MAKE_LATCH("WorkStealingThreadPool::Worker::mutex");
+        std::deque<Task> tasks;
+
+        // Only used by the thread which owns this queue, to pick where to begin stealing.
+        PseudoRandom random;
+    };
+
+    static void _workerThreadBody(WorkStealingThreadPool* pool,
+                                  size_t workerIndex,
+                                  const std::string& threadName) noexcept;
+
+    /**
+     * This is the run loop of a worker thread. Returns once the pool is shutting down and no
+     * tasks remain.
+     */
+    void _consumeTasks(size_t workerIndex);
+
+    /**
+     * Takes the next task from the worker's own queue or, failing that, from another worker's.
+     */
+    boost::optional<Task> _takeTask(size_t workerIndex);
+    boost::optional<Task> _popTask(Worker& worker);
+
+    /**
+     * Sleeps until a task is scheduled or the pool begins to shut down.
+     */
+    void _park();
+
+    void _runTask(Task task) noexcept;
+
+    /**
+     * Runs any tasks scheduled before startup() on a new thread, for pools which are joined
+     * without ever being started.
+     */
+    void _drainPendingTasks();
+
+    void _setState_inlock(LifecycleState newState);
+
+    const Options _options;
+
+    std::vector<std::unique_ptr<Worker>> _workers;
+
+    // Tasks scheduled from outside the pool are spread across the workers in turn.
+    AtomicWord<unsigned> _nextWorker{0};
+
+    // Counts tasks from the moment schedule() commits to queueing them until they are taken, so
+    // that the workers never all park or exit while a task is on its way into a queue.
+    AtomicWord<long long> _numPendingTasks{0};
+
+    AtomicWord<int> _state{preStart};
+
+    // Guards lifecycle transitions and _threads.
+    mutable Mutex _mutex = MONGO_MAKE_LATCH("WorkStealingThreadPool::_mutex");
+    stdx::condition_variable _stateChange;
+    std::vector<stdx::thread> _threads;
+
+    // Parked workers sleep on _workAvailable. Schedulers only take _parkMutex to wake one when
+    // _numParked says there is a worker to wake.
+    Mutex _parkMutex = MONGO_MAKE_LATCH("WorkStealingThreadPool::_parkMutex");
+    stdx::condition_variable _workAvailable;
+    AtomicWord<int> _numParked{0};
+
+    AtomicWord<long long> _numStolenTasks{0};
+    AtomicWord<long long> _numParks{0};
+};
+
+}  // namespace mongo
@@ -0,0 +1,125 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#define MONGO_LOGV2_DEFAULT_COMPONENT ::mongo::logv2::LogComponent::kTest
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/base/init.h"
+#include "mongo/platform/mutex.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/concurrency/thread_pool_test_common.h"
+#include "mongo/util/concurrency/work_stealing_thread_pool.h"
+
+namespace {
+using namespace mongo;
+
+MONGO_INITIALIZER(WorkStealingThreadPoolCommonTests)(InitializerContext*) {
+    addTestsForThreadPool("WorkStealingThreadPoolCommon", []() {
+        return std::make_unique<WorkStealingThreadPool>(WorkStealingThreadPool::Options());
+    });
+    return Status::OK();
+}
+
+TEST(WorkStealingThreadPoolTest, IdleThreadsStealTasksQueuedBehindABusyThread) {
+    WorkStealingThreadPool::Options options;
+    options.numThreads = 4;
+    WorkStealingThreadPool pool(options);
+    pool.startup();
+
+    constexpr int kNumTasks = 100;
+    auto mutex = MONGO_MAKE_LATCH();
+    stdx::condition_variable cv;
+    int numRun = 0;
+
+    // Tasks scheduled from within the pool are queued behind the task scheduling them, which does
+    // not return until they have all run, so every one of them must be stolen.
+    pool.schedule([&](auto status) {
+        ASSERT_OK(status);
+        for (int i = 0; i < kNumTasks; ++i) {
+            pool.schedule([&](auto status) {
+                ASSERT_OK(status);
+                stdx::lock_guard<Latch> lk(mutex);
+                ++numRun;
+                cv.notify_all();
+            });
+        }
+
+        stdx::unique_lock<Latch> lk(mutex);
+        cv.wait(lk, [&] { return numRun == kNumTasks; });
+    });
+
+    pool.shutdown();
+    pool.join();
+
+    ASSERT_EQ(numRun, kNumTasks);
+    ASSERT_GTE(pool.getStats().numStolenTasks, kNumTasks);
+    ASSERT_EQ(pool.getStats().numPendingTasks, 0U);
+}
+
+TEST(WorkStealingThreadPoolTest, ParkedThreadsWakeForNewTasks) {
+    WorkStealingThreadPool::Options options;
+    options.numThreads = 2;
+    WorkStealingThreadPool pool(options);
+    pool.startup();
+
+    auto mutex = MONGO_MAKE_LATCH();
+    stdx::condition_variable cv;
+    int numRun = 0;
+    const auto waitForParks = [&](long long numParks) {
+        while (pool.getStats().numParks < numParks) {
+            sleepmillis(1);
+        }
+    };
+
+    // Wait for the threads to park before each task, so that each task has to wake one.
+    waitForParks(2);
+    for (int i = 0; i < 10; ++i) {
+        const auto numParks = pool.getStats().numParks;
+        pool.schedule([&](auto status) {
+            ASSERT_OK(status);
+            stdx::lock_guard<Latch> lk(mutex);
+            ++numRun;
+            cv.notify_all();
+        });
+
+        stdx::unique_lock<Latch> lk(mutex);
+        cv.wait(lk, [&] { return numRun == i + 1; });
+        lk.unlock();
+        waitForParks(numParks + 1);
+    }
+
+    pool.shutdown();
+    pool.join();
+    ASSERT_EQ(pool.getStats().numThreads, 0U);
+}
+
+}  // namespace
@@ -31,11 +31,143 @@
 
 #include "summation.h"
 
+#include <algorithm>
 #include <cmath>
 
+#if defined(_M_AMD64) || defined(__amd64__)
+#define MONGO_HAVE_SSE2_SUMMATION
+#include <emmintrin.h>
+#endif
+
 #include "mongo/util/assert_util.h"
 
 namespace mongo {
+namespace {
+
+// The number of independent compensated sums used by addDoubleBatch().
+constexpr size_t kLanes = 4;
+
+// The largest number of values addLongBatch() adds up in one pass. It keeps both the sum of the
+// high halves, shifted back into place, and the sum of the low halves exactly representable.
+constexpr size_t kMaxLongPass = size_t{1} << 20;
+
+#ifdef MONGO_HAVE_SSE2_SUMMATION
+// The steps of DoubleDoubleSummation::addDouble() for two lanes at a time.
+inline void addToLanePair(__m128d x, __m128d* sum, __m128d* addend) {
+    // Fast2Sum of 'x' and '*addend'.
+    __m128d s = _mm_add_pd(x, *addend);
+    *addend = _mm_sub_pd(*addend, _mm_sub_pd(s, x));
+    x = s;
+
+    // 2Sum of '*sum' and 'x'.
+    s = _mm_add_pd(*sum, x);
+    const __m128d aPrime = _mm_sub_pd(s, x);
+    const __m128d bPrime = _mm_sub_pd(s, aPrime);
+    x = _mm_add_pd(_mm_sub_pd(*sum, aPrime), _mm_sub_pd(x, bPrime));
+    *sum = s;
+
+    *addend = _mm_add_pd(*addend, x);
+}
+#endif
+
+/**
+ * Adds value i of the 'count' values starting at 'values' to lane i % kLanes of 'sums' and
+ * 'addends', using the compensated addition of DoubleDoubleSummation::addDouble(). 'count' must be
+ * a multiple of kLanes.
+ */
+void addToLanes(const double* values, size_t count, double* sums, double* addends) {
+#ifdef MONGO_HAVE_SSE2_SUMMATION
+    __m128d sum0 = _mm_setzero_pd();
+    __m128d sum1 = _mm_setzero_pd();
+    __m128d addend0 = _mm_setzero_pd();
+    __m128d addend1 = _mm_setzero_pd();
+    for (size_t i = 0; i < count; i += kLanes) {
+        addToLanePair(_mm_loadu_pd(values + i), &sum0, &addend0);
+        addToLanePair(_mm_loadu_pd(values + i + 2), &sum1, &addend1);
+    }
+    _mm_storeu_pd(sums, sum0);
+    _mm_storeu_pd(sums + 2, sum1);
+    _mm_storeu_pd(addends, addend0);
+    _mm_storeu_pd(addends + 2, addend1);
+#else
+    for (size_t lane = 0; lane < kLanes; ++lane) {
+        sums[lane] = 0.0;
+        addends[lane] = 0.0;
+    }
+    for (size_t i = 0; i < count; i += kLanes) {
+        for (size_t lane = 0; lane < kLanes; ++lane) {
+            double x = values[i + lane];
+            double s = x + addends[lane];
+            addends[lane] -= s - x;
+            x = s;
+
+            s = sums[lane] + x;
+            const double aPrime = s - x;
+            const double bPrime = s - aPrime;
+            x = (sums[lane] - aPrime) + (x - bPrime);
+            sums[lane] = s;
+
+            addends[lane] += x;
+        }
+    }
+#endif
+}
+
+}  // namespace
+
+void DoubleDoubleSummation::addDoubleBatch(const double* values, size_t count) {
+    const size_t laneCount = count - count % kLanes;
+    if (laneCount > 0) {
+        double sums[kLanes];
+        double addends[kLanes];
+        addToLanes(values, laneCount, sums, addends);
+
+        bool finite = true;
+        for (size_t lane = 0; lane < kLanes; ++lane) {
+            finite = finite && std::isfinite(sums[lane]) && std::isfinite(addends[lane]);
+        }
+
+        if (finite) {
+            for (size_t lane = 0; lane < kLanes; ++lane) {
+                addDouble(sums[lane]);
+                addDouble(addends[lane]);
+            }
+        } else {
+            // Infinities and NaNs, whether among the values or from an overflow within a lane,
+            // need the special handling of addDouble() to produce the same result.
+            for (size_t i = 0; i < laneCount; ++i) {
+                addDouble(values[i]);
+            }
+        }
+    }
+
+    for (size_t i = laneCount; i < count; ++i) {
+        addDouble(values[i]);
+    }
+}
+
+void DoubleDoubleSummation::addLongBatch(const long long* values, size_t count) {
+    while (count > 0) {
+        const size_t passCount = std::min(count, kMaxLongPass);
+
+        // Split every value into a signed high and an unsigned low 32-bit half and add up the
+        // halves separately. Neither sum can overflow, so the loop needs no checks.
+        long long highTotal = 0;
+        unsigned long long lowTotal = 0;
+        for (size_t i = 0; i < passCount; ++i) {
+            highTotal += values[i] >> 32;
+            lowTotal += static_cast<unsigned long long>(values[i]) & 0xffffffffULL;
+        }
+
+        // Both parts are exact: 'highTotal' has at most 52 significant bits, and 'lowTotal' is
+        // below 2**52 and split further by addLong().
+        addDouble(static_cast<double>(highTotal) * (1ll << 32));
+        addLong(static_cast<long long>(lowTotal));
+
+        values += passCount;
+        count -= passCount;
+    }
+}
 void DoubleDoubleSummation::addLong(long long x) {
     // Split 64-bit integers into two doubles, so the sum remains exact.
     int64_t high = x / (1ll << 32) * (1ll << 32);
@@ -29,7 +29,10 @@
 
 #pragma once
 
+#include <array>
 #include <cmath>
+#include <cstddef>
+#include <memory>
 #include <tuple>
 #include <utility>
 
@@ -64,6 +67,19 @@ public:
      */
     void addLong(long long x);
 
+    /**
+     * Adds the 'count' values starting at 'values', as if by calling addDouble() on each of them.
+     * The values are spread over several independent compensated sums, which are updated with
+     * vector instructions where available and added to this sum at the end.
+     */
+    void addDoubleBatch(const double* values, size_t count);
+
+    /**
+     * Adds the 'count' values starting at 'values', as if by calling addLong() on each of them.
+     * The values are added up exactly with integer arithmetic first.
+     */
+    void addLongBatch(const long long* values, size_t count);
+
     /**
      * Adds x to internal sum. Adds as double as that is more efficient.
      */
@@ -152,4 +168,88 @@ private:
     // using compensated addition.
     double _special = 0.0;
 };
+
+/**
+ * A DoubleDoubleSummation that stages its inputs and adds them a batch at a time with
+ * addDoubleBatch() and addLongBatch(), which is much cheaper per input than adding them one at a
+ * time. Doubles and longs are staged separately, so that a mix of both still gets batched.
+ *
+ * Staging only starts after the first kInputsBeforeBatching inputs, so that the many short
+ * summations, such as those of groups with few members, don't pay for the staging buffers.
+ */
+class BatchedDoubleDoubleSummation {
+public:
+    static constexpr size_t kBatchSize = 32;
+    static constexpr size_t kInputsBeforeBatching = 64;
+
+    void addDouble(double x) {
+        if (!_batch) {
+            _sum.addDouble(x);
+            _countUnbatchedInput();
+            return;
+        }
+        if (_batch->numDoubles == kBatchSize) {
+            _flushDoubles();
+        }
+        _batch->doubles[_batch->numDoubles++] = x;
+    }
+
+    void addLong(long long x) {
+        if (!_batch) {
+            _sum.addLong(x);
+            _countUnbatchedInput();
+            return;
+        }
+        if (_batch->numLongs == kBatchSize) {
+            _flushLongs();
+        }
+        _batch->longs[_batch->numLongs++] = x;
+    }
+
+    /**
+     * Returns the sum of all inputs added so far.
+     */
+    const DoubleDoubleSummation& get() {
+        if (_batch) {
+            _flushDoubles();
+            _flushLongs();
+        }
+        return _sum;
+    }
+
+    /**
+     * Returns the number of bytes taken by the staging buffers, if they have been allocated.
+     */
+    size_t getBatchMemoryUsageBytes() const {
+        return _batch ? sizeof(Batch) : 0;
+    }
+
+private:
+    struct Batch {
+        std::array<double, kBatchSize> doubles;
+        std::array<long long, kBatchSize> longs;
+        size_t numDoubles = 0;
+        size_t numLongs = 0;
+    };
+
+    void _countUnbatchedInput() {
+        if (++_numUnbatchedInputs == kInputsBeforeBatching) {
+            _batch = std::make_unique<Batch>();
+        }
+    }
+
+    void _flushDoubles() {
+        _sum.addDoubleBatch(_batch->doubles.data(), _batch->numDoubles);
+        _batch->numDoubles = 0;
+    }
+
+    void _flushLongs() {
+        _sum.addLongBatch(_batch->longs.data(), _batch->numLongs);
+        _batch->numLongs = 0;
+    }
+
+    DoubleDoubleSummation _sum;
+    size_t _numUnbatchedInputs = 0;
+    std::unique_ptr<Batch> _batch;
+};
 }  // namespace mongo
@@ -232,4 +232,105 @@ TEST(Summation, ConvertNaNToDecimal) {
     ASSERT_TRUE(sum.getDecimal().isNaN());
     ASSERT_FALSE(sum.getDecimal().isInfinite());
 }
+
+TEST(Summation, AddLongBatchMatchesAddLong) {
+    const std::vector<long long> values = {std::numeric_limits<long long>::max(),
+                                           std::numeric_limits<long long>::max(),
+                                           std::numeric_limits<long long>::min(),
+                                           -1,
+                                           1,
+                                           (1ll << 53) + 1,
+                                           -(1ll << 40) - 7,
+                                           0x123456789abcdefll,
+                                           std::numeric_limits<long long>::min(),
+                                           42};
+    // Lengths both below and above the vector width, so the scalar tail is covered too.
+    for (size_t count = 0; count <= values.size(); ++count) {
+        DoubleDoubleSummation sequential;
+        DoubleDoubleSummation batched;
+        for (size_t i = 0; i < count; ++i) {
+            sequential.addLong(values[i]);
+        }
+        batched.addLongBatch(values.data(), count);
+        ASSERT_EQUALS(sequential.fitsLong(), batched.fitsLong());
+        ASSERT_EQUALS(sequential.getDecimal().toString(), batched.getDecimal().toString());
+        if (sequential.fitsLong()) {
+            ASSERT_EQUALS(sequential.getLong(), batched.getLong());
+        }
+    }
+}
+
+TEST(Summation, AddDoubleBatch) {
+    std::vector<double> values;
+    for (int i = 0; i < 37; ++i) {
+        values.push_back(i % 2 ? 0.1 * i : -1.0 / (i + 1));
+    }
+    DoubleDoubleSummation sequential;
+    DoubleDoubleSummation batched;
+    for (double value : values) {
+        sequential.addDouble(value);
+    }
+    batched.addDoubleBatch(values.data(), values.size());
+    // The lanes add in a different order, which may only change the last bit of the result.
+    ASSERT_APPROX_EQUAL(sequential.getDouble(), batched.getDouble(), 1e-12);
+
+    // Integral doubles are summed exactly regardless of the order.
+    std::vector<double> integers = {1e15, 3, -2, 1e15, 7, -1e15, 11};
+    DoubleDoubleSummation integerSum;
+    integerSum.addDoubleBatch(integers.data(), integers.size());
+    ASSERT_TRUE(integerSum.isInteger());
+    ASSERT_EQUALS(1e15 + 19, integerSum.getDouble());
+}
+
+TEST(Summation, AddDoubleBatchSpecial) {
+    constexpr double infinity = std::numeric_limits<double>::infinity();
+    constexpr double nan = std::numeric_limits<double>::quiet_NaN();
+
+    std::vector<double> values(20, 1.0);
+    values[9] = infinity;
+    DoubleDoubleSummation sum;
+    sum.addDoubleBatch(values.data(), values.size());
+    ASSERT_EQUALS(infinity, sum.getDouble());
+
+    values[13] = -infinity;
+    DoubleDoubleSummation mixedInfinities;
+    mixedInfinities.addDoubleBatch(values.data(), values.size());
+    ASSERT_TRUE(std::isnan(mixedInfinities.getDouble()));
+
+    values[9] = 1.0;
+    values[13] = nan;
+    DoubleDoubleSummation withNaN;
+    withNaN.addDoubleBatch(values.data(), values.size());
+    ASSERT_TRUE(std::isnan(withNaN.getDouble()));
+}
+
+TEST(Summation, BatchedSummationMatchesUnbatched) {
+    BatchedDoubleDoubleSummation batched;
+    DoubleDoubleSummation sequential;
+    ASSERT_EQUALS(0U, batched.getBatchMemoryUsageBytes());
+
+    const size_t numInputs = 4 * BatchedDoubleDoubleSummation::kInputsBeforeBatching;
+    for (size_t i = 0; i < numInputs; ++i) {
+        if (i % 3) {
+            batched.addLong(static_cast<long long>(i) * 1000003);
+            sequential.addLong(static_cast<long long>(i) * 1000003);
+        } else {
+            batched.addDouble(i * 0.5);
+            sequential.addDouble(i * 0.5);
+        }
+
+        // Staging only starts once enough inputs have been seen.
+        ASSERT_EQUALS(i + 1 >= BatchedDoubleDoubleSummation::kInputsBeforeBatching,
+                      batched.getBatchMemoryUsageBytes() > 0);
+    }
+
+    // Every input is integral or a half, so the sum is exact no matter how it was grouped.
+    ASSERT_EQUALS(sequential.getDouble(), batched.get().getDouble());
+    ASSERT_EQUALS(sequential.getDecimal().toString(), batched.get().getDecimal().toString());
+
+    // Reading the sum flushes the staged inputs but later inputs are still counted.
+    batched.addLong(5);
+    sequential.addLong(5);
+    ASSERT_EQUALS(sequential.getDouble(), batched.get().getDouble());
+}
 }  // namespace mongo